@@ -36,8 +36,12 @@ NS_ASSUME_NONNULL_BEGIN
 
 @interface SMJArrayIndexToken : SMJArrayPathToken
 
+// -- Instance --
 - (instancetype)initWithIndexOperation:(SMJArrayIndexOperation *)indexOperation;
 
+// -- Content --
+@property (readonly) SMJArrayIndexOperation *indexOperation;
+
 @end
 
 
@@ -57,14 +57,25 @@ NS_ASSUME_NONNULL_BEGIN
 }
 
 
+/*
+** SMJArrayIndexToken - Content
+*/
+#pragma mark - SMJArrayIndexToken - Content
+
+- (SMJArrayIndexOperation *)indexOperation
+{
+	return _indexOperation;
+}
+
+
 /*
 ** SMJArrayIndexToken - SMJPathToken
 */
 #pragma mark - SMJArrayIndexToken - SMJPathToken
 
-- (SMJEvaluationStatus)evaluateWithCurrentPath:(NSString *)currentPath parentPathRef:(SMJPathRef *)parent jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error
+- (SMJEvaluationStatus)evaluateWithCurrentPath:(const SMJPathSegment *)currentPath parentPathRef:(SMJPathRef *)parent jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error
 {
-	SMJArrayPathCheck checkResult = [self checkArrayWithCurrentPathString:currentPath jsonObject:jsonObject evaluationContext:context error:error];
+	SMJArrayPathCheck checkResult = [self checkArrayWithCurrentPath:currentPath jsonObject:jsonObject evaluationContext:context error:error];
 	
 	if (checkResult == SMJArrayPathCheckSkip)
 		return SMJEvaluationStatusDone;
@@ -74,7 +85,7 @@ NS_ASSUME_NONNULL_BEGIN
 	if (_indexOperation.singleIndexOperation)
 	{
 		NSArray <NSNumber *> *indexSet = _indexOperation.indexes;
-		SMJEvaluationStatus result = [self handleArrayIndex:indexSet.firstObject.integerValue currentPathString:currentPath jsonObject:jsonObject evaluationContext:context error:error];
+		SMJEvaluationStatus result = [self handleArrayIndex:indexSet.firstObject.integerValue currentPath:currentPath jsonObject:jsonObject evaluationContext:context error:error];
 		
 		if (result == SMJEvaluationStatusError)
 			return SMJEvaluationStatusError;
@@ -87,7 +98,7 @@ NS_ASSUME_NONNULL_BEGIN
 		
 		for (NSNumber *index in indexSet)
 		{
-			SMJEvaluationStatus result = [self handleArrayIndex:index.integerValue currentPathString:currentPath jsonObject:jsonObject evaluationContext:context error:error];
+			SMJEvaluationStatus result = [self handleArrayIndex:index.integerValue currentPath:currentPath jsonObject:jsonObject evaluationContext:context error:error];
 			
 			if (result == SMJEvaluationStatusError)
 				return SMJEvaluationStatusError;
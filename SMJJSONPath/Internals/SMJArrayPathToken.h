@@ -48,7 +48,7 @@ typedef enum SMJArrayPathCheck
 
 @interface SMJArrayPathToken : SMJPathToken
 
-- (SMJArrayPathCheck)checkArrayWithCurrentPathString:(NSString *)currentPath jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error;
+- (SMJArrayPathCheck)checkArrayWithCurrentPath:(const SMJPathSegment *)currentPath jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error;
 
 @end
 
@@ -54,7 +54,7 @@ NS_ASSUME_NONNULL_BEGIN
  * @throws PathNotFoundException if object is null and evaluation must be interrupted
  * @throws InvalidPathException if object is not an array and evaluation must be interrupted
  */
-- (SMJArrayPathCheck)checkArrayWithCurrentPathString:(NSString *)currentPath jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error
+- (SMJArrayPathCheck)checkArrayWithCurrentPath:(const SMJPathSegment *)currentPath jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error
 {
 	if (jsonObject == nil)
 	{
@@ -64,7 +64,7 @@ NS_ASSUME_NONNULL_BEGIN
 		}
 		else
 		{
-			SMSetError(error, 1, @"The path %@ is null", currentPath);
+			SMSetError(error, 1, @"The path %@ is null", SMJPathSegmentString(currentPath));
 			return SMJArrayPathCheckError;
 		}
 	}
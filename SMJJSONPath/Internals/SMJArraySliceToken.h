@@ -36,8 +36,12 @@ NS_ASSUME_NONNULL_BEGIN
 
 @interface SMJArraySliceToken : SMJArrayPathToken
 
+// -- Instance --
 - (instancetype)initWithSliceOperation:(SMJArraySliceOperation *)sliceOperation;
 
+// -- Content --
+@property (readonly) SMJArraySliceOperation *sliceOperation;
+
 @end
 
 
@@ -57,14 +57,25 @@ NS_ASSUME_NONNULL_BEGIN
 }
 
 
+/*
+** SMJArraySliceToken - Content
+*/
+#pragma mark - SMJArraySliceToken - Content
+
+- (SMJArraySliceOperation *)sliceOperation
+{
+	return _sliceOperation;
+}
+
+
 /*
 ** SMJArraySliceToken - SMJPathToken
 */
 #pragma mark - SMJArraySliceToken - SMJPathToken
 
-- (SMJEvaluationStatus)evaluateWithCurrentPath:(NSString *)currentPath parentPathRef:(SMJPathRef *)parent jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error
+- (SMJEvaluationStatus)evaluateWithCurrentPath:(const SMJPathSegment *)currentPath parentPathRef:(SMJPathRef *)parent jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error
 {
-	SMJArrayPathCheck checkResult = [self checkArrayWithCurrentPathString:currentPath jsonObject:jsonObject evaluationContext:context error:error];
+	SMJArrayPathCheck checkResult = [self checkArrayWithCurrentPath:currentPath jsonObject:jsonObject evaluationContext:context error:error];
 	
 	if (checkResult == SMJArrayPathCheckSkip)
 		return SMJEvaluationStatusDone;
@@ -74,13 +85,13 @@ NS_ASSUME_NONNULL_BEGIN
 	switch (_sliceOperation.operation)
 	{
 		case SMJSliceOperationFrom:
-			return [self sliceFromWithOperation:_sliceOperation currentPathString:currentPath parentPathRef:parent jsonObject:jsonObject evaluationContext:context error:error];
+			return [self sliceFromWithOperation:_sliceOperation currentPath:currentPath parentPathRef:parent jsonObject:jsonObject evaluationContext:context error:error];
 			
 		case SMJSliceOperationBetween:
-			return [self sliceBetweenWithOperation:_sliceOperation currentPathString:currentPath parentPathRef:parent jsonObject:jsonObject evaluationContext:context error:error];
+			return [self sliceBetweenWithOperation:_sliceOperation currentPath:currentPath parentPathRef:parent jsonObject:jsonObject evaluationContext:context error:error];
 			
 		case SMJSliceOperationTo:
-			return [self sliceToWithOperation:_sliceOperation currentPathString:currentPath parentPathRef:parent jsonObject:jsonObject evaluationContext:context error:error];
+			return [self sliceToWithOperation:_sliceOperation currentPath:currentPath parentPathRef:parent jsonObject:jsonObject evaluationContext:context error:error];
 	}
 	
 	return SMJEvaluationStatusDone;
@@ -102,7 +113,7 @@ NS_ASSUME_NONNULL_BEGIN
 */
 #pragma mark - SMJArraySliceToken - Helpers
 
-- (SMJEvaluationStatus)sliceFromWithOperation:(SMJArraySliceOperation *)operation currentPathString:(NSString *)currentPath parentPathRef:(SMJPathRef *)parent jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error
+- (SMJEvaluationStatus)sliceFromWithOperation:(SMJArraySliceOperation *)operation currentPath:(const SMJPathSegment *)currentPath parentPathRef:(SMJPathRef *)parent jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error
 {
 	NSArray *array = jsonObject;
 	NSInteger length = array.count;
@@ -121,7 +132,7 @@ NS_ASSUME_NONNULL_BEGIN
 	
 	for (NSInteger i = from; i < length; i++)
 	{
-		SMJEvaluationStatus result = [self handleArrayIndex:i currentPathString:currentPath jsonObject:jsonObject evaluationContext:context error:error];
+		SMJEvaluationStatus result = [self handleArrayIndex:i currentPath:currentPath jsonObject:jsonObject evaluationContext:context error:error];
 		
 		if (result == SMJEvaluationStatusError)
 			return SMJEvaluationStatusError;
@@ -132,7 +143,7 @@ NS_ASSUME_NONNULL_BEGIN
 	return SMJEvaluationStatusDone;
 }
 
-- (SMJEvaluationStatus)sliceBetweenWithOperation:(SMJArraySliceOperation *)operation currentPathString:(NSString *)currentPath parentPathRef:(SMJPathRef *)parent jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error
+- (SMJEvaluationStatus)sliceBetweenWithOperation:(SMJArraySliceOperation *)operation currentPath:(const SMJPathSegment *)currentPath parentPathRef:(SMJPathRef *)parent jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error
 {
 	NSArray *array = jsonObject;
 	NSInteger length = array.count;
@@ -150,7 +161,7 @@ NS_ASSUME_NONNULL_BEGIN
 	
 	for (NSInteger i = from; i < to; i++)
 	{
-		SMJEvaluationStatus result = [self handleArrayIndex:i currentPathString:currentPath jsonObject:jsonObject evaluationContext:context error:error];
+		SMJEvaluationStatus result = [self handleArrayIndex:i currentPath:currentPath jsonObject:jsonObject evaluationContext:context error:error];
 		
 		if (result == SMJEvaluationStatusError)
 			return SMJEvaluationStatusError;
@@ -161,7 +172,7 @@ NS_ASSUME_NONNULL_BEGIN
 	return SMJEvaluationStatusDone;
 }
 
-- (SMJEvaluationStatus)sliceToWithOperation:(SMJArraySliceOperation *)operation currentPathString:(NSString *)currentPath parentPathRef:(SMJPathRef *)parent jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error
+- (SMJEvaluationStatus)sliceToWithOperation:(SMJArraySliceOperation *)operation currentPath:(const SMJPathSegment *)currentPath parentPathRef:(SMJPathRef *)parent jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error
 {
 	NSArray		*array = jsonObject;
 	NSInteger	length = array.count;
@@ -181,7 +192,7 @@ NS_ASSUME_NONNULL_BEGIN
 	
 	for (NSInteger i = 0; i < to; i++)
 	{
-		SMJEvaluationStatus result = [self handleArrayIndex:i currentPathString:currentPath jsonObject:jsonObject evaluationContext:context error:error];
+		SMJEvaluationStatus result = [self handleArrayIndex:i currentPath:currentPath jsonObject:jsonObject evaluationContext:context error:error];
 		
 		if (result == SMJEvaluationStatusError)
 			return SMJEvaluationStatusError;
@@ -25,6 +25,7 @@
 #import "SMJPath.h"
 
 #import "SMJRootPathToken.h"
+#import "SMJEvaluationProfile.h"
 
 
 NS_ASSUME_NONNULL_BEGIN
@@ -40,6 +41,21 @@ NS_ASSUME_NONNULL_BEGIN
 // -- Instance --
 - (instancetype)initWithRootPathToken:(SMJRootPathToken *)root isRootPath:(BOOL)isRootPath;
 
+// -- Properties --
+@property (readonly) SMJRootPathToken *root;
+
+// -- Evaluate --
+// > Record the statistics of the evaluation in profile, when not nil.
+- (nullable id <SMJEvaluationContext>)evaluateJsonObject:(id)jsonObject rootJsonObject:(id)rootJsonObject configuration:(SMJConfiguration *)configuration forUpdate:(BOOL)forUpdate resultLimit:(NSUInteger)resultLimit profile:(nullable SMJEvaluationProfile *)profile error:(NSError **)error;
+
+// > Evaluate for update, and record the location of each update operation, so they can be applied on a copy of jsonObject (see SMJPathRef copy on write).
+- (nullable id <SMJEvaluationContext>)evaluateJsonObjectForCopyOnWrite:(id)jsonObject configuration:(SMJConfiguration *)configuration error:(NSError **)error;
+
+// -- Probe --
+// > Tell if the path selects a value in jsonObject, as an evaluation with SMJOptionRequireProperties added to configuration would.
+// > Paths made of single properties and single indexes are walked with direct lookups, without evaluation context, results or errors.
+- (BOOL)probeJsonObject:(id)jsonObject rootJsonObject:(id)rootJsonObject configuration:(SMJConfiguration *)configuration;
+
 @end
 
 
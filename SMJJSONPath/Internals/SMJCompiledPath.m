@@ -24,11 +24,27 @@
 
 #import "SMJFunctionPathToken.h"
 #import "SMJScanPathToken.h"
+#import "SMJPropertyPathToken.h"
+#import "SMJArrayIndexToken.h"
+#import "SMJEvaluationProfileInternal.h"
 
 
 NS_ASSUME_NONNULL_BEGIN
 
 
+/*
+** Types
+*/
+#pragma mark - Types
+
+typedef struct SMJProbeStep
+{
+	__unsafe_unretained NSString * _Nullable property; // nil for an index step.
+	NSInteger index;
+} SMJProbeStep;
+
+
+
 /*
 ** SMJCompiledPath
 */
@@ -39,6 +55,11 @@ NS_ASSUME_NONNULL_BEGIN
 	SMJRootPathToken *_root;
 	
 	BOOL _isRootPath;
+	
+	// Probe plan. Only for paths made of single properties and single indexes.
+	SMJProbeStep	*_probeSteps;
+	NSUInteger		_probeStepCount;
+	BOOL			_probeable;
 }
 
 
@@ -55,17 +76,69 @@ NS_ASSUME_NONNULL_BEGIN
 	{
 		_root = [self invertScannerFunctionRelationshipWithToken:root];
 		_isRootPath = isRootPath;
+		
+		[_root freeze];
+		
+		[self buildProbePlan];
 	}
 	
 	return self;
 }
 
+- (void)dealloc
+{
+	free(_probeSteps);
+}
+
+
+/*
+** SMJCompiledPath - Properties
+*/
+#pragma mark - SMJCompiledPath - Properties
+
+- (SMJRootPathToken *)root
+{
+	return _root;
+}
+
 
 /*
 ** SMJCompiledPath - Helpers
 */
 #pragma mark - SMJCompiledPath - Helpers
 
+- (void)buildProbePlan
+{
+	// Count steps. Tokens are frozen, so the plan stays valid, and properties stay alive with their token.
+	NSUInteger count = 0;
+	
+	for (SMJPathToken *token = (_root.leaf ? nil : _root.next); token; token = (token.leaf ? nil : token.next))
+	{
+		if ([token isKindOfClass:[SMJPropertyPathToken class]] && ((SMJPropertyPathToken *)token).singlePropertyCase)
+			count++;
+		else if ([token isKindOfClass:[SMJArrayIndexToken class]] && ((SMJArrayIndexToken *)token).indexOperation.singleIndexOperation)
+			count++;
+		else
+			return;
+	}
+	
+	// Build steps.
+	SMJProbeStep	*steps = calloc(MAX(count, 1), sizeof(SMJProbeStep));
+	NSUInteger		i = 0;
+	
+	for (SMJPathToken *token = (_root.leaf ? nil : _root.next); token; token = (token.leaf ? nil : token.next), i++)
+	{
+		if ([token isKindOfClass:[SMJPropertyPathToken class]])
+			steps[i].property = ((SMJPropertyPathToken *)token).properties[0];
+		else
+			steps[i].index = ((SMJArrayIndexToken *)token).indexOperation.indexes.firstObject.integerValue;
+	}
+	
+	_probeSteps = steps;
+	_probeStepCount = count;
+	_probeable = YES;
+}
+
 /**
  * In the event the writer of the path referenced a function at the tail end of a scanner, augment the query such
  * that the root node is the function and the parameter to the function is the scanner.   This way we maintain
@@ -130,22 +203,57 @@ NS_ASSUME_NONNULL_BEGIN
 }
 
 - (nullable id <SMJEvaluationContext>)evaluateJsonObject:(id)jsonObject rootJsonObject:(id)rootJsonObject configuration:(SMJConfiguration *)configuration forUpdate:(BOOL)forUpdate error:(NSError **)error
+{
+	return [self evaluateJsonObject:jsonObject rootJsonObject:rootJsonObject configuration:configuration forUpdate:forUpdate resultLimit:0 error:error];
+}
+
+- (nullable id <SMJEvaluationContext>)evaluateJsonObject:(id)jsonObject rootJsonObject:(id)rootJsonObject configuration:(SMJConfiguration *)configuration forUpdate:(BOOL)forUpdate resultLimit:(NSUInteger)resultLimit error:(NSError **)error
+{
+	return [self evaluateJsonObject:jsonObject rootJsonObject:rootJsonObject configuration:configuration forUpdate:forUpdate resultLimit:resultLimit profile:nil error:error];
+}
+
+- (nullable id <SMJEvaluationContext>)evaluateJsonObject:(id)jsonObject rootJsonObject:(id)rootJsonObject configuration:(SMJConfiguration *)configuration forUpdate:(BOOL)forUpdate resultLimit:(NSUInteger)resultLimit profile:(nullable SMJEvaluationProfile *)profile error:(NSError **)error
 {
 	//if (logger.isDebugEnabled()) {
 	//	logger.debug("Evaluating path: {}", toString());
 	//}
 	
-	SMJEvaluationContextImpl *context = [[SMJEvaluationContextImpl alloc] initWithPath:self rootJsonObject:rootJsonObject configuration:configuration forUpdate:forUpdate];
-	SMJPathRef				 *op = context.forUpdate ?  [SMJPathRef pathRefWithRootObject:rootJsonObject] : [SMJPathRef pathRefNull];
+	SMJEvaluationContextImpl *context = [[SMJEvaluationContextImpl alloc] initWithPath:self rootJsonObject:rootJsonObject configuration:configuration forUpdate:forUpdate resultLimit:resultLimit];
+	uint64_t				 start = (profile ? SMJProfileTime() : 0);
+	
+	context.profile = profile;
+
+	BOOL succeed = [self evaluateJsonObject:jsonObject rootJsonObject:rootJsonObject context:context error:error];
+	
+	if (profile)
+		[profile finishWithResultCount:context.resultCount duration:SMJProfileTime() - start];
+	
+	if (!succeed)
+		return nil;
+	
+	return context;
+}
 
-	SMJEvaluationStatus result = [_root evaluateWithCurrentPath:@"" parentPathRef:op jsonObject:jsonObject evaluationContext:context error:error];
+- (nullable id <SMJEvaluationContext>)evaluateJsonObjectForCopyOnWrite:(id)jsonObject configuration:(SMJConfiguration *)configuration error:(NSError **)error
+{
+	SMJEvaluationContextImpl *context = [[SMJEvaluationContextImpl alloc] initWithPath:self rootJsonObject:jsonObject configuration:configuration forUpdate:YES];
+	
+	context.recordsUpdateLocations = YES;
 	
-	if (result == SMJEvaluationStatusError)
+	if ([self evaluateJsonObject:jsonObject rootJsonObject:jsonObject context:context error:error] == NO)
 		return nil;
 	
 	return context;
 }
 
+- (BOOL)evaluateJsonObject:(id)jsonObject rootJsonObject:(id)rootJsonObject context:(SMJEvaluationContextImpl *)context error:(NSError **)error
+{
+	SMJPathRef		*op = context.forUpdate ?  [SMJPathRef pathRefWithRootObject:rootJsonObject] : [SMJPathRef pathRefNull];
+	SMJPathSegment	currentPath = SMJPathSegmentMakeRoot(@"");
+	
+	return (SMJPathTokenEvaluate(_root, &currentPath, op, jsonObject, context, error) != SMJEvaluationStatusError);
+}
+
 - (BOOL)isDefinite
 {
 	return _root.pathDefinite;
@@ -161,6 +269,65 @@ NS_ASSUME_NONNULL_BEGIN
 	 return _isRootPath;
 }
 
+
+/*
+** SMJCompiledPath - Probe
+*/
+#pragma mark - SMJCompiledPath - Probe
+
+- (BOOL)probeJsonObject:(id)jsonObject rootJsonObject:(id)rootJsonObject configuration:(SMJConfiguration *)configuration
+{
+	if (!_probeable)
+	{
+		// Generic evaluation.
+		SMJConfiguration *probeConfiguration = [configuration mutableCopy];
+		
+		[probeConfiguration addOption:SMJOptionRequireProperties];
+		
+		id <SMJEvaluationContext> evaluationContext = [self evaluateJsonObject:jsonObject rootJsonObject:rootJsonObject configuration:probeConfiguration error:nil];
+		
+		return (evaluationContext && [evaluationContext jsonObjectWithError:nil] != nil);
+	}
+	
+	// Direct lookups. Each failure below is an error, or a missing result, for the generic evaluation.
+	id current = jsonObject;
+	
+	for (NSUInteger i = 0; i < _probeStepCount; i++)
+	{
+		const SMJProbeStep *step = &_probeSteps[i];
+		
+		if (step->property)
+		{
+			if ([current isKindOfClass:[NSDictionary class]] == NO)
+				return NO;
+			
+			current = [(NSDictionary *)current objectForKey:(NSString *)step->property];
+			
+			if (!current)
+			{
+				// A missing leaf is null with this option.
+				return (i + 1 == _probeStepCount && [configuration containsOption:SMJOptionDefaultPathLeafToNull]);
+			}
+		}
+		else
+		{
+			if ([current isKindOfClass:[NSArray class]] == NO)
+				return NO;
+			
+			NSArray		*array = current;
+			NSInteger	count = (NSInteger)array.count;
+			NSInteger	index = (step->index < 0 ? count + step->index : step->index);
+			
+			if (index < 0 || index >= count)
+				return NO;
+			
+			current = array[(NSUInteger)index];
+		}
+	}
+	
+	return (current != nil);
+}
+
 @end
 
 
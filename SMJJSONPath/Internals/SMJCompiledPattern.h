@@ -0,0 +1,56 @@
+/*
+ * SMJCompiledPattern.h
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** SMJCompiledPattern
+*/
+#pragma mark - SMJCompiledPattern
+
+// A compiled regular expression, shared by all the nodes using the same pattern and flags.
+// When the pattern requires a literal substring (or an anchored prefix), strings without it are rejected before running the regex engine.
+
+@interface SMJCompiledPattern : NSObject
+
+// -- Instance --
++ (nullable SMJCompiledPattern *)compiledPatternWithPattern:(NSString *)pattern flags:(NSString *)flags error:(NSError **)error;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+// -- Match --
+- (BOOL)matchesString:(NSString *)string;
+
+// -- Properties --
+@property (readonly) NSRegularExpression *regularExpression;
+
+@property (nullable, readonly) NSString *requiredLiteral;
+@property (readonly) BOOL requiredLiteralIsPrefix;
+
+// -- Cache --
++ (void)purgeCache;
+
+@end
+
+
+NS_ASSUME_NONNULL_END
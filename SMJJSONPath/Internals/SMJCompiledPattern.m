@@ -0,0 +1,482 @@
+/*
+ * SMJCompiledPattern.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <pthread.h>
+
+#import "SMJCompiledPattern.h"
+
+#import "SMJPatternFlags.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** Defines
+*/
+#pragma mark - Defines
+
+#define SMJCompiledPatternCacheCapacity 256
+
+
+
+/*
+** Globals
+*/
+#pragma mark - Globals
+
+static pthread_mutex_t									gCacheLock = PTHREAD_MUTEX_INITIALIZER;
+static NSMutableDictionary <NSString *, SMJCompiledPattern *>	*gCache;
+
+
+
+/*
+** Helpers
+*/
+#pragma mark - Helpers
+
+NS_INLINE BOOL SMJIsASCIIAlphanumeric(unichar c)
+{
+	return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+// Skip the quantifier at index, if any, with its lazy or possessive suffix. Return NO on a malformed quantifier.
+static BOOL SMJSkipQuantifier(const unichar *chars, NSUInteger length, NSUInteger *index)
+{
+	NSUInteger i = *index;
+	
+	if (i >= length)
+		return YES;
+	
+	if (chars[i] == '?' || chars[i] == '*' || chars[i] == '+')
+		i++;
+	else if (chars[i] == '{')
+	{
+		while (i < length && chars[i] != '}')
+			i++;
+		
+		if (i >= length)
+			return NO;
+		
+		i++;
+	}
+	else
+		return YES;
+	
+	if (i < length && (chars[i] == '?' || chars[i] == '+'))
+		i++;
+	
+	*index = i;
+	
+	return YES;
+}
+
+// Skip the character class starting at index (on the '['). Return NO if the class isn't closed.
+static BOOL SMJSkipClass(const unichar *chars, NSUInteger length, NSUInteger *index)
+{
+	NSUInteger	i = *index + 1;
+	NSUInteger	depth = 1;
+	
+	// A ']' right after the opening is a literal.
+	if (i < length && chars[i] == '^')
+		i++;
+	
+	if (i < length && chars[i] == ']')
+		i++;
+	
+	for (; i < length; i++)
+	{
+		if (chars[i] == '\\')
+			i++;
+		else if (chars[i] == '[')
+			depth++;
+		else if (chars[i] == ']' && --depth == 0)
+		{
+			*index = i + 1;
+			return YES;
+		}
+	}
+	
+	return NO;
+}
+
+// Skip the group starting at index (on the '('). Return NO if the group isn't closed, or if it changes the flags of the enclosing group.
+static BOOL SMJSkipGroup(const unichar *chars, NSUInteger length, NSUInteger *index)
+{
+	NSUInteger i = *index;
+	
+	// (?i), (?-s), ... apply to the rest of the pattern: literals after them can't be trusted.
+	if (i + 2 < length && chars[i + 1] == '?')
+	{
+		unichar c = chars[i + 2];
+		
+		if (c != ':' && c != '=' && c != '!' && c != '<' && c != '>')
+			return NO;
+	}
+	
+	NSUInteger depth = 0;
+	
+	while (i < length)
+	{
+		unichar c = chars[i];
+		
+		if (c == '\\')
+			i += 2;
+		else if (c == '[')
+		{
+			if (SMJSkipClass(chars, length, &i) == NO)
+				return NO;
+		}
+		else
+		{
+			if (c == '(')
+				depth++;
+			else if (c == ')' && --depth == 0)
+			{
+				*index = i + 1;
+				return YES;
+			}
+			
+			i++;
+		}
+	}
+	
+	return NO;
+}
+
+// Extract the longest literal substring any match has to contain. The parsing is conservative: anything unexpected gives up the prefilter.
+static NSString * _Nullable SMJPatternRequiredLiteral(NSString *pattern, NSRegularExpressionOptions options, BOOL *isPrefix)
+{
+	*isPrefix = NO;
+	
+	// Literals can't be compared as-is.
+	if (options & (NSRegularExpressionCaseInsensitive | NSRegularExpressionAllowCommentsAndWhitespace | NSRegularExpressionIgnoreMetacharacters))
+		return nil;
+	
+	NSUInteger length = pattern.length;
+	
+	if (length == 0)
+		return nil;
+	
+	unichar *chars = malloc(length * sizeof(unichar));
+	
+	[pattern getCharacters:chars range:NSMakeRange(0, length)];
+	
+	NSMutableString		*run = [[NSMutableString alloc] init];
+	__block NSString	*best = nil;
+	__block BOOL		runIsPrefix = NO;
+	__block BOOL		bestIsPrefix = NO;
+	BOOL				failed = NO;
+	NSUInteger			i = 0;
+	
+	void (^endRun)(void) = ^{
+		if (run.length > best.length)
+		{
+			best = [run copy];
+			bestIsPrefix = runIsPrefix;
+		}
+		
+		[run setString:@""];
+		runIsPrefix = NO;
+	};
+	
+	// A leading '^' anchors the first literal at the beginning of the string, unless it matches after each line separator.
+	if (chars[0] == '^' && (options & NSRegularExpressionAnchorsMatchLines) == 0)
+	{
+		runIsPrefix = YES;
+		i = 1;
+	}
+	
+	while (i < length && !failed)
+	{
+		unichar		c = chars[i];
+		unichar		atom[2];
+		NSUInteger	atomLength = 0;
+		
+		switch (c)
+		{
+			case '\\':
+			{
+				if (i + 1 >= length)
+				{
+					failed = YES;
+					break;
+				}
+				
+				unichar escaped = chars[i + 1];
+				
+				if (SMJIsASCIIAlphanumeric(escaped) == NO)
+				{
+					atom[0] = escaped;
+					atomLength = 1;
+					i += 2;
+				}
+				else if (escaped == 'd' || escaped == 'D' || escaped == 'w' || escaped == 'W' || escaped == 's' || escaped == 'S' || escaped == 'b' || escaped == 'B')
+				{
+					endRun();
+					i += 2;
+					failed = !SMJSkipQuantifier(chars, length, &i);
+				}
+				else
+					failed = YES; // \Q, \x, \u, \p, back-references, ...
+				
+				break;
+			}
+			
+			case '(':
+				endRun();
+				failed = !SMJSkipGroup(chars, length, &i) || !SMJSkipQuantifier(chars, length, &i);
+				break;
+			
+			case '[':
+				endRun();
+				failed = !SMJSkipClass(chars, length, &i) || !SMJSkipQuantifier(chars, length, &i);
+				break;
+			
+			case '.':
+				endRun();
+				i++;
+				failed = !SMJSkipQuantifier(chars, length, &i);
+				break;
+			
+			case '^':
+			case '$':
+				endRun();
+				i++;
+				break;
+			
+			case '|':
+			case ')':
+			case '?':
+			case '*':
+			case '+':
+			case '{':
+				failed = YES;
+				break;
+			
+			default:
+			{
+				atom[0] = c;
+				atomLength = 1;
+				i++;
+				
+				// Keep surrogate pairs together.
+				if (CFStringIsSurrogateHighCharacter(c) && i < length && CFStringIsSurrogateLowCharacter(chars[i]))
+				{
+					atom[1] = chars[i];
+					atomLength = 2;
+					i++;
+				}
+				
+				break;
+			}
+		}
+		
+		if (atomLength == 0 || failed)
+			continue;
+		
+		// Handle quantified literals.
+		unichar next = (i < length ? chars[i] : 0);
+		
+		if (next == '?' || next == '*' || next == '{')
+		{
+			endRun();
+			failed = !SMJSkipQuantifier(chars, length, &i);
+		}
+		else if (next == '+')
+		{
+			[run appendString:[NSString stringWithCharacters:atom length:atomLength]];
+			endRun();
+			failed = !SMJSkipQuantifier(chars, length, &i);
+		}
+		else
+			[run appendString:[NSString stringWithCharacters:atom length:atomLength]];
+	}
+	
+	free(chars);
+	
+	if (failed)
+		return nil;
+	
+	endRun();
+	
+	if (best.length == 0)
+		return nil;
+	
+	*isPrefix = bestIsPrefix;
+	
+	return best;
+}
+
+
+
+/*
+** SMJCompiledPattern
+*/
+#pragma mark - SMJCompiledPattern
+
+@implementation SMJCompiledPattern
+{
+	// UTF-8 bytes of the required literal, if it's ASCII: searched directly in the 8-bit storage of strings.
+	NSData *_asciiLiteral;
+}
+
+
+/*
+** SMJCompiledPattern - Instance
+*/
+#pragma mark - SMJCompiledPattern - Instance
+
++ (nullable SMJCompiledPattern *)compiledPatternWithPattern:(NSString *)pattern flags:(NSString *)flags error:(NSError **)error
+{
+	NSRegularExpressionOptions	options = [SMJPatternFlags parseFlags:flags];
+	NSString					*key = [NSString stringWithFormat:@"%lu/%@", (unsigned long)options, pattern];
+	SMJCompiledPattern			*result = nil;
+	
+	// Search in cache.
+	pthread_mutex_lock(&gCacheLock);
+	{
+		result = gCache[key];
+	}
+	pthread_mutex_unlock(&gCacheLock);
+	
+	if (result)
+		return result;
+	
+	// Compile.
+	NSRegularExpression *regularExpression = [NSRegularExpression regularExpressionWithPattern:pattern options:options error:error];
+	
+	if (!regularExpression)
+		return nil;
+	
+	result = [[SMJCompiledPattern alloc] initWithRegularExpression:regularExpression];
+	
+	// Store in cache. Patterns built dynamically can be unbounded: the cache is simply flushed when it's full.
+	pthread_mutex_lock(&gCacheLock);
+	{
+		SMJCompiledPattern *existing = gCache[key];
+		
+		if (existing)
+			result = existing;
+		else
+		{
+			if (!gCache)
+				gCache = [[NSMutableDictionary alloc] init];
+			else if (gCache.count >= SMJCompiledPatternCacheCapacity)
+				[gCache removeAllObjects];
+			
+			gCache[key] = result;
+		}
+	}
+	pthread_mutex_unlock(&gCacheLock);
+	
+	return result;
+}
+
+- (instancetype)initWithRegularExpression:(NSRegularExpression *)regularExpression
+{
+	self = [super init];
+	
+	if (self)
+	{
+		BOOL isPrefix = NO;
+		
+		_regularExpression = regularExpression;
+		_requiredLiteral = SMJPatternRequiredLiteral(regularExpression.pattern, regularExpression.options, &isPrefix);
+		_requiredLiteralIsPrefix = isPrefix;
+		
+		if (_requiredLiteral && [_requiredLiteral canBeConvertedToEncoding:NSASCIIStringEncoding])
+			_asciiLiteral = [_requiredLiteral dataUsingEncoding:NSASCIIStringEncoding];
+	}
+	
+	return self;
+}
+
+
+/*
+** SMJCompiledPattern - Match
+*/
+#pragma mark - SMJCompiledPattern - Match
+
+- (BOOL)matchesString:(NSString *)string
+{
+	if (_requiredLiteral && [self containsRequiredLiteral:string] == NO)
+		return NO;
+	
+	return ([_regularExpression rangeOfFirstMatchInString:string options:0 range:NSMakeRange(0, string.length)].location != NSNotFound);
+}
+
+- (BOOL)containsRequiredLiteral:(NSString *)string
+{
+	// Fast path: the string is stored on 8 bits, and the literal is ASCII, so bytes and characters are the same thing.
+	const char *bytes = (_asciiLiteral ? CFStringGetCStringPtr((__bridge CFStringRef)string, kCFStringEncodingUTF8) : NULL);
+	
+	if (bytes)
+	{
+		const char	*literal = _asciiLiteral.bytes;
+		size_t		literalLength = _asciiLiteral.length;
+		size_t		length = (size_t)CFStringGetLength((__bridge CFStringRef)string);
+		
+		if (literalLength > length)
+			return NO;
+		
+		if (_requiredLiteralIsPrefix)
+			return (memcmp(bytes, literal, literalLength) == 0);
+		
+		const char *end = bytes + length - literalLength + 1;
+		
+		for (const char *cursor = bytes; cursor < end; cursor++)
+		{
+			cursor = memchr(cursor, literal[0], (size_t)(end - cursor));
+			
+			if (!cursor)
+				return NO;
+			
+			if (memcmp(cursor, literal, literalLength) == 0)
+				return YES;
+		}
+		
+		return NO;
+	}
+	
+	// Generic path.
+	NSStringCompareOptions options = NSLiteralSearch | (_requiredLiteralIsPrefix ? NSAnchoredSearch : 0);
+	
+	return ([string rangeOfString:_requiredLiteral options:options].location != NSNotFound);
+}
+
+
+/*
+** SMJCompiledPattern - Cache
+*/
+#pragma mark - SMJCompiledPattern - Cache
+
++ (void)purgeCache
+{
+	pthread_mutex_lock(&gCacheLock);
+	{
+		[gCache removeAllObjects];
+	}
+	pthread_mutex_unlock(&gCacheLock);
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,44 @@
+/*
+ * SMJEvaluationCache.h
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** SMJEvaluationCache
+*/
+#pragma mark - SMJEvaluationCache
+
+// Values computed once per evaluation (root paths evaluated by filters, path parameters of functions), shared by all the tokens of an evaluation.
+// Compiled paths are immutable, so this is where values which depend on the evaluated document are kept.
+// Lock protected, so the workers of a parallel evaluation can share it.
+
+@interface SMJEvaluationCache : NSObject
+
+// -- Content --
+- (nullable id)objectForKey:(id <NSCopying>)key;
+- (void)setObject:(id)object forKey:(id <NSCopying>)key;
+
+@end
+
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,91 @@
+/*
+ * SMJEvaluationCache.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <pthread.h>
+
+#import "SMJEvaluationCache.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** SMJEvaluationCache
+*/
+#pragma mark - SMJEvaluationCache
+
+@implementation SMJEvaluationCache
+{
+	pthread_mutex_t _lock;
+	
+	NSMutableDictionary <id <NSCopying>, id> *_objects;
+}
+
+
+/*
+** SMJEvaluationCache - Instance
+*/
+#pragma mark - SMJEvaluationCache - Instance
+
+- (instancetype)init
+{
+	self = [super init];
+	
+	if (self)
+	{
+		pthread_mutex_init(&_lock, NULL);
+		_objects = [[NSMutableDictionary alloc] init];
+	}
+	
+	return self;
+}
+
+- (void)dealloc
+{
+	pthread_mutex_destroy(&_lock);
+}
+
+
+/*
+** SMJEvaluationCache - Content
+*/
+#pragma mark - SMJEvaluationCache - Content
+
+- (nullable id)objectForKey:(id <NSCopying>)key
+{
+	id result;
+	
+	pthread_mutex_lock(&_lock);
+	result = _objects[key];
+	pthread_mutex_unlock(&_lock);
+	
+	return result;
+}
+
+- (void)setObject:(id)object forKey:(id <NSCopying>)key
+{
+	pthread_mutex_lock(&_lock);
+	_objects[key] = object;
+	pthread_mutex_unlock(&_lock);
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
@@ -63,6 +63,8 @@ NS_ASSUME_NONNULL_BEGIN
 /**
  * Get list of hits as String path representations
  *
+ * Paths are only rendered when the configuration contains SMJOptionAsPathList or evaluation listeners, the list is empty otherwise.
+ *
  * @return list of path representations
  */
 @property (readonly) NSArray <NSString *> *pathList;
@@ -27,6 +27,11 @@
 
 #import "SMJPath.h"
 #import "SMJPathRef.h"
+#import "SMJEvaluationCache.h"
+#import "SMJPathSegment.h"
+
+
+@class SMJEvaluationProfile;
 
 
 NS_ASSUME_NONNULL_BEGIN
@@ -55,15 +60,41 @@ typedef enum SMJEvaluationContextStatus
 
 // -- Instance --
 - (instancetype)initWithPath:(id <SMJPath>)path rootJsonObject:(id)rootJsonObject configuration:(SMJConfiguration *)configuration forUpdate:(BOOL)forUpdate;
+- (instancetype)initWithPath:(id <SMJPath>)path rootJsonObject:(id)rootJsonObject configuration:(SMJConfiguration *)configuration forUpdate:(BOOL)forUpdate resultLimit:(NSUInteger)resultLimit; // 0 for no limit.
 
 // -- Result --
-- (SMJEvaluationContextStatus)addResult:(NSString *)path operation:(SMJPathRef *)operation jsonObject:(id)jsonObject;
+- (SMJEvaluationContextStatus)addResult:(const SMJPathSegment *)path operation:(SMJPathRef *)operation jsonObject:(id)jsonObject;
+
+@property (readonly) NSUInteger resultCount;
+@property (readonly) BOOL needPaths; // YES if the paths of the results are visible (path list, listeners), and so rendered.
+
+// -- Options --
+// > Snapshot of the configuration options, taken when the context is created. Use it instead of -[SMJConfiguration containsOption:] while evaluating.
+@property (readonly) SMJOptionMask optionMask;
+
+- (BOOL)containsOption:(SMJOption)option;
+
+// -- Limit --
+@property (readonly) NSUInteger resultLimit;
+
+// -- Parallel --
+// > A worker context collects the results of a part of the evaluation, without calling listeners. Its results are merged in its parent, in order, once the part is done.
+- (instancetype)initWithParentContext:(SMJEvaluationContextImpl *)parent;
+- (SMJEvaluationContextStatus)mergeResultsOfContext:(SMJEvaluationContextImpl *)context;
+
+@property (readonly) NSUInteger parallelScanThreshold; // 0 if parallel scans are disabled, which is always the case for worker contexts.
+@property (readonly) NSUInteger parallelFilterThreshold; // 0 if parallel filters are disabled, which is always the case for worker contexts.
+@property (readonly) NSUInteger parallelConcurrency;
 
 // -- Update --
 @property (readonly, getter=isForUpdate) BOOL forUpdate;
+@property BOOL recordsUpdateLocations; // Set before the evaluation to set the location of each update operation (see SMJPathRef). Inherited by worker contexts.
 
 // -- Cache --
-@property (readonly) NSMutableDictionary <NSString *, id> *evaluationCache;
+@property (readonly) SMJEvaluationCache *evaluationCache; // Shared with worker contexts.
+
+// -- Profile --
+@property (nullable) SMJEvaluationProfile *profile; // Set before the evaluation to profile it. Shared with worker contexts.
 
 @end
 
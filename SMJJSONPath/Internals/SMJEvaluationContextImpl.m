@@ -76,12 +76,19 @@ NS_ASSUME_NONNULL_BEGIN
 @implementation SMJEvaluationContextImpl
 {
 	SMJConfiguration *_configuration;
+	SMJOptionMask _optionMask;
+	NSArray <id <SMJEvaluationListener>> *_evaluationListeners;
 	NSMutableArray *_valueResult;
 	NSMutableArray *_pathResult;
 	id <SMJPath> _path;
 	id _rootJsonObject;
 	NSMutableArray <SMJPathRef *> *_updateOperations;
 	NSInteger _resultIndex;
+	BOOL _needPaths;
+	BOOL _worker;
+	NSUInteger _parallelScanThreshold;
+	NSUInteger _parallelFilterThreshold;
+	NSUInteger _parallelConcurrency;
 }
 
 /*
@@ -90,6 +97,11 @@ NS_ASSUME_NONNULL_BEGIN
 #pragma mark - SMJEvaluationContextImpl - Instance
 
 - (instancetype)initWithPath:(id <SMJPath>)path rootJsonObject:(id)rootJsonObject configuration:(SMJConfiguration *)configuration forUpdate:(BOOL)forUpdate
+{
+	return [self initWithPath:path rootJsonObject:rootJsonObject configuration:configuration forUpdate:forUpdate resultLimit:0];
+}
+
+- (instancetype)initWithPath:(id <SMJPath>)path rootJsonObject:(id)rootJsonObject configuration:(SMJConfiguration *)configuration forUpdate:(BOOL)forUpdate resultLimit:(NSUInteger)resultLimit
 {
 	self = [super init];
 	
@@ -99,15 +111,49 @@ NS_ASSUME_NONNULL_BEGIN
 		//notNull(rootJsonObject, "root can not be null");
 		//notNull(configuration, "configuration can not be null");
 		
-		_evaluationCache = [[NSMutableDictionary alloc] init];
+		_evaluationCache = [[SMJEvaluationCache alloc] init];
 		
 		_forUpdate = forUpdate;
+		_resultLimit = resultLimit;
 		_path = path;
 		_rootJsonObject = rootJsonObject;
 		_configuration = configuration;
+		_optionMask = configuration.optionMask;
+		_evaluationListeners = (configuration.evaluationListeners.count > 0 ? [configuration.evaluationListeners copy] : nil);
 		_valueResult = [NSMutableArray array];
 		_pathResult = [NSMutableArray array];
 		_updateOperations = [NSMutableArray array];
+		
+		// Paths are only rendered if someone can see them.
+		_needPaths = (SMJOptionMaskContains(_optionMask, SMJOptionAsPathList) || _evaluationListeners.count > 0);
+		
+		// Parallel scans.
+		_parallelScanThreshold = configuration.parallelScanThreshold;
+		_parallelFilterThreshold = configuration.parallelFilterThreshold;
+		_parallelConcurrency = configuration.parallelConcurrency;
+		
+		if (_parallelConcurrency == 0)
+			_parallelConcurrency = [NSProcessInfo processInfo].activeProcessorCount;
+	}
+	
+	return self;
+}
+
+- (instancetype)initWithParentContext:(SMJEvaluationContextImpl *)parent
+{
+	self = [self initWithPath:parent->_path rootJsonObject:parent->_rootJsonObject configuration:parent->_configuration forUpdate:parent->_forUpdate resultLimit:parent->_resultLimit];
+	
+	if (self)
+	{
+		_worker = YES;
+		_recordsUpdateLocations = parent->_recordsUpdateLocations;
+		_optionMask = parent->_optionMask;
+		_evaluationListeners = parent->_evaluationListeners;
+		_needPaths = parent->_needPaths;
+		_evaluationCache = parent->_evaluationCache;
+		_profile = parent->_profile;
+		_parallelScanThreshold = 0;
+		_parallelFilterThreshold = 0;
 	}
 	
 	return self;
@@ -119,20 +165,39 @@ NS_ASSUME_NONNULL_BEGIN
 */
 #pragma mark - SMJEvaluationContextImpl - Result
 
-- (SMJEvaluationContextStatus)addResult:(NSString *)path operation:(SMJPathRef *)operation jsonObject:(id)jsonObject
+- (SMJEvaluationContextStatus)addResult:(const SMJPathSegment *)pathSegment operation:(SMJPathRef *)operation jsonObject:(id)jsonObject
+{
+	// The operation points into the container of the result, except for the root operation, which points to the root itself.
+	if (_recordsUpdateLocations && operation.location == nil && pathSegment->type != SMJPathSegmentTypeFunction)
+		operation.location = (pathSegment->type == SMJPathSegmentTypeRoot ? @[ ] : SMJPathSegmentComponents(pathSegment->parent));
+	
+	return [self addResultWithPath:(_needPaths ? SMJPathSegmentString(pathSegment) : nil) operation:operation jsonObject:jsonObject];
+}
+
+- (SMJEvaluationContextStatus)addResultWithPath:(nullable NSString *)path operation:(SMJPathRef *)operation jsonObject:(id)jsonObject
 {
 	if (_forUpdate)
 		[_updateOperations addObject:operation];
 	
 	[_valueResult addObject:jsonObject];
-	[_pathResult addObject:[path copy]];
 	
 	_resultIndex++;
 	
-	NSArray 	*evaluationListeners = _configuration.evaluationListeners;
-	NSInteger	idx = _resultIndex - 1;
+	// Stop the evaluation when we have enough results (scan, wildcard and filters stop their traversal on abort).
+	BOOL limitReached = (_resultLimit > 0 && (NSUInteger)_resultIndex >= _resultLimit);
+	
+	if (!path)
+		return (limitReached ? SMJEvaluationContextStatusAborted : SMJEvaluationContextStatusDone);
+	
+	[_pathResult addObject:path];
+	
+	// Workers don't notify: their results are notified when merged.
+	if (_worker)
+		return (limitReached ? SMJEvaluationContextStatusAborted : SMJEvaluationContextStatusDone);
 	
-	for (id <SMJEvaluationListener> listener in evaluationListeners)
+	NSInteger idx = _resultIndex - 1;
+	
+	for (id <SMJEvaluationListener> listener in _evaluationListeners)
 	{
 		SMJEvaluationContinuation continuation = [listener resultFound:[FoundResultImpl foundResultWithIndex:idx path:path result:jsonObject]];
 		
@@ -140,9 +205,67 @@ NS_ASSUME_NONNULL_BEGIN
 			return SMJEvaluationContextStatusAborted;
 	}
 	
+	return (limitReached ? SMJEvaluationContextStatusAborted : SMJEvaluationContextStatusDone);
+}
+
+
+- (NSUInteger)resultCount
+{
+	return (NSUInteger)_resultIndex;
+}
+
+- (BOOL)needPaths
+{
+	return _needPaths;
+}
+
+
+/*
+** SMJEvaluationContextImpl - Parallel
+*/
+#pragma mark - SMJEvaluationContextImpl - Parallel
+
+- (SMJEvaluationContextStatus)mergeResultsOfContext:(SMJEvaluationContextImpl *)context
+{
+	NSUInteger count = context->_valueResult.count;
+	
+	for (NSUInteger idx = 0; idx < count; idx++)
+	{
+		NSString	*path = (context->_needPaths ? context->_pathResult[idx] : nil);
+		SMJPathRef	*operation = (context->_forUpdate ? context->_updateOperations[idx] : [SMJPathRef pathRefNull]);
+		
+		if ([self addResultWithPath:path operation:operation jsonObject:context->_valueResult[idx]] == SMJEvaluationContextStatusAborted)
+			return SMJEvaluationContextStatusAborted;
+	}
+	
 	return SMJEvaluationContextStatusDone;
 }
 
+- (SMJOptionMask)optionMask
+{
+	return _optionMask;
+}
+
+- (BOOL)containsOption:(SMJOption)option
+{
+	return SMJOptionMaskContains(_optionMask, option);
+}
+
+- (NSUInteger)parallelScanThreshold
+{
+	return _parallelScanThreshold;
+}
+
+- (NSUInteger)parallelFilterThreshold
+{
+	return _parallelFilterThreshold;
+}
+
+- (NSUInteger)parallelConcurrency
+{
+	return _parallelConcurrency;
+}
+
 
 /*
 ** SMJEvaluationContextImpl - SMJEvaluationContext
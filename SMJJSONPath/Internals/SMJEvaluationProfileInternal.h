@@ -0,0 +1,79 @@
+/*
+ * SMJEvaluationProfileInternal.h
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+#import <time.h>
+
+#import "SMJEvaluationProfile.h"
+
+#import "SMJPredicate.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** Forward
+*/
+#pragma mark - Forward
+
+@class SMJCompiledPath;
+@class SMJPathToken;
+
+
+
+/*
+** Functions
+*/
+#pragma mark - Functions
+
+// Monotonic time, in nanoseconds.
+NS_INLINE uint64_t SMJProfileTime(void)
+{
+	return clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+}
+
+
+
+/*
+** SMJEvaluationProfile (Internal)
+*/
+#pragma mark - SMJEvaluationProfile (Internal)
+
+// Record methods are thread safe: they are called by parallel workers too.
+
+@interface SMJEvaluationProfile (Internal)
+
+// -- Instance --
+- (instancetype)initWithPath:(SMJCompiledPath *)path;
+
+// -- Record --
+- (void)recordEvaluationOfToken:(SMJPathToken *)token duration:(uint64_t)duration;
+- (void)recordScanOfToken:(SMJPathToken *)token; // One node walked by a deep scan.
+- (void)recordApplyOfToken:(SMJPathToken *)token match:(BOOL)match;
+- (void)recordApplyOfExpression:(id <SMJPredicate>)expression match:(BOOL)match duration:(uint64_t)duration;
+- (void)recordCacheHit:(BOOL)hit;
+
+// -- Finish --
+- (void)finishWithResultCount:(NSUInteger)resultCount duration:(uint64_t)duration;
+
+@end
+
+
+NS_ASSUME_NONNULL_END
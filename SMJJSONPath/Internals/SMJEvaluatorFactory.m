@@ -91,6 +91,34 @@ typedef SMJEvaluatorEvaluate (^SMJEvaluatorGenericBlock)(SMJValueNode *leftNode,
 
 
 
+/*
+** Helpers
+*/
+#pragma mark - Helpers
+
+// Return the set to probe an array with, or nil if scanning the array is cheaper.
+static NSSet * _Nullable SMJProbeSetForArray(SMJValueNode *node, NSArray *array, NSUInteger probeCount)
+{
+	// Literal arrays are hashed when the filter is compiled.
+	NSSet *items = ([node isKindOfClass:[SMJJsonNode class]] ? [(SMJJsonNode *)node arrayItems] : nil);
+	
+	if (items)
+		return items;
+	
+	// Hashing an evaluated array costs about one scan: only worth it if the array is probed several times.
+	if (probeCount > 1 && array.count > 8)
+		return [[NSSet alloc] initWithArray:array];
+	
+	return nil;
+}
+
+NS_INLINE BOOL SMJArrayContainsObject(NSArray *array, NSSet * _Nullable set, id object)
+{
+	return (set ? [set containsObject:object] : [array containsObject:object]);
+}
+
+
+
 /*
 ** SMJEvaluatorFactory
 */
@@ -247,17 +275,17 @@ typedef SMJEvaluatorEvaluate (^SMJEvaluatorGenericBlock)(SMJValueNode *leftNode,
 	// Regexp.
 	map[SMJRelationalOperatorREGEX] = [SMJEvaluatorGeneric evaluatorWithBlock:^SMJEvaluatorEvaluate(SMJValueNode *leftNode, SMJValueNode *rightNode, id<SMJPredicateContext> context, NSError **error) {
 		
-		NSRegularExpression	*regexp = nil;
+		SMJCompiledPattern	*regexp = nil;
 		NSString			*string = nil;
 		
 		if ([leftNode isKindOfClass:[SMJPatternNode class]] && ![rightNode isKindOfClass:[SMJPatternNode class]])
 		{
-			regexp = [(SMJPatternNode *)leftNode underlayingObjectWithError:error];
+			regexp = [(SMJPatternNode *)leftNode compiledPatternWithError:error];
 			string = [rightNode literalValue];
 		}
 		else if (![leftNode isKindOfClass:[SMJPatternNode class]] && [rightNode isKindOfClass:[SMJPatternNode class]])
 		{
-			regexp = [(SMJPatternNode *)rightNode underlayingObjectWithError:error];
+			regexp = [(SMJPatternNode *)rightNode compiledPatternWithError:error];
 			string = [leftNode literalValue];
 		}
 
@@ -265,7 +293,7 @@ typedef SMJEvaluatorEvaluate (^SMJEvaluatorGenericBlock)(SMJValueNode *leftNode,
 			return SMJEvaluatorEvaluateError;
 		
 		if (regexp && string)
-			return SMBoolToEvaluateResult([regexp numberOfMatchesInString:string options:0 range:NSMakeRange(0, string.length)] > 0);
+			return SMBoolToEvaluateResult([regexp matchesString:string]);
 		
 		return SMJEvaluatorEvaluateFalse;
 	}];
@@ -365,7 +393,7 @@ typedef SMJEvaluatorEvaluate (^SMJEvaluatorGenericBlock)(SMJValueNode *leftNode,
 			return SMJEvaluatorEvaluateError;
 		
 		// > Compare.
-		return SMBoolToEvaluateResult([rightArray containsObject:leftObject]);
+		return SMBoolToEvaluateResult(SMJArrayContainsObject(rightArray, SMJProbeSetForArray(rightNode, rightArray, 1), leftObject));
 	}];
 	
 	
@@ -417,9 +445,11 @@ typedef SMJEvaluatorEvaluate (^SMJEvaluatorGenericBlock)(SMJValueNode *leftNode,
 			return SMJEvaluatorEvaluateFalse;
 		
 		// > All.
+		NSSet *leftSet = SMJProbeSetForArray(leftNode, leftArray, rightArray.count);
+		
 		for (id rightObject in rightArray)
 		{
-			if ([leftArray containsObject:rightObject] == NO)
+			if (SMJArrayContainsObject(leftArray, leftSet, rightObject) == NO)
 				return SMJEvaluatorEvaluateFalse;
 		}
 		
@@ -458,7 +488,7 @@ typedef SMJEvaluatorEvaluate (^SMJEvaluatorGenericBlock)(SMJValueNode *leftNode,
 				return SMJEvaluatorEvaluateError;
 
 
-			return SMBoolToEvaluateResult([leftArray containsObject:rightValue]);
+			return SMBoolToEvaluateResult(SMJArrayContainsObject(leftArray, SMJProbeSetForArray(leftNode, leftArray, 1), rightValue));
 		}
 		
 		return SMJEvaluatorEvaluateFalse;
@@ -536,9 +566,11 @@ typedef SMJEvaluatorEvaluate (^SMJEvaluatorGenericBlock)(SMJValueNode *leftNode,
 		
 		
 		// > Check subset-of.
+		NSSet *rightSet = SMJProbeSetForArray(rightNode, rightArray, leftArray.count);
+		
 		for (id leftObject in leftArray)
 		{
-			if ([rightArray containsObject:leftObject] == NO)
+			if (SMJArrayContainsObject(rightArray, rightSet, leftObject) == NO)
 				return SMJEvaluatorEvaluateFalse;
 		}
 		
@@ -573,9 +605,11 @@ typedef SMJEvaluatorEvaluate (^SMJEvaluatorGenericBlock)(SMJValueNode *leftNode,
 
 		
 		// > Check any-of.
+		NSSet *rightSet = SMJProbeSetForArray(rightNode, rightArray, leftArray.count);
+		
 		for (id leftObject in leftArray)
 		{
-			if ([rightArray containsObject:leftObject])
+			if (SMJArrayContainsObject(rightArray, rightSet, leftObject))
 				return SMJEvaluatorEvaluateTrue;
 		}
 		
@@ -609,9 +643,11 @@ typedef SMJEvaluatorEvaluate (^SMJEvaluatorGenericBlock)(SMJValueNode *leftNode,
 		
 		
 		// > Check none-of.
+		NSSet *rightSet = SMJProbeSetForArray(rightNode, rightArray, leftArray.count);
+		
 		for (id leftObject in leftArray)
 		{
-			if ([rightArray containsObject:leftObject])
+			if (SMJArrayContainsObject(rightArray, rightSet, leftObject))
 				return SMJEvaluatorEvaluateFalse;
 		}
 		
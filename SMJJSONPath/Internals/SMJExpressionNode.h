@@ -25,6 +25,9 @@
 #import "SMJPredicate.h"
 
 
+@class SMJFilterProgram;
+
+
 NS_ASSUME_NONNULL_BEGIN
 
 
@@ -35,6 +38,10 @@ NS_ASSUME_NONNULL_BEGIN
 
 @interface SMJExpressionNode : NSObject <SMJPredicate>
 
+// -- Lowering --
+// > Append the instructions evaluating this node to a filter program. By default, the node is applied as an opaque predicate.
+- (void)lowerToFilterProgram:(SMJFilterProgram *)program;
+
 @end
 
 
@@ -22,6 +22,8 @@
 
 #import "SMJExpressionNode.h"
 
+#import "SMJFilterProgram.h"
+
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -51,6 +53,17 @@ NS_ASSUME_NONNULL_BEGIN
 	return nil;
 }
 
+
+/*
+** SMJExpressionNode - Lowering
+*/
+#pragma mark - SMJExpressionNode - Lowering
+
+- (void)lowerToFilterProgram:(SMJFilterProgram *)program
+{
+	[program appendPredicate:self];
+}
+
 @end
 
 
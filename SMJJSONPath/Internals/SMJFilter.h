@@ -23,6 +23,7 @@
 #import <Foundation/Foundation.h>
 
 #import "SMJPredicate.h"
+#import "SMJEvaluationProfile.h"
 
 
 NS_ASSUME_NONNULL_BEGIN
@@ -40,6 +41,9 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (NSString *)stringValue;
 
+// Profile. By default, call -applyWithContext:error:.
+- (SMJPredicateApply)applyWithContext:(id <SMJPredicateContext>)context profile:(nullable SMJEvaluationProfile *)profile error:(NSError **)error;
+
 @end
 
 
@@ -45,6 +45,11 @@ NS_ASSUME_NONNULL_BEGIN
 	return (NSString *)nil;
 }
 
+- (SMJPredicateApply)applyWithContext:(id <SMJPredicateContext>)context profile:(nullable SMJEvaluationProfile *)profile error:(NSError **)error
+{
+	return [self applyWithContext:context error:error];
+}
+
 @end
 
 
@@ -31,6 +31,8 @@
 #import "SMJLogicalExpressionNode.h"
 #import "SMJRelationalExpressionNode.h"
 
+#import "SMJFilterProgram.h"
+
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -764,6 +766,8 @@ NS_ASSUME_NONNULL_BEGIN
 @implementation SMJCompiledFilter
 {
 	id <SMJPredicate> _predicate;
+	
+	SMJFilterProgram *_program;
 }
 
 /*
@@ -778,6 +782,7 @@ NS_ASSUME_NONNULL_BEGIN
 	if (self)
 	{
 		_predicate = predicate;
+		_program = [[SMJFilterProgram alloc] initWithPredicate:predicate];
 	}
 	
 	return self;
@@ -791,7 +796,12 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (SMJPredicateApply)applyWithContext:(id <SMJPredicateContext>)context error:(NSError **)error
 {
-	return [_predicate applyWithContext:context error:error];
+	return [_program applyWithContext:context error:error];
+}
+
+- (SMJPredicateApply)applyWithContext:(id <SMJPredicateContext>)context profile:(nullable SMJEvaluationProfile *)profile error:(NSError **)error
+{
+	return [_program applyWithContext:context profile:profile error:error];
 }
 
 - (NSString *)stringValue
@@ -0,0 +1,84 @@
+/*
+ * SMJFilterProgram.h
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+#import "SMJPredicate.h"
+#import "SMJEvaluator.h"
+#import "SMJValueNode.h"
+#import "SMJRelationalOperator.h"
+#import "SMJEvaluationProfile.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** Types
+*/
+#pragma mark - Types
+
+typedef enum SMJFilterOpcode
+{
+	SMJFilterOpcodeCompare,			// Evaluate a relational expression, and store the result.
+	SMJFilterOpcodeCompareScalar,	// Compare the value of a path to an unboxed literal, and store the result. Other value types fall back on the evaluator.
+	SMJFilterOpcodePredicate,		// Apply a predicate which can't be lowered, and store the result.
+	SMJFilterOpcodeJumpIfTrue,		// Jump to target if the stored result is true (short-circuit OR).
+	SMJFilterOpcodeJumpIfFalse,		// Jump to target if the stored result is false (short-circuit AND).
+	SMJFilterOpcodeNot				// Negate the stored result.
+} SMJFilterOpcode;
+
+
+/*
+** SMJFilterProgram
+*/
+#pragma mark - SMJFilterProgram
+
+// A filter program is a flat sequence of instructions lowered from a filter expression tree.
+// Everything which doesn't depend on the evaluated item is resolved when the program is built: evaluators are bound to their
+// operators, the kind of each operand is known, and logical operators are turned into jumps. Applying the program to an item
+// is then a simple loop over the instructions, without operator lookup or class introspection.
+// Once built, a program is immutable, and can be applied concurrently.
+
+@interface SMJFilterProgram : NSObject <SMJPredicate>
+
+// -- Instance --
+- (instancetype)initWithPredicate:(id <SMJPredicate>)predicate;
+
+// -- Building --
+// > Used by expression nodes to lower themselves.
+- (void)appendCompareWithExpression:(id <SMJPredicate>)expression leftNode:(SMJValueNode *)leftNode operator:(SMJRelationalOperator *)op rightNode:(SMJValueNode *)rightNode evaluator:(id <SMJEvaluator>)evaluator;
+- (void)appendPredicate:(id <SMJPredicate>)predicate;
+- (void)appendNot;
+
+// > Return the index of the jump instruction, to patch its target once known.
+- (NSUInteger)appendJumpWithOpcode:(SMJFilterOpcode)opcode;
+- (void)patchJumpAtIndex:(NSUInteger)index;
+
+// -- Properties --
+@property (readonly) NSUInteger instructionCount;
+
+// -- Apply --
+// > Record each comparison and predicate applied in profile, when not nil.
+- (SMJPredicateApply)applyWithContext:(id <SMJPredicateContext>)context profile:(nullable SMJEvaluationProfile *)profile error:(NSError **)error;
+
+@end
+
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,511 @@
+/*
+ * SMJFilterProgram.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import "SMJFilterProgram.h"
+
+#import "SMJExpressionNode.h"
+#import "SMJValueNodes.h"
+#import "SMJFilterScalar.h"
+#import "SMJEvaluationProfileInternal.h"
+#import "SMJPredicateContextImpl.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** Types
+*/
+#pragma mark - Types
+
+typedef SMJEvaluatorEvaluate (*SMJEvaluateIMP)(id, SEL, SMJValueNode *, SMJValueNode *, id <SMJPredicateContext>, NSError **);
+
+typedef enum SMJScalarOperator
+{
+	SMJScalarOperatorNone,
+	SMJScalarOperatorEQ,
+	SMJScalarOperatorNE,
+	SMJScalarOperatorLT,
+	SMJScalarOperatorLTE,
+	SMJScalarOperatorGT,
+	SMJScalarOperatorGTE
+} SMJScalarOperator;
+
+typedef struct SMJFilterInstruction
+{
+	SMJFilterOpcode opcode;
+	
+	// Profile.
+	__unsafe_unretained id <SMJPredicate> _Nullable expression;
+	
+	// Compare.
+	__unsafe_unretained SMJValueNode * _Nullable	left;
+	__unsafe_unretained SMJValueNode * _Nullable	right;
+	BOOL											leftIsPath;
+	BOOL											rightIsPath;
+	BOOL											rootInvariant; // Only root paths and literals: same result for all the items of a document.
+	
+	__unsafe_unretained id _Nullable	evaluator;
+	SMJEvaluateIMP _Nullable			evaluate;
+	
+	// Compare scalar.
+	SMJFilterScalar		scalar;
+	SMJScalarOperator	scalarOperator;
+	BOOL				scalarOnLeft;
+	
+	// Predicate.
+	__unsafe_unretained id <SMJPredicate> _Nullable predicate;
+	
+	// Jumps.
+	NSUInteger target;
+} SMJFilterInstruction;
+
+
+
+/*
+** Helpers
+*/
+#pragma mark - Helpers
+
+static SMJScalarOperator SMJScalarOperatorFromString(NSString *op)
+{
+	if ([op isEqualToString:SMJRelationalOperatorEQ])
+		return SMJScalarOperatorEQ;
+	else if ([op isEqualToString:SMJRelationalOperatorNE])
+		return SMJScalarOperatorNE;
+	else if ([op isEqualToString:SMJRelationalOperatorLT])
+		return SMJScalarOperatorLT;
+	else if ([op isEqualToString:SMJRelationalOperatorLTE])
+		return SMJScalarOperatorLTE;
+	else if ([op isEqualToString:SMJRelationalOperatorGT])
+		return SMJScalarOperatorGT;
+	else if ([op isEqualToString:SMJRelationalOperatorGTE])
+		return SMJScalarOperatorGTE;
+	
+	return SMJScalarOperatorNone;
+}
+
+// Same tests than the evaluators of these operators.
+NS_INLINE BOOL SMJScalarOperatorMatch(SMJScalarOperator op, SMJComparisonResult comparison)
+{
+	switch (op)
+	{
+		case SMJScalarOperatorEQ:
+			return (comparison == SMJComparisonSame);
+			
+		case SMJScalarOperatorNE:
+			return (comparison != SMJComparisonSame);
+			
+		case SMJScalarOperatorLT:
+			return (comparison == SMJComparisonDifferLessThan);
+			
+		case SMJScalarOperatorLTE:
+			return (comparison == SMJComparisonSame || comparison == SMJComparisonDifferLessThan);
+			
+		case SMJScalarOperatorGT:
+			return (comparison == SMJComparisonDifferGreaterThan);
+			
+		case SMJScalarOperatorGTE:
+			return (comparison == SMJComparisonSame || comparison == SMJComparisonDifferGreaterThan);
+			
+		case SMJScalarOperatorNone:
+			return NO;
+	}
+	
+	return NO;
+}
+
+// Literals, and root paths which aren't exists checks (those are evaluated on the item).
+static BOOL SMJValueNodeIsRootInvariant(SMJValueNode *node)
+{
+	if ([node isKindOfClass:[SMJPathNode class]] == NO)
+		return YES;
+	
+	SMJPathNode *pathNode = (SMJPathNode *)node;
+	
+	return (pathNode.existsCheck == NO && [pathNode underlayingObjectWithError:nil].rootPath);
+}
+
+NS_INLINE NSValue *SMJInstructionCacheKey(const SMJFilterInstruction *instruction)
+{
+	return [NSValue valueWithNonretainedObject:instruction->expression];
+}
+
+NS_INLINE SMJComparisonResult SMJComparisonReverse(SMJComparisonResult comparison)
+{
+	if (comparison == SMJComparisonDifferLessThan)
+		return SMJComparisonDifferGreaterThan;
+	else if (comparison == SMJComparisonDifferGreaterThan)
+		return SMJComparisonDifferLessThan;
+	
+	return comparison;
+}
+
+
+
+/*
+** SMJFilterProgram
+*/
+#pragma mark - SMJFilterProgram
+
+@implementation SMJFilterProgram
+{
+	id <SMJPredicate> _predicate;
+	
+	SMJFilterInstruction	*_instructions;
+	NSUInteger				_count;
+	NSUInteger				_capacity;
+	
+	// Keep alive objects referenced by instructions.
+	NSMutableArray *_objects;
+	
+	BOOL _hasRootInvariant;
+}
+
+
+/*
+** SMJFilterProgram - Instance
+*/
+#pragma mark - SMJFilterProgram - Instance
+
+- (instancetype)initWithPredicate:(id <SMJPredicate>)predicate
+{
+	self = [super init];
+	
+	if (self)
+	{
+		_predicate = predicate;
+		_objects = [[NSMutableArray alloc] init];
+		
+		if ([(NSObject *)predicate isKindOfClass:[SMJExpressionNode class]])
+			[(SMJExpressionNode *)predicate lowerToFilterProgram:self];
+		else
+			[self appendPredicate:predicate];
+	}
+	
+	return self;
+}
+
+- (void)dealloc
+{
+	free(_instructions);
+}
+
+
+/*
+** SMJFilterProgram - Building
+*/
+#pragma mark - SMJFilterProgram - Building
+
+- (void)appendCompareWithExpression:(id <SMJPredicate>)expression leftNode:(SMJValueNode *)leftNode operator:(SMJRelationalOperator *)op rightNode:(SMJValueNode *)rightNode evaluator:(id <SMJEvaluator>)evaluator
+{
+	SMJFilterInstruction *instruction = [self appendInstructionWithOpcode:SMJFilterOpcodeCompare];
+	
+	[_objects addObject:expression];
+	
+	instruction->expression = expression;
+	
+	[_objects addObject:leftNode];
+	[_objects addObject:rightNode];
+	[_objects addObject:evaluator];
+	
+	instruction->left = leftNode;
+	instruction->right = rightNode;
+	instruction->leftIsPath = [leftNode isKindOfClass:[SMJPathNode class]];
+	instruction->rightIsPath = [rightNode isKindOfClass:[SMJPathNode class]];
+	
+	instruction->evaluator = evaluator;
+	instruction->evaluate = (SMJEvaluateIMP)[(NSObject *)evaluator methodForSelector:@selector(evaluateLeftNode:rightNode:predicateContext:error:)];
+	
+	// Comparisons of root paths with literals or other root paths are evaluated once per document, then reused for each item.
+	instruction->rootInvariant = (instruction->leftIsPath || instruction->rightIsPath) && SMJValueNodeIsRootInvariant(leftNode) && SMJValueNodeIsRootInvariant(rightNode);
+	_hasRootInvariant = _hasRootInvariant || instruction->rootInvariant;
+	
+	// Compare a path to a literal without boxing, when the literal has a scalar form.
+	SMJScalarOperator scalarOperator = SMJScalarOperatorFromString(op.stringOperator);
+	
+	if (scalarOperator == SMJScalarOperatorNone)
+		return;
+	
+	if (instruction->leftIsPath && !instruction->rightIsPath && [(SMJPathNode *)leftNode isExistsCheck] == NO)
+	{
+		if (SMJFilterScalarMakeWithValueNode(rightNode, &instruction->scalar) == NO)
+			return;
+		
+		instruction->scalarOnLeft = NO;
+	}
+	else if (instruction->rightIsPath && !instruction->leftIsPath && [(SMJPathNode *)rightNode isExistsCheck] == NO)
+	{
+		if (SMJFilterScalarMakeWithValueNode(leftNode, &instruction->scalar) == NO)
+			return;
+		
+		instruction->scalarOnLeft = YES;
+	}
+	else
+		return;
+	
+	instruction->opcode = SMJFilterOpcodeCompareScalar;
+	instruction->scalarOperator = scalarOperator;
+}
+
+- (void)appendPredicate:(id <SMJPredicate>)predicate
+{
+	SMJFilterInstruction *instruction = [self appendInstructionWithOpcode:SMJFilterOpcodePredicate];
+	
+	[_objects addObject:predicate];
+	
+	instruction->expression = predicate;
+	instruction->predicate = predicate;
+}
+
+- (void)appendNot
+{
+	[self appendInstructionWithOpcode:SMJFilterOpcodeNot];
+}
+
+- (NSUInteger)appendJumpWithOpcode:(SMJFilterOpcode)opcode
+{
+	NSAssert(opcode == SMJFilterOpcodeJumpIfTrue || opcode == SMJFilterOpcodeJumpIfFalse, @"not a jump opcode");
+	
+	[self appendInstructionWithOpcode:opcode];
+	
+	return _count - 1;
+}
+
+- (void)patchJumpAtIndex:(NSUInteger)index
+{
+	NSAssert(index < _count, @"invalid jump index");
+	
+	_instructions[index].target = _count;
+}
+
+- (SMJFilterInstruction *)appendInstructionWithOpcode:(SMJFilterOpcode)opcode
+{
+	if (_count == _capacity)
+	{
+		_capacity = (_capacity ? _capacity * 2 : 8);
+		_instructions = realloc(_instructions, _capacity * sizeof(*_instructions));
+		
+		if (!_instructions)
+			abort();
+	}
+	
+	SMJFilterInstruction *instruction = &_instructions[_count++];
+	
+	memset(instruction, 0, sizeof(*instruction));
+	instruction->opcode = opcode;
+	
+	return instruction;
+}
+
+
+/*
+** SMJFilterProgram - Properties
+*/
+#pragma mark - SMJFilterProgram - Properties
+
+- (NSUInteger)instructionCount
+{
+	return _count;
+}
+
+
+/*
+** SMJFilterProgram - SMJPredicate
+*/
+#pragma mark - SMJFilterProgram - SMJPredicate
+
+- (SMJPredicateApply)applyWithContext:(id <SMJPredicateContext>)context error:(NSError **)error
+{
+	return [self applyWithContext:context profile:nil error:error];
+}
+
+- (NSString *)stringValue
+{
+	return [_predicate stringValue];
+}
+
+
+/*
+** SMJFilterProgram - Apply
+*/
+#pragma mark - SMJFilterProgram - Apply
+
+- (SMJPredicateApply)applyWithContext:(id <SMJPredicateContext>)context profile:(nullable SMJEvaluationProfile *)profile error:(NSError **)error
+{
+	const SMJFilterInstruction	*instructions = _instructions;
+	NSUInteger					count = _count;
+	NSUInteger					pc = 0;
+	SMJPredicateApply			result = SMJPredicateApplyFalse;
+	SMJEvaluationCache			*cache = nil;
+	
+	// Root-invariant results are kept in the cache shared by all the predicate contexts of the evaluation.
+	if (_hasRootInvariant && [(NSObject *)context isKindOfClass:[SMJPredicateContextImpl class]])
+		cache = ((SMJPredicateContextImpl *)context).pathCache;
+	
+	while (pc < count)
+	{
+		const SMJFilterInstruction *instruction = &instructions[pc];
+		
+		// Root-invariant comparison already evaluated for this document.
+		if (instruction->rootInvariant && cache)
+		{
+			NSNumber *cached = [cache objectForKey:SMJInstructionCacheKey(instruction)];
+			
+			if (cached)
+			{
+				result = (cached.boolValue ? SMJPredicateApplyTrue : SMJPredicateApplyFalse);
+				
+				if (profile)
+					[profile recordApplyOfExpression:instruction->expression match:(result == SMJPredicateApplyTrue) duration:0];
+				
+				pc++;
+				continue;
+			}
+		}
+		
+		switch (instruction->opcode)
+		{
+			case SMJFilterOpcodeCompare:
+			{
+				uint64_t start = (profile ? SMJProfileTime() : 0);
+				
+				SMJValueNode *left = instruction->left;
+				SMJValueNode *right = instruction->right;
+				
+				if (instruction->leftIsPath)
+				{
+					left = [(SMJPathNode *)left evaluate:context error:error];
+					
+					if (!left)
+						return SMJPredicateApplyError;
+				}
+				
+				if (instruction->rightIsPath)
+				{
+					right = [(SMJPathNode *)right evaluate:context error:error];
+					
+					if (!right)
+						return SMJPredicateApplyError;
+				}
+				
+				SMJEvaluatorEvaluate evaluate = instruction->evaluate(instruction->evaluator, @selector(evaluateLeftNode:rightNode:predicateContext:error:), left, right, context, error);
+				
+				if (evaluate == SMJEvaluatorEvaluateError)
+					return SMJPredicateApplyError;
+				
+				result = (evaluate == SMJEvaluatorEvaluateTrue ? SMJPredicateApplyTrue : SMJPredicateApplyFalse);
+				
+				if (instruction->rootInvariant && cache)
+					[cache setObject:@(result == SMJPredicateApplyTrue) forKey:SMJInstructionCacheKey(instruction)];
+				
+				if (profile)
+					[profile recordApplyOfExpression:instruction->expression match:(result == SMJPredicateApplyTrue) duration:SMJProfileTime() - start];
+				
+				pc++;
+				break;
+			}
+			
+			case SMJFilterOpcodeCompareScalar:
+			{
+				uint64_t start = (profile ? SMJProfileTime() : 0);
+				
+				SMJPathNode	*pathNode = (SMJPathNode *)(instruction->scalarOnLeft ? instruction->right : instruction->left);
+				id			object = [pathNode evaluateJsonObject:context error:error];
+				
+				if (!object)
+					return SMJPredicateApplyError;
+				
+				SMJComparisonResult comparison;
+				
+				if (SMJFilterScalarCompareObject(object, &instruction->scalar, &comparison))
+				{
+					// The comparison was object to literal: reverse it if the literal is the left operand.
+					if (instruction->scalarOnLeft)
+						comparison = SMJComparisonReverse(comparison);
+					
+					result = (SMJScalarOperatorMatch(instruction->scalarOperator, comparison) ? SMJPredicateApplyTrue : SMJPredicateApplyFalse);
+				}
+				else
+				{
+					// Generic comparison.
+					SMJValueNode *node = [SMJValueNodes valueNodeWithJsonObject:object error:error];
+					
+					if (!node)
+						return SMJPredicateApplyError;
+					
+					SMJValueNode *left = (instruction->scalarOnLeft ? instruction->left : node);
+					SMJValueNode *right = (instruction->scalarOnLeft ? node : instruction->right);
+					
+					SMJEvaluatorEvaluate evaluate = instruction->evaluate(instruction->evaluator, @selector(evaluateLeftNode:rightNode:predicateContext:error:), left, right, context, error);
+					
+					if (evaluate == SMJEvaluatorEvaluateError)
+						return SMJPredicateApplyError;
+					
+					result = (evaluate == SMJEvaluatorEvaluateTrue ? SMJPredicateApplyTrue : SMJPredicateApplyFalse);
+				}
+				
+				if (instruction->rootInvariant && cache)
+					[cache setObject:@(result == SMJPredicateApplyTrue) forKey:SMJInstructionCacheKey(instruction)];
+				
+				if (profile)
+					[profile recordApplyOfExpression:instruction->expression match:(result == SMJPredicateApplyTrue) duration:SMJProfileTime() - start];
+				
+				pc++;
+				break;
+			}
+			
+			case SMJFilterOpcodePredicate:
+			{
+				uint64_t start = (profile ? SMJProfileTime() : 0);
+				
+				result = [instruction->predicate applyWithContext:context error:error];
+				
+				if (result == SMJPredicateApplyError)
+					return SMJPredicateApplyError;
+				
+				if (profile)
+					[profile recordApplyOfExpression:instruction->expression match:(result == SMJPredicateApplyTrue) duration:SMJProfileTime() - start];
+				
+				pc++;
+				break;
+			}
+			
+			case SMJFilterOpcodeJumpIfTrue:
+				pc = (result == SMJPredicateApplyTrue ? instruction->target : pc + 1);
+				break;
+			
+			case SMJFilterOpcodeJumpIfFalse:
+				pc = (result == SMJPredicateApplyFalse ? instruction->target : pc + 1);
+				break;
+			
+			case SMJFilterOpcodeNot:
+				result = (result == SMJPredicateApplyTrue ? SMJPredicateApplyFalse : SMJPredicateApplyTrue);
+				pc++;
+				break;
+		}
+	}
+	
+	return result;
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
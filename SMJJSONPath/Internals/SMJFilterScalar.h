@@ -0,0 +1,68 @@
+/*
+ * SMJFilterScalar.h
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+#import "SMJValueNode.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** Types
+*/
+#pragma mark - Types
+
+typedef enum SMJFilterScalarType
+{
+	SMJFilterScalarTypeInteger,	// int64. Booleans are integers too: they compare as 0 and 1, like the NSNumber they are boxed in.
+	SMJFilterScalarTypeDouble,
+	SMJFilterScalarTypeString	// Only strings which aren't numbers: numeric strings are compared as numbers.
+} SMJFilterScalarType;
+
+
+/*
+** SMJFilterScalar
+*/
+#pragma mark - SMJFilterScalar
+
+// The unboxed form of a literal filter operand. Comparing a JSON value to a scalar gives the same result than
+// -[SMJValueNode compare:withError:] on their value nodes, without creating the nodes, for the value types it knows.
+// Other value types (numeric strings against numbers, null, arrays, ...) are left to the generic comparison.
+// The string is not retained: it has to be kept alive by the owner of the scalar.
+
+typedef struct SMJFilterScalar
+{
+	SMJFilterScalarType type;
+	
+	int64_t									integerValue;
+	double									doubleValue;
+	__unsafe_unretained NSString * _Nullable	stringValue;
+} SMJFilterScalar;
+
+
+// Return NO if the node isn't a literal with a scalar form.
+FOUNDATION_EXTERN BOOL SMJFilterScalarMakeWithValueNode(SMJValueNode *node, SMJFilterScalar *scalar);
+
+// Compare object to scalar. Return NO if the object type needs the generic comparison.
+FOUNDATION_EXTERN BOOL SMJFilterScalarCompareObject(id object, const SMJFilterScalar *scalar, SMJComparisonResult *result);
+
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,236 @@
+/*
+ * SMJFilterScalar.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <math.h>
+
+#import "SMJFilterScalar.h"
+
+#import "SMJValueNodes.h"
+#import "SMJUtils.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** Helpers
+*/
+#pragma mark - Helpers
+
+// Unbox a number. Return NO for numbers which don't fit an int64 or a double (big unsigned, decimals, ...).
+static BOOL SMJFilterScalarUnboxNumber(id number, SMJFilterScalar *scalar)
+{
+	if ([number isKindOfClass:[NSNumber class]] == NO || [number isKindOfClass:[NSDecimalNumber class]])
+		return NO;
+	
+	const char *objCType = [(NSNumber *)number objCType];
+	
+	if (!objCType || objCType[0] == 0 || objCType[1] != 0)
+		return NO;
+	
+	switch (objCType[0])
+	{
+		case 'f':
+		case 'd':
+			scalar->type = SMJFilterScalarTypeDouble;
+			scalar->doubleValue = [(NSNumber *)number doubleValue];
+			return YES;
+			
+		case 'B':
+		case 'c':
+		case 'C':
+		case 's':
+		case 'S':
+		case 'i':
+		case 'I':
+		case 'l':
+		case 'q':
+			scalar->type = SMJFilterScalarTypeInteger;
+			scalar->integerValue = [(NSNumber *)number longLongValue];
+			return YES;
+			
+		case 'L':
+		case 'Q':
+		{
+			unsigned long long value = [(NSNumber *)number unsignedLongLongValue];
+			
+			if (value > INT64_MAX)
+				return NO;
+			
+			scalar->type = SMJFilterScalarTypeInteger;
+			scalar->integerValue = (int64_t)value;
+			return YES;
+		}
+	}
+	
+	return NO;
+}
+
+NS_INLINE SMJComparisonResult SMJFilterScalarCompareIntegers(int64_t a, int64_t b)
+{
+	if (a < b)
+		return SMJComparisonDifferLessThan;
+	else if (a > b)
+		return SMJComparisonDifferGreaterThan;
+	else
+		return SMJComparisonSame;
+}
+
+NS_INLINE SMJComparisonResult SMJFilterScalarCompareDoubles(double a, double b)
+{
+	if (a < b)
+		return SMJComparisonDifferLessThan;
+	else if (a > b)
+		return SMJComparisonDifferGreaterThan;
+	else
+		return SMJComparisonSame;
+}
+
+// Compare exactly: converting a to double would round it above 2^53.
+static SMJComparisonResult SMJFilterScalarCompareIntegerToDouble(int64_t a, double b)
+{
+	// 2^63 is exactly representable: doubles outside [-2^63, 2^63) are beyond any int64.
+	if (b >= 9223372036854775808.0)
+		return SMJComparisonDifferLessThan;
+	else if (b < -9223372036854775808.0)
+		return SMJComparisonDifferGreaterThan;
+	
+	// Integral part fits an int64: compare it, then the fraction.
+	double	integral = trunc(b);
+	int64_t	integralValue = (int64_t)integral;
+	
+	if (a != integralValue)
+		return SMJFilterScalarCompareIntegers(a, integralValue);
+	
+	return SMJFilterScalarCompareDoubles(0.0, b - integral);
+}
+
+NS_INLINE SMJComparisonResult SMJFilterScalarInverseResult(SMJComparisonResult result)
+{
+	if (result == SMJComparisonDifferLessThan)
+		return SMJComparisonDifferGreaterThan;
+	else if (result == SMJComparisonDifferGreaterThan)
+		return SMJComparisonDifferLessThan;
+	
+	return result;
+}
+
+
+
+/*
+** SMJFilterScalar
+*/
+#pragma mark - SMJFilterScalar
+
+BOOL SMJFilterScalarMakeWithValueNode(SMJValueNode *node, SMJFilterScalar *scalar)
+{
+	memset(scalar, 0, sizeof(*scalar));
+	
+	if ([node isKindOfClass:[SMJNumberNode class]] || [node isKindOfClass:[SMJBooleanNode class]])
+	{
+		id number = [node underlayingObjectWithError:nil];
+		
+		if (!number)
+			return NO;
+		
+		return SMJFilterScalarUnboxNumber(number, scalar);
+	}
+	else if ([node isKindOfClass:[SMJStringNode class]])
+	{
+		NSString *string = [(SMJStringNode *)node underlayingObjectWithError:nil];
+		
+		// Numeric strings are compared as numbers to numbers and numeric strings: keep them on the generic path.
+		if (!string || [SMJUtils numberWithString:string])
+			return NO;
+		
+		scalar->type = SMJFilterScalarTypeString;
+		scalar->stringValue = string;
+		
+		return YES;
+	}
+	
+	return NO;
+}
+
+BOOL SMJFilterScalarCompareObject(id object, const SMJFilterScalar *scalar, SMJComparisonResult *result)
+{
+	switch (scalar->type)
+	{
+		case SMJFilterScalarTypeInteger:
+		case SMJFilterScalarTypeDouble:
+		{
+			SMJFilterScalar value;
+			
+			if (SMJFilterScalarUnboxNumber(object, &value) == NO)
+				return NO;
+			
+			// NaN isn't ordered: leave it to the generic comparison.
+			if ((value.type == SMJFilterScalarTypeDouble && isnan(value.doubleValue)) || (scalar->type == SMJFilterScalarTypeDouble && isnan(scalar->doubleValue)))
+				return NO;
+			
+			if (value.type == SMJFilterScalarTypeInteger && scalar->type == SMJFilterScalarTypeInteger)
+				*result = SMJFilterScalarCompareIntegers(value.integerValue, scalar->integerValue);
+			else if (value.type == SMJFilterScalarTypeInteger)
+				*result = SMJFilterScalarCompareIntegerToDouble(value.integerValue, scalar->doubleValue);
+			else if (scalar->type == SMJFilterScalarTypeInteger)
+				*result = SMJFilterScalarInverseResult(SMJFilterScalarCompareIntegerToDouble(scalar->integerValue, value.doubleValue));
+			else
+				*result = SMJFilterScalarCompareDoubles(value.doubleValue, scalar->doubleValue);
+			
+			return YES;
+		}
+		
+		case SMJFilterScalarTypeString:
+		{
+			// A string compared to a non numeric string is always compared as a string.
+			if ([object isKindOfClass:[NSString class]] == NO)
+				return NO;
+			
+			NSString *string = object;
+			
+			if (string == scalar->stringValue)
+			{
+				*result = SMJComparisonSame;
+				return YES;
+			}
+			
+			switch ([string compare:(NSString *)scalar->stringValue])
+			{
+				case NSOrderedAscending:
+					*result = SMJComparisonDifferLessThan;
+					break;
+					
+				case NSOrderedSame:
+					*result = SMJComparisonSame;
+					break;
+					
+				case NSOrderedDescending:
+					*result = SMJComparisonDifferGreaterThan;
+					break;
+			}
+			
+			return YES;
+		}
+	}
+	
+	return NO;
+}
+
+
+NS_ASSUME_NONNULL_END
@@ -41,7 +41,7 @@ NS_ASSUME_NONNULL_BEGIN
 - (instancetype)initWithPathFragment:(NSString *)pathFragment parameters:(NSArray <SMJParameter *> *)parameters;
 
 // -- Properties --
-@property (nonatomic) NSArray <SMJParameter *> *functionParams;
+@property (nullable, readonly) NSArray <SMJParameter *> *functionParams;
 
 @end
 
@@ -37,6 +37,9 @@ NS_ASSUME_NONNULL_BEGIN
 {
 	NSString *_functionName;
 	NSString *_pathFragment;
+	
+	Class					_functionClass;
+	id <SMJPathFunction>	_sharedFunction;
 }
 
 
@@ -57,6 +60,12 @@ NS_ASSUME_NONNULL_BEGIN
 		{
 			_functionName = [pathFragment copy];
 			_functionParams = [parameters copy];
+			
+			// Resolve the function now, so evaluations don't have to search it.
+			_functionClass = [SMJPathFunctionFactory pathFunctionClassForName:_functionName error:nil];
+			
+			if ([_functionClass respondsToSelector:@selector(isShareable)] && [_functionClass isShareable])
+				_sharedFunction = [_functionClass new];
 		}
 	}
 	
@@ -69,82 +78,40 @@ NS_ASSUME_NONNULL_BEGIN
 */
 #pragma mark - SMJFunctionPathToken - SMJPathToken
 
-- (SMJEvaluationStatus)evaluateWithCurrentPath:(NSString *)currentPath parentPathRef:(SMJPathRef *)parent jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error
+- (SMJEvaluationStatus)evaluateWithCurrentPath:(const SMJPathSegment *)currentPath parentPathRef:(SMJPathRef *)parent jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error
 {
-	id <SMJPathFunction> pathFunction = [SMJPathFunctionFactory pathFunctionForName:_functionName error:error];
+	id <SMJPathFunction> pathFunction = _sharedFunction;
 	
 	if (!pathFunction)
-		return SMJEvaluationStatusError;
-	
-	[self evaluateParametersWithCurrentPathString:currentPath parentPathRef:parent jsonObject:jsonObject context:context];
+	{
+		if (_functionClass)
+			pathFunction = [_functionClass new];
+		else
+			pathFunction = [SMJPathFunctionFactory pathFunctionForName:_functionName error:error]; // Unknown when the path was compiled: registered later, or an error.
+		
+		if (!pathFunction)
+			return SMJEvaluationStatusError;
+	}
 	
-	id result = [pathFunction invokeWithCurrentPathString:currentPath parentPath:parent jsonObject:jsonObject evaluationContext:context parameters:_functionParams error:error];
+	// Parameters are immutable: their values are computed by the function, from the evaluation context.
+	// The current path is only rendered if the evaluation renders paths, so hot function paths only pay for the function itself.
+	NSString	*currentPathString = (context.needPaths ? SMJPathSegmentString(currentPath) : @"");
+	id			result = [pathFunction invokeWithCurrentPathString:currentPathString parentPath:parent jsonObject:jsonObject evaluationContext:context parameters:_functionParams error:error];
 	
 	if (!result)
 		return SMJEvaluationStatusError;
 	
-	if ([context addResult:[NSString stringWithFormat:@"%@.%@", currentPath, _functionName] operation:parent jsonObject:result] == SMJEvaluationContextStatusAborted)
+	SMJPathSegment functionPath = SMJPathSegmentMakeFunction(currentPath, _functionName);
+	
+	if ([context addResult:&functionPath operation:parent jsonObject:result] == SMJEvaluationContextStatusAborted)
 		return SMJEvaluationStatusAborted;
 	
 	if (self.leaf == NO)
-		return [self.next evaluateWithCurrentPath:currentPath parentPathRef:parent jsonObject:result evaluationContext:context error:error];
+		return SMJPathTokenEvaluate(self.next, currentPath, parent, result, context, error);
 	
 	return SMJEvaluationStatusDone;
 }
 
-- (void)evaluateParametersWithCurrentPathString:(NSString *)currentPath parentPathRef:(SMJPathRef *)parent jsonObject:(id)jsonObject context:(SMJEvaluationContextImpl *)context
-{
-	if (!_functionParams)
-		return;
-	
-	for (SMJParameter *param in _functionParams)
-	{
-		if (param.evaluated)
-			continue;
-		
-		switch (param.type)
-		{
-			case SMJParamTypePath:
-			{
-				SMJParamLateBinding lateBinding = ^ id _Nullable (SMJParameter *parameter, NSError **lateError) {
-					
-					id <SMJPath> path = parameter.path;
-					id <SMJEvaluationContext> evaluationContext = [path evaluateJsonObject:context.rootJsonObject rootJsonObject:context.rootJsonObject configuration:context.configuration error:lateError];
-					
-					if (!evaluationContext)
-						return nil;
-					
-					return [evaluationContext jsonObjectWithError:lateError];
-				};
-				
-				param.lateBinding = lateBinding;
-				param.evaluated = YES;
-				
-				break;
-			}
-			
-			case SMJParamTypeJSON:
-			{
-				SMJParamLateBinding lateBinding = ^ id _Nullable (SMJParameter *parameter, NSError **lateError) {
-					NSString	*jsonString = parameter.jsonString;
-					NSData		*jsonData = [jsonString dataUsingEncoding:NSUTF8StringEncoding];
-					
-					if (!jsonData)
-						return nil;
-					
-					return [NSJSONSerialization JSONObjectWithData:jsonData options:NSJSONReadingAllowFragments error:lateError];
-				};
-
-				param.lateBinding = lateBinding;
-				param.evaluated = YES;
-				
-				break;
-			}
-		}
-	}
-}
-
-
 /**
  * Return the actual value by indicating true. If this return was false then we'd return the value in an array which
  * isn't what is desired - true indicates the raw value is returned.
@@ -0,0 +1,69 @@
+/*
+ * SMJJSONParser.h
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** Types
+*/
+#pragma mark - Types
+
+typedef enum SMJJSONParserKernel
+{
+	SMJJSONParserKernelScalar,
+	SMJJSONParserKernelSSE2,
+	SMJJSONParserKernelAVX2,
+	SMJJSONParserKernelNEON
+} SMJJSONParserKernel;
+
+
+
+/*
+** SMJJSONParser
+*/
+#pragma mark - SMJJSONParser
+
+// JSON parser for UTF-8 documents in memory, building the same values than NSJSONSerialization (immutable containers).
+// The document is parsed in two stages: structural characters are first indexed 64 bytes at a time with a SIMD kernel
+// (AVX2 or SSE2 on x86, NEON on arm64, scalar code elsewhere), then values are built by walking this index.
+
+@interface SMJJSONParser : NSObject
+
+// -- Instance --
+- (instancetype)initWithData:(NSData *)data;
+- (instancetype)initWithData:(NSData *)data kernel:(SMJJSONParserKernel)kernel; // The kernel needs to be available.
+
+// -- Kernels --
++ (SMJJSONParserKernel)bestKernel;
++ (BOOL)isKernelAvailable:(SMJJSONParserKernel)kernel;
+
+// -- Read --
+- (nullable id)readJSONObjectWithError:(NSError **)error; // Fragments are allowed.
+
+// -- Properties --
+@property (readonly) BOOL unsupportedEncoding; // YES if the read failed because the data is not UTF-8 encoded.
+
+@end
+
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,1182 @@
+/*
+ * SMJJSONParser.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+# include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+# include <arm_neon.h>
+#endif
+
+#import "SMJJSONParser.h"
+
+#import "SMJUtils.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** Macros
+*/
+#pragma mark - Macros
+
+#define SMSetError(Error, Code, Message, ...) \
+	do { \
+		if ((Error) && *(Error) == nil) {\
+			NSString *___message = [NSString stringWithFormat:(Message), ## __VA_ARGS__];\
+			*(Error) = [NSError errorWithDomain:@"SMJJSONParserErrorDomain" code:(Code) userInfo:@{ NSLocalizedDescriptionKey : ___message }]; \
+		} \
+	} while (0) \
+
+
+
+/*
+** Defines
+*/
+#pragma mark - Defines
+
+#define SMJJSONParserMaxDepth		512
+#define SMJJSONParserKeyCacheSize	512 // Power of 2.
+#define SMJJSONParserMaxCachedKey	64
+
+
+
+/*
+** Prototypes
+*/
+#pragma mark - Prototypes
+
+static BOOL		SMJPushValue(const void * _Nullable * _Nullable * _Nonnull values, NSUInteger *count, NSUInteger *capacity, id value);
+static size_t	SMJDecodeUnicodeEscape(const uint8_t *bytes, size_t length, uint8_t *output, size_t *outputLength);
+
+
+
+/*
+** Structural index - Kernels
+*/
+#pragma mark - Structural index - Kernels
+
+// Kernels classify 64 bytes at once, one bit per byte (bit n is byte n).
+
+typedef struct SMJBlockMasks
+{
+	uint64_t quote;
+	uint64_t backslash;
+	uint64_t operators; // { } [ ] : ,
+	uint64_t whitespace;
+} SMJBlockMasks;
+
+static void SMJClassifyBlockScalar(const uint8_t *block, SMJBlockMasks *masks)
+{
+	uint64_t quote = 0, backslash = 0, operators = 0, whitespace = 0;
+	
+	for (unsigned i = 0; i < 64; i++)
+	{
+		uint64_t bit = ((uint64_t)1 << i);
+		
+		switch (block[i])
+		{
+			case '"':	quote |= bit;		break;
+			case '\\':	backslash |= bit;	break;
+			
+			case '{': case '}': case '[': case ']': case ':': case ',':
+				operators |= bit;
+				break;
+			
+			case ' ': case '\t': case '\n': case '\r':
+				whitespace |= bit;
+				break;
+		}
+	}
+	
+	masks->quote = quote;
+	masks->backslash = backslash;
+	masks->operators = operators;
+	masks->whitespace = whitespace;
+}
+
+#if defined(__SSE2__)
+
+static void SMJClassifyBlockSSE2(const uint8_t *block, SMJBlockMasks *masks)
+{
+	const __m128i quote = _mm_set1_epi8('"');
+	const __m128i backslash = _mm_set1_epi8('\\');
+	const __m128i braceBit = _mm_set1_epi8(0x20); // '[' | 0x20 == '{', ']' | 0x20 == '}'.
+	const __m128i openBrace = _mm_set1_epi8('{');
+	const __m128i closeBrace = _mm_set1_epi8('}');
+	const __m128i colon = _mm_set1_epi8(':');
+	const __m128i comma = _mm_set1_epi8(',');
+	const __m128i space = _mm_set1_epi8(' ');
+	const __m128i tab = _mm_set1_epi8('\t');
+	const __m128i lineFeed = _mm_set1_epi8('\n');
+	const __m128i carriageReturn = _mm_set1_epi8('\r');
+	
+	memset(masks, 0, sizeof(*masks));
+	
+	for (unsigned i = 0; i < 4; i++)
+	{
+		__m128i bytes = _mm_loadu_si128((const __m128i *)(block + 16 * i));
+		__m128i braces = _mm_or_si128(bytes, braceBit);
+		__m128i operators = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(braces, openBrace), _mm_cmpeq_epi8(braces, closeBrace)), _mm_or_si128(_mm_cmpeq_epi8(bytes, colon), _mm_cmpeq_epi8(bytes, comma)));
+		__m128i whitespace = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, space), _mm_cmpeq_epi8(bytes, tab)), _mm_or_si128(_mm_cmpeq_epi8(bytes, lineFeed), _mm_cmpeq_epi8(bytes, carriageReturn)));
+		unsigned shift = 16 * i;
+		
+		masks->quote |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, quote)) << shift;
+		masks->backslash |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, backslash)) << shift;
+		masks->operators |= (uint64_t)(uint16_t)_mm_movemask_epi8(operators) << shift;
+		masks->whitespace |= (uint64_t)(uint16_t)_mm_movemask_epi8(whitespace) << shift;
+	}
+}
+
+__attribute__((target("avx2")))
+static void SMJClassifyBlockAVX2(const uint8_t *block, SMJBlockMasks *masks)
+{
+	const __m256i quote = _mm256_set1_epi8('"');
+	const __m256i backslash = _mm256_set1_epi8('\\');
+	const __m256i braceBit = _mm256_set1_epi8(0x20);
+	const __m256i openBrace = _mm256_set1_epi8('{');
+	const __m256i closeBrace = _mm256_set1_epi8('}');
+	const __m256i colon = _mm256_set1_epi8(':');
+	const __m256i comma = _mm256_set1_epi8(',');
+	const __m256i space = _mm256_set1_epi8(' ');
+	const __m256i tab = _mm256_set1_epi8('\t');
+	const __m256i lineFeed = _mm256_set1_epi8('\n');
+	const __m256i carriageReturn = _mm256_set1_epi8('\r');
+	
+	memset(masks, 0, sizeof(*masks));
+	
+	for (unsigned i = 0; i < 2; i++)
+	{
+		__m256i bytes = _mm256_loadu_si256((const __m256i *)(block + 32 * i));
+		__m256i braces = _mm256_or_si256(bytes, braceBit);
+		__m256i operators = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(braces, openBrace), _mm256_cmpeq_epi8(braces, closeBrace)), _mm256_or_si256(_mm256_cmpeq_epi8(bytes, colon), _mm256_cmpeq_epi8(bytes, comma)));
+		__m256i whitespace = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(bytes, space), _mm256_cmpeq_epi8(bytes, tab)), _mm256_or_si256(_mm256_cmpeq_epi8(bytes, lineFeed), _mm256_cmpeq_epi8(bytes, carriageReturn)));
+		unsigned shift = 32 * i;
+		
+		masks->quote |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, quote)) << shift;
+		masks->backslash |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, backslash)) << shift;
+		masks->operators |= (uint64_t)(uint32_t)_mm256_movemask_epi8(operators) << shift;
+		masks->whitespace |= (uint64_t)(uint32_t)_mm256_movemask_epi8(whitespace) << shift;
+	}
+}
+
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+
+static inline uint64_t SMJMovemaskNEON(uint8x16_t m0, uint8x16_t m1, uint8x16_t m2, uint8x16_t m3)
+{
+	// Keep one bit by lane, then add neighbour lanes until each byte holds 8 lanes.
+	const uint8x16_t weights = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
+	
+	uint8x16_t sum0 = vpaddq_u8(vandq_u8(m0, weights), vandq_u8(m1, weights));
+	uint8x16_t sum1 = vpaddq_u8(vandq_u8(m2, weights), vandq_u8(m3, weights));
+	
+	sum0 = vpaddq_u8(sum0, sum1);
+	sum0 = vpaddq_u8(sum0, sum0);
+	
+	return vgetq_lane_u64(vreinterpretq_u64_u8(sum0), 0);
+}
+
+static void SMJClassifyBlockNEON(const uint8_t *block, SMJBlockMasks *masks)
+{
+	const uint8x16_t quote = vdupq_n_u8('"');
+	const uint8x16_t backslash = vdupq_n_u8('\\');
+	const uint8x16_t braceBit = vdupq_n_u8(0x20);
+	const uint8x16_t openBrace = vdupq_n_u8('{');
+	const uint8x16_t closeBrace = vdupq_n_u8('}');
+	const uint8x16_t colon = vdupq_n_u8(':');
+	const uint8x16_t comma = vdupq_n_u8(',');
+	const uint8x16_t space = vdupq_n_u8(' ');
+	const uint8x16_t tab = vdupq_n_u8('\t');
+	const uint8x16_t lineFeed = vdupq_n_u8('\n');
+	const uint8x16_t carriageReturn = vdupq_n_u8('\r');
+	
+	uint8x16_t quoteMasks[4], backslashMasks[4], operatorMasks[4], whitespaceMasks[4];
+	
+	for (unsigned i = 0; i < 4; i++)
+	{
+		uint8x16_t bytes = vld1q_u8(block + 16 * i);
+		uint8x16_t braces = vorrq_u8(bytes, braceBit);
+		
+		quoteMasks[i] = vceqq_u8(bytes, quote);
+		backslashMasks[i] = vceqq_u8(bytes, backslash);
+		operatorMasks[i] = vorrq_u8(vorrq_u8(vceqq_u8(braces, openBrace), vceqq_u8(braces, closeBrace)), vorrq_u8(vceqq_u8(bytes, colon), vceqq_u8(bytes, comma)));
+		whitespaceMasks[i] = vorrq_u8(vorrq_u8(vceqq_u8(bytes, space), vceqq_u8(bytes, tab)), vorrq_u8(vceqq_u8(bytes, lineFeed), vceqq_u8(bytes, carriageReturn)));
+	}
+	
+	masks->quote = SMJMovemaskNEON(quoteMasks[0], quoteMasks[1], quoteMasks[2], quoteMasks[3]);
+	masks->backslash = SMJMovemaskNEON(backslashMasks[0], backslashMasks[1], backslashMasks[2], backslashMasks[3]);
+	masks->operators = SMJMovemaskNEON(operatorMasks[0], operatorMasks[1], operatorMasks[2], operatorMasks[3]);
+	masks->whitespace = SMJMovemaskNEON(whitespaceMasks[0], whitespaceMasks[1], whitespaceMasks[2], whitespaceMasks[3]);
+}
+
+#endif
+
+
+
+/*
+** Structural index - Builder
+*/
+#pragma mark - Structural index - Builder
+
+typedef void (*SMJClassifyBlock)(const uint8_t *block, SMJBlockMasks *masks);
+
+static uint64_t SMJPrefixXor(uint64_t bits)
+{
+	// Bit n is the parity of bits 0 to n: set between an opening quote (included) and its closing quote (excluded).
+	bits ^= bits << 1;
+	bits ^= bits << 2;
+	bits ^= bits << 4;
+	bits ^= bits << 8;
+	bits ^= bits << 16;
+	bits ^= bits << 32;
+	
+	return bits;
+}
+
+static uint64_t SMJEscapedBits(uint64_t backslash, uint64_t *prevEndsOddBackslash)
+{
+	// Characters following an odd-length sequence of backslashes are escaped.
+	const uint64_t evenBits = 0x5555555555555555ULL;
+	const uint64_t oddBits = ~evenBits;
+	
+	uint64_t startEdges = backslash & ~(backslash << 1);
+	uint64_t evenStartMask = evenBits ^ *prevEndsOddBackslash;
+	uint64_t evenStarts = startEdges & evenStartMask;
+	uint64_t oddStarts = startEdges & ~evenStartMask;
+	uint64_t evenCarries = backslash + evenStarts;
+	uint64_t oddCarries = backslash + oddStarts;
+	BOOL	 endsOddBackslash = (oddCarries < backslash);
+	
+	oddCarries |= *prevEndsOddBackslash;
+	*prevEndsOddBackslash = (endsOddBackslash ? 1 : 0);
+	
+	uint64_t evenCarryEnds = evenCarries & ~backslash;
+	uint64_t oddCarryEnds = oddCarries & ~backslash;
+	
+	return (evenCarryEnds & oddBits) | (oddCarryEnds & evenBits);
+}
+
+static BOOL SMJBuildStructuralIndex(const uint8_t *bytes, size_t length, SMJClassifyBlock classify, uint32_t *indexes, size_t *count)
+{
+	// > Index structural operators, quotes, and the first byte of each literal and number, outside strings.
+	// > indexes needs room for length + 1 entries. Return NO if a string is not terminated.
+	
+	uint64_t	prevInString = 0;
+	uint64_t	prevEndsOddBackslash = 0;
+	uint64_t	prevScalar = 0;
+	size_t		result = 0;
+	
+	for (size_t offset = 0; offset < length; offset += 64)
+	{
+		SMJBlockMasks	masks;
+		size_t			blockLength = (length - offset < 64 ? length - offset : 64);
+		
+		if (blockLength == 64)
+			classify(bytes + offset, &masks);
+		else
+		{
+			// Last block: pad with spaces.
+			uint8_t block[64];
+			
+			memset(block, ' ', sizeof(block));
+			memcpy(block, bytes + offset, blockLength);
+			
+			classify(block, &masks);
+		}
+		
+		// Strings.
+		uint64_t escaped = SMJEscapedBits(masks.backslash, &prevEndsOddBackslash);
+		uint64_t quotes = masks.quote & ~escaped;
+		uint64_t inString = SMJPrefixXor(quotes) ^ prevInString;
+		
+		prevInString = (uint64_t)((int64_t)inString >> 63);
+		
+		// Literals and numbers: runs of other bytes, outside strings.
+		uint64_t scalars = ~(masks.operators | masks.whitespace | quotes | inString);
+		uint64_t scalarStarts = scalars & ~((scalars << 1) | prevScalar);
+		
+		prevScalar = scalars >> 63;
+		
+		// Flatten.
+		uint64_t structurals = (masks.operators & ~inString) | quotes | scalarStarts;
+		
+		while (structurals)
+		{
+			indexes[result++] = (uint32_t)(offset + (size_t)__builtin_ctzll(structurals));
+			structurals &= structurals - 1;
+		}
+	}
+	
+	*count = result;
+	
+	return (prevInString == 0);
+}
+
+
+
+/*
+** SMJJSONParser
+*/
+#pragma mark - SMJJSONParser
+
+@implementation SMJJSONParser
+{
+	NSData			*_data;
+	const uint8_t	*_bytes;
+	size_t			_length;
+	
+	SMJClassifyBlock _classify;
+	
+	// Structural index.
+	uint32_t	*_indexes;
+	size_t		_indexCount;
+	size_t		_current;
+	
+	// Children of the containers being built (retained).
+	const void * _Nullable	*_values;
+	NSUInteger				_valuesCount;
+	NSUInteger				_valuesCapacity;
+	
+	const void * _Nullable	*_keys;
+	NSUInteger				_keysCount;
+	NSUInteger				_keysCapacity;
+	
+	NSUInteger _depth;
+	
+	// Decoded strings with escapes.
+	uint8_t	*_scratch;
+	size_t	_scratchCapacity;
+	
+	// Keys already built, by bytes in the document.
+	NSString		*_keyCache[SMJJSONParserKeyCacheSize];
+	const uint8_t	*_keyCacheBytes[SMJJSONParserKeyCacheSize];
+	size_t			_keyCacheLengths[SMJJSONParserKeyCacheSize];
+	
+	BOOL _unsupportedEncoding;
+}
+
+
+/*
+** SMJJSONParser - Instance
+*/
+#pragma mark - SMJJSONParser - Instance
+
+- (instancetype)initWithData:(NSData *)data
+{
+	return [self initWithData:data kernel:[[self class] bestKernel]];
+}
+
+- (instancetype)initWithData:(NSData *)data kernel:(SMJJSONParserKernel)kernel
+{
+	NSAssert([[self class] isKernelAvailable:kernel], @"kernel is not available");
+	
+	self = [super init];
+	
+	if (self)
+	{
+		_data = data;
+		_bytes = data.bytes;
+		_length = data.length;
+		
+		switch (kernel)
+		{
+#if defined(__SSE2__)
+			case SMJJSONParserKernelSSE2:
+				_classify = SMJClassifyBlockSSE2;
+				break;
+			
+			case SMJJSONParserKernelAVX2:
+				_classify = SMJClassifyBlockAVX2;
+				break;
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+			case SMJJSONParserKernelNEON:
+				_classify = SMJClassifyBlockNEON;
+				break;
+#endif
+				
+			default:
+				_classify = SMJClassifyBlockScalar;
+				break;
+		}
+	}
+	
+	return self;
+}
+
+- (void)dealloc
+{
+	[self releaseValuesFromIndex:0 keysFromIndex:0];
+	
+	free(_indexes);
+	free(_values);
+	free(_keys);
+	free(_scratch);
+}
+
+
+/*
+** SMJJSONParser - Kernels
+*/
+#pragma mark - SMJJSONParser - Kernels
+
++ (SMJJSONParserKernel)bestKernel
+{
+	if ([self isKernelAvailable:SMJJSONParserKernelAVX2])
+		return SMJJSONParserKernelAVX2;
+	else if ([self isKernelAvailable:SMJJSONParserKernelSSE2])
+		return SMJJSONParserKernelSSE2;
+	else if ([self isKernelAvailable:SMJJSONParserKernelNEON])
+		return SMJJSONParserKernelNEON;
+	
+	return SMJJSONParserKernelScalar;
+}
+
++ (BOOL)isKernelAvailable:(SMJJSONParserKernel)kernel
+{
+	switch (kernel)
+	{
+		case SMJJSONParserKernelScalar:
+			return YES;
+		
+		case SMJJSONParserKernelSSE2:
+#if defined(__SSE2__)
+			return YES;
+#else
+			return NO;
+#endif
+			
+		case SMJJSONParserKernelAVX2:
+		{
+#if defined(__SSE2__)
+			static dispatch_once_t	onceToken;
+			static BOOL				available;
+			
+			dispatch_once(&onceToken, ^{
+				__builtin_cpu_init();
+				available = (__builtin_cpu_supports("avx2") != 0);
+			});
+			
+			return available;
+#else
+			return NO;
+#endif
+		}
+		
+		case SMJJSONParserKernelNEON:
+#if defined(__aarch64__) && defined(__ARM_NEON)
+			return YES;
+#else
+			return NO;
+#endif
+	}
+	
+	return NO;
+}
+
+
+/*
+** SMJJSONParser - Read
+*/
+#pragma mark - SMJJSONParser - Read
+
+- (nullable id)readJSONObjectWithError:(NSError **)error
+{
+	const uint8_t	*bytes = _bytes;
+	size_t			length = _length;
+	
+	// Encoding. UTF-16 and UTF-32 documents start with a zero byte or a byte order mark.
+	if (length >= 2 && (bytes[0] == 0 || bytes[1] == 0 || (bytes[0] == 0xFE && bytes[1] == 0xFF) || (bytes[0] == 0xFF && bytes[1] == 0xFE)))
+	{
+		_unsupportedEncoding = YES;
+		SMSetError(error, 1, @"Only UTF-8 documents are supported.");
+		return nil;
+	}
+	
+	if (length >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF)
+	{
+		bytes += 3;
+		length -= 3;
+	}
+	
+	if (length >= UINT32_MAX)
+	{
+		SMSetError(error, 2, @"Document is too large.");
+		return nil;
+	}
+	
+	_bytes = bytes;
+	_length = length;
+	
+	// Stage 1: structural index.
+	free(_indexes);
+	
+	_indexes = malloc((length + 1) * sizeof(uint32_t));
+	_current = 0;
+	
+	if (!_indexes)
+	{
+		SMSetError(error, 4, @"Not enough memory.");
+		return nil;
+	}
+	
+	if (SMJBuildStructuralIndex(bytes, length, _classify, _indexes, &_indexCount) == NO)
+	{
+		[self setError:error message:@"Unterminated string" position:length];
+		return nil;
+	}
+	
+	// Stage 2: values.
+	id result = [self readValueWithError:error];
+	
+	if (!result)
+		return nil;
+	
+	if (_current < _indexCount)
+	{
+		[self setError:error message:@"Unexpected data after value" position:_indexes[_current]];
+		return nil;
+	}
+	
+	return result;
+}
+
+
+/*
+** SMJJSONParser - Properties
+*/
+#pragma mark - SMJJSONParser - Properties
+
+- (BOOL)unsupportedEncoding
+{
+	return _unsupportedEncoding;
+}
+
+
+/*
+** SMJJSONParser - Values
+*/
+#pragma mark - SMJJSONParser - Values
+
+- (nullable id)readValueWithError:(NSError **)error
+{
+	if (_current >= _indexCount)
+	{
+		[self setError:error message:@"Unexpected end of data" position:_length];
+		return nil;
+	}
+	
+	size_t position = _indexes[_current++];
+	
+	switch (_bytes[position])
+	{
+		case '{':
+			return [self readObjectAtPosition:position error:error];
+		
+		case '[':
+			return [self readArrayAtPosition:position error:error];
+		
+		case '"':
+			return [self readStringAtPosition:position key:NO error:error];
+		
+		case 't':
+			return ([self scanLiteral:"true" position:position error:error] ? @YES : nil);
+		
+		case 'f':
+			return ([self scanLiteral:"false" position:position error:error] ? @NO : nil);
+		
+		case 'n':
+			return ([self scanLiteral:"null" position:position error:error] ? [NSNull null] : nil);
+		
+		case '-': case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8': case '9':
+			return [self readNumberAtPosition:position error:error];
+	}
+	
+	[self setError:error message:[NSString stringWithFormat:@"Unexpected character '%c'", _bytes[position]] position:position];
+	
+	return nil;
+}
+
+- (nullable NSDictionary *)readObjectAtPosition:(size_t)position error:(NSError **)error
+{
+	if (_depth >= SMJJSONParserMaxDepth)
+	{
+		[self setError:error message:@"Too many nested containers" position:position];
+		return nil;
+	}
+	
+	_depth++;
+	
+	NSUInteger		valuesBase = _valuesCount;
+	NSUInteger		keysBase = _keysCount;
+	NSDictionary	*result = nil;
+	
+	if ([self nextStructuralIs:'}'])
+	{
+		_current++;
+		result = @{ };
+		goto end;
+	}
+	
+	for (;;)
+	{
+		// Key.
+		if ([self nextStructuralIs:'"'] == NO)
+		{
+			[self setError:error message:@"Expected string key" position:[self nextStructuralPosition]];
+			goto end;
+		}
+		
+		NSString *key = [self readStringAtPosition:_indexes[_current++] key:YES error:error];
+		
+		if (!key)
+			goto end;
+		
+		if ([self nextStructuralIs:':'] == NO)
+		{
+			[self setError:error message:@"Expected ':'" position:[self nextStructuralPosition]];
+			goto end;
+		}
+		
+		_current++;
+		
+		// Value.
+		id value = [self readValueWithError:error];
+		
+		if (!value)
+			goto end;
+		
+		if (SMJPushValue(&_keys, &_keysCount, &_keysCapacity, key) == NO || SMJPushValue(&_values, &_valuesCount, &_valuesCapacity, value) == NO)
+		{
+			SMSetError(error, 4, @"Not enough memory.");
+			goto end;
+		}
+		
+		// Next.
+		if ([self nextStructuralIs:','])
+		{
+			_current++;
+			continue;
+		}
+		else if ([self nextStructuralIs:'}'])
+		{
+			_current++;
+			break;
+		}
+		
+		[self setError:error message:@"Expected ',' or '}'" position:[self nextStructuralPosition]];
+		goto end;
+	}
+	
+	result = [[NSDictionary alloc] initWithObjects:(__unsafe_unretained id const *)(const void *)(_values + valuesBase) forKeys:(__unsafe_unretained id <NSCopying> const *)(const void *)(_keys + keysBase) count:(_valuesCount - valuesBase)];
+	
+end:
+	[self releaseValuesFromIndex:valuesBase keysFromIndex:keysBase];
+	_depth--;
+	
+	return result;
+}
+
+- (nullable NSArray *)readArrayAtPosition:(size_t)position error:(NSError **)error
+{
+	if (_depth >= SMJJSONParserMaxDepth)
+	{
+		[self setError:error message:@"Too many nested containers" position:position];
+		return nil;
+	}
+	
+	_depth++;
+	
+	NSUInteger	valuesBase = _valuesCount;
+	NSArray		*result = nil;
+	
+	if ([self nextStructuralIs:']'])
+	{
+		_current++;
+		result = @[ ];
+		goto end;
+	}
+	
+	for (;;)
+	{
+		// Value.
+		id value = [self readValueWithError:error];
+		
+		if (!value)
+			goto end;
+		
+		if (SMJPushValue(&_values, &_valuesCount, &_valuesCapacity, value) == NO)
+		{
+			SMSetError(error, 4, @"Not enough memory.");
+			goto end;
+		}
+		
+		// Next.
+		if ([self nextStructuralIs:','])
+		{
+			_current++;
+			continue;
+		}
+		else if ([self nextStructuralIs:']'])
+		{
+			_current++;
+			break;
+		}
+		
+		[self setError:error message:@"Expected ',' or ']'" position:[self nextStructuralPosition]];
+		goto end;
+	}
+	
+	result = [[NSArray alloc] initWithObjects:(__unsafe_unretained id const *)(const void *)(_values + valuesBase) count:(_valuesCount - valuesBase)];
+	
+end:
+	[self releaseValuesFromIndex:valuesBase keysFromIndex:_keysCount];
+	_depth--;
+	
+	return result;
+}
+
+
+/*
+** SMJJSONParser - Scalars
+*/
+#pragma mark - SMJJSONParser - Scalars
+
+- (nullable NSString *)readStringAtPosition:(size_t)position key:(BOOL)isKey error:(NSError **)error
+{
+	// > The closing quote is always the next structural character.
+	size_t			end = _indexes[_current++];
+	const uint8_t	*start = _bytes + position + 1;
+	size_t			length = end - position - 1;
+	size_t			i = 0;
+	
+	// Plain bytes.
+	while (i < length && start[i] != '\\' && start[i] >= 0x20)
+		i++;
+	
+	if (i == length)
+	{
+		if (isKey && length <= SMJJSONParserMaxCachedKey)
+			return [self keyWithBytes:start length:length position:position error:error];
+		
+		NSString *result = [[NSString alloc] initWithBytes:start length:length encoding:NSUTF8StringEncoding];
+		
+		if (!result)
+			[self setError:error message:@"Invalid UTF-8 string" position:position];
+		
+		return result;
+	}
+	
+	// Escapes. Decoded strings are never longer than their JSON representation.
+	if (_scratchCapacity < length)
+	{
+		free(_scratch);
+		
+		_scratchCapacity = MAX(length, 256);
+		_scratch = malloc(_scratchCapacity);
+		
+		if (!_scratch)
+		{
+			_scratchCapacity = 0;
+			SMSetError(error, 4, @"Not enough memory.");
+			return nil;
+		}
+	}
+	
+	memcpy(_scratch, start, i);
+	
+	size_t scratchLength = i;
+	
+	while (i < length)
+	{
+		uint8_t c = start[i++];
+		
+		if (c >= 0x20 && c != '\\')
+		{
+			_scratch[scratchLength++] = c;
+			continue;
+		}
+		
+		if (c < 0x20)
+		{
+			[self setError:error message:@"Unescaped control character in string" position:position + i];
+			return nil;
+		}
+		
+		// Escape sequence. The closing quote can't be escaped, so there is always a byte after the backslash.
+		switch (start[i++])
+		{
+			case '"':	_scratch[scratchLength++] = '"';	break;
+			case '\\':	_scratch[scratchLength++] = '\\';	break;
+			case '/':	_scratch[scratchLength++] = '/';	break;
+			case 'b':	_scratch[scratchLength++] = '\b';	break;
+			case 'f':	_scratch[scratchLength++] = '\f';	break;
+			case 'n':	_scratch[scratchLength++] = '\n';	break;
+			case 'r':	_scratch[scratchLength++] = '\r';	break;
+			case 't':	_scratch[scratchLength++] = '\t';	break;
+			
+			case 'u':
+			{
+				size_t consumed = SMJDecodeUnicodeEscape(start + i, length - i, _scratch + scratchLength, &scratchLength);
+				
+				if (consumed == 0)
+				{
+					[self setError:error message:@"Invalid unicode escape" position:position + i];
+					return nil;
+				}
+				
+				i += consumed;
+				break;
+			}
+			
+			default:
+				[self setError:error message:@"Invalid escape sequence" position:position + i];
+				return nil;
+		}
+	}
+	
+	NSString *result = [[NSString alloc] initWithBytes:_scratch length:scratchLength encoding:NSUTF8StringEncoding];
+	
+	if (!result)
+		[self setError:error message:@"Invalid UTF-8 string" position:position];
+	
+	return result;
+}
+
+- (nullable NSString *)keyWithBytes:(const uint8_t *)bytes length:(size_t)length position:(size_t)position error:(NSError **)error
+{
+	// Documents tend to repeat the same keys: build them once.
+	uint32_t hash = 2166136261U;
+	
+	for (size_t i = 0; i < length; i++)
+		hash = (hash ^ bytes[i]) * 16777619U;
+	
+	NSUInteger slot = hash & (SMJJSONParserKeyCacheSize - 1);
+	
+	if (_keyCache[slot] && _keyCacheLengths[slot] == length && memcmp(_keyCacheBytes[slot], bytes, length) == 0)
+		return _keyCache[slot];
+	
+	NSString *key = [[NSString alloc] initWithBytes:bytes length:length encoding:NSUTF8StringEncoding];
+	
+	if (!key)
+	{
+		[self setError:error message:@"Invalid UTF-8 string" position:position];
+		return nil;
+	}
+	
+	_keyCache[slot] = key;
+	_keyCacheBytes[slot] = bytes;
+	_keyCacheLengths[slot] = length;
+	
+	return key;
+}
+
+- (nullable NSNumber *)readNumberAtPosition:(size_t)position error:(NSError **)error
+{
+	// > Grammar: -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+	
+#define SMJIsDigit(c) ((c) >= '0' && (c) <= '9')
+#define SMJByteAt(idx) ((idx) < _length ? _bytes[(idx)] : 0)
+	
+	size_t		i = position;
+	BOOL		negative = NO;
+	BOOL		isInteger = YES;
+	uint64_t	mantissa = 0;
+	size_t		digits = 0;
+	
+	if (SMJByteAt(i) == '-')
+	{
+		negative = YES;
+		i++;
+	}
+	
+	if (SMJByteAt(i) == '0')
+	{
+		i++;
+		digits++;
+	}
+	else if (SMJByteAt(i) >= '1' && SMJByteAt(i) <= '9')
+	{
+		while (SMJIsDigit(SMJByteAt(i)))
+		{
+			mantissa = mantissa * 10 + (uint64_t)(_bytes[i] - '0');
+			digits++;
+			i++;
+		}
+	}
+	else
+	{
+		[self setError:error message:@"Invalid number" position:position];
+		return nil;
+	}
+	
+	if (SMJByteAt(i) == '.')
+	{
+		isInteger = NO;
+		i++;
+		
+		if (!SMJIsDigit(SMJByteAt(i)))
+		{
+			[self setError:error message:@"Invalid number fraction" position:position];
+			return nil;
+		}
+		
+		while (SMJIsDigit(SMJByteAt(i)))
+			i++;
+	}
+	
+	if (SMJByteAt(i) == 'e' || SMJByteAt(i) == 'E')
+	{
+		isInteger = NO;
+		i++;
+		
+		if (SMJByteAt(i) == '+' || SMJByteAt(i) == '-')
+			i++;
+		
+		if (!SMJIsDigit(SMJByteAt(i)))
+		{
+			[self setError:error message:@"Invalid number exponent" position:position];
+			return nil;
+		}
+		
+		while (SMJIsDigit(SMJByteAt(i)))
+			i++;
+	}
+	
+	if ([self isScalarEndAtPosition:i] == NO)
+	{
+		[self setError:error message:@"Invalid number" position:position];
+		return nil;
+	}
+	
+#undef SMJByteAt
+#undef SMJIsDigit
+	
+	// Integers which fit in 18 digits can't overflow.
+	if (isInteger && digits <= 18)
+		return [NSNumber numberWithLongLong:(negative ? -(long long)mantissa : (long long)mantissa)];
+	
+	// Others are converted like the stream reader does.
+	size_t	length = i - position;
+	char	stackBuffer[128];
+	char	*string = (length < sizeof(stackBuffer) ? stackBuffer : malloc(length + 1));
+	
+	if (!string)
+	{
+		SMSetError(error, 4, @"Not enough memory.");
+		return nil;
+	}
+	
+	memcpy(string, _bytes + position, length);
+	string[length] = 0;
+	
+	NSNumber *result = [SMJUtils numberWithJSONNumberCString:string integer:isInteger];
+	
+	if (string != stackBuffer)
+		free(string);
+	
+	return result;
+}
+
+- (BOOL)scanLiteral:(const char *)literal position:(size_t)position error:(NSError **)error
+{
+	size_t length = strlen(literal);
+	
+	if (position + length > _length || memcmp(_bytes + position, literal, length) != 0 || [self isScalarEndAtPosition:position + length] == NO)
+	{
+		[self setError:error message:@"Invalid literal" position:position];
+		return NO;
+	}
+	
+	return YES;
+}
+
+
+/*
+** SMJJSONParser - Helpers
+*/
+#pragma mark - SMJJSONParser - Helpers
+
+- (BOOL)nextStructuralIs:(uint8_t)character
+{
+	return (_current < _indexCount && _bytes[_indexes[_current]] == character);
+}
+
+- (size_t)nextStructuralPosition
+{
+	return (_current < _indexCount ? _indexes[_current] : _length);
+}
+
+- (BOOL)isScalarEndAtPosition:(size_t)position
+{
+	if (position >= _length)
+		return YES;
+	
+	switch (_bytes[position])
+	{
+		case ' ': case '\t': case '\n': case '\r':
+		case '{': case '}': case '[': case ']': case ':': case ',':
+			return YES;
+	}
+	
+	return NO;
+}
+
+- (void)releaseValuesFromIndex:(NSUInteger)valuesBase keysFromIndex:(NSUInteger)keysBase
+{
+	// Balance the retains of SMJPushValue.
+	for (NSUInteger i = valuesBase; i < _valuesCount; i++)
+		(void)(__bridge_transfer id)_values[i];
+	
+	for (NSUInteger i = keysBase; i < _keysCount; i++)
+		(void)(__bridge_transfer id)_keys[i];
+	
+	_valuesCount = valuesBase;
+	_keysCount = keysBase;
+}
+
+- (void)setError:(NSError **)error message:(NSString *)message position:(size_t)position
+{
+	SMSetError(error, 3, @"%@ around byte %lu.", message, (unsigned long)position);
+}
+
+@end
+
+
+
+/*
+** C Tools
+*/
+#pragma mark - C Tools
+
+static BOOL SMJPushValue(const void * _Nullable * _Nullable * _Nonnull values, NSUInteger *count, NSUInteger *capacity, id value)
+{
+	if (*count == *capacity)
+	{
+		// On failure, the current stack is left untouched: its values are still released by the parser.
+		NSUInteger	newCapacity = MAX(*capacity * 2, 64);
+		const void	**newValues = realloc(*values, newCapacity * sizeof(void *));
+		
+		if (!newValues)
+			return NO;
+		
+		*values = newValues;
+		*capacity = newCapacity;
+	}
+	
+	(*values)[(*count)++] = (__bridge_retained const void *)value;
+	
+	return YES;
+}
+
+static int SMJHexValue(uint8_t c)
+{
+	if (c >= '0' && c <= '9')
+		return c - '0';
+	else if (c >= 'a' && c <= 'f')
+		return c - 'a' + 10;
+	else if (c >= 'A' && c <= 'F')
+		return c - 'A' + 10;
+	
+	return -1;
+}
+
+static BOOL SMJReadHex4(const uint8_t *bytes, size_t length, uint32_t *value)
+{
+	if (length < 4)
+		return NO;
+	
+	uint32_t result = 0;
+	
+	for (size_t i = 0; i < 4; i++)
+	{
+		int digit = SMJHexValue(bytes[i]);
+		
+		if (digit < 0)
+			return NO;
+		
+		result = (result << 4) | (uint32_t)digit;
+	}
+	
+	*value = result;
+	
+	return YES;
+}
+
+static size_t SMJDecodeUnicodeEscape(const uint8_t *bytes, size_t length, uint8_t *output, size_t *outputLength)
+{
+	// > bytes follow '\u'. Return the number of bytes consumed, or 0 if the escape is invalid.
+	uint32_t	codepoint;
+	size_t		consumed = 4;
+	
+	if (SMJReadHex4(bytes, length, &codepoint) == NO)
+		return 0;
+	
+	if (codepoint >= 0xD800 && codepoint <= 0xDBFF)
+	{
+		uint32_t low;
+		
+		if (length < 10 || bytes[4] != '\\' || bytes[5] != 'u' || SMJReadHex4(bytes + 6, length - 6, &low) == NO || low < 0xDC00 || low > 0xDFFF)
+			return 0;
+		
+		codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+		consumed = 10;
+	}
+	else if (codepoint >= 0xDC00 && codepoint <= 0xDFFF)
+		return 0;
+	
+	// Encode as UTF-8.
+	if (codepoint < 0x80)
+	{
+		output[0] = (uint8_t)codepoint;
+		*outputLength += 1;
+	}
+	else if (codepoint < 0x800)
+	{
+		output[0] = (uint8_t)(0xC0 | (codepoint >> 6));
+		output[1] = (uint8_t)(0x80 | (codepoint & 0x3F));
+		*outputLength += 2;
+	}
+	else if (codepoint < 0x10000)
+	{
+		output[0] = (uint8_t)(0xE0 | (codepoint >> 12));
+		output[1] = (uint8_t)(0x80 | ((codepoint >> 6) & 0x3F));
+		output[2] = (uint8_t)(0x80 | (codepoint & 0x3F));
+		*outputLength += 3;
+	}
+	else
+	{
+		output[0] = (uint8_t)(0xF0 | (codepoint >> 18));
+		output[1] = (uint8_t)(0x80 | ((codepoint >> 12) & 0x3F));
+		output[2] = (uint8_t)(0x80 | ((codepoint >> 6) & 0x3F));
+		output[3] = (uint8_t)(0x80 | (codepoint & 0x3F));
+		*outputLength += 4;
+	}
+	
+	return consumed;
+}
+
+
+NS_ASSUME_NONNULL_END
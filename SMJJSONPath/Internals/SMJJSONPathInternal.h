@@ -0,0 +1,48 @@
+/*
+ * SMJJSONPathInternal.h
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+#import "SMJJSONPath.h"
+
+#import "SMJPath.h"
+#import "SMJEvaluationContext.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** SMJJSONPath (Internal)
+*/
+#pragma mark - SMJJSONPath (Internal)
+
+@interface SMJJSONPath (Internal)
+
+// -- Path --
+@property (readonly) id <SMJPath> path;
+
+// -- Result --
+- (BOOL)checkConfiguration:(SMJConfiguration *)configuration error:(NSError **)error;
+- (nullable id)resultForEvaluationContext:(id <SMJEvaluationContext>)evaluationContext configuration:(SMJConfiguration *)configuration error:(NSError **)error;
+
+@end
+
+
+NS_ASSUME_NONNULL_END
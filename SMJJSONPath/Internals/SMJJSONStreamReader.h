@@ -0,0 +1,54 @@
+/*
+ * SMJJSONStreamReader.h
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+#import "SMJPathToken.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** SMJJSONStreamReader
+*/
+#pragma mark - SMJJSONStreamReader
+
+// Pull JSON reader working on a stream, chunk by chunk.
+// While reading, the value is projected on a token chain: only the parts of the document the chain can select are
+// materialized, everything else is skipped without allocation. Evaluating the chain on the projected value gives the
+// same result than evaluating it on the whole document.
+
+@interface SMJJSONStreamReader : NSObject
+
+// -- Instance --
+- (instancetype)initWithInputStream:(NSInputStream *)inputStream;
+
+// -- Read --
+- (nullable id)readJSONObjectWithError:(NSError **)error;
+- (nullable id)readJSONObjectProjectedOnPathToken:(nullable SMJPathToken *)token error:(NSError **)error; // nil token materialize the whole document.
+
+// -- Properties --
+@property (readonly) NSUInteger bytesRead;
+@property (readonly) BOOL unsupportedEncoding; // YES if a read failed because the stream is not UTF-8 encoded (nothing was materialized).
+
+@end
+
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,1027 @@
+/*
+ * SMJJSONStreamReader.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <stdlib.h>
+
+#import "SMJJSONStreamReader.h"
+
+#import "SMJPropertyPathToken.h"
+#import "SMJWildcardPathToken.h"
+#import "SMJArrayIndexToken.h"
+#import "SMJArraySliceToken.h"
+
+#import "SMJUtils.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** Macros
+*/
+#pragma mark - Macros
+
+#define SMSetError(Error, Code, Message, ...) \
+	do { \
+		if ((Error) && *(Error) == nil) {\
+			NSString *___message = [NSString stringWithFormat:(Message), ## __VA_ARGS__];\
+			*(Error) = [NSError errorWithDomain:@"SMJJSONStreamReaderErrorDomain" code:(Code) userInfo:@{ NSLocalizedDescriptionKey : ___message }]; \
+		} \
+	} while (0) \
+
+
+
+/*
+** Defines
+*/
+#pragma mark - Defines
+
+#define SMJJSONStreamReaderBufferSize	(64 * 1024)
+#define SMJJSONStreamReaderMaxDepth		512
+
+
+
+/*
+** SMJJSONStreamReader
+*/
+#pragma mark - SMJJSONStreamReader
+
+@implementation SMJJSONStreamReader
+{
+	NSInputStream *_inputStream;
+	
+	// Current chunk.
+	uint8_t		*_buffer;
+	NSInteger	_length;
+	NSInteger	_position;
+	
+	NSUInteger	_consumed;
+	BOOL		_ended;
+	NSError		*_streamError;
+	
+	// Decoded string or number.
+	uint8_t		*_scratch;
+	NSUInteger	_scratchLength;
+	NSUInteger	_scratchCapacity;
+	
+	NSUInteger	_depth;
+	BOOL		_unsupportedEncoding;
+	
+	// Token -> keys or positions kept by this token.
+	NSMapTable *_projections;
+}
+
+
+/*
+** SMJJSONStreamReader - Instance
+*/
+#pragma mark - SMJJSONStreamReader - Instance
+
+- (instancetype)initWithInputStream:(NSInputStream *)inputStream
+{
+	self = [super init];
+	
+	if (self)
+	{
+		_inputStream = inputStream;
+		
+		_buffer = malloc(SMJJSONStreamReaderBufferSize);
+		
+		_scratchCapacity = 256;
+		_scratch = malloc(_scratchCapacity);
+		
+		_projections = [NSMapTable mapTableWithKeyOptions:(NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality) valueOptions:NSPointerFunctionsStrongMemory];
+	}
+	
+	return self;
+}
+
+- (void)dealloc
+{
+	free(_buffer);
+	free(_scratch);
+}
+
+
+/*
+** SMJJSONStreamReader - Bytes
+*/
+#pragma mark - SMJJSONStreamReader - Bytes
+
+static BOOL SMJFillBuffer(SMJJSONStreamReader *reader)
+{
+	if (reader->_ended)
+		return NO;
+	
+	reader->_consumed += (NSUInteger)reader->_length;
+	reader->_position = 0;
+	reader->_length = 0;
+	
+	NSInteger count = [reader->_inputStream read:reader->_buffer maxLength:SMJJSONStreamReaderBufferSize];
+	
+	if (count <= 0)
+	{
+		reader->_ended = YES;
+		
+		if (count < 0)
+			reader->_streamError = reader->_inputStream.streamError;
+		
+		return NO;
+	}
+	
+	reader->_length = count;
+	
+	return YES;
+}
+
+NS_INLINE int SMJPeekByte(SMJJSONStreamReader *reader)
+{
+	if (reader->_position >= reader->_length && SMJFillBuffer(reader) == NO)
+		return -1;
+	
+	return reader->_buffer[reader->_position];
+}
+
+NS_INLINE int SMJNextByte(SMJJSONStreamReader *reader)
+{
+	int c = SMJPeekByte(reader);
+	
+	if (c >= 0)
+		reader->_position++;
+	
+	return c;
+}
+
+NS_INLINE int SMJPeekToken(SMJJSONStreamReader *reader)
+{
+	for (;;)
+	{
+		while (reader->_position < reader->_length)
+		{
+			uint8_t c = reader->_buffer[reader->_position];
+			
+			if (c != ' ' && c != '\n' && c != '\r' && c != '\t')
+				return c;
+			
+			reader->_position++;
+		}
+		
+		if (SMJFillBuffer(reader) == NO)
+			return -1;
+	}
+}
+
+NS_INLINE int SMJNextToken(SMJJSONStreamReader *reader)
+{
+	int c = SMJPeekToken(reader);
+	
+	if (c >= 0)
+		reader->_position++;
+	
+	return c;
+}
+
+static void SMJScratchAppend(SMJJSONStreamReader *reader, const uint8_t *bytes, NSUInteger length)
+{
+	if (reader->_scratchLength + length > reader->_scratchCapacity)
+	{
+		reader->_scratchCapacity = MAX(reader->_scratchCapacity * 2, reader->_scratchLength + length);
+		reader->_scratch = realloc(reader->_scratch, reader->_scratchCapacity);
+		
+		if (!reader->_scratch)
+			abort();
+	}
+	
+	memcpy(reader->_scratch + reader->_scratchLength, bytes, length);
+	reader->_scratchLength += length;
+}
+
+NS_INLINE void SMJScratchAppendByte(SMJJSONStreamReader *reader, uint8_t byte)
+{
+	if (reader->_scratchLength < reader->_scratchCapacity)
+		reader->_scratch[reader->_scratchLength++] = byte;
+	else
+		SMJScratchAppend(reader, &byte, 1);
+}
+
+
+/*
+** SMJJSONStreamReader - Read
+*/
+#pragma mark - SMJJSONStreamReader - Read
+
+- (nullable id)readJSONObjectWithError:(NSError **)error
+{
+	return [self readJSONObjectProjectedOnPathToken:nil error:error];
+}
+
+- (nullable id)readJSONObjectProjectedOnPathToken:(nullable SMJPathToken *)token error:(NSError **)error
+{
+	// Check encoding (UTF-16 & UTF-32 start by a BOM or have a null byte in the first two bytes).
+	int first = SMJPeekByte(self);
+	
+	if (first == 0x00 || first == 0xFE || first == 0xFF || (_length >= 2 && _buffer[1] == 0x00))
+	{
+		_unsupportedEncoding = YES;
+		
+		SMSetError(error, 2, @"Unsupported encoding, only UTF-8 is supported.");
+		return nil;
+	}
+	
+	// Skip UTF-8 BOM.
+	if (first == 0xEF)
+	{
+		if (SMJNextByte(self) != 0xEF || SMJNextByte(self) != 0xBB || SMJNextByte(self) != 0xBF)
+		{
+			[self setError:error message:@"Invalid byte order mark"];
+			return nil;
+		}
+	}
+	
+	// Read.
+	id result = [self readValueProjectedOnToken:token error:error];
+	
+	if (!result)
+		return nil;
+	
+	// Check end.
+	if (SMJPeekToken(self) != -1)
+	{
+		[self setError:error message:@"Garbage at end"];
+		return nil;
+	}
+	
+	if (_streamError)
+	{
+		[self setError:error message:@"Stream error"];
+		return nil;
+	}
+	
+	return result;
+}
+
+
+/*
+** SMJJSONStreamReader - Properties
+*/
+#pragma mark - SMJJSONStreamReader - Properties
+
+- (NSUInteger)bytesRead
+{
+	return _consumed + (NSUInteger)_position;
+}
+
+- (BOOL)unsupportedEncoding
+{
+	return _unsupportedEncoding;
+}
+
+
+/*
+** SMJJSONStreamReader - Projection
+*/
+#pragma mark - SMJJSONStreamReader - Projection
+
+- (nullable id)readValueProjectedOnToken:(nullable SMJPathToken *)token error:(NSError **)error
+{
+	int c = SMJPeekToken(self);
+	
+	if (c == '{')
+	{
+		if ([token isKindOfClass:[SMJPropertyPathToken class]])
+			return [self readObjectKeepingKeys:[self keysForPropertyToken:(SMJPropertyPathToken *)token] childToken:token.next error:error];
+		else if ([token isKindOfClass:[SMJWildcardPathToken class]])
+			return [self readObjectKeepingKeys:nil childToken:token.next error:error];
+		else
+			return [self readObjectKeepingKeys:nil childToken:nil error:error];
+	}
+	else if (c == '[')
+	{
+		if ([token isKindOfClass:[SMJWildcardPathToken class]])
+			return [self readArrayKeepingPositions:nil childToken:token.next error:error];
+		else if ([token isKindOfClass:[SMJArrayIndexToken class]] || [token isKindOfClass:[SMJArraySliceToken class]])
+			return [self readArrayKeepingPositions:[self positionsForArrayToken:(SMJArrayPathToken *)token] childToken:token.next error:error];
+		else
+			return [self readArrayKeepingPositions:nil childToken:nil error:error];
+	}
+	
+	// > Scan, predicates and functions can look anywhere in their value: nil token, materialize it fully.
+	// > Scalars, or a container not matching the token, are materialized as-is, so the evaluation fails or skip as usual.
+	
+	return [self readScalarWithError:error];
+}
+
+- (nullable NSArray <NSData *> *)keysForPropertyToken:(SMJPropertyPathToken *)token
+{
+	NSArray <NSData *> *keys = [_projections objectForKey:token];
+	
+	if (!keys)
+	{
+		NSMutableArray <NSData *> *mutableKeys = [[NSMutableArray alloc] init];
+		
+		for (NSString *property in token.properties)
+			[mutableKeys addObject:[property dataUsingEncoding:NSUTF8StringEncoding]];
+		
+		keys = mutableKeys;
+		
+		[_projections setObject:keys forKey:token];
+	}
+	
+	return keys;
+}
+
+- (nullable NSIndexSet *)positionsForArrayToken:(SMJArrayPathToken *)token
+{
+	id positions = [_projections objectForKey:token];
+	
+	if (!positions)
+	{
+		positions = [self computePositionsForArrayToken:token] ?: [NSNull null];
+		
+		[_projections setObject:positions forKey:token];
+	}
+	
+	return (positions == [NSNull null] ? nil : positions);
+}
+
+- (nullable NSIndexSet *)computePositionsForArrayToken:(SMJArrayPathToken *)token
+{
+	// > A negative index or bound depends on the array length: keep everything (nil).
+	
+	if ([token isKindOfClass:[SMJArrayIndexToken class]])
+	{
+		NSMutableIndexSet *positions = [[NSMutableIndexSet alloc] init];
+		
+		for (NSNumber *index in ((SMJArrayIndexToken *)token).indexOperation.indexes)
+		{
+			NSInteger value = index.integerValue;
+			
+			if (value < 0)
+				return nil;
+			
+			[positions addIndex:(NSUInteger)value];
+		}
+		
+		return positions;
+	}
+	else if ([token isKindOfClass:[SMJArraySliceToken class]])
+	{
+		SMJArraySliceOperation	*operation = ((SMJArraySliceToken *)token).sliceOperation;
+		NSInteger				from = operation.fromIndex;
+		NSInteger				to = operation.toIndex;
+		
+		switch (operation.operation)
+		{
+			case SMJSliceOperationFrom:
+				if (from < 0)
+					return nil;
+				
+				return [NSIndexSet indexSetWithIndexesInRange:NSMakeRange((NSUInteger)from, NSNotFound - 1 - (NSUInteger)from)];
+			
+			case SMJSliceOperationBetween:
+				if (from < 0 || to < 0)
+					return nil;
+				
+				if (from >= to)
+					return [NSIndexSet indexSet];
+				
+				return [NSIndexSet indexSetWithIndexesInRange:NSMakeRange((NSUInteger)from, (NSUInteger)(to - from))];
+			
+			case SMJSliceOperationTo:
+				if (to < 0)
+					return nil;
+				
+				return [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, (NSUInteger)to)];
+		}
+	}
+	
+	return nil;
+}
+
+
+/*
+** SMJJSONStreamReader - Values
+*/
+#pragma mark - SMJJSONStreamReader - Values
+
+- (nullable NSDictionary *)readObjectKeepingKeys:(nullable NSArray <NSData *> *)keys childToken:(nullable SMJPathToken *)childToken error:(NSError **)error
+{
+	// > keys: nil to keep all the keys.
+	
+	_position++; // '{'
+	
+	if (++_depth > SMJJSONStreamReaderMaxDepth)
+	{
+		[self setError:error message:@"Too many nested arrays or dictionaries"];
+		return nil;
+	}
+	
+	NSMutableDictionary *result = [[NSMutableDictionary alloc] init];
+	
+	if (SMJPeekToken(self) == '}')
+	{
+		_position++;
+		_depth--;
+		
+		return result;
+	}
+	
+	for (;;)
+	{
+		// Key.
+		if (SMJPeekToken(self) != '"')
+		{
+			[self setError:error message:@"Expected a string key"];
+			return nil;
+		}
+		
+		if ([self readStringStoring:YES error:error] == NO)
+			return nil;
+		
+		NSString *key = nil;
+		
+		if (!keys || [self scratchMatchesKeys:keys])
+		{
+			key = [self stringFromScratchWithError:error];
+			
+			if (!key)
+				return nil;
+		}
+		
+		if (SMJPeekToken(self) != ':')
+		{
+			[self setError:error message:@"Expected ':' after key"];
+			return nil;
+		}
+		
+		_position++;
+		
+		// Value.
+		if (key)
+		{
+			id value = [self readValueProjectedOnToken:childToken error:error];
+			
+			if (!value)
+				return nil;
+			
+			result[key] = value;
+		}
+		else if ([self skipValueWithError:error] == NO)
+			return nil;
+		
+		// Next.
+		int c = SMJNextToken(self);
+		
+		if (c == ',')
+			continue;
+		else if (c == '}')
+			break;
+		
+		[self setError:error message:@"Expected ',' or '}'"];
+		return nil;
+	}
+	
+	_depth--;
+	
+	return result;
+}
+
+- (nullable NSArray *)readArrayKeepingPositions:(nullable NSIndexSet *)positions childToken:(nullable SMJPathToken *)childToken error:(NSError **)error
+{
+	// > positions: nil to keep all the items. Items before the last kept position are replaced by NSNull to keep indexes stable,
+	// > items after are dropped.
+	
+	_position++; // '['
+	
+	if (++_depth > SMJJSONStreamReaderMaxDepth)
+	{
+		[self setError:error message:@"Too many nested arrays or dictionaries"];
+		return nil;
+	}
+	
+	NSMutableArray	*result = [[NSMutableArray alloc] init];
+	NSUInteger		cutoff = (positions ? (positions.count > 0 ? positions.lastIndex + 1 : 0) : NSUIntegerMax);
+	
+	if (SMJPeekToken(self) == ']')
+	{
+		_position++;
+		_depth--;
+		
+		return result;
+	}
+	
+	for (NSUInteger position = 0; ; position++)
+	{
+		// Value.
+		if (position >= cutoff)
+		{
+			if ([self skipValueWithError:error] == NO)
+				return nil;
+		}
+		else if (!positions || [positions containsIndex:position])
+		{
+			id value = [self readValueProjectedOnToken:childToken error:error];
+			
+			if (!value)
+				return nil;
+			
+			[result addObject:value];
+		}
+		else
+		{
+			if ([self skipValueWithError:error] == NO)
+				return nil;
+			
+			[result addObject:[NSNull null]];
+		}
+		
+		// Next.
+		int c = SMJNextToken(self);
+		
+		if (c == ',')
+			continue;
+		else if (c == ']')
+			break;
+		
+		[self setError:error message:@"Expected ',' or ']'"];
+		return nil;
+	}
+	
+	_depth--;
+	
+	return result;
+}
+
+- (nullable id)readScalarWithError:(NSError **)error
+{
+	int c = SMJPeekToken(self);
+	
+	switch (c)
+	{
+		case '"':
+		{
+			if ([self readStringStoring:YES error:error] == NO)
+				return nil;
+			
+			return [self stringFromScratchWithError:error];
+		}
+		
+		case 't':
+			return ([self scanLiteral:"true" error:error] ? @YES : nil);
+		
+		case 'f':
+			return ([self scanLiteral:"false" error:error] ? @NO : nil);
+		
+		case 'n':
+			return ([self scanLiteral:"null" error:error] ? [NSNull null] : nil);
+		
+		case '-': case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8': case '9':
+		{
+			BOOL integer = NO;
+			
+			if ([self scanNumberStoring:YES integer:&integer error:error] == NO)
+				return nil;
+			
+			return [self numberFromScratchInteger:integer];
+		}
+		
+		case -1:
+			[self setError:error message:@"Unexpected end of data"];
+			return nil;
+	}
+	
+	[self setError:error message:[NSString stringWithFormat:@"Unexpected character '%c'", c]];
+	
+	return nil;
+}
+
+- (BOOL)skipValueWithError:(NSError **)error
+{
+	int c = SMJPeekToken(self);
+	
+	switch (c)
+	{
+		case '{':
+		case '[':
+		{
+			int closing = (c == '{' ? '}' : ']');
+			
+			_position++;
+			
+			if (++_depth > SMJJSONStreamReaderMaxDepth)
+			{
+				[self setError:error message:@"Too many nested arrays or dictionaries"];
+				return NO;
+			}
+			
+			if (SMJPeekToken(self) == closing)
+			{
+				_position++;
+				_depth--;
+				
+				return YES;
+			}
+			
+			for (;;)
+			{
+				if (c == '{')
+				{
+					if (SMJPeekToken(self) != '"')
+					{
+						[self setError:error message:@"Expected a string key"];
+						return NO;
+					}
+					
+					if ([self readStringStoring:NO error:error] == NO)
+						return NO;
+					
+					if (SMJPeekToken(self) != ':')
+					{
+						[self setError:error message:@"Expected ':' after key"];
+						return NO;
+					}
+					
+					_position++;
+				}
+				
+				if ([self skipValueWithError:error] == NO)
+					return NO;
+				
+				int next = SMJNextToken(self);
+				
+				if (next == ',')
+					continue;
+				else if (next == closing)
+					break;
+				
+				[self setError:error message:(c == '{' ? @"Expected ',' or '}'" : @"Expected ',' or ']'")];
+				return NO;
+			}
+			
+			_depth--;
+			
+			return YES;
+		}
+		
+		case '"':
+			return [self readStringStoring:NO error:error];
+		
+		case 't':
+			return [self scanLiteral:"true" error:error];
+		
+		case 'f':
+			return [self scanLiteral:"false" error:error];
+		
+		case 'n':
+			return [self scanLiteral:"null" error:error];
+		
+		case '-': case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8': case '9':
+			return [self scanNumberStoring:NO integer:NULL error:error];
+		
+		case -1:
+			[self setError:error message:@"Unexpected end of data"];
+			return NO;
+	}
+	
+	[self setError:error message:[NSString stringWithFormat:@"Unexpected character '%c'", c]];
+	
+	return NO;
+}
+
+
+/*
+** SMJJSONStreamReader - Scalars
+*/
+#pragma mark - SMJJSONStreamReader - Scalars
+
+- (BOOL)readStringStoring:(BOOL)store error:(NSError **)error
+{
+	// > Decoded UTF-8 bytes are stored in scratch buffer when store is YES.
+	
+	_position++; // '"'
+	_scratchLength = 0;
+	
+	for (;;)
+	{
+		// Consume plain bytes in bulk.
+		NSInteger start = _position;
+		
+		while (_position < _length)
+		{
+			uint8_t c = _buffer[_position];
+			
+			if (c == '"' || c == '\\' || c < 0x20)
+				break;
+			
+			_position++;
+		}
+		
+		if (store && _position > start)
+			SMJScratchAppend(self, _buffer + start, (NSUInteger)(_position - start));
+		
+		if (_position >= _length)
+		{
+			if (SMJFillBuffer(self) == NO)
+			{
+				[self setError:error message:@"Unterminated string"];
+				return NO;
+			}
+			
+			continue;
+		}
+		
+		// Handle special byte.
+		uint8_t c = _buffer[_position++];
+		
+		if (c == '"')
+			return YES;
+		else if (c < 0x20)
+		{
+			[self setError:error message:@"Unescaped control character in string"];
+			return NO;
+		}
+		
+		// Escape sequence.
+		uint8_t unescaped;
+		
+		switch (SMJNextByte(self))
+		{
+			case '"':	unescaped = '"';	break;
+			case '\\':	unescaped = '\\';	break;
+			case '/':	unescaped = '/';	break;
+			case 'b':	unescaped = '\b';	break;
+			case 'f':	unescaped = '\f';	break;
+			case 'n':	unescaped = '\n';	break;
+			case 'r':	unescaped = '\r';	break;
+			case 't':	unescaped = '\t';	break;
+			
+			case 'u':
+			{
+				if ([self readUnicodeEscapeStoring:store error:error] == NO)
+					return NO;
+				
+				continue;
+			}
+			
+			default:
+				[self setError:error message:@"Invalid escape sequence"];
+				return NO;
+		}
+		
+		if (store)
+			SMJScratchAppendByte(self, unescaped);
+	}
+}
+
+- (BOOL)readUnicodeEscapeStoring:(BOOL)store error:(NSError **)error
+{
+	// > The '\u' is already consumed.
+	uint32_t codepoint;
+	
+	if ([self readHex4:&codepoint error:error] == NO)
+		return NO;
+	
+	if (codepoint >= 0xD800 && codepoint <= 0xDBFF)
+	{
+		uint32_t low;
+		
+		if (SMJNextByte(self) != '\\' || SMJNextByte(self) != 'u')
+		{
+			[self setError:error message:@"Missing low surrogate in unicode escape"];
+			return NO;
+		}
+		
+		if ([self readHex4:&low error:error] == NO)
+			return NO;
+		
+		if (low < 0xDC00 || low > 0xDFFF)
+		{
+			[self setError:error message:@"Invalid low surrogate in unicode escape"];
+			return NO;
+		}
+		
+		codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+	}
+	else if (codepoint >= 0xDC00 && codepoint <= 0xDFFF)
+	{
+		[self setError:error message:@"Unexpected low surrogate in unicode escape"];
+		return NO;
+	}
+	
+	if (!store)
+		return YES;
+	
+	// Encode as UTF-8.
+	uint8_t		bytes[4];
+	NSUInteger	length;
+	
+	if (codepoint < 0x80)
+	{
+		bytes[0] = (uint8_t)codepoint;
+		length = 1;
+	}
+	else if (codepoint < 0x800)
+	{
+		bytes[0] = (uint8_t)(0xC0 | (codepoint >> 6));
+		bytes[1] = (uint8_t)(0x80 | (codepoint & 0x3F));
+		length = 2;
+	}
+	else if (codepoint < 0x10000)
+	{
+		bytes[0] = (uint8_t)(0xE0 | (codepoint >> 12));
+		bytes[1] = (uint8_t)(0x80 | ((codepoint >> 6) & 0x3F));
+		bytes[2] = (uint8_t)(0x80 | (codepoint & 0x3F));
+		length = 3;
+	}
+	else
+	{
+		bytes[0] = (uint8_t)(0xF0 | (codepoint >> 18));
+		bytes[1] = (uint8_t)(0x80 | ((codepoint >> 12) & 0x3F));
+		bytes[2] = (uint8_t)(0x80 | ((codepoint >> 6) & 0x3F));
+		bytes[3] = (uint8_t)(0x80 | (codepoint & 0x3F));
+		length = 4;
+	}
+	
+	SMJScratchAppend(self, bytes, length);
+	
+	return YES;
+}
+
+- (BOOL)readHex4:(uint32_t *)value error:(NSError **)error
+{
+	uint32_t result = 0;
+	
+	for (NSUInteger i = 0; i < 4; i++)
+	{
+		int			c = SMJNextByte(self);
+		uint32_t	digit;
+		
+		if (c >= '0' && c <= '9')
+			digit = (uint32_t)(c - '0');
+		else if (c >= 'a' && c <= 'f')
+			digit = (uint32_t)(c - 'a' + 10);
+		else if (c >= 'A' && c <= 'F')
+			digit = (uint32_t)(c - 'A' + 10);
+		else
+		{
+			[self setError:error message:@"Invalid unicode escape"];
+			return NO;
+		}
+		
+		result = (result << 4) | digit;
+	}
+	
+	*value = result;
+	
+	return YES;
+}
+
+- (BOOL)scanNumberStoring:(BOOL)store integer:(nullable BOOL *)integer error:(NSError **)error
+{
+	// > Grammar: -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+	
+#define SMJConsume() do { if (store) SMJScratchAppendByte(self, (uint8_t)c); _position++; c = SMJPeekByte(self); } while (0)
+#define SMJIsDigit(c) ((c) >= '0' && (c) <= '9')
+	
+	BOOL	isInteger = YES;
+	int		c = SMJPeekByte(self);
+	
+	_scratchLength = 0;
+	
+	if (c == '-')
+		SMJConsume();
+	
+	if (c == '0')
+		SMJConsume();
+	else if (c >= '1' && c <= '9')
+	{
+		while (SMJIsDigit(c))
+			SMJConsume();
+	}
+	else
+	{
+		[self setError:error message:@"Invalid number"];
+		return NO;
+	}
+	
+	if (c == '.')
+	{
+		isInteger = NO;
+		SMJConsume();
+		
+		if (!SMJIsDigit(c))
+		{
+			[self setError:error message:@"Invalid number fraction"];
+			return NO;
+		}
+		
+		while (SMJIsDigit(c))
+			SMJConsume();
+	}
+	
+	if (c == 'e' || c == 'E')
+	{
+		isInteger = NO;
+		SMJConsume();
+		
+		if (c == '+' || c == '-')
+			SMJConsume();
+		
+		if (!SMJIsDigit(c))
+		{
+			[self setError:error message:@"Invalid number exponent"];
+			return NO;
+		}
+		
+		while (SMJIsDigit(c))
+			SMJConsume();
+	}
+	
+#undef SMJIsDigit
+#undef SMJConsume
+	
+	if (integer)
+		*integer = isInteger;
+	
+	return YES;
+}
+
+- (BOOL)scanLiteral:(const char *)literal error:(NSError **)error
+{
+	for (const char *ptr = literal; *ptr; ptr++)
+	{
+		if (SMJNextByte(self) != *ptr)
+		{
+			[self setError:error message:@"Invalid literal"];
+			return NO;
+		}
+	}
+	
+	return YES;
+}
+
+
+/*
+** SMJJSONStreamReader - Helpers
+*/
+#pragma mark - SMJJSONStreamReader - Helpers
+
+- (BOOL)scratchMatchesKeys:(NSArray <NSData *> *)keys
+{
+	for (NSData *key in keys)
+	{
+		if (key.length == _scratchLength && memcmp(key.bytes, _scratch, _scratchLength) == 0)
+			return YES;
+	}
+	
+	return NO;
+}
+
+- (nullable NSString *)stringFromScratchWithError:(NSError **)error
+{
+	NSString *result = [[NSString alloc] initWithBytes:_scratch length:_scratchLength encoding:NSUTF8StringEncoding];
+	
+	if (!result)
+		[self setError:error message:@"Invalid UTF-8 string"];
+	
+	return result;
+}
+
+- (NSNumber *)numberFromScratchInteger:(BOOL)integer
+{
+	SMJScratchAppendByte(self, 0);
+	
+	return [SMJUtils numberWithJSONNumberCString:(const char *)_scratch integer:integer];
+}
+
+- (void)setError:(NSError **)error message:(NSString *)message
+{
+	if (_streamError)
+	{
+		if (error && *error == nil)
+			*error = _streamError;
+	}
+	else
+		SMSetError(error, 1, @"%@ around byte %lu.", message, (unsigned long)self.bytesRead);
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
@@ -23,6 +23,7 @@
 #import "SMJLogicalExpressionNode.h"
 
 #import "SMJLogicalOperator.h"
+#import "SMJFilterProgram.h"
 
 #import "SMJUtils.h"
 
@@ -163,6 +164,45 @@ NS_ASSUME_NONNULL_BEGIN
 	return result;
 }
 
+
+/*
+** SMJLogicalExpressionNode - Lowering
+*/
+#pragma mark - SMJLogicalExpressionNode - Lowering
+
+- (void)lowerToFilterProgram:(SMJFilterProgram *)program
+{
+	if (_chain.count == 0)
+	{
+		[program appendPredicate:self];
+		return;
+	}
+	
+	if (_operator == [SMJLogicalOperator logicalOperatorOR] || _operator == [SMJLogicalOperator logicalOperatorAND])
+	{
+		// Short-circuit: after each expression but the last, jump to the end of the chain as soon as the result is known.
+		SMJFilterOpcode	opcode = (_operator == [SMJLogicalOperator logicalOperatorOR] ? SMJFilterOpcodeJumpIfTrue : SMJFilterOpcodeJumpIfFalse);
+		NSUInteger		count = _chain.count;
+		NSUInteger		jumps[count];
+		
+		for (NSUInteger i = 0; i < count; i++)
+		{
+			[_chain[i] lowerToFilterProgram:program];
+			
+			if (i + 1 < count)
+				jumps[i] = [program appendJumpWithOpcode:opcode];
+		}
+		
+		for (NSUInteger i = 0; i + 1 < count; i++)
+			[program patchJumpAtIndex:jumps[i]];
+	}
+	else
+	{
+		[_chain[0] lowerToFilterProgram:program];
+		[program appendNot];
+	}
+}
+
 @end
 
 
@@ -0,0 +1,93 @@
+/*
+ * SMJNumericAggregation.h
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** Types
+*/
+#pragma mark - Types
+
+typedef struct SMJNumericAggregates
+{
+	NSUInteger count;
+	
+	double sum;
+	double min;
+	double max;
+	
+	double variance; // Population variance. Only computed if requested.
+} SMJNumericAggregates;
+
+
+
+/*
+** SMJNumericBuffer
+*/
+#pragma mark - SMJNumericBuffer
+
+// A contiguous buffer of unboxed numbers. Small series stay in the inline storage, bigger ones are moved to the heap.
+
+typedef struct SMJNumericBuffer
+{
+	double		*values;
+	NSUInteger	count;
+	NSUInteger	capacity;
+	
+	double		storage[128];
+} SMJNumericBuffer;
+
+
+FOUNDATION_EXTERN void SMJNumericBufferInit(SMJNumericBuffer *buffer);
+FOUNDATION_EXTERN void SMJNumericBufferFree(SMJNumericBuffer *buffer);
+
+// > Return NO if the memory can't be allocated. The buffer is left unchanged in this case.
+FOUNDATION_EXTERN BOOL SMJNumericBufferReserve(SMJNumericBuffer *buffer, NSUInteger additionalCount);
+
+// Append the numbers of the array. Other items are skipped.
+FOUNDATION_EXTERN BOOL SMJNumericBufferAppendNumbers(SMJNumericBuffer *buffer, NSArray *array);
+
+NS_INLINE BOOL SMJNumericBufferAppend(SMJNumericBuffer *buffer, double value)
+{
+	if (buffer->count == buffer->capacity && SMJNumericBufferReserve(buffer, 1) == NO)
+		return NO;
+	
+	buffer->values[buffer->count++] = value;
+	
+	return YES;
+}
+
+
+
+/*
+** Functions
+*/
+#pragma mark - Functions
+
+// Compute sum, min and max in a single pass. The loop keeps independent accumulators, so the compiler can vectorize it.
+// The variance, if requested, is computed by a second pass on the deviations from the mean, which is numerically stable
+// even when values are large compared to their spread.
+FOUNDATION_EXTERN SMJNumericAggregates SMJNumericAggregate(const double *values, NSUInteger count, BOOL computeVariance);
+
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,197 @@
+/*
+ * SMJNumericAggregation.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import "SMJNumericAggregation.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** Defines
+*/
+#pragma mark - Defines
+
+#define SMJAggregationLanes	4
+
+
+
+/*
+** SMJNumericBuffer
+*/
+#pragma mark - SMJNumericBuffer
+
+void SMJNumericBufferInit(SMJNumericBuffer *buffer)
+{
+	buffer->values = buffer->storage;
+	buffer->count = 0;
+	buffer->capacity = sizeof(buffer->storage) / sizeof(buffer->storage[0]);
+}
+
+void SMJNumericBufferFree(SMJNumericBuffer *buffer)
+{
+	if (buffer->values != buffer->storage)
+		free(buffer->values);
+	
+	buffer->values = buffer->storage;
+	buffer->count = 0;
+	buffer->capacity = sizeof(buffer->storage) / sizeof(buffer->storage[0]);
+}
+
+BOOL SMJNumericBufferReserve(SMJNumericBuffer *buffer, NSUInteger additionalCount)
+{
+	NSUInteger needed = buffer->count + additionalCount;
+	
+	if (needed <= buffer->capacity)
+		return YES;
+	
+	NSUInteger	capacity = MAX(buffer->capacity * 2, needed);
+	double		*values;
+	
+	if (capacity > SIZE_MAX / sizeof(double))
+		return NO;
+	
+	if (buffer->values == buffer->storage)
+	{
+		values = malloc(capacity * sizeof(double));
+		
+		if (!values)
+			return NO;
+		
+		memcpy(values, buffer->storage, buffer->count * sizeof(double));
+	}
+	else
+	{
+		// On failure, realloc leaves the current allocation untouched: it's still released by SMJNumericBufferFree.
+		values = realloc(buffer->values, capacity * sizeof(double));
+		
+		if (!values)
+			return NO;
+	}
+	
+	buffer->values = values;
+	buffer->capacity = capacity;
+	
+	return YES;
+}
+
+BOOL SMJNumericBufferAppendNumbers(SMJNumericBuffer *buffer, NSArray *array)
+{
+	NSUInteger count = array.count;
+	
+	if (SMJNumericBufferReserve(buffer, count) == NO)
+		return NO;
+	
+	double *values = buffer->values + buffer->count;
+	
+	for (id item in array)
+	{
+		if ([item isKindOfClass:[NSNumber class]] == NO)
+			continue;
+		
+		*values++ = [(NSNumber *)item doubleValue];
+	}
+	
+	buffer->count = (NSUInteger)(values - buffer->values);
+	
+	return YES;
+}
+
+
+
+/*
+** Functions
+*/
+#pragma mark - Functions
+
+SMJNumericAggregates SMJNumericAggregate(const double *values, NSUInteger count, BOOL computeVariance)
+{
+	SMJNumericAggregates result = { .count = count, .sum = 0.0, .min = 0.0, .max = 0.0, .variance = 0.0 };
+	
+	if (count == 0)
+		return result;
+	
+	// Sum, min, max.
+	double		sum[SMJAggregationLanes] = { 0.0 };
+	double		min[SMJAggregationLanes];
+	double		max[SMJAggregationLanes];
+	NSUInteger	idx = 0;
+	
+	for (NSUInteger lane = 0; lane < SMJAggregationLanes; lane++)
+	{
+		min[lane] = values[0];
+		max[lane] = values[0];
+	}
+	
+	for (; idx + SMJAggregationLanes <= count; idx += SMJAggregationLanes)
+	{
+		for (NSUInteger lane = 0; lane < SMJAggregationLanes; lane++)
+		{
+			double value = values[idx + lane];
+			
+			sum[lane] += value;
+			min[lane] = (value < min[lane] ? value : min[lane]);
+			max[lane] = (value > max[lane] ? value : max[lane]);
+		}
+	}
+	
+	for (; idx < count; idx++)
+	{
+		double value = values[idx];
+		
+		sum[0] += value;
+		min[0] = (value < min[0] ? value : min[0]);
+		max[0] = (value > max[0] ? value : max[0]);
+	}
+	
+	result.sum = (sum[0] + sum[1]) + (sum[2] + sum[3]);
+	result.min = MIN(MIN(min[0], min[1]), MIN(min[2], min[3]));
+	result.max = MAX(MAX(max[0], max[1]), MAX(max[2], max[3]));
+	
+	if (!computeVariance)
+		return result;
+	
+	// Variance.
+	double mean = result.sum / (double)count;
+	double squares[SMJAggregationLanes] = { 0.0 };
+	
+	for (idx = 0; idx + SMJAggregationLanes <= count; idx += SMJAggregationLanes)
+	{
+		for (NSUInteger lane = 0; lane < SMJAggregationLanes; lane++)
+		{
+			double deviation = values[idx + lane] - mean;
+			
+			squares[lane] += deviation * deviation;
+		}
+	}
+	
+	for (; idx < count; idx++)
+	{
+		double deviation = values[idx] - mean;
+		
+		squares[0] += deviation * deviation;
+	}
+	
+	result.variance = ((squares[0] + squares[1]) + (squares[2] + squares[3])) / (double)count;
+	
+	return result;
+}
+
+
+NS_ASSUME_NONNULL_END
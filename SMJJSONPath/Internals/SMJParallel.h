@@ -0,0 +1,41 @@
+/*
+ * SMJParallel.h
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** SMJParallel
+*/
+#pragma mark - SMJParallel
+
+// Size of the chunks used to split count items between concurrency workers.
+// There are several chunks by worker, so faster workers can take over the chunks left by slower ones.
+FOUNDATION_EXTERN NSUInteger SMJParallelChunkSize(NSUInteger count, NSUInteger concurrency);
+
+// Evaluate the items [0, count[ by contiguous chunks of chunkSize items, with at most concurrency workers, and wait for all of them.
+// Each worker pulls the next pending chunk. When the handler returns NO, the chunks following its chunk are not started anymore
+// (the chunks preceding it are still all evaluated).
+FOUNDATION_EXTERN void SMJParallelApply(NSUInteger count, NSUInteger chunkSize, NSUInteger concurrency, BOOL (^handler)(NSUInteger chunkIndex, NSRange range));
+
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,94 @@
+/*
+ * SMJParallel.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <stdatomic.h>
+
+#import "SMJParallel.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** Defines
+*/
+#pragma mark - Defines
+
+#define SMJParallelChunksPerWorker	8
+
+// Workers run at the caller QoS where it exists (Darwin), so a background evaluation doesn't take over the CPU.
+#if defined(__APPLE__)
+# define SMJParallelQueue()	dispatch_get_global_queue(qos_class_self(), 0)
+#else
+# define SMJParallelQueue()	dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0)
+#endif
+
+
+
+/*
+** SMJParallel
+*/
+#pragma mark - SMJParallel
+
+NSUInteger SMJParallelChunkSize(NSUInteger count, NSUInteger concurrency)
+{
+	NSUInteger workersCount = MAX(MIN(concurrency, count), 1);
+	
+	return MAX(count / (workersCount * SMJParallelChunksPerWorker), 1);
+}
+
+void SMJParallelApply(NSUInteger count, NSUInteger chunkSize, NSUInteger concurrency, BOOL (^handler)(NSUInteger chunkIndex, NSRange range))
+{
+	if (count == 0)
+		return;
+	
+	NSUInteger chunksCount = (count + chunkSize - 1) / chunkSize;
+	NSUInteger workersCount = MAX(MIN(concurrency, chunksCount), 1);
+	
+	atomic_ulong nextChunk = 0;
+	atomic_ulong stopChunk = chunksCount;
+	
+	atomic_ulong *nextChunkPtr = &nextChunk;
+	atomic_ulong *stopChunkPtr = &stopChunk;
+	
+	dispatch_apply(workersCount, SMJParallelQueue(), ^(size_t worker) {
+		
+		for (;;)
+		{
+			unsigned long chunkIndex = atomic_fetch_add(nextChunkPtr, 1);
+			
+			if (chunkIndex >= chunksCount || chunkIndex > atomic_load(stopChunkPtr))
+				break;
+			
+			NSUInteger location = chunkIndex * chunkSize;
+			
+			if (handler(chunkIndex, NSMakeRange(location, MIN(chunkSize, count - location))))
+				continue;
+			
+			// Lower the stop chunk to this one.
+			unsigned long stopIndex = atomic_load(stopChunkPtr);
+			
+			while (chunkIndex < stopIndex && !atomic_compare_exchange_weak(stopChunkPtr, &stopIndex, chunkIndex))
+				;
+		}
+	});
+}
+
+
+NS_ASSUME_NONNULL_END
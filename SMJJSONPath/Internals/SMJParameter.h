@@ -22,8 +22,6 @@
 
 #import <Foundation/Foundation.h>
 
-#import "SMJPath.h"
-
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -31,9 +29,10 @@ NS_ASSUME_NONNULL_BEGIN
 /*
 ** Forward
 */
-#pragma mark Forward
+#pragma mark - Forward
 
-@class SMJParameter;
+@protocol SMJPath;
+@protocol SMJEvaluationContext;
 
 
 
@@ -49,15 +48,15 @@ typedef enum SMJParamType
 } SMJParamType;
 
 
-typedef id _Nullable (^SMJParamLateBinding)(SMJParameter *parameter, NSError **error);
-
-
 
 /*
 ** SMJParameter
 */
 #pragma mark - SMJParameter
 
+// Parameters are part of compiled paths, which are shared: they are immutable once built.
+// Values of path parameters are computed by evaluation, and kept in the evaluation context.
+
 @interface SMJParameter : NSObject
 
 // -- Instance --
@@ -65,17 +64,15 @@ typedef id _Nullable (^SMJParamLateBinding)(SMJParameter *parameter, NSError **e
 - (instancetype)initWithPath:(id <SMJPath>)path;
 
 // -- Properties --
-@property (nonatomic) BOOL evaluated;
-@property (nonatomic) SMJParamLateBinding lateBinding;
-
 @property (readonly) SMJParamType type;
-@property (readonly) id <SMJPath> path;
-@property (readonly) NSString *jsonString;
+@property (readonly, nullable) id <SMJPath> path;
+@property (readonly, nullable) NSString *jsonString;
 
-- (nullable id)valueWithError:(NSError **)error;
+// -- Value --
+- (nullable id)valueWithEvaluationContext:(id <SMJEvaluationContext>)context error:(NSError **)error;
 
 // -- Tools --
-+ (nullable NSArray *)listWithParameters:(NSArray <SMJParameter *> *)parameters itemsClass:(Class)resultClass error:(NSError **)error;
++ (nullable NSArray *)listWithParameters:(nullable NSArray <SMJParameter *> *)parameters evaluationContext:(id <SMJEvaluationContext>)context itemsClass:(Class)resultClass error:(NSError **)error;
 
 @end
 
@@ -22,10 +22,28 @@
 
 #import "SMJParameter.h"
 
+#import "SMJPath.h"
+#import "SMJEvaluationContextImpl.h"
+
 
 NS_ASSUME_NONNULL_BEGIN
 
 
+/*
+** Macros
+*/
+#pragma mark - Macros
+
+#define SMSetError(Error, Code, Message, ...) \
+	do { \
+		if ((Error) && *(Error) == nil) {\
+			NSString *___message = [NSString stringWithFormat:(Message), ## __VA_ARGS__];\
+			*(Error) = [NSError errorWithDomain:@"SMJParameterErrorDomain" code:(Code) userInfo:@{ NSLocalizedDescriptionKey : ___message }]; \
+		} \
+	} while (0) \
+
+
+
 /*
 ** SMJParameter
 */
@@ -33,7 +51,8 @@ NS_ASSUME_NONNULL_BEGIN
 
 @implementation SMJParameter
 {
-	id _value;
+	id		_jsonValue;
+	NSError	*_jsonError;
 }
 
 
@@ -48,8 +67,17 @@ NS_ASSUME_NONNULL_BEGIN
 	
 	if (self)
 	{
+		NSError *error = nil;
+		NSData	*jsonData = [json dataUsingEncoding:NSUTF8StringEncoding];
+		
 		_jsonString = [json copy];
 		_type = SMJParamTypeJSON;
+		
+		// Parse now: the value of a JSON parameter doesn't depend on the evaluation.
+		if (jsonData)
+			_jsonValue = [NSJSONSerialization JSONObjectWithData:jsonData options:NSJSONReadingAllowFragments error:&error];
+		
+		_jsonError = error;
 	}
 	
 	return self;
@@ -70,19 +98,53 @@ NS_ASSUME_NONNULL_BEGIN
 
 
 /*
-** SMJParameter - Properties
+** SMJParameter - Value
 */
-#pragma mark - SMJParameter - Properties
+#pragma mark - SMJParameter - Value
 
-- (nullable id)valueWithError:(NSError **)error
+- (nullable id)valueWithEvaluationContext:(id <SMJEvaluationContext>)context error:(NSError **)error
 {
-	if (_value)
-		return _value;
-	
-	if (_lateBinding)
-		_value = _lateBinding(self, error);
+	switch (_type)
+	{
+		case SMJParamTypeJSON:
+		{
+			if (!_jsonValue)
+			{
+				if (error)
+					*error = _jsonError;
+				
+				SMSetError(error, 1, @"Invalid JSON parameter %@", _jsonString);
+			}
+			
+			return _jsonValue;
+		}
+		
+		case SMJParamTypePath:
+		{
+			// Path parameters are evaluated on the root object: their value is the same for the whole evaluation, so compute it once.
+			// Keyed by path, like the root paths of filters: the same path used as parameter and in a filter is evaluated once.
+			SMJEvaluationCache	*cache = ([context isKindOfClass:[SMJEvaluationContextImpl class]] ? ((SMJEvaluationContextImpl *)context).evaluationCache : nil);
+			NSValue				*key = [NSValue valueWithNonretainedObject:_path];
+			id					value = [cache objectForKey:key];
+			
+			if (value)
+				return value;
+			
+			id <SMJEvaluationContext> evaluationContext = [_path evaluateJsonObject:context.rootJsonObject rootJsonObject:context.rootJsonObject configuration:context.configuration error:error];
+			
+			if (!evaluationContext)
+				return nil;
+			
+			value = [evaluationContext jsonObjectWithError:error];
+			
+			if (value)
+				[cache setObject:value forKey:key];
+			
+			return value;
+		}
+	}
 	
-	return _value;
+	return nil;
 }
 
 
@@ -91,7 +153,7 @@ NS_ASSUME_NONNULL_BEGIN
 */
 #pragma mark - SMJParameter - Tools
 
-+ (nullable NSArray *)listWithParameters:(NSArray <SMJParameter *> *)parameters itemsClass:(Class)resultClass error:(NSError **)error
++ (nullable NSArray *)listWithParameters:(nullable NSArray <SMJParameter *> *)parameters evaluationContext:(id <SMJEvaluationContext>)context itemsClass:(Class)resultClass error:(NSError **)error
 {
 	NSMutableArray *values = [NSMutableArray new];
 	
@@ -110,7 +172,7 @@ NS_ASSUME_NONNULL_BEGIN
 	
 	for (SMJParameter *param in parameters)
 	{
-		id value = [param valueWithError:error];
+		id value = [param valueWithEvaluationContext:context error:error];
 		
 		if (!value)
 			return nil;
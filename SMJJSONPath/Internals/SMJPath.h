@@ -67,6 +67,19 @@ NS_ASSUME_NONNULL_BEGIN
 - (nullable id <SMJEvaluationContext>)evaluateJsonObject:(id)jsonObject rootJsonObject:(id)rootJsonObject configuration:(SMJConfiguration *)configuration forUpdate:(BOOL)forUpdate error:(NSError **)error;
 
 
+/**
+ * Evaluates this path, and stop the evaluation as soon as enough results are found
+ *
+ * @param jsonObject the json object to apply the path on
+ * @param rootJsonObject the root json object that started this evaluation
+ * @param configuration configuration to use
+ * @param forUpdate is this a read or a write operation
+ * @param resultLimit maximum number of results to collect, 0 for no limit
+ * @return EvaluationContext containing results of evaluation
+ */
+- (nullable id <SMJEvaluationContext>)evaluateJsonObject:(id)jsonObject rootJsonObject:(id)rootJsonObject configuration:(SMJConfiguration *)configuration forUpdate:(BOOL)forUpdate resultLimit:(NSUInteger)resultLimit error:(NSError **)error;
+
+
 /**
  *
  * true if this path is definite
@@ -0,0 +1,59 @@
+/*
+ * SMJPathCache.h
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/* Adapted from https://github.com/json-path/JsonPath/blob/master/json-path/src/main/java/com/jayway/jsonpath/spi/cache/LRUCache.java */
+
+
+#import <Foundation/Foundation.h>
+
+#import "SMJPath.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** SMJPathCache
+*/
+#pragma mark - SMJPathCache
+
+@interface SMJPathCache : NSObject
+
+// -- Instance --
++ (instancetype)sharedCache;
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity;
+
+// -- Content --
+- (nullable id <SMJPath>)pathForKey:(NSString *)key;
+- (void)setPath:(id <SMJPath>)path forKey:(NSString *)key;
+
+- (void)purge;
+
+// -- Properties --
+@property NSUInteger capacity; // 0 disable the cache.
+
+@property (readonly) NSUInteger count;
+@property (readonly) NSUInteger hitCount;
+@property (readonly) NSUInteger missCount;
+
+@end
+
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,334 @@
+/*
+ * SMJPathCache.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/* Adapted from https://github.com/json-path/JsonPath/blob/master/json-path/src/main/java/com/jayway/jsonpath/spi/cache/LRUCache.java */
+
+
+#include <pthread.h>
+
+#import "SMJPathCache.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** Defines
+*/
+#pragma mark - Defines
+
+#define SMJPathCacheDefaultCapacity 400
+
+
+
+/*
+** SMJPathCacheEntry
+*/
+#pragma mark - SMJPathCacheEntry
+
+@interface SMJPathCacheEntry : NSObject
+{
+@public
+	NSString		*_key;
+	id <SMJPath>	_path;
+	
+	SMJPathCacheEntry					*_next;
+	__unsafe_unretained SMJPathCacheEntry	*_prev;
+}
+@end
+
+@implementation SMJPathCacheEntry
+@end
+
+
+
+/*
+** SMJPathCache
+*/
+#pragma mark - SMJPathCache
+
+@implementation SMJPathCache
+{
+	pthread_mutex_t _lock;
+	
+	NSMutableDictionary <NSString *, SMJPathCacheEntry *> *_entries;
+	
+	// Most recently used first.
+	SMJPathCacheEntry					*_head;
+	__unsafe_unretained SMJPathCacheEntry	*_tail;
+	
+	NSUInteger _capacity;
+	NSUInteger _hitCount;
+	NSUInteger _missCount;
+}
+
+
+/*
+** SMJPathCache - Instance
+*/
+#pragma mark - SMJPathCache - Instance
+
++ (instancetype)sharedCache
+{
+	static dispatch_once_t	onceToken;
+	static SMJPathCache		*sharedCache;
+	
+	dispatch_once(&onceToken, ^{
+		sharedCache = [[SMJPathCache alloc] initWithCapacity:SMJPathCacheDefaultCapacity];
+	});
+	
+	return sharedCache;
+}
+
+- (instancetype)init
+{
+	return [self initWithCapacity:SMJPathCacheDefaultCapacity];
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity
+{
+	self = [super init];
+	
+	if (self)
+	{
+		pthread_mutex_init(&_lock, NULL);
+		_entries = [[NSMutableDictionary alloc] init];
+		_capacity = capacity;
+	}
+	
+	return self;
+}
+
+- (void)dealloc
+{
+	pthread_mutex_destroy(&_lock);
+}
+
+
+/*
+** SMJPathCache - Content
+*/
+#pragma mark - SMJPathCache - Content
+
+- (nullable id <SMJPath>)pathForKey:(NSString *)key
+{
+	id <SMJPath> result = nil;
+	
+	pthread_mutex_lock(&_lock);
+	{
+		SMJPathCacheEntry *entry = _entries[key];
+		
+		if (entry)
+		{
+			[self moveEntryToHead:entry];
+			
+			result = entry->_path;
+			_hitCount++;
+		}
+		else
+			_missCount++;
+	}
+	pthread_mutex_unlock(&_lock);
+	
+	return result;
+}
+
+- (void)setPath:(id <SMJPath>)path forKey:(NSString *)key
+{
+	pthread_mutex_lock(&_lock);
+	{
+		if (_capacity > 0)
+		{
+			SMJPathCacheEntry *entry = _entries[key];
+			
+			if (entry)
+			{
+				entry->_path = path;
+				[self moveEntryToHead:entry];
+			}
+			else
+			{
+				entry = [[SMJPathCacheEntry alloc] init];
+				
+				entry->_key = [key copy];
+				entry->_path = path;
+				
+				_entries[entry->_key] = entry;
+				[self insertEntryAtHead:entry];
+				
+				[self trimToCapacity];
+			}
+		}
+	}
+	pthread_mutex_unlock(&_lock);
+}
+
+- (void)purge
+{
+	pthread_mutex_lock(&_lock);
+	{
+		[self removeAllEntries];
+	}
+	pthread_mutex_unlock(&_lock);
+}
+
+
+/*
+** SMJPathCache - Properties
+*/
+#pragma mark - SMJPathCache - Properties
+
+- (NSUInteger)capacity
+{
+	NSUInteger result;
+	
+	pthread_mutex_lock(&_lock);
+	result = _capacity;
+	pthread_mutex_unlock(&_lock);
+	
+	return result;
+}
+
+- (void)setCapacity:(NSUInteger)capacity
+{
+	pthread_mutex_lock(&_lock);
+	{
+		_capacity = capacity;
+		[self trimToCapacity];
+	}
+	pthread_mutex_unlock(&_lock);
+}
+
+- (NSUInteger)count
+{
+	NSUInteger result;
+	
+	pthread_mutex_lock(&_lock);
+	result = _entries.count;
+	pthread_mutex_unlock(&_lock);
+	
+	return result;
+}
+
+- (NSUInteger)hitCount
+{
+	NSUInteger result;
+	
+	pthread_mutex_lock(&_lock);
+	result = _hitCount;
+	pthread_mutex_unlock(&_lock);
+	
+	return result;
+}
+
+- (NSUInteger)missCount
+{
+	NSUInteger result;
+	
+	pthread_mutex_lock(&_lock);
+	result = _missCount;
+	pthread_mutex_unlock(&_lock);
+	
+	return result;
+}
+
+
+/*
+** SMJPathCache - Helpers
+*/
+#pragma mark - SMJPathCache - Helpers
+
+// > All the helpers below need to be called with _lock held.
+
+- (void)insertEntryAtHead:(SMJPathCacheEntry *)entry
+{
+	entry->_prev = nil;
+	entry->_next = _head;
+	
+	if (_head)
+		_head->_prev = entry;
+	else
+		_tail = entry;
+	
+	_head = entry;
+}
+
+- (void)unlinkEntry:(SMJPathCacheEntry *)entry
+{
+	SMJPathCacheEntry *retained = entry; // Keep it alive while we relink (_head can hold the last strong reference).
+	
+	if (retained->_prev)
+		retained->_prev->_next = retained->_next;
+	else
+		_head = retained->_next;
+	
+	if (retained->_next)
+		retained->_next->_prev = retained->_prev;
+	else
+		_tail = retained->_prev;
+	
+	retained->_next = nil;
+	retained->_prev = nil;
+}
+
+- (void)moveEntryToHead:(SMJPathCacheEntry *)entry
+{
+	if (entry == _head)
+		return;
+	
+	[self unlinkEntry:entry];
+	[self insertEntryAtHead:entry];
+}
+
+- (void)trimToCapacity
+{
+	while (_entries.count > _capacity && _tail)
+	{
+		SMJPathCacheEntry *entry = _tail;
+		
+		[self unlinkEntry:entry];
+		[_entries removeObjectForKey:entry->_key];
+	}
+}
+
+- (void)removeAllEntries
+{
+	// Break the chain iteratively, to avoid a deep recursive release of the entries.
+	SMJPathCacheEntry *entry = _head;
+	
+	while (entry)
+	{
+		SMJPathCacheEntry *next = entry->_next;
+		
+		entry->_next = nil;
+		entry->_prev = nil;
+		
+		entry = next;
+	}
+	
+	_head = nil;
+	_tail = nil;
+	
+	[_entries removeAllObjects];
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
@@ -38,6 +38,10 @@ NS_ASSUME_NONNULL_BEGIN
 // -- Compiler --
 + (nullable id <SMJPath>)compilePathString:(NSString *)path error:(NSError **)error;
 
+// > Return the same compiled path for the same string while it's alive. Used for the paths embedded in other paths (filter operands,
+//   function parameters): their values are cached per evaluation by path identity, so identical paths share one evaluation.
++ (nullable id <SMJPath>)compileSharedPathString:(NSString *)path error:(NSError **)error;
+
 @end
 
 
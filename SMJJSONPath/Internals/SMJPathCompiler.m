@@ -20,6 +20,8 @@
 /* Adapted from https://github.com/json-path/JsonPath/blob/master/json-path/src/main/java/com/jayway/jsonpath/internal/path/PathCompiler.java */
 
 
+#include <pthread.h>
+
 #import "SMJPathCompiler.h"
 
 #import "SMJUtils.h"
@@ -95,6 +97,16 @@ NS_ASSUME_NONNULL_BEGIN
 
 
 
+/*
+** Globals
+*/
+#pragma mark - Globals
+
+static pthread_mutex_t						gSharedPathsLock = PTHREAD_MUTEX_INITIALIZER;
+static NSMapTable <NSString *, id <SMJPath>>	*gSharedPaths;
+
+
+
 /*
 ** SMJPathCompiler
 */
@@ -151,6 +163,46 @@ NS_ASSUME_NONNULL_BEGIN
 	return [[[SMJPathCompiler alloc] initWithPath:ci] compileWithError:error];
 }
 
++ (nullable id <SMJPath>)compileSharedPathString:(NSString *)path error:(NSError **)error
+{
+	id <SMJPath> result = nil;
+	
+	// Search shared paths.
+	pthread_mutex_lock(&gSharedPathsLock);
+	{
+		result = [gSharedPaths objectForKey:path];
+	}
+	pthread_mutex_unlock(&gSharedPathsLock);
+	
+	if (result)
+		return result;
+	
+	// Compile. Compiled paths are immutable, so they can be shared by any number of owners.
+	result = [self compilePathString:path error:error];
+	
+	if (!result)
+		return nil;
+	
+	// Share. Values are weak: a path is shared while one of its owners is alive.
+	pthread_mutex_lock(&gSharedPathsLock);
+	{
+		id <SMJPath> existing = [gSharedPaths objectForKey:path];
+		
+		if (existing)
+			result = existing;
+		else
+		{
+			if (!gSharedPaths)
+				gSharedPaths = [NSMapTable strongToWeakObjectsMapTable];
+			
+			[gSharedPaths setObject:result forKey:[path copy]];
+		}
+	}
+	pthread_mutex_unlock(&gSharedPathsLock);
+	
+	return result;
+}
+
 - (nullable id <SMJPath>)compileWithError:(NSError **)error
 {
 	SMJRootPathToken *root = [self readContextTokenWithError:error];
@@ -570,7 +622,7 @@ NS_ASSUME_NONNULL_BEGIN
 								
 							case SMJParamTypePath:
 							{
-								id <SMJPath> path = [SMJPathCompiler compilePathString:parameter error:error];
+								id <SMJPath> path = [SMJPathCompiler compileSharedPathString:parameter error:error];
 								
 								if (!path)
 									return nil;
@@ -22,14 +22,28 @@
 
 #import <Foundation/Foundation.h>
 
-#import "SMJPathRef.h"
-#import "SMJEvaluationContext.h"
-#import "SMJParameter.h"
+#import <SMJJSONPath/SMJParameter.h>
 
 
 NS_ASSUME_NONNULL_BEGIN
 
 
+/*
+** Forward
+*/
+#pragma mark - Forward
+
+@class SMJPathRef;
+@protocol SMJEvaluationContext;
+
+
+
+/*
+** SMJPathFunction
+*/
+#pragma mark - SMJPathFunction
+
+
 /**
  * Defines the pattern by which a function can be executed over the result set in the particular path
  * being grabbed.  The Function's input is the content of the data from the json path selector and its output
@@ -44,7 +58,8 @@ NS_ASSUME_NONNULL_BEGIN
  * Invoke the function and output a JSON object (or scalar) value which will be the result of executing the path
  *
  * @param currentPath
- *      The current path location inclusive of the function name
+ *      The current path location inclusive of the function name. Only rendered when the evaluation reports paths
+ *      (SMJOptionAsPathList, or evaluation listeners): it's an empty string otherwise
  *
  * @param parentPath
  *      The path location above the current function
@@ -57,6 +72,14 @@ NS_ASSUME_NONNULL_BEGIN
  *
  */
 - (nullable id)invokeWithCurrentPathString:(NSString *)currentPath parentPath:(SMJPathRef *)parentPath jsonObject:(id)jsonObject evaluationContext:(id <SMJEvaluationContext>)context parameters:(nullable NSArray <SMJParameter *> *)parameters error:(NSError **)error;
+
+@optional
+
+/**
+ * Return YES if the function doesn't keep any state between invocations. In this case, one instance is created when
+ * the path is compiled, and invoked by all evaluations, possibly at the same time. Else, an instance is created by evaluation.
+ */
++ (BOOL)isShareable;
 																																
 @end
 
@@ -52,7 +52,14 @@ typedef _Nonnull id (^SMJPathRefMapper)(id object, SMJConfiguration *configurati
 
 + (instancetype)pathRefWithObject:(id)object property:(NSString *)property;
 + (instancetype)pathRefWithObject:(id)object properties:(NSArray <NSString *> *)properties;
-+ (instancetype)pathRefWithObject:(id)object item:(id)item;
++ (instancetype)pathRefWithObject:(id)object index:(NSUInteger)index;
+
+// -- Location --
+// > Steps from the root to the container the reference points into (see SMJPathSegmentComponents). Only set by evaluations recording update locations.
+@property (nullable) NSArray *location;
+
+// > Enumerate the JSON Pointers (RFC 6901) of the referenced values, with their current value (nil if missing). Does nothing without location.
+- (void)enumerateReferencedValuesUsingBlock:(void (^)(NSString *jsonPointer, id _Nullable value))block;
 
 // -- Operations --
 - (BOOL)setObject:(id)newVal configuration:(SMJConfiguration *)configuration error:(NSError **)error;
@@ -61,6 +68,43 @@ typedef _Nonnull id (^SMJPathRefMapper)(id object, SMJConfiguration *configurati
 - (BOOL)addObject:(id)newVal configuration:(SMJConfiguration *)configuration error:(NSError **)error;
 - (BOOL)putObject:(id)value forKey:(NSString *)key configuration:(SMJConfiguration *)configuration error:(NSError **)error;
 - (BOOL)renameKey:(NSString *)oldKey toKey:(NSString *)newKey configuration:(SMJConfiguration *)configuration error:(NSError **)error;
+- (BOOL)insertObject:(id)newVal configuration:(SMJConfiguration *)configuration error:(NSError **)error; // Array items are inserted before the referenced index (which can be the array count), properties are set.
+
+// -- Batch --
+// > Delete all path refs. Array items are removed at the end, in one pass per array, so indexes of the remaining path refs stay valid.
++ (BOOL)deletePathRefs:(NSArray <SMJPathRef *> *)pathRefs configuration:(SMJConfiguration *)configuration error:(NSError **)error;
+
+@end
+
+
+
+/*
+** SMJCopyOnWriteDocument
+*/
+#pragma mark - SMJCopyOnWriteDocument
+
+// A copy on write document makes path refs point into a copy of a JSON object, where only the containers on the way to the referenced values are copied.
+// Other values are shared with the original JSON object, which is not modified. A container appearing several times in the original has a single copy.
+
+@interface SMJCopyOnWriteDocument : NSObject
+
+// -- Instance --
+- (instancetype)initWithRootJsonObject:(id)rootJsonObject;
+
+@property (readonly) id rootJsonObject; // Root of the copy.
+
+// -- Root --
+// > Replace the whole copy, forgetting the containers copied so far. The new root has to be mutable to be updated by following operations. It can only be committed when it's the same kind of container as the original root.
+- (void)replaceRootJsonObject:(id)rootJsonObject;
+
+// -- Prepare --
+// > Copy the containers on the way to the path ref location (and the referenced value if copyTarget is YES, for operations modifying it in place), and make the path ref point to the copy.
+// > The path ref has to come from an evaluation recording update locations. Path ref operations can then be applied.
+- (BOOL)preparePathRef:(SMJPathRef *)pathRef copyTarget:(BOOL)copyTarget error:(NSError **)error;
+
+// -- Commit --
+// > Write the content of the modified copies back into the original containers, which have to be mutable. Nothing is written if it fails.
+- (BOOL)commitWithError:(NSError **)error;
 
 @end
 
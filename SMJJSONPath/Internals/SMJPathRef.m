@@ -22,6 +22,8 @@
 
 #import "SMJPathRef.h"
 
+#import "SMJUtils.h"
+
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -61,7 +63,8 @@ NS_ASSUME_NONNULL_BEGIN
 @end
 
 @interface SMJArrayIndexPathRef : SMJPathRef
-- (instancetype)initWithObject:(id)object item:(id)item;
+- (instancetype)initWithObject:(id)object index:(NSUInteger)index;
+@property (readonly) NSUInteger index;
 @end
 
 
@@ -73,7 +76,10 @@ NS_ASSUME_NONNULL_BEGIN
 
 @interface SMJPathRef ()
 
-@property (readonly) id parent;
+@property (strong) id parent;
+
+- (nullable id)targetKey; // Key of the referenced value in parent: NSString, NSNumber, or nil if it's not a single value.
+- (nullable NSArray *)referencedKeys; // Keys of the referenced values in parent, or nil if the parent itself is referenced.
 
 @end
 
@@ -118,9 +124,9 @@ NS_ASSUME_NONNULL_BEGIN
 	return [[SMJObjectMultiPropertyPathRef alloc] initWithObject:object properties:properties];
 }
 
-+ (instancetype)pathRefWithObject:(id)object item:(id)item
++ (instancetype)pathRefWithObject:(id)object index:(NSUInteger)index
 {
-	return [[SMJArrayIndexPathRef alloc] initWithObject:object item:item];
+	return [[SMJArrayIndexPathRef alloc] initWithObject:object index:index];
 }
 
 - (instancetype)initWithParent:(id)parent
@@ -184,6 +190,118 @@ NS_ASSUME_NONNULL_BEGIN
 	return NO;
 }
 
+- (BOOL)insertObject:(id)newVal configuration:(SMJConfiguration *)configuration error:(NSError **)error
+{
+	// Must be overwritten.
+	NSAssert(NO, @"must be overwrittent");
+	return NO;
+}
+
+- (nullable id)targetKey
+{
+	return nil;
+}
+
+- (nullable NSArray *)referencedKeys
+{
+	return nil;
+}
+
+
+
+/*
+** SMJPathRef - Location
+*/
+#pragma mark - SMJPathRef - Location
+
+- (void)enumerateReferencedValuesUsingBlock:(void (^)(NSString *jsonPointer, id _Nullable value))block
+{
+	NSArray *location = self.location;
+	
+	if (!location)
+		return;
+	
+	NSArray *keys = [self referencedKeys];
+	
+	if (!keys)
+	{
+		block([SMJUtils jsonPointerWithComponents:location], _parent);
+		return;
+	}
+	
+	for (id key in keys)
+	{
+		id value = nil;
+		
+		if ([key isKindOfClass:[NSNumber class]])
+		{
+			NSUInteger index = [key unsignedIntegerValue];
+			
+			if ([_parent isKindOfClass:[NSArray class]] && index < [(NSArray *)_parent count])
+				value = [(NSArray *)_parent objectAtIndex:index];
+		}
+		else if ([_parent isKindOfClass:[NSDictionary class]])
+			value = [(NSDictionary *)_parent objectForKey:key];
+		
+		block([SMJUtils jsonPointerWithComponents:[location arrayByAddingObject:key]], value);
+	}
+}
+
+
+
+/*
+** SMJPathRef - Batch
+*/
+#pragma mark - SMJPathRef - Batch
+
++ (BOOL)deletePathRefs:(NSArray <SMJPathRef *> *)pathRefs configuration:(SMJConfiguration *)configuration error:(NSError **)error
+{
+	NSMapTable <NSMutableArray *, NSMutableIndexSet *> *arraysIndexes = nil;
+	
+	for (SMJPathRef *pathRef in pathRefs)
+	{
+		if ([pathRef isKindOfClass:[SMJArrayIndexPathRef class]] == NO)
+		{
+			if ([pathRef deleteWithConfiguration:configuration error:error] == NO)
+				return NO;
+			
+			continue;
+		}
+		
+		// Group array items by array.
+		NSMutableArray	*parent = [pathRef arrayWithParentWithError:error];
+		NSUInteger		index = ((SMJArrayIndexPathRef *)pathRef).index;
+		
+		if (!parent)
+			return NO;
+		
+		if (index >= parent.count)
+		{
+			SMSetError(error, 1, @"Index %lu is out of bounds", (unsigned long)index);
+			return NO;
+		}
+		
+		if (!arraysIndexes)
+			arraysIndexes = [NSMapTable mapTableWithKeyOptions:(NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality) valueOptions:NSPointerFunctionsStrongMemory];
+		
+		NSMutableIndexSet *indexes = [arraysIndexes objectForKey:parent];
+		
+		if (!indexes)
+		{
+			indexes = [[NSMutableIndexSet alloc] init];
+			[arraysIndexes setObject:indexes forKey:parent];
+		}
+		
+		[indexes addIndex:index];
+	}
+	
+	// Compact each array once.
+	for (NSMutableArray *parent in arraysIndexes)
+		[parent removeObjectsAtIndexes:[arraysIndexes objectForKey:parent]];
+	
+	return YES;
+}
+
 
 
 /*
@@ -313,6 +431,11 @@ NS_ASSUME_NONNULL_BEGIN
 	return YES;
 }
 
+- (BOOL)insertObject:(id)newVal configuration:(SMJConfiguration *)configuration error:(NSError **)error
+{
+	return YES;
+}
+
 @end
 
 
@@ -386,6 +509,12 @@ NS_ASSUME_NONNULL_BEGIN
 	return [self renameInMap:parent fromKey:oldKey toKey:newKey configuration:configuration error:error];
 }
 
+- (BOOL)insertObject:(id)newVal configuration:(SMJConfiguration *)configuration error:(NSError **)error
+{
+	SMSetError(error, 1, @"Invalid insert operation");
+	return NO;
+}
+
 @end
 
 
@@ -493,6 +622,20 @@ NS_ASSUME_NONNULL_BEGIN
 	return [self renameInMap:target fromKey:oldKey toKey:newKey configuration:configuration error:error];
 }
 
+- (BOOL)insertObject:(id)newVal configuration:(SMJConfiguration *)configuration error:(NSError **)error
+{
+	return [self setObject:newVal configuration:configuration error:error];
+}
+
+- (nullable id)targetKey
+{
+	return _property;
+}
+
+- (nullable NSArray *)referencedKeys
+{
+	return @[ _property ];
+}
 
 @end
 
@@ -579,28 +722,47 @@ NS_ASSUME_NONNULL_BEGIN
 	return NO;
 }
 
+- (BOOL)insertObject:(id)newVal configuration:(SMJConfiguration *)configuration error:(NSError **)error
+{
+	SMSetError(error, 1, @"Insert can not be performed to multiple properties");
+	return NO;
+}
+
+- (nullable NSArray *)referencedKeys
+{
+	return _properties;
+}
+
 @end
 
 
 #pragma mark SMJArrayIndexPathRef
 
 @implementation SMJArrayIndexPathRef
-{
-	id _item;
-}
 
-- (instancetype)initWithObject:(id)object item:(id)item
+- (instancetype)initWithObject:(id)object index:(NSUInteger)index
 {
 	self = [super initWithParent:object];
 	
 	if (self)
 	{
-		_item = item;
+		_index = index;
 	}
 	
 	return self;
 }
 
+- (nullable id)itemWithParent:(NSArray *)parent error:(NSError **)error
+{
+	if (_index >= parent.count)
+	{
+		SMSetError(error, 1, @"Index %lu is out of bounds", (unsigned long)_index);
+		return nil;
+	}
+	
+	return [parent objectAtIndex:_index];
+}
+
 - (BOOL)setObject:(id)newVal configuration:(SMJConfiguration *)configuration error:(NSError **)error
 {
 	NSMutableArray *parent = [self arrayWithParentWithError:error];
@@ -608,12 +770,10 @@ NS_ASSUME_NONNULL_BEGIN
 	if (!parent)
 		return NO;
 	
-	NSInteger index = [parent indexOfObjectIdenticalTo:_item];
-	
-	if (index == NSNotFound)
+	if (![self itemWithParent:parent error:error])
 		return NO;
 	
-	[parent replaceObjectAtIndex:index withObject:newVal];
+	[parent replaceObjectAtIndex:_index withObject:newVal];
 	
 	return YES;
 }
@@ -625,17 +785,14 @@ NS_ASSUME_NONNULL_BEGIN
 	if (!parent)
 		return NO;
 	
-	NSInteger index = [parent indexOfObjectIdenticalTo:_item];
+	id currentValue = [self itemWithParent:parent error:error];
 	
-	if (index == NSNotFound)
+	if (!currentValue)
 		return NO;
 
-	id currentValue = [parent objectAtIndex:index];
 	id newValue = mapper(currentValue, configuration);
 
-	[parent replaceObjectAtIndex:index withObject:newValue];
-	
-	_item = newValue;
+	[parent replaceObjectAtIndex:_index withObject:newValue];
 	
 	return YES;
 }
@@ -647,14 +804,10 @@ NS_ASSUME_NONNULL_BEGIN
 	if (!parent)
 		return NO;
 	
-	NSInteger index = [parent indexOfObjectIdenticalTo:_item];
-
-	if (index == NSNotFound)
+	if (![self itemWithParent:parent error:error])
 		return NO;
 	
-	[parent removeObjectAtIndex:index];
-	
-	_item = nil;
+	[parent removeObjectAtIndex:_index];
 	
 	return YES;
 }
@@ -666,12 +819,12 @@ NS_ASSUME_NONNULL_BEGIN
 	if (!parent)
 		return NO;
 	
-	NSInteger index = [parent indexOfObjectIdenticalTo:_item];
+	id item = [self itemWithParent:parent error:error];
 	
-	if (index == NSNotFound)
+	if (!item)
 		return NO;
 	
-	NSMutableArray *target =  [self arrayWithObject:[parent objectAtIndex:index] error:error];
+	NSMutableArray *target =  [self arrayWithObject:item error:error];
 	
 	if (!target)
 		return NO;
@@ -688,12 +841,12 @@ NS_ASSUME_NONNULL_BEGIN
 	if (!parent)
 		return NO;
 	
-	NSInteger index = [parent indexOfObjectIdenticalTo:_item];
-
-	if (index == NSNotFound)
+	id item = [self itemWithParent:parent error:error];
+	
+	if (!item)
 		return NO;
 	
-	NSMutableDictionary *target = [self dictionaryWithObject:[parent objectAtIndex:index] error:error];
+	NSMutableDictionary *target = [self dictionaryWithObject:item error:error];
 	
 	if (!target)
 		return NO;
@@ -710,16 +863,320 @@ NS_ASSUME_NONNULL_BEGIN
 	if (!parent)
 		return NO;
 	
-	NSInteger index = [parent indexOfObjectIdenticalTo:_item];
+	id target = [self itemWithParent:parent error:error];
 	
-	if (index == NSNotFound)
+	if (!target)
 		return NO;
 	
-	id target = [parent objectAtIndex:index];
-	
 	return [self renameInMap:target fromKey:oldKey toKey:newKey configuration:configuration error:error];
 }
 
+- (BOOL)insertObject:(id)newVal configuration:(SMJConfiguration *)configuration error:(NSError **)error
+{
+	NSMutableArray *parent = [self arrayWithParentWithError:error];
+	
+	if (!parent)
+		return NO;
+	
+	if (_index > parent.count)
+	{
+		SMSetError(error, 1, @"Index %lu is out of bounds", (unsigned long)_index);
+		return NO;
+	}
+	
+	[parent insertObject:newVal atIndex:_index];
+	
+	return YES;
+}
+
+- (nullable id)targetKey
+{
+	return @(_index);
+}
+
+- (nullable NSArray *)referencedKeys
+{
+	return @[ @(_index) ];
+}
+
+@end
+
+
+
+
+/*
+** SMJCopyOnWriteDocument
+*/
+#pragma mark - SMJCopyOnWriteDocument
+
+@implementation SMJCopyOnWriteDocument
+{
+	id _originalRootJsonObject;
+	
+	NSMapTable *_originals; // copy -> original.
+	NSMapTable *_copies; // original -> copy.
+}
+
+
+/*
+** SMJCopyOnWriteDocument - Instance
+*/
+#pragma mark - SMJCopyOnWriteDocument - Instance
+
+- (instancetype)initWithRootJsonObject:(id)rootJsonObject
+{
+	self = [super init];
+	
+	if (self)
+	{
+		NSPointerFunctionsOptions options = (NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality);
+		
+		_originals = [[NSMapTable alloc] initWithKeyOptions:options valueOptions:options capacity:0];
+		_copies = [[NSMapTable alloc] initWithKeyOptions:options valueOptions:options capacity:0];
+		
+		_originalRootJsonObject = rootJsonObject;
+		_rootJsonObject = [self copyOfValue:rootJsonObject];
+	}
+	
+	return self;
+}
+
+
+/*
+** SMJCopyOnWriteDocument - Root
+*/
+#pragma mark - SMJCopyOnWriteDocument - Root
+
+- (void)replaceRootJsonObject:(id)rootJsonObject
+{
+	// Forget the copies made so far: they are not part of the document anymore, and their originals shouldn't be written on commit.
+	[_originals removeAllObjects];
+	[_copies removeAllObjects];
+	
+	// The new root is handled as a copy, so following operations can update it. Its content is written into the original root on commit, when they are the same kind of container.
+	BOOL sameDictionaries = ([rootJsonObject isKindOfClass:[NSDictionary class]] && [_originalRootJsonObject isKindOfClass:[NSDictionary class]]);
+	BOOL sameArrays = ([rootJsonObject isKindOfClass:[NSArray class]] && [_originalRootJsonObject isKindOfClass:[NSArray class]]);
+	
+	if (sameDictionaries || sameArrays)
+	{
+		[_copies setObject:rootJsonObject forKey:_originalRootJsonObject];
+		[_originals setObject:_originalRootJsonObject forKey:rootJsonObject];
+	}
+	else if ([rootJsonObject isKindOfClass:[NSDictionary class]] || [rootJsonObject isKindOfClass:[NSArray class]])
+		[_originals setObject:rootJsonObject forKey:rootJsonObject];
+	
+	_rootJsonObject = rootJsonObject;
+}
+
+
+/*
+** SMJCopyOnWriteDocument - Prepare
+*/
+#pragma mark - SMJCopyOnWriteDocument - Prepare
+
+- (BOOL)preparePathRef:(SMJPathRef *)pathRef copyTarget:(BOOL)copyTarget error:(NSError **)error
+{
+	if (pathRef == [SMJPathRef pathRefNull])
+		return YES;
+	
+	NSArray *location = pathRef.location;
+	
+	if (!location)
+	{
+		SMSetError(error, 1, @"Invalid operation: this path result can't be updated in a copy.");
+		return NO;
+	}
+	
+	// Walk the copy, copying containers on the way.
+	id container = _rootJsonObject;
+	
+	for (id component in location)
+	{
+		container = [self copyOfChild:component container:container error:error];
+		
+		if (!container)
+			return NO;
+	}
+	
+	pathRef.parent = container;
+	
+	// Copy the referenced value too, for operations modifying it in place.
+	id targetKey = (copyTarget ? [pathRef targetKey] : nil);
+	
+	if (targetKey && ![self copyOfChild:targetKey container:container error:error])
+		return NO;
+	
+	return YES;
+}
+
+
+/*
+** SMJCopyOnWriteDocument - Commit
+*/
+#pragma mark - SMJCopyOnWriteDocument - Commit
+
+- (BOOL)commitWithError:(NSError **)error
+{
+	// A root replaced by another kind of value can't be written into the original root.
+	if (_rootJsonObject != _originalRootJsonObject && [_originals objectForKey:_rootJsonObject] != _originalRootJsonObject)
+	{
+		SMSetError(error, 1, @"Invalid operation: the root can't be replaced in place by another kind of value.");
+		return NO;
+	}
+	
+	NSMutableArray *originals = [[NSMutableArray alloc] init];
+	NSMutableArray *contents = [[NSMutableArray alloc] init];
+	
+	// Compute the new content of each original container, with original children in place of their copies.
+	for (id copy in _originals)
+	{
+		id		original = [_originals objectForKey:copy];
+		id		content;
+		BOOL	changed;
+		
+		if ([copy isKindOfClass:[NSDictionary class]])
+		{
+			NSDictionary		*dictionary = copy;
+			NSMutableDictionary	*newContent = [[NSMutableDictionary alloc] initWithCapacity:dictionary.count];
+			
+			changed = (dictionary.count != [original count]);
+			
+			for (id key in dictionary)
+			{
+				id value = dictionary[key];
+				id originalValue = ([_originals objectForKey:value] ?: value);
+				
+				newContent[key] = originalValue;
+				changed = changed || (((NSDictionary *)original)[key] != originalValue);
+			}
+			
+			content = newContent;
+		}
+		else
+		{
+			NSArray			*array = copy;
+			NSMutableArray	*newContent = [[NSMutableArray alloc] initWithCapacity:array.count];
+			NSUInteger		idx = 0;
+			
+			changed = (array.count != [original count]);
+			
+			for (id value in array)
+			{
+				id originalValue = ([_originals objectForKey:value] ?: value);
+				
+				[newContent addObject:originalValue];
+				changed = changed || (idx >= [original count] || ((NSArray *)original)[idx] != originalValue);
+				idx++;
+			}
+			
+			content = newContent;
+		}
+		
+		if (changed == NO)
+			continue;
+		
+		if ([original isKindOfClass:[NSMutableDictionary class]] == NO && [original isKindOfClass:[NSMutableArray class]] == NO)
+		{
+			SMSetError(error, 1, @"Invalid operation: containers should be mutable.");
+			return NO;
+		}
+		
+		[originals addObject:original];
+		[contents addObject:content];
+	}
+	
+	// Write. This can't fail.
+	[originals enumerateObjectsUsingBlock:^(id original, NSUInteger idx, BOOL *stop) {
+		if ([original isKindOfClass:[NSMutableDictionary class]])
+			[(NSMutableDictionary *)original setDictionary:contents[idx]];
+		else
+			[(NSMutableArray *)original setArray:contents[idx]];
+	}];
+	
+	return YES;
+}
+
+
+/*
+** SMJCopyOnWriteDocument - Helpers
+*/
+#pragma mark - SMJCopyOnWriteDocument - Helpers
+
+- (id)copyOfValue:(id)value
+{
+	if ([value isKindOfClass:[NSDictionary class]] == NO && [value isKindOfClass:[NSArray class]] == NO)
+		return value;
+	
+	// A container shared by several parts of the document keeps a single copy.
+	id copy = [_copies objectForKey:value];
+	
+	if (copy)
+		return copy;
+	
+	copy = [value mutableCopy];
+	
+	[_copies setObject:copy forKey:value];
+	[_originals setObject:value forKey:copy];
+	
+	return copy;
+}
+
+- (nullable id)copyOfChild:(id)key container:(id)container error:(NSError **)error
+{
+	id child;
+	id copy;
+	
+	if ([key isKindOfClass:[NSString class]] && [container isKindOfClass:[NSMutableDictionary class]] && [_originals objectForKey:container])
+	{
+		child = [(NSMutableDictionary *)container objectForKey:key];
+		
+		if (!child)
+		{
+			SMSetError(error, 2, @"Invalid operation: no value for key %@.", key);
+			return nil;
+		}
+		
+		if ([_originals objectForKey:child])
+			return child;
+		
+		copy = [self copyOfValue:child];
+		
+		if (copy != child)
+			[(NSMutableDictionary *)container setObject:copy forKey:key];
+	}
+	else if ([key isKindOfClass:[NSNumber class]] && [container isKindOfClass:[NSMutableArray class]] && [_originals objectForKey:container])
+	{
+		NSMutableArray	*array = container;
+		NSInteger		index = [key integerValue];
+		
+		if (index < 0)
+			index += (NSInteger)array.count;
+		
+		if (index < 0 || index >= (NSInteger)array.count)
+		{
+			SMSetError(error, 3, @"Invalid operation: index %@ is out of bounds.", key);
+			return nil;
+		}
+		
+		child = array[(NSUInteger)index];
+		
+		if ([_originals objectForKey:child])
+			return child;
+		
+		copy = [self copyOfValue:child];
+		
+		if (copy != child)
+			[array replaceObjectAtIndex:(NSUInteger)index withObject:copy];
+	}
+	else
+	{
+		SMSetError(error, 4, @"Invalid operation: the document changed since the evaluation.");
+		return nil;
+	}
+	
+	return copy;
+}
+
 @end
 
 
@@ -0,0 +1,96 @@
+/*
+ * SMJPathSegment.h
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** Types
+*/
+#pragma mark - Types
+
+typedef enum SMJPathSegmentType
+{
+	SMJPathSegmentTypeRoot,			// string
+	SMJPathSegmentTypeProperty,		// ['string']
+	SMJPathSegmentTypeProperties,	// ['string', 'string', ...]
+	SMJPathSegmentTypeIndex,		// [index]
+	SMJPathSegmentTypeFunction		// .string
+} SMJPathSegmentType;
+
+
+/*
+** SMJPathSegment
+*/
+#pragma mark - SMJPathSegment
+
+// A path segment describes one step of the current evaluation path. Segments live on the stack of the token doing the step,
+// and reference their parent segment, so building the current path cost nothing. The path is rendered as a string only
+// when someone needs it (path list, listeners, errors).
+// Objects are not retained: they have to outlive the segment (they are owned by the tokens or the evaluated JSON).
+
+typedef struct SMJPathSegment
+{
+	const struct SMJPathSegment * _Nullable	parent;
+	
+	SMJPathSegmentType type;
+	
+	__unsafe_unretained id _Nullable	object; // NSString for root, property and function. NSArray <NSString *> for properties.
+	NSInteger							index;
+} SMJPathSegment;
+
+
+NS_INLINE SMJPathSegment SMJPathSegmentMakeRoot(NSString *root)
+{
+	return (SMJPathSegment){ .parent = NULL, .type = SMJPathSegmentTypeRoot, .object = root, .index = 0 };
+}
+
+NS_INLINE SMJPathSegment SMJPathSegmentMakeProperty(const SMJPathSegment *parent, NSString *property)
+{
+	return (SMJPathSegment){ .parent = parent, .type = SMJPathSegmentTypeProperty, .object = property, .index = 0 };
+}
+
+NS_INLINE SMJPathSegment SMJPathSegmentMakeProperties(const SMJPathSegment *parent, NSArray <NSString *> *properties)
+{
+	return (SMJPathSegment){ .parent = parent, .type = SMJPathSegmentTypeProperties, .object = properties, .index = 0 };
+}
+
+NS_INLINE SMJPathSegment SMJPathSegmentMakeIndex(const SMJPathSegment *parent, NSInteger index)
+{
+	return (SMJPathSegment){ .parent = parent, .type = SMJPathSegmentTypeIndex, .object = nil, .index = index };
+}
+
+NS_INLINE SMJPathSegment SMJPathSegmentMakeFunction(const SMJPathSegment *parent, NSString *functionName)
+{
+	return (SMJPathSegment){ .parent = parent, .type = SMJPathSegmentTypeFunction, .object = functionName, .index = 0 };
+}
+
+
+// Render the full path, from the root segment to this segment.
+FOUNDATION_EXTERN NSString * SMJPathSegmentString(const SMJPathSegment *segment);
+
+// List the steps from the root segment (excluded) to this segment: NSString for properties, NSNumber for indexes.
+// Return nil if the path contains a multi-properties or a function segment, as they don't address a single value.
+FOUNDATION_EXTERN NSArray * _Nullable SMJPathSegmentComponents(const SMJPathSegment *segment);
+
+
+NS_ASSUME_NONNULL_END
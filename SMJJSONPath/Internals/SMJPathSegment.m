@@ -0,0 +1,133 @@
+/*
+ * SMJPathSegment.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import "SMJPathSegment.h"
+
+#import "SMJUtils.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** SMJPathSegment
+*/
+#pragma mark - SMJPathSegment
+
+NSString * SMJPathSegmentString(const SMJPathSegment *segment)
+{
+	// Collect segments from leaf to root.
+	const SMJPathSegment	*stackSegments[64];
+	const SMJPathSegment	**segments = stackSegments;
+	NSUInteger				count = 0;
+	
+	for (const SMJPathSegment *current = segment; current != NULL; current = current->parent)
+		count++;
+	
+	if (count > sizeof(stackSegments) / sizeof(stackSegments[0]))
+		segments = malloc(count * sizeof(*segments));
+	
+	NSUInteger idx = count;
+	
+	for (const SMJPathSegment *current = segment; current != NULL; current = current->parent)
+		segments[--idx] = current;
+	
+	// Render from root to leaf.
+	NSMutableString *result = [[NSMutableString alloc] init];
+	
+	for (idx = 0; idx < count; idx++)
+	{
+		const SMJPathSegment *current = segments[idx];
+		
+		switch (current->type)
+		{
+			case SMJPathSegmentTypeRoot:
+				[result appendString:current->object];
+				break;
+			
+			case SMJPathSegmentTypeProperty:
+				[result appendString:@"['"];
+				[result appendString:current->object];
+				[result appendString:@"']"];
+				break;
+			
+			case SMJPathSegmentTypeProperties:
+				[result appendString:@"["];
+				[result appendString:[SMJUtils stringByJoiningStrings:current->object delimiter:@", " wrap:@"'"]];
+				[result appendString:@"]"];
+				break;
+			
+			case SMJPathSegmentTypeIndex:
+				[result appendFormat:@"[%ld]", (long)current->index];
+				break;
+			
+			case SMJPathSegmentTypeFunction:
+				[result appendString:@"."];
+				[result appendString:current->object];
+				break;
+		}
+	}
+	
+	if (segments != stackSegments)
+		free(segments);
+	
+	return result;
+}
+
+NSArray * _Nullable SMJPathSegmentComponents(const SMJPathSegment *segment)
+{
+	NSUInteger count = 0;
+	
+	for (const SMJPathSegment *current = segment; current != NULL; current = current->parent)
+	{
+		if (current->type == SMJPathSegmentTypeProperties || current->type == SMJPathSegmentTypeFunction)
+			return nil;
+		
+		if (current->type != SMJPathSegmentTypeRoot)
+			count++;
+	}
+	
+	// Fill from leaf to root.
+	id			stackComponents[32];
+	id __strong	*components = (count > sizeof(stackComponents) / sizeof(stackComponents[0]) ? (id __strong *)calloc(count, sizeof(id)) : stackComponents);
+	NSUInteger	idx = count;
+	
+	for (const SMJPathSegment *current = segment; current != NULL; current = current->parent)
+	{
+		if (current->type == SMJPathSegmentTypeProperty)
+			components[--idx] = current->object;
+		else if (current->type == SMJPathSegmentTypeIndex)
+			components[--idx] = @(current->index);
+	}
+	
+	NSArray *result = [NSArray arrayWithObjects:components count:count];
+	
+	if (components != stackComponents)
+	{
+		for (idx = 0; idx < count; idx++)
+			components[idx] = nil;
+		
+		free(components);
+	}
+	
+	return result;
+}
+
+
+NS_ASSUME_NONNULL_END
@@ -23,6 +23,7 @@
 #import <Foundation/Foundation.h>
 
 #import "SMJEvaluationContextImpl.h"
+#import "SMJPathSegment.h"
 
 
 NS_ASSUME_NONNULL_BEGIN
@@ -51,9 +52,9 @@ typedef enum SMJEvaluationStatus
 
 - (SMJPathToken *)appendTailToken:(SMJPathToken *)token;
 
-- (SMJEvaluationStatus)handleObjectPropertyWithCurrentPathString:(NSString *)currentPath jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context properties:(NSArray <NSString *> *)properties error:(NSError **)error;
+- (SMJEvaluationStatus)handleObjectPropertyWithCurrentPath:(const SMJPathSegment *)currentPath jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context properties:(NSArray <NSString *> *)properties error:(NSError **)error;
 
-- (SMJEvaluationStatus)handleArrayIndex:(NSInteger)index currentPathString:(NSString *)currentPath jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error;
+- (SMJEvaluationStatus)handleArrayIndex:(NSInteger)index currentPath:(const SMJPathSegment *)currentPath jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error;
 
 
 @property (nullable) SMJPathToken *next;
@@ -68,8 +69,11 @@ typedef enum SMJEvaluationStatus
 
 - (NSString *)stringValue;
 
+// Cache derived values and stop the chain from being modified. Called once the path is compiled.
+- (void)freeze;
+
 // Overwrite.
-- (SMJEvaluationStatus)evaluateWithCurrentPath:(NSString *)currentPath parentPathRef:(SMJPathRef *)parent jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error;
+- (SMJEvaluationStatus)evaluateWithCurrentPath:(const SMJPathSegment *)currentPath parentPathRef:(SMJPathRef *)parent jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error;
 
 @property (readonly, getter=isTokenDefinite) BOOL tokenDefinite;
 
@@ -78,4 +82,22 @@ typedef enum SMJEvaluationStatus
 @end
 
 
+
+/*
+** Functions
+*/
+#pragma mark - Functions
+
+FOUNDATION_EXTERN SMJEvaluationStatus SMJPathTokenEvaluateProfiled(SMJPathToken *token, const SMJPathSegment *currentPath, SMJPathRef *parent, id jsonObject, SMJEvaluationContextImpl *context, NSError **error);
+
+// Evaluate a token. Tokens evaluate other tokens through this function, so profiled evaluations can record each of them.
+NS_INLINE SMJEvaluationStatus SMJPathTokenEvaluate(SMJPathToken *token, const SMJPathSegment *currentPath, SMJPathRef *parent, id jsonObject, SMJEvaluationContextImpl *context, NSError **error)
+{
+	if (context.profile)
+		return SMJPathTokenEvaluateProfiled(token, currentPath, parent, jsonObject, context, error);
+	
+	return [token evaluateWithCurrentPath:currentPath parentPathRef:parent jsonObject:jsonObject evaluationContext:context error:error];
+}
+
+
 NS_ASSUME_NONNULL_END
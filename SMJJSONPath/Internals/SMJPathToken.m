@@ -22,8 +22,8 @@
 
 #import "SMJPathToken.h"
 
-#import "SMJUtils.h"
 #import "SMJPathRef.h"
+#import "SMJEvaluationProfileInternal.h"
 
 
 NS_ASSUME_NONNULL_BEGIN
@@ -54,24 +54,27 @@ NS_ASSUME_NONNULL_BEGIN
 	__weak SMJPathToken	*_prev;
 	SMJPathToken		*_next;
 	
-	NSNumber *_definite;
-	NSNumber *_upstreamDefinite;
+	BOOL _frozen;
+	BOOL _definite;
+	BOOL _upstreamDefinite;
 }
 
 - (SMJPathToken *)appendTailToken:(SMJPathToken *)token
 {
+	NSAssert(_frozen == NO, @"can't modify a frozen token");
+	
 	_next = token;
 	_next->_prev = self;
 	
 	return token;
 }
 
-- (SMJEvaluationStatus)handleObjectPropertyWithCurrentPathString:(NSString *)currentPath jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context properties:(NSArray <NSString *> *)properties error:(NSError **)error
+- (SMJEvaluationStatus)handleObjectPropertyWithCurrentPath:(const SMJPathSegment *)currentPath jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context properties:(NSArray <NSString *> *)properties error:(NSError **)error
 {
 	if (properties.count == 1)
 	{
-		NSString *property = properties[0];
-		NSString *evalPath = [SMJUtils stringByConcatenatingStrings:@[ currentPath, @"['", property, @"']" ]];
+		NSString		*property = properties[0];
+		SMJPathSegment	evalPath = SMJPathSegmentMakeProperty(currentPath, property);
 		
 		id propertyVal = [self readObjectProperty:property jsonObject:jsonObject context:context];
 		
@@ -85,24 +88,24 @@ NS_ASSUME_NONNULL_BEGIN
 			
 			if (self.leaf)
 			{
-				if ([context.configuration containsOption:SMJOptionDefaultPathLeafToNull])
+				if ([context containsOption:SMJOptionDefaultPathLeafToNull])
 				{
 					propertyVal = [NSNull null];
 				}
 				else
 				{
-					if ([context.configuration containsOption:SMJOptionRequireProperties] == NO)
+					if ([context containsOption:SMJOptionRequireProperties] == NO)
 						return SMJEvaluationStatusDone;
 					else
 					{
-						SMSetError(error, 1, @"No results for property path: %@", evalPath);
+						SMSetError(error, 1, @"No results for property path: %@", SMJPathSegmentString(&evalPath));
 						return SMJEvaluationStatusError;
 					}
 				}
 			}
 			else
 			{
-				if (!(self.upstreamDefinite && self.tokenDefinite) && ([context.configuration containsOption:SMJOptionRequireProperties] == NO))
+				if (!(self.upstreamDefinite && self.tokenDefinite) && ([context containsOption:SMJOptionRequireProperties] == NO))
 				{
 					// If there is some indefiniteness in the path and properties are not required - we'll ignore
 					// absent property.
@@ -110,7 +113,7 @@ NS_ASSUME_NONNULL_BEGIN
 				}
 				else
 				{
-					SMSetError(error, 2, @"Missing property in path %@", evalPath);
+					SMSetError(error, 2, @"Missing property in path %@", SMJPathSegmentString(&evalPath));
 					return SMJEvaluationStatusError;
 				}
 			}
@@ -120,12 +123,12 @@ NS_ASSUME_NONNULL_BEGIN
 		
 		if (self.leaf)
 		{
-			if ([context addResult:evalPath operation:pathRef jsonObject:propertyVal] == SMJEvaluationContextStatusAborted)
+			if ([context addResult:&evalPath operation:pathRef jsonObject:propertyVal] == SMJEvaluationContextStatusAborted)
 				return SMJEvaluationStatusAborted;
 		}
 		else
 		{
-			SMJEvaluationStatus result = [self.next evaluateWithCurrentPath:evalPath parentPathRef:pathRef jsonObject:propertyVal evaluationContext:context error:error];
+			SMJEvaluationStatus result = SMJPathTokenEvaluate(self.next, &evalPath, pathRef, propertyVal, context, error);
 			
 			if (result == SMJEvaluationStatusError)
 				return SMJEvaluationStatusError;
@@ -135,7 +138,7 @@ NS_ASSUME_NONNULL_BEGIN
 	}
 	else
 	{
-		NSString *evalPath = [NSString stringWithFormat:@"%@[%@]", currentPath, [SMJUtils stringByJoiningStrings:properties delimiter:@", " wrap:@"'"]];
+		SMJPathSegment evalPath = SMJPathSegmentMakeProperties(currentPath, properties);
 		
 		//assert isLeaf() : "non-leaf multi props handled elsewhere";
 		
@@ -151,7 +154,7 @@ NS_ASSUME_NONNULL_BEGIN
 				
 				if (propertyVal == nil)
 				{
-					if ([context.configuration containsOption:SMJOptionDefaultPathLeafToNull])
+					if ([context containsOption:SMJOptionDefaultPathLeafToNull])
 						propertyVal = [NSNull null];
 					else
 						continue;
@@ -159,13 +162,13 @@ NS_ASSUME_NONNULL_BEGIN
 			}
 			else
 			{
-				if ([context.configuration containsOption:SMJOptionDefaultPathLeafToNull])
+				if ([context containsOption:SMJOptionDefaultPathLeafToNull])
 				{
 					propertyVal = [NSNull null];
 				}
-				else if ([context.configuration containsOption:SMJOptionRequireProperties])
+				else if ([context containsOption:SMJOptionRequireProperties])
 				{
-					SMSetError(error, 3, @"Missing property in path %@", evalPath);
+					SMSetError(error, 3, @"Missing property in path %@", SMJPathSegmentString(&evalPath));
 					return SMJEvaluationStatusError;
 				}
 				else
@@ -179,7 +182,7 @@ NS_ASSUME_NONNULL_BEGIN
 		
 		SMJPathRef *pathRef = context.forUpdate ?  [SMJPathRef pathRefWithObject:jsonObject properties:properties] : [SMJPathRef pathRefNull];
 		
-		if ([context addResult:evalPath operation:pathRef jsonObject:merged] == SMJEvaluationContextStatusAborted)
+		if ([context addResult:&evalPath operation:pathRef jsonObject:merged] == SMJEvaluationContextStatusAborted)
 			return SMJEvaluationStatusAborted;
 	}
 	
@@ -222,33 +225,32 @@ NS_ASSUME_NONNULL_BEGIN
 	return nil;
 }
 
-- (SMJEvaluationStatus)handleArrayIndex:(NSInteger)index currentPathString:(NSString *)currentPath jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error
+- (SMJEvaluationStatus)handleArrayIndex:(NSInteger)index currentPath:(const SMJPathSegment *)currentPath jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error
 {
 	if ([jsonObject isKindOfClass:[NSArray class]] == NO)
 		return SMJEvaluationStatusDone;
 	
 	NSArray *obj = jsonObject;
 	
-	NSString 	*evalPath = [SMJUtils stringByConcatenatingStrings:@[ currentPath, @"[", [NSString stringWithFormat:@"%ld", (long)index], @"]" ]];
-	SMJPathRef	*pathRef = context.forUpdate ? [SMJPathRef pathRefWithObject:jsonObject item:obj[index]] : [SMJPathRef pathRefNull];
-	
 	NSInteger effectiveIndex = index < 0 ? obj.count + index : index;
 	
 	if (effectiveIndex < 0 || effectiveIndex >= obj.count)
 		return SMJEvaluationStatusDone;
 
-	id evalHit = obj[effectiveIndex];
+	id				evalHit = obj[effectiveIndex];
+	SMJPathSegment	evalPath = SMJPathSegmentMakeIndex(currentPath, index);
+	SMJPathRef		*pathRef = context.forUpdate ? [SMJPathRef pathRefWithObject:jsonObject index:(NSUInteger)effectiveIndex] : [SMJPathRef pathRefNull];
 	
 	if (self.leaf)
 	{
-		if ([context addResult:evalPath operation:pathRef jsonObject:evalHit] == SMJEvaluationContextStatusAborted)
+		if ([context addResult:&evalPath operation:pathRef jsonObject:evalHit] == SMJEvaluationContextStatusAborted)
 			return SMJEvaluationStatusAborted;
 		
 		return SMJEvaluationStatusDone;
 	}
 	else
 	{
-		return [self.next evaluateWithCurrentPath:evalPath parentPathRef:pathRef jsonObject:evalHit evaluationContext:context error:error];
+		return SMJPathTokenEvaluate(self.next, &evalPath, pathRef, evalHit, context, error);
 	}
 }
 
@@ -265,6 +267,8 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (void)setNext:(nullable SMJPathToken *)next
 {
+	NSAssert(_frozen == NO, @"can't modify a frozen token");
+	
 	_next = next;
 }
 
@@ -280,12 +284,10 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (BOOL)isUpstreamDefinite
 {
-	if (_upstreamDefinite == nil)
-	{
-		_upstreamDefinite = @([self isRoot] || (_prev.tokenDefinite && _prev.upstreamDefinite));
-	}
+	if (_frozen)
+		return _upstreamDefinite;
 	
-	return [_upstreamDefinite boolValue];
+	return ([self isRoot] || (_prev.tokenDefinite && _prev.upstreamDefinite));
 }
 
 - (NSInteger)tokenCount
@@ -304,19 +306,29 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (BOOL)isPathDefinite
 {
-	if (_definite)
-		return [_definite boolValue];
+	if (_frozen)
+		return _definite;
 	
 	BOOL isDefinite = self.tokenDefinite;
 	
 	if (isDefinite && self.leaf == NO)
 		isDefinite = _next.pathDefinite;
 	
-	_definite = @(isDefinite);
-	
 	return isDefinite;
 }
 
+- (void)freeze
+{
+	// Compute the derived values once, while the chain is still owned by the compiler.
+	// After this point, evaluation only read the tokens, so a compiled path can be shared between threads.
+	for (SMJPathToken *token = self; token != nil; token = token->_next)
+	{
+		token->_upstreamDefinite = token.upstreamDefinite;
+		token->_definite = token.pathDefinite;
+		token->_frozen = YES;
+	}
+}
+
 
 - (NSString *)stringValue
 {
@@ -328,7 +340,7 @@ NS_ASSUME_NONNULL_BEGIN
 
 
 // Overwrite
-- (SMJEvaluationStatus)evaluateWithCurrentPath:(NSString *)currentPath parentPathRef:(SMJPathRef *)parent jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error
+- (SMJEvaluationStatus)evaluateWithCurrentPath:(const SMJPathSegment *)currentPath parentPathRef:(SMJPathRef *)parent jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error
 {
 	NSAssert(NO, @"need to be overwritten");
 	return SMJEvaluationStatusError;
@@ -349,4 +361,21 @@ NS_ASSUME_NONNULL_BEGIN
 @end
 
 
+
+/*
+** Functions
+*/
+#pragma mark - Functions
+
+SMJEvaluationStatus SMJPathTokenEvaluateProfiled(SMJPathToken *token, const SMJPathSegment *currentPath, SMJPathRef *parent, id jsonObject, SMJEvaluationContextImpl *context, NSError **error)
+{
+	uint64_t			start = SMJProfileTime();
+	SMJEvaluationStatus	status = [token evaluateWithCurrentPath:currentPath parentPathRef:parent jsonObject:jsonObject evaluationContext:context error:error];
+	
+	[context.profile recordEvaluationOfToken:token duration:SMJProfileTime() - start];
+	
+	return status;
+}
+
+
 NS_ASSUME_NONNULL_END
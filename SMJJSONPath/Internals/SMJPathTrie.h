@@ -0,0 +1,55 @@
+/*
+ * SMJPathTrie.h
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+#import "SMJCompiledPath.h"
+#import "SMJConfiguration.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** SMJPathTrie
+*/
+#pragma mark - SMJPathTrie
+
+// A path trie merges the common prefixes of several compiled paths, so a single walk of a document evaluate all of them.
+// Property, wildcard and single index steps are shared between paths. Deep scans share one walk of the sub-tree.
+// Other steps (filters, slices, functions, ...) are evaluated by each path token, from the point where paths diverge.
+
+@interface SMJPathTrie : NSObject
+
+// -- Instance --
+- (instancetype)initWithPaths:(NSArray <SMJCompiledPath *> *)paths;
+
+// -- Evaluate --
+// > Return one item by path, in the same order than paths: the evaluation context (SMJEvaluationContextImpl) on success, the NSError which stopped the path evaluation on failure.
+- (NSArray *)evaluateJsonObject:(id)jsonObject configuration:(SMJConfiguration *)configuration;
+- (NSArray *)evaluateJsonObjectForUpdate:(id)jsonObject configuration:(SMJConfiguration *)configuration; // Contexts record update operations, with their locations (see SMJCopyOnWriteDocument).
+
+// -- Properties --
+@property (readonly) NSArray <SMJCompiledPath *> *paths;
+@property (readonly) NSUInteger nodeCount;
+
+@end
+
+
+NS_ASSUME_NONNULL_END
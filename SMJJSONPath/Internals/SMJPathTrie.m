@@ -0,0 +1,636 @@
+/*
+ * SMJPathTrie.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import "SMJPathTrie.h"
+
+#import "SMJEvaluationContextImpl.h"
+
+#import "SMJRootPathToken.h"
+#import "SMJPropertyPathToken.h"
+#import "SMJWildcardPathToken.h"
+#import "SMJArrayIndexToken.h"
+#import "SMJScanPathToken.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** Macros
+*/
+#pragma mark - Macros
+
+#define SMSetError(Error, Code, Message) \
+	do { \
+		if (Error)\
+			*(Error) = [NSError errorWithDomain:@"SMJPathTrieErrorDomain" code:(Code) userInfo:@{ NSLocalizedDescriptionKey : (Message) }]; \
+	} while (0) \
+
+
+
+/*
+** Types
+*/
+#pragma mark - Types
+
+typedef enum SMJPathTrieNodeKind
+{
+	SMJPathTrieNodeKindRoot,
+	SMJPathTrieNodeKindProperty,
+	SMJPathTrieNodeKindWildcard,
+	SMJPathTrieNodeKindIndex,
+	SMJPathTrieNodeKindScan,
+	SMJPathTrieNodeKindOther
+} SMJPathTrieNodeKind;
+
+typedef enum SMJPathTrieMemberStatus
+{
+	SMJPathTrieMemberStatusActive,
+	SMJPathTrieMemberStatusStopped,
+	SMJPathTrieMemberStatusFailed
+} SMJPathTrieMemberStatus;
+
+
+
+/*
+** SMJPathTrieNode
+*/
+#pragma mark - SMJPathTrieNode
+
+// A node groups the tokens of all paths doing the same step at the same depth.
+// Scan and other nodes have no children: the rest of their paths are evaluated by the tokens themselves.
+
+@interface SMJPathTrieNode : NSObject
+{
+@public
+	SMJPathTrieNodeKind _kind;
+	id _Nullable		_value; // NSString for root and property, NSNumber for index.
+	
+	NSMutableArray <SMJPathToken *>	*_tokens;
+	NSUInteger						*_pathIndexes;
+	NSUInteger						_memberCount;
+	
+	NSMutableArray <SMJPathTrieNode *>		*_children;
+	NSMutableDictionary <id, SMJPathTrieNode *>	*_childrenByKey;
+}
+
+- (void)addToken:(SMJPathToken *)token pathIndex:(NSUInteger)pathIndex;
+
+@end
+
+@implementation SMJPathTrieNode
+
+- (instancetype)init
+{
+	self = [super init];
+	
+	if (self)
+	{
+		_tokens = [[NSMutableArray alloc] init];
+		_children = [[NSMutableArray alloc] init];
+		_childrenByKey = [[NSMutableDictionary alloc] init];
+	}
+	
+	return self;
+}
+
+- (void)dealloc
+{
+	free(_pathIndexes);
+}
+
+- (void)addToken:(SMJPathToken *)token pathIndex:(NSUInteger)pathIndex
+{
+	_pathIndexes = realloc(_pathIndexes, (_memberCount + 1) * sizeof(NSUInteger));
+	
+	if (!_pathIndexes)
+		abort();
+	
+	_pathIndexes[_memberCount] = pathIndex;
+	_memberCount++;
+	
+	[_tokens addObject:token];
+}
+
+@end
+
+
+
+/*
+** SMJPathTrieEvaluation
+*/
+#pragma mark - SMJPathTrieEvaluation
+
+@interface SMJPathTrieEvaluation : NSObject
+{
+@public
+	NSArray <SMJEvaluationContextImpl *>	*_contexts;
+	SMJPathTrieMemberStatus					*_statuses;
+	NSMutableArray							*_errors; // NSError, or NSNull.
+	
+	BOOL _requireProperties;
+	BOOL _forUpdate;
+}
+@end
+
+@implementation SMJPathTrieEvaluation
+
+- (void)dealloc
+{
+	free(_statuses);
+}
+
+@end
+
+
+
+/*
+** SMJPathTrie
+*/
+#pragma mark - SMJPathTrie
+
+@implementation SMJPathTrie
+{
+	NSArray <SMJCompiledPath *> *_paths;
+	
+	SMJPathTrieNode	*_top;
+	NSUInteger		_nodeCount;
+}
+
+
+/*
+** SMJPathTrie - Instance
+*/
+#pragma mark - SMJPathTrie - Instance
+
+- (instancetype)initWithPaths:(NSArray <SMJCompiledPath *> *)paths
+{
+	self = [super init];
+	
+	if (self)
+	{
+		_paths = [paths copy];
+		_top = [[SMJPathTrieNode alloc] init];
+		
+		[_paths enumerateObjectsUsingBlock:^(SMJCompiledPath * _Nonnull path, NSUInteger pathIndex, BOOL * _Nonnull stop) {
+			[self insertPath:path pathIndex:pathIndex];
+		}];
+	}
+	
+	return self;
+}
+
+
+/*
+** SMJPathTrie - Evaluate
+*/
+#pragma mark - SMJPathTrie - Evaluate
+
+- (NSArray *)evaluateJsonObject:(id)jsonObject configuration:(SMJConfiguration *)configuration
+{
+	return [self evaluateJsonObject:jsonObject configuration:configuration forUpdate:NO];
+}
+
+- (NSArray *)evaluateJsonObjectForUpdate:(id)jsonObject configuration:(SMJConfiguration *)configuration
+{
+	return [self evaluateJsonObject:jsonObject configuration:configuration forUpdate:YES];
+}
+
+- (NSArray *)evaluateJsonObject:(id)jsonObject configuration:(SMJConfiguration *)configuration forUpdate:(BOOL)forUpdate
+{
+	NSUInteger pathsCount = _paths.count;
+	
+	// Prepare evaluation state.
+	SMJPathTrieEvaluation 					*evaluation = [[SMJPathTrieEvaluation alloc] init];
+	NSMutableArray <SMJEvaluationContextImpl *>	*contexts = [[NSMutableArray alloc] initWithCapacity:pathsCount];
+	
+	for (SMJCompiledPath *path in _paths)
+	{
+		SMJEvaluationContextImpl *context = [[SMJEvaluationContextImpl alloc] initWithPath:path rootJsonObject:jsonObject configuration:configuration forUpdate:forUpdate];
+		
+		context.recordsUpdateLocations = forUpdate;
+		
+		[contexts addObject:context];
+	}
+	
+	evaluation->_contexts = contexts;
+	evaluation->_statuses = calloc(MAX(pathsCount, 1), sizeof(SMJPathTrieMemberStatus));
+	evaluation->_errors = [[NSMutableArray alloc] initWithCapacity:pathsCount];
+	evaluation->_requireProperties = [configuration containsOption:SMJOptionRequireProperties];
+	evaluation->_forUpdate = forUpdate;
+	
+	for (NSUInteger i = 0; i < pathsCount; i++)
+		[evaluation->_errors addObject:[NSNull null]];
+	
+	// Evaluate.
+	SMJPathSegment currentPath = SMJPathSegmentMakeRoot(@"");
+	
+	for (SMJPathTrieNode *node in _top->_children)
+		[self evaluateNode:node currentPath:&currentPath parentPathRef:[SMJPathRef pathRefNull] jsonObject:jsonObject evaluation:evaluation];
+	
+	// Collect.
+	NSMutableArray *result = [[NSMutableArray alloc] initWithCapacity:pathsCount];
+	
+	for (NSUInteger i = 0; i < pathsCount; i++)
+	{
+		if (evaluation->_statuses[i] == SMJPathTrieMemberStatusFailed)
+			[result addObject:evaluation->_errors[i]];
+		else
+			[result addObject:contexts[i]];
+	}
+	
+	return result;
+}
+
+
+/*
+** SMJPathTrie - Properties
+*/
+#pragma mark - SMJPathTrie - Properties
+
+- (NSArray <SMJCompiledPath *> *)paths
+{
+	return _paths;
+}
+
+- (NSUInteger)nodeCount
+{
+	return _nodeCount;
+}
+
+
+/*
+** SMJPathTrie - Helpers - Build
+*/
+#pragma mark - SMJPathTrie - Helpers - Build
+
+- (void)insertPath:(SMJCompiledPath *)path pathIndex:(NSUInteger)pathIndex
+{
+	SMJPathTrieNode *parent = _top;
+	
+	for (SMJPathToken *token = path.root; token != nil; token = (token.leaf ? nil : token.next))
+	{
+		SMJPathTrieNodeKind	kind;
+		id 					value = nil;
+		id					key;
+		
+		if ([token isKindOfClass:[SMJRootPathToken class]])
+		{
+			kind = SMJPathTrieNodeKindRoot;
+			value = token.pathFragment;
+			key = @[ @(kind), value ];
+		}
+		else if ([token isKindOfClass:[SMJPropertyPathToken class]] && ((SMJPropertyPathToken *)token).singlePropertyCase)
+		{
+			kind = SMJPathTrieNodeKindProperty;
+			value = ((SMJPropertyPathToken *)token).properties.firstObject;
+			key = @[ @(kind), value ];
+		}
+		else if ([token isKindOfClass:[SMJWildcardPathToken class]])
+		{
+			kind = SMJPathTrieNodeKindWildcard;
+			key = @[ @(kind) ];
+		}
+		else if ([token isKindOfClass:[SMJArrayIndexToken class]] && ((SMJArrayIndexToken *)token).indexOperation.singleIndexOperation)
+		{
+			kind = SMJPathTrieNodeKindIndex;
+			value = ((SMJArrayIndexToken *)token).indexOperation.indexes.firstObject;
+			key = @[ @(kind), value ];
+		}
+		else if ([token isKindOfClass:[SMJScanPathToken class]])
+		{
+			kind = SMJPathTrieNodeKindScan;
+			key = @[ @(kind) ];
+		}
+		else
+		{
+			kind = SMJPathTrieNodeKindOther;
+			key = @[ @(kind), [NSValue valueWithNonretainedObject:token] ];
+		}
+		
+		// Find or create the node.
+		SMJPathTrieNode *node = parent->_childrenByKey[key];
+		
+		if (!node)
+		{
+			node = [[SMJPathTrieNode alloc] init];
+			
+			node->_kind = kind;
+			node->_value = value;
+			
+			parent->_childrenByKey[key] = node;
+			[parent->_children addObject:node];
+			
+			_nodeCount++;
+		}
+		
+		[node addToken:token pathIndex:pathIndex];
+		
+		// The tokens evaluate the rest of the path themselves.
+		if (kind == SMJPathTrieNodeKindScan || kind == SMJPathTrieNodeKindOther)
+			break;
+		
+		parent = node;
+	}
+}
+
+
+/*
+** SMJPathTrie - Helpers - Evaluate
+*/
+#pragma mark - SMJPathTrie - Helpers - Evaluate
+
+- (void)evaluateNode:(SMJPathTrieNode *)node currentPath:(const SMJPathSegment *)currentPath parentPathRef:(SMJPathRef *)parentPathRef jsonObject:(id)jsonObject evaluation:(SMJPathTrieEvaluation *)evaluation
+{
+	BOOL forUpdate = evaluation->_forUpdate;
+	
+	if ([self hasActiveMember:node evaluation:evaluation] == NO)
+		return;
+	
+	switch (node->_kind)
+	{
+		case SMJPathTrieNodeKindRoot:
+		{
+			SMJPathSegment	rootPath = SMJPathSegmentMakeRoot(node->_value);
+			SMJPathRef		*pathRef = forUpdate ? [SMJPathRef pathRefWithRootObject:jsonObject] : [SMJPathRef pathRefNull];
+			
+			[self dispatchNode:node currentPath:&rootPath pathRef:pathRef jsonObject:jsonObject evaluation:evaluation];
+			break;
+		}
+		
+		case SMJPathTrieNodeKindProperty:
+		{
+			NSString	*property = node->_value;
+			id			propertyVal = ([jsonObject isKindOfClass:[NSDictionary class]] ? ((NSDictionary *)jsonObject)[property] : nil);
+			
+			if (propertyVal)
+			{
+				SMJPathSegment	evalPath = SMJPathSegmentMakeProperty(currentPath, property);
+				SMJPathRef		*pathRef = forUpdate ? [SMJPathRef pathRefWithObject:jsonObject property:property] : [SMJPathRef pathRefNull];
+				
+				[self dispatchNode:node currentPath:&evalPath pathRef:pathRef jsonObject:propertyVal evaluation:evaluation];
+			}
+			else
+			{
+				// Missing properties depend on options and on each path definiteness: let the tokens handle them.
+				[self evaluateTokensOfNode:node currentPath:currentPath parentPathRef:parentPathRef jsonObject:jsonObject evaluation:evaluation];
+			}
+			break;
+		}
+		
+		case SMJPathTrieNodeKindWildcard:
+		{
+			[self evaluateWildcardNode:node currentPath:currentPath jsonObject:jsonObject evaluation:evaluation];
+			break;
+		}
+		
+		case SMJPathTrieNodeKindIndex:
+		{
+			if ([jsonObject isKindOfClass:[NSArray class]])
+			{
+				NSArray		*array = jsonObject;
+				NSInteger	index = [node->_value integerValue];
+				NSInteger	effectiveIndex = index < 0 ? (NSInteger)array.count + index : index;
+				
+				if (effectiveIndex < 0 || effectiveIndex >= (NSInteger)array.count)
+					break;
+				
+				SMJPathSegment	evalPath = SMJPathSegmentMakeIndex(currentPath, index);
+				SMJPathRef		*pathRef = forUpdate ? [SMJPathRef pathRefWithObject:jsonObject index:(NSUInteger)effectiveIndex] : [SMJPathRef pathRefNull];
+				
+				[self dispatchNode:node currentPath:&evalPath pathRef:pathRef jsonObject:array[(NSUInteger)effectiveIndex] evaluation:evaluation];
+			}
+			else
+			{
+				// Not an array: let the tokens decide if it's an error.
+				[self evaluateTokensOfNode:node currentPath:currentPath parentPathRef:parentPathRef jsonObject:jsonObject evaluation:evaluation];
+			}
+			break;
+		}
+		
+		case SMJPathTrieNodeKindScan:
+		{
+			[self evaluateScanNode:node currentPath:currentPath parentPathRef:parentPathRef jsonObject:jsonObject evaluation:evaluation];
+			break;
+		}
+		
+		case SMJPathTrieNodeKindOther:
+		{
+			[self evaluateTokensOfNode:node currentPath:currentPath parentPathRef:parentPathRef jsonObject:jsonObject evaluation:evaluation];
+			break;
+		}
+	}
+}
+
+- (void)dispatchNode:(SMJPathTrieNode *)node currentPath:(const SMJPathSegment *)currentPath pathRef:(SMJPathRef *)pathRef jsonObject:(id)jsonObject evaluation:(SMJPathTrieEvaluation *)evaluation
+{
+	// Paths ending on this node.
+	for (NSUInteger i = 0; i < node->_memberCount; i++)
+	{
+		NSUInteger pathIndex = node->_pathIndexes[i];
+		
+		if (evaluation->_statuses[pathIndex] != SMJPathTrieMemberStatusActive || node->_tokens[i].leaf == NO)
+			continue;
+		
+		if ([evaluation->_contexts[pathIndex] addResult:currentPath operation:pathRef jsonObject:jsonObject] == SMJEvaluationContextStatusAborted)
+			evaluation->_statuses[pathIndex] = SMJPathTrieMemberStatusStopped;
+	}
+	
+	// Paths continuing after this node.
+	for (SMJPathTrieNode *child in node->_children)
+		[self evaluateNode:child currentPath:currentPath parentPathRef:pathRef jsonObject:jsonObject evaluation:evaluation];
+}
+
+- (void)evaluateWildcardNode:(SMJPathTrieNode *)node currentPath:(const SMJPathSegment *)currentPath jsonObject:(id)jsonObject evaluation:(SMJPathTrieEvaluation *)evaluation
+{
+	if ([jsonObject isKindOfClass:[NSDictionary class]])
+	{
+		NSDictionary *dictionary = jsonObject;
+		
+		for (NSString *property in dictionary.allKeys)
+		{
+			SMJPathSegment	evalPath = SMJPathSegmentMakeProperty(currentPath, property);
+			SMJPathRef		*pathRef = evaluation->_forUpdate ? [SMJPathRef pathRefWithObject:dictionary property:property] : [SMJPathRef pathRefNull];
+			
+			[self dispatchNode:node currentPath:&evalPath pathRef:pathRef jsonObject:dictionary[property] evaluation:evaluation];
+			
+			if ([self hasActiveMember:node evaluation:evaluation] == NO)
+				break;
+		}
+	}
+	else if ([jsonObject isKindOfClass:[NSArray class]])
+	{
+		NSArray *array = jsonObject;
+		
+		// Errors on an item don't stop the wildcard on arrays, unless properties are required.
+		NSMutableIndexSet *activePaths = [[NSMutableIndexSet alloc] init];
+		
+		if (evaluation->_requireProperties == NO)
+		{
+			for (NSUInteger i = 0; i < node->_memberCount; i++)
+			{
+				if (evaluation->_statuses[node->_pathIndexes[i]] == SMJPathTrieMemberStatusActive)
+					[activePaths addIndex:node->_pathIndexes[i]];
+			}
+		}
+		
+		for (NSUInteger idx = 0; idx < array.count; idx++)
+		{
+			SMJPathSegment	evalPath = SMJPathSegmentMakeIndex(currentPath, (NSInteger)idx);
+			SMJPathRef		*pathRef = evaluation->_forUpdate ? [SMJPathRef pathRefWithObject:array index:idx] : [SMJPathRef pathRefNull];
+			
+			[self dispatchNode:node currentPath:&evalPath pathRef:pathRef jsonObject:array[idx] evaluation:evaluation];
+			
+			[activePaths enumerateIndexesUsingBlock:^(NSUInteger pathIndex, BOOL * _Nonnull stop) {
+				if (evaluation->_statuses[pathIndex] == SMJPathTrieMemberStatusFailed)
+				{
+					evaluation->_statuses[pathIndex] = SMJPathTrieMemberStatusActive;
+					evaluation->_errors[pathIndex] = [NSNull null];
+				}
+			}];
+			
+			if ([self hasActiveMember:node evaluation:evaluation] == NO)
+				break;
+		}
+	}
+}
+
+- (void)evaluateScanNode:(SMJPathTrieNode *)node currentPath:(const SMJPathSegment *)currentPath parentPathRef:(SMJPathRef *)parentPathRef jsonObject:(id)jsonObject evaluation:(SMJPathTrieEvaluation *)evaluation
+{
+	NSMutableArray <id <SMJScanPredicate>> *predicates = [[NSMutableArray alloc] initWithCapacity:node->_memberCount];
+	
+	for (NSUInteger i = 0; i < node->_memberCount; i++)
+	{
+		SMJScanPathToken *token = (SMJScanPathToken *)node->_tokens[i];
+		
+		[predicates addObject:[token scanPredicateWithEvaluationContext:evaluation->_contexts[node->_pathIndexes[i]]]];
+	}
+	
+	[self walkScanNode:node currentPath:currentPath pathRef:parentPathRef jsonObject:jsonObject predicates:predicates evaluation:evaluation];
+}
+
+- (BOOL)walkScanNode:(SMJPathTrieNode *)node currentPath:(const SMJPathSegment *)currentPath pathRef:(SMJPathRef *)pathRef jsonObject:(id)jsonObject predicates:(NSArray <id <SMJScanPredicate>> *)predicates evaluation:(SMJPathTrieEvaluation *)evaluation
+{
+	BOOL isDictionary = [jsonObject isKindOfClass:[NSDictionary class]];
+	
+	if (isDictionary == NO && [jsonObject isKindOfClass:[NSArray class]] == NO)
+		return YES;
+	
+	// Visit this node with each scan.
+	BOOL hasActive = NO;
+	
+	for (NSUInteger i = 0; i < node->_memberCount; i++)
+	{
+		NSUInteger pathIndex = node->_pathIndexes[i];
+		
+		if (evaluation->_statuses[pathIndex] != SMJPathTrieMemberStatusActive)
+			continue;
+		
+		SMJScanPathToken	*token = (SMJScanPathToken *)node->_tokens[i];
+		NSError				*error = nil;
+		SMJEvaluationStatus	status = [token visitJsonObject:jsonObject currentPath:currentPath parentPathRef:pathRef predicate:predicates[i] evaluationContext:evaluation->_contexts[pathIndex] error:&error];
+		
+		[self setStatus:status error:error pathIndex:pathIndex evaluation:evaluation];
+		
+		hasActive = hasActive || (evaluation->_statuses[pathIndex] == SMJPathTrieMemberStatusActive);
+	}
+	
+	if (hasActive == NO)
+		return NO;
+	
+	// Recurse.
+	if (isDictionary)
+	{
+		NSDictionary *dictionary = jsonObject;
+		
+		for (NSString *property in dictionary)
+		{
+			SMJPathSegment	evalPath = SMJPathSegmentMakeProperty(currentPath, property);
+			SMJPathRef		*evalPathRef = evaluation->_forUpdate ? [SMJPathRef pathRefWithObject:dictionary property:property] : [SMJPathRef pathRefNull];
+			
+			if ([self walkScanNode:node currentPath:&evalPath pathRef:evalPathRef jsonObject:dictionary[property] predicates:predicates evaluation:evaluation] == NO)
+				return NO;
+		}
+	}
+	else
+	{
+		NSUInteger idx = 0;
+		
+		for (id item in (NSArray *)jsonObject)
+		{
+			SMJPathSegment	evalPath = SMJPathSegmentMakeIndex(currentPath, (NSInteger)idx);
+			SMJPathRef		*evalPathRef = evaluation->_forUpdate ? [SMJPathRef pathRefWithObject:jsonObject index:idx] : [SMJPathRef pathRefNull];
+			
+			if ([self walkScanNode:node currentPath:&evalPath pathRef:evalPathRef jsonObject:item predicates:predicates evaluation:evaluation] == NO)
+				return NO;
+			
+			idx++;
+		}
+	}
+	
+	return YES;
+}
+
+- (void)evaluateTokensOfNode:(SMJPathTrieNode *)node currentPath:(const SMJPathSegment *)currentPath parentPathRef:(SMJPathRef *)parentPathRef jsonObject:(id)jsonObject evaluation:(SMJPathTrieEvaluation *)evaluation
+{
+	for (NSUInteger i = 0; i < node->_memberCount; i++)
+	{
+		NSUInteger pathIndex = node->_pathIndexes[i];
+		
+		if (evaluation->_statuses[pathIndex] != SMJPathTrieMemberStatusActive)
+			continue;
+		
+		NSError				*error = nil;
+		SMJEvaluationStatus	status = SMJPathTokenEvaluate(node->_tokens[i], currentPath, parentPathRef, jsonObject, evaluation->_contexts[pathIndex], &error);
+		
+		[self setStatus:status error:error pathIndex:pathIndex evaluation:evaluation];
+	}
+}
+
+- (void)setStatus:(SMJEvaluationStatus)status error:(nullable NSError *)error pathIndex:(NSUInteger)pathIndex evaluation:(SMJPathTrieEvaluation *)evaluation
+{
+	if (status == SMJEvaluationStatusAborted)
+	{
+		evaluation->_statuses[pathIndex] = SMJPathTrieMemberStatusStopped;
+	}
+	else if (status == SMJEvaluationStatusError)
+	{
+		if (!error)
+			SMSetError(&error, 1, @"internal error (evaluation failed without error)");
+		
+		evaluation->_statuses[pathIndex] = SMJPathTrieMemberStatusFailed;
+		evaluation->_errors[pathIndex] = error;
+	}
+}
+
+- (BOOL)hasActiveMember:(SMJPathTrieNode *)node evaluation:(SMJPathTrieEvaluation *)evaluation
+{
+	for (NSUInteger i = 0; i < node->_memberCount; i++)
+	{
+		if (evaluation->_statuses[node->_pathIndexes[i]] == SMJPathTrieMemberStatusActive)
+			return YES;
+	}
+	
+	return NO;
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
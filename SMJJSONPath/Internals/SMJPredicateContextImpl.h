@@ -26,6 +26,8 @@
 
 #import "SMJConfiguration.h"
 #import "SMJPath.h"
+#import "SMJEvaluationCache.h"
+#import "SMJEvaluationProfile.h"
 
 
 NS_ASSUME_NONNULL_BEGIN
@@ -39,11 +41,17 @@ NS_ASSUME_NONNULL_BEGIN
 @interface SMJPredicateContextImpl : NSObject <SMJPredicateContext>
 
 // -- Instance --
-- (instancetype)initWithJsonObject:(id)jsonObject rootJsonObject:(id)rootJsonObject configuration:(SMJConfiguration *)configuration pathCache:(NSMutableDictionary <NSString *, id> *)pathCache;
+- (instancetype)initWithJsonObject:(id)jsonObject rootJsonObject:(id)rootJsonObject configuration:(SMJConfiguration *)configuration pathCache:(SMJEvaluationCache *)pathCache;
 
 // -- Evaluate --
 - (nullable id)evaluatePath:(id <SMJPath>)path error:(NSError **)error;
 
+// -- Properties --
+@property (readonly) SMJEvaluationCache *pathCache; // Shared by all the predicate contexts of an evaluation.
+
+// -- Profile --
+@property (nullable) SMJEvaluationProfile *profile; // Record path cache hits & misses.
+
 @end
 
 
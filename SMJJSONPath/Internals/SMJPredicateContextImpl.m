@@ -22,6 +22,8 @@
 
 #import "SMJPredicateContextImpl.h"
 
+#import "SMJEvaluationProfileInternal.h"
+
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -36,10 +38,10 @@ NS_ASSUME_NONNULL_BEGIN
 	id _jsonObject;
 	id _rootJsonObject;
 	SMJConfiguration *_configuration;
-	NSMutableDictionary<NSString *, id> *_pathCache;
+	SMJEvaluationCache *_pathCache;
 }
 
-- (instancetype)initWithJsonObject:(id)jsonObject rootJsonObject:(id)rootJsonObject configuration:(SMJConfiguration *)configuration pathCache:(NSMutableDictionary <NSString *, id> *)pathCache
+- (instancetype)initWithJsonObject:(id)jsonObject rootJsonObject:(id)rootJsonObject configuration:(SMJConfiguration *)configuration pathCache:(SMJEvaluationCache *)pathCache
 {
 	self = [super init];
 	
@@ -60,8 +62,12 @@ NS_ASSUME_NONNULL_BEGIN
 	
 	if (path.rootPath)
 	{
-		NSString	*pathString = [path stringValue];
-		id			obj = _pathCache[pathString];
+		// Identical paths are compiled once (see +[SMJPathCompiler compileSharedPathString:error:]), so the identity of the path is the key.
+		NSValue	*pathKey = [NSValue valueWithNonretainedObject:path];
+		id		obj = [_pathCache objectForKey:pathKey];
+		
+		if (_profile)
+			[_profile recordCacheHit:(obj != nil)];
 		
 		if (obj)
 		{
@@ -78,7 +84,7 @@ NS_ASSUME_NONNULL_BEGIN
 			result = [evaluationContext jsonObjectWithError:error];
 			
 			if (result)
-				_pathCache[pathString] = result;
+				[_pathCache setObject:result forKey:pathKey];
 		}
 	}
 	else
@@ -110,6 +116,11 @@ NS_ASSUME_NONNULL_BEGIN
 	return _configuration;
 }
 
+- (SMJEvaluationCache *)pathCache
+{
+	return _pathCache;
+}
+
 @end
 
 
@@ -23,6 +23,9 @@
 #import "SMJPredicatePathToken.h"
 
 #import "SMJPredicateContextImpl.h"
+#import "SMJFilter.h"
+#import "SMJParallel.h"
+#import "SMJEvaluationProfileInternal.h"
 
 
 NS_ASSUME_NONNULL_BEGIN
@@ -93,17 +96,32 @@ NS_ASSUME_NONNULL_BEGIN
 {
 	// XXX why "accept" drop predicate error there ?
 	
-	id <SMJPredicateContext> predicateContext = [[SMJPredicateContextImpl alloc] initWithJsonObject:jsonObject rootJsonObject:rootJsonObject configuration:configuration pathCache:evaluationContext.evaluationCache];
+	SMJEvaluationProfile	*profile = evaluationContext.profile;
+	SMJPredicateContextImpl	*predicateContext = [[SMJPredicateContextImpl alloc] initWithJsonObject:jsonObject rootJsonObject:rootJsonObject configuration:configuration pathCache:evaluationContext.evaluationCache];
+	BOOL					accepted = YES;
+	
+	predicateContext.profile = profile;
 	
 	for (id <SMJPredicate> predicate in _predicates)
 	{
-		SMJPredicateApply result = [predicate applyWithContext:predicateContext error:nil];
+		SMJPredicateApply result;
+		
+		if (profile && [predicate isKindOfClass:[SMJFilter class]])
+			result = [(SMJFilter *)predicate applyWithContext:predicateContext profile:profile error:nil];
+		else
+			result = [predicate applyWithContext:predicateContext error:nil];
 		
 		if (result == SMJPredicateApplyError || result == SMJPredicateApplyFalse)
-			return NO;
+		{
+			accepted = NO;
+			break;
+		}
 	}
 	
-	return YES;
+	if (profile)
+		[profile recordApplyOfToken:self match:accepted];
+	
+	return accepted;
 }
 
 
@@ -112,7 +130,7 @@ NS_ASSUME_NONNULL_BEGIN
 */
 #pragma mark - SMJPredicatePathToken - SMJPathToken
 
-- (SMJEvaluationStatus)evaluateWithCurrentPath:(NSString *)currentPath parentPathRef:(SMJPathRef *)parent jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error
+- (SMJEvaluationStatus)evaluateWithCurrentPath:(const SMJPathSegment *)currentPath parentPathRef:(SMJPathRef *)parent jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error
 {
 	if ([jsonObject isKindOfClass:[NSDictionary class]])
 	{
@@ -122,11 +140,12 @@ NS_ASSUME_NONNULL_BEGIN
 			
 			if (self.leaf)
 			{
-				[context addResult:currentPath operation:op jsonObject:jsonObject];
+				if ([context addResult:currentPath operation:op jsonObject:jsonObject] == SMJEvaluationContextStatusAborted)
+					return SMJEvaluationStatusAborted;
 			}
 			else
 			{
-				SMJEvaluationStatus result = [self.next evaluateWithCurrentPath:currentPath parentPathRef:op jsonObject:jsonObject evaluationContext:context error:error];
+				SMJEvaluationStatus result = SMJPathTokenEvaluate(self.next, currentPath, op, jsonObject, context, error);
 				
 				if (result == SMJEvaluationStatusError)
 					return SMJEvaluationStatusError;
@@ -138,13 +157,18 @@ NS_ASSUME_NONNULL_BEGIN
 	else if ([jsonObject isKindOfClass:[NSArray class]])
 	{
 		NSArray 	*jsonObjects = jsonObject;
+		NSUInteger	parallelFilterThreshold = context.parallelFilterThreshold;
 		NSUInteger	idx = 0;
 		
+		// A limited evaluation stops at the first matches: filtering all the items ahead would only waste work.
+		if (parallelFilterThreshold > 0 && jsonObjects.count >= parallelFilterThreshold && context.resultLimit == 0)
+			return [self evaluateArrayInParallel:jsonObjects currentPath:currentPath evaluationContext:context error:error];
+		
 		for (id idxObject in jsonObjects)
 		{
 			if ([self acceptJsonObject:idxObject rootJsonObject:context.rootJsonObject configuration:context.configuration evaluationContext:context])
 			{
-				SMJEvaluationStatus result = [self handleArrayIndex:idx currentPathString:currentPath jsonObject:jsonObject evaluationContext:context error:error];
+				SMJEvaluationStatus result = [self handleArrayIndex:idx currentPath:currentPath jsonObject:jsonObject evaluationContext:context error:error];
 				
 				if (result == SMJEvaluationStatusError)
 					return SMJEvaluationStatusError;
@@ -192,6 +216,48 @@ NS_ASSUME_NONNULL_BEGIN
 }
 
 
+/*
+** SMJPredicatePathToken - Helpers
+*/
+#pragma mark - SMJPredicatePathToken - Helpers
+
+- (SMJEvaluationStatus)evaluateArrayInParallel:(NSArray *)jsonObjects currentPath:(const SMJPathSegment *)currentPath evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error
+{
+	NSUInteger count = jsonObjects.count;
+	NSUInteger concurrency = context.parallelConcurrency;
+	
+	// Evaluate predicates on all items, by chunks.
+	id					rootJsonObject = context.rootJsonObject;
+	SMJConfiguration	*configuration = context.configuration;
+	BOOL				*matches = calloc(count, sizeof(BOOL));
+	
+	SMJParallelApply(count, SMJParallelChunkSize(count, concurrency), concurrency, ^BOOL(NSUInteger chunkIndex, NSRange range) {
+		for (NSUInteger idx = range.location; idx < NSMaxRange(range); idx++)
+			matches[idx] = [self acceptJsonObject:jsonObjects[idx] rootJsonObject:rootJsonObject configuration:configuration evaluationContext:context];
+		
+		return YES;
+	});
+	
+	// Handle matching items in order.
+	SMJEvaluationStatus result = SMJEvaluationStatusDone;
+	
+	for (NSUInteger idx = 0; idx < count; idx++)
+	{
+		if (matches[idx] == NO)
+			continue;
+		
+		result = [self handleArrayIndex:(NSInteger)idx currentPath:currentPath jsonObject:jsonObjects evaluationContext:context error:error];
+		
+		if (result != SMJEvaluationStatusDone)
+			break;
+	}
+	
+	free(matches);
+	
+	return result;
+}
+
+
 @end
 
 
@@ -112,7 +112,7 @@ NS_ASSUME_NONNULL_BEGIN
 */
 #pragma mark - SMJPropertyPathToken - SMJPathToken
 
-- (SMJEvaluationStatus)evaluateWithCurrentPath:(NSString *)currentPath parentPathRef:(SMJPathRef *)parent jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error
+- (SMJEvaluationStatus)evaluateWithCurrentPath:(const SMJPathSegment *)currentPath parentPathRef:(SMJPathRef *)parent jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error
 {
 	// Can't assert it in ctor because isLeaf() could be changed later on.
 	//assert onlyOneIsTrueNonThrow(singlePropertyCase(), multiPropertyMergeCase(), multiPropertyIterationCase());
@@ -127,7 +127,7 @@ NS_ASSUME_NONNULL_BEGIN
 		{
 			NSString *m = (jsonObject == nil ? @"null" : [[jsonObject class] description]);
 			
-			SMSetError(error, 1, @"Expected to find an object with property %@ in path %@ but found '%@'. This is not a json object.", self.pathFragment, currentPath, m);
+			SMSetError(error, 1, @"Expected to find an object with property %@ in path %@ but found '%@'. This is not a json object.", self.pathFragment, SMJPathSegmentString(currentPath), m);
 			
 			return SMJEvaluationStatusError;
 		}
@@ -135,7 +135,7 @@ NS_ASSUME_NONNULL_BEGIN
 	
 	if (self.singlePropertyCase || self.multiPropertyMergeCase)
 	{
-		return [self handleObjectPropertyWithCurrentPathString:currentPath jsonObject:jsonObject evaluationContext:context properties:_properties error:error];
+		return [self handleObjectPropertyWithCurrentPath:currentPath jsonObject:jsonObject evaluationContext:context properties:_properties error:error];
 	}
 	
 	if (self.multiPropertyIterationCase == NO)
@@ -146,7 +146,7 @@ NS_ASSUME_NONNULL_BEGIN
 	
 	for (NSString *property in _properties)
 	{
-		SMJEvaluationStatus result = [self handleObjectPropertyWithCurrentPathString:currentPath jsonObject:jsonObject evaluationContext:context properties:@[ property ] error:error];
+		SMJEvaluationStatus result = [self handleObjectPropertyWithCurrentPath:currentPath jsonObject:jsonObject evaluationContext:context properties:@[ property ] error:error];
 		
 		if (result == SMJEvaluationStatusError)
 			return SMJEvaluationStatusError;
@@ -23,6 +23,7 @@
 #import "SMJRelationalExpressionNode.h"
 
 #import "SMJEvaluatorFactory.h"
+#import "SMJFilterProgram.h"
 
 
 NS_ASSUME_NONNULL_BEGIN
@@ -38,6 +39,11 @@ NS_ASSUME_NONNULL_BEGIN
 	SMJValueNode *_left;
 	SMJRelationalOperator *_relationalOperator;
 	SMJValueNode *_right;
+	
+	// Resolved at init.
+	SMJValueNode			*_evaluatedLeft;
+	id <SMJEvaluator>		_evaluator;
+	NSError					*_evaluatorError;
 }
 
 
@@ -60,6 +66,23 @@ NS_ASSUME_NONNULL_BEGIN
 		_left = leftValue;
 		_right = rightValue;
 		_relationalOperator = op;
+		
+		// SourceMac-Note: we support the "EXISTS" token, event if it's similar (and so redoundant) to don't use operator and right value.
+		_evaluatedLeft = leftValue;
+		
+		if ([leftValue isKindOfClass:[SMJPathNode class]])
+		{
+			SMJPathNode *pathNode = (SMJPathNode *)leftValue;
+			
+			if (op == [SMJRelationalOperator relationalOperatorEXISTS] && pathNode.existsCheck == NO)
+				_evaluatedLeft = [pathNode copyWithExistsCheckAndShouldExists:pathNode.shouldExists];
+		}
+		
+		// Bind the evaluator once, instead of looking it up at each application.
+		NSError *error = nil;
+		
+		_evaluator = [SMJEvaluatorFactory createEvaluatorForRelationalOperator:op error:&error];
+		_evaluatorError = error;
 	}
 	
 	return self;
@@ -73,40 +96,34 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (SMJPredicateApply)applyWithContext:(id <SMJPredicateContext>)context error:(NSError **)error
 {
-	SMJValueNode *left = _left;
+	SMJValueNode *left = _evaluatedLeft;
 	SMJValueNode *right = _right;
 	
-	if ([_left isKindOfClass:[SMJPathNode class]])
+	if (!_evaluator)
 	{
-		SMJPathNode *tmp = (SMJPathNode *)_left;
-		
-		// SourceMac-Note: we support the "EXISTS" token, event if it's similar (and so redoundant) to don't use operator and right value.
-		if (_relationalOperator == [SMJRelationalOperator relationalOperatorEXISTS] && tmp.existsCheck == NO)
-			tmp = [tmp copyWithExistsCheckAndShouldExists:tmp.shouldExists];
+		if (error)
+			*error = _evaluatorError;
 		
-		left = [tmp evaluate:context error:error];
+		return SMJPredicateApplyError;
+	}
+	
+	if ([left isKindOfClass:[SMJPathNode class]])
+	{
+		left = [(SMJPathNode *)left evaluate:context error:error];
 		
 		if (!left)
 			return SMJPredicateApplyError;
 	}
 	
-	if ([_right isKindOfClass:[SMJPathNode class]])
+	if ([right isKindOfClass:[SMJPathNode class]])
 	{
-		SMJPathNode *tmp = (SMJPathNode *)_right;
-		
-		right = [tmp evaluate:context error:error];
+		right = [(SMJPathNode *)right evaluate:context error:error];
 
 		if (!right)
 			return SMJPredicateApplyError;
 	}
 	
-	id <SMJEvaluator> evaluator = [SMJEvaluatorFactory createEvaluatorForRelationalOperator:_relationalOperator error:error];
-
-	if (!evaluator)
-		return SMJPredicateApplyError;
-	
-	
-	SMJEvaluatorEvaluate result = [evaluator evaluateLeftNode:left rightNode:right predicateContext:context error:error];
+	SMJEvaluatorEvaluate result = [_evaluator evaluateLeftNode:left rightNode:right predicateContext:context error:error];
 	
 	if (result == SMJEvaluatorEvaluateTrue)
 		return SMJPredicateApplyTrue;
@@ -126,6 +143,24 @@ NS_ASSUME_NONNULL_BEGIN
 		return [NSString stringWithFormat:@"%@ %@ %@", [_left stringValue], _relationalOperator.stringOperator, [_right stringValue]];
 }
 
+
+/*
+** SMJRelationalExpressionNode - Lowering
+*/
+#pragma mark - SMJRelationalExpressionNode - Lowering
+
+- (void)lowerToFilterProgram:(SMJFilterProgram *)program
+{
+	// Keep the evaluator error for evaluation time, like the non-lowered node.
+	if (!_evaluator)
+	{
+		[program appendPredicate:self];
+		return;
+	}
+	
+	[program appendCompareWithExpression:self leftNode:_evaluatedLeft operator:_relationalOperator rightNode:_right evaluator:_evaluator];
+}
+
 @end
 
 
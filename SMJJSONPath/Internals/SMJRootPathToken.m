@@ -119,20 +119,22 @@ NS_ASSUME_NONNULL_BEGIN
 */
 #pragma mark - SMJRootPathToken - SMJPathToken
 
-- (SMJEvaluationStatus)evaluateWithCurrentPath:(NSString *)currentPath parentPathRef:(SMJPathRef *)pathRef jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error
+- (SMJEvaluationStatus)evaluateWithCurrentPath:(const SMJPathSegment *)currentPath parentPathRef:(SMJPathRef *)pathRef jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error
 {
+	SMJPathSegment rootPath = SMJPathSegmentMakeRoot(_rootToken);
+	
 	if (self.leaf)
 	{
 		SMJPathRef *op = context.forUpdate ? pathRef : [SMJPathRef pathRefNull];
 		
-		if ([context addResult:_rootToken operation:op jsonObject:jsonObject] == SMJEvaluationContextStatusAborted)
+		if ([context addResult:&rootPath operation:op jsonObject:jsonObject] == SMJEvaluationContextStatusAborted)
 			return SMJEvaluationStatusAborted;
 		
 		return SMJEvaluationStatusDone;
 	}
 	else
 	{
-		return [self.next evaluateWithCurrentPath:_rootToken parentPathRef:pathRef jsonObject:jsonObject evaluationContext:context error:error];
+		return SMJPathTokenEvaluate(self.next, &rootPath, pathRef, jsonObject, context, error);
 	}
 }
 
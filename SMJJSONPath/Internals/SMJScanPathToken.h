@@ -28,6 +28,17 @@
 NS_ASSUME_NONNULL_BEGIN
 
 
+/*
+** SMJScanPredicate
+*/
+#pragma mark - SMJScanPredicate
+
+@protocol SMJScanPredicate <NSObject>
+- (BOOL)matchesJsonObject:(id)jsonObject;
+@end
+
+
+
 /*
 ** SMJScanPathToken
 */
@@ -35,6 +46,11 @@ NS_ASSUME_NONNULL_BEGIN
 
 @interface SMJScanPathToken : SMJPathToken
 
+// -- Walk --
+// > Let a single walk feed several scans: create a predicate per scan, then visit each node of the walk with each scan.
+- (id <SMJScanPredicate>)scanPredicateWithEvaluationContext:(SMJEvaluationContextImpl *)context;
+- (SMJEvaluationStatus)visitJsonObject:(id)jsonObject currentPath:(const SMJPathSegment *)currentPath parentPathRef:(SMJPathRef *)parent predicate:(id <SMJScanPredicate>)predicate evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error;
+
 @end
 
 
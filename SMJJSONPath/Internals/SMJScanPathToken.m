@@ -27,19 +27,34 @@
 #import "SMJWildcardPathToken.h"
 #import "SMJPredicatePathToken.h"
 
+#import "SMJParallel.h"
+#import "SMJEvaluationProfileInternal.h"
+
 
 NS_ASSUME_NONNULL_BEGIN
 
 
 /*
-** Predicates - Interface
+** Parallel - Interface
 */
-#pragma mark - Predicates - Interface
+#pragma mark - Parallel - Interface
 
-@protocol SMJScanPredicate <NSObject>
-- (BOOL)matchesJsonObject:(id)jsonObject;
+@interface SMJScanChunk : NSObject
+{
+@public
+	SMJEvaluationContextImpl	*_context;
+	SMJEvaluationStatus			_status;
+	NSError						*_error;
+}
 @end
 
+
+
+/*
+** Predicates - Interface
+*/
+#pragma mark - Predicates - Interface
+
 @interface SMJPropertyPathTokenPredicate : NSObject <SMJScanPredicate>
 - (instancetype)initWithTarget:(SMJPathToken *)target context:(SMJEvaluationContextImpl *)context;
 @end
@@ -72,7 +87,7 @@ NS_ASSUME_NONNULL_BEGIN
 */
 #pragma mark - SMJScanPathToken - SMJPathToken
 
-- (SMJEvaluationStatus)evaluateWithCurrentPath:(NSString *)currentPath parentPathRef:(SMJPathRef *)parent jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error
+- (SMJEvaluationStatus)evaluateWithCurrentPath:(const SMJPathSegment *)currentPath parentPathRef:(SMJPathRef *)parent jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error
 {
 	SMJPathToken *pt = self.next;
 	
@@ -90,13 +105,37 @@ NS_ASSUME_NONNULL_BEGIN
 }
 
 
+/*
+** SMJScanPathToken - Walk
+*/
+#pragma mark - SMJScanPathToken - Walk
+
+- (id <SMJScanPredicate>)scanPredicateWithEvaluationContext:(SMJEvaluationContextImpl *)context
+{
+	return [self createScanPredicate:self.next context:context];
+}
+
+- (SMJEvaluationStatus)visitJsonObject:(id)jsonObject currentPath:(const SMJPathSegment *)currentPath parentPathRef:(SMJPathRef *)parent predicate:(id <SMJScanPredicate>)predicate evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error
+{
+	if ([jsonObject isKindOfClass:[NSDictionary class]])
+		return [self visitObject:self.next currentPath:currentPath parent:parent jsonObject:jsonObject context:context predicate:predicate error:error];
+	else if ([jsonObject isKindOfClass:[NSArray class]])
+		return [self visitArray:self.next currentPath:currentPath parent:parent jsonObject:jsonObject context:context predicate:predicate error:error];
+	
+	return SMJEvaluationStatusDone;
+}
+
+
 /*
 ** SMJScanPathToken - Helpers
 */
 #pragma mark - SMJScanPathToken - Helpers
 
-- (SMJEvaluationStatus)walk:(SMJPathToken *)pt currentPath:(NSString *)currentPath parent:(SMJPathRef *)parent jsonObject:(id)jsonObject context:(SMJEvaluationContextImpl *)context predicate:(id <SMJScanPredicate>)predicate  error:(NSError **)error
+- (SMJEvaluationStatus)walk:(SMJPathToken *)pt currentPath:(const SMJPathSegment *)currentPath parent:(SMJPathRef *)parent jsonObject:(id)jsonObject context:(SMJEvaluationContextImpl *)context predicate:(id <SMJScanPredicate>)predicate  error:(NSError **)error
 {
+	if (context.profile)
+		[context.profile recordScanOfToken:self];
+	
 	if ([jsonObject isKindOfClass:[NSDictionary class]])
 		return [self walkObject:pt currentPath:currentPath parent:parent jsonObject:jsonObject context:context predicate:predicate error:error];
 	else if ([jsonObject isKindOfClass:[NSArray class]])
@@ -105,14 +144,165 @@ NS_ASSUME_NONNULL_BEGIN
 	return SMJEvaluationStatusDone;
 }
 
-- (SMJEvaluationStatus)walkArray:(SMJPathToken *)pt currentPath:(NSString *)currentPath parent:(SMJPathRef *)parent jsonObject:(NSArray *)jsonObject context:(SMJEvaluationContextImpl *)context predicate:(id <SMJScanPredicate>)predicate error:(NSError **)error
+- (SMJEvaluationStatus)walkArray:(SMJPathToken *)pt currentPath:(const SMJPathSegment *)currentPath parent:(SMJPathRef *)parent jsonObject:(NSArray *)jsonObject context:(SMJEvaluationContextImpl *)context predicate:(id <SMJScanPredicate>)predicate error:(NSError **)error
+{
+	// Evaluate.
+	SMJEvaluationStatus status = [self visitArray:pt currentPath:currentPath parent:parent jsonObject:jsonObject context:context predicate:predicate error:error];
+	
+	if (status != SMJEvaluationStatusDone)
+		return status;
+	
+	// Recurse.
+	NSUInteger parallelScanThreshold = context.parallelScanThreshold;
+	
+	if (parallelScanThreshold > 0 && jsonObject.count >= parallelScanThreshold)
+		return [self walkChildrenInParallel:pt currentPath:currentPath jsonObject:jsonObject context:context error:error];
+	
+	BOOL		forUpdate = context.forUpdate;
+	NSUInteger	idx = 0;
+
+	for (id evalObject in jsonObject)
+	{
+		SMJPathSegment		evalPath = SMJPathSegmentMakeIndex(currentPath, (NSInteger)idx);
+		SMJPathRef			*evalParent = forUpdate ? [SMJPathRef pathRefWithObject:jsonObject index:idx] : [SMJPathRef pathRefNull];
+		SMJEvaluationStatus	result = [self walk:pt currentPath:&evalPath parent:evalParent jsonObject:evalObject context:context predicate:predicate error:error];
+		
+		if (result == SMJEvaluationStatusError)
+			return SMJEvaluationStatusError;
+		else if (result == SMJEvaluationStatusAborted)
+			return SMJEvaluationStatusAborted;
+		
+		idx++;
+	}
+	
+	return SMJEvaluationStatusDone;
+}
+
+- (SMJEvaluationStatus)walkObject:(SMJPathToken *)pt currentPath:(const SMJPathSegment *)currentPath parent:(SMJPathRef *)parent jsonObject:(NSDictionary *)jsonObject context:(SMJEvaluationContextImpl *)context predicate:(id <SMJScanPredicate>)predicate error:(NSError **)error
 {
 	// Evaluate.
+	SMJEvaluationStatus status = [self visitObject:pt currentPath:currentPath parent:parent jsonObject:jsonObject context:context predicate:predicate error:error];
+	
+	if (status != SMJEvaluationStatusDone)
+		return status;
+	
+	// Recurse.
+	NSUInteger parallelScanThreshold = context.parallelScanThreshold;
+	
+	if (parallelScanThreshold > 0 && jsonObject.count >= parallelScanThreshold)
+		return [self walkChildrenInParallel:pt currentPath:currentPath jsonObject:jsonObject context:context error:error];
+	
+	BOOL forUpdate = context.forUpdate;
+	
+	for (NSString *property in jsonObject)
+	{
+		id propertyObject = jsonObject[property];
+		
+		SMJPathSegment	evalPath = SMJPathSegmentMakeProperty(currentPath, property);
+		SMJPathRef		*evalParent = forUpdate ? [SMJPathRef pathRefWithObject:jsonObject property:property] : [SMJPathRef pathRefNull];
+		
+		SMJEvaluationStatus result = [self walk:pt currentPath:&evalPath parent:evalParent jsonObject:propertyObject context:context predicate:predicate error:error];
+		
+		if (result == SMJEvaluationStatusError)
+			return SMJEvaluationStatusError;
+		else if (result == SMJEvaluationStatusAborted)
+			return SMJEvaluationStatusAborted;
+	}
+	
+	return SMJEvaluationStatusDone;
+}
+
+- (SMJEvaluationStatus)walkChildrenInParallel:(SMJPathToken *)pt currentPath:(const SMJPathSegment *)currentPath jsonObject:(id)jsonObject context:(SMJEvaluationContextImpl *)context error:(NSError **)error
+{
+	// Snapshot children in enumeration order.
+	NSArray		*keys = ([jsonObject isKindOfClass:[NSDictionary class]] ? [(NSDictionary *)jsonObject allKeys] : nil);
+	NSUInteger	count = [jsonObject count];
+	BOOL		forUpdate = context.forUpdate;
+	
+	// Split children in contiguous chunks, each one evaluated in its own worker context.
+	NSUInteger concurrency = context.parallelConcurrency;
+	NSUInteger chunkSize = SMJParallelChunkSize(count, concurrency);
+	
+	NSMutableArray <SMJScanChunk *> *chunks = [[NSMutableArray alloc] init];
+	
+	for (NSUInteger location = 0; location < count; location += chunkSize)
+	{
+		SMJScanChunk *chunk = [[SMJScanChunk alloc] init];
+		
+		chunk->_context = [[SMJEvaluationContextImpl alloc] initWithParentContext:context];
+		chunk->_status = SMJEvaluationStatusDone;
+		
+		[chunks addObject:chunk];
+	}
+	
+	// Evaluate chunks. Once a chunk fails or aborts, results of the following chunks would be dropped: stop there.
+	SMJParallelApply(count, chunkSize, concurrency, ^BOOL(NSUInteger chunkIndex, NSRange range) {
+		SMJScanChunk				*chunk = chunks[chunkIndex];
+		SMJEvaluationContextImpl	*chunkContext = chunk->_context;
+		id <SMJScanPredicate>		predicate = [self createScanPredicate:pt context:chunkContext];
+		NSError						*chunkError = nil;
+		
+		for (NSUInteger idx = range.location; idx < NSMaxRange(range); idx++)
+		{
+			SMJPathSegment	evalPath;
+			SMJPathRef		*evalParent;
+			id				evalObject;
+			
+			if (keys)
+			{
+				NSString *property = keys[idx];
+				
+				evalObject = ((NSDictionary *)jsonObject)[property];
+				evalPath = SMJPathSegmentMakeProperty(currentPath, property);
+				evalParent = forUpdate ? [SMJPathRef pathRefWithObject:jsonObject property:property] : [SMJPathRef pathRefNull];
+			}
+			else
+			{
+				evalObject = ((NSArray *)jsonObject)[idx];
+				evalPath = SMJPathSegmentMakeIndex(currentPath, (NSInteger)idx);
+				evalParent = forUpdate ? [SMJPathRef pathRefWithObject:jsonObject index:idx] : [SMJPathRef pathRefNull];
+			}
+			
+			SMJEvaluationStatus result = [self walk:pt currentPath:&evalPath parent:evalParent jsonObject:evalObject context:chunkContext predicate:predicate error:&chunkError];
+			
+			if (result != SMJEvaluationStatusDone)
+			{
+				chunk->_status = result;
+				chunk->_error = chunkError;
+				
+				return NO;
+			}
+		}
+		
+		return YES;
+	});
+	
+	// Merge results in document order.
+	for (SMJScanChunk *chunk in chunks)
+	{
+		SMJEvaluationContextStatus status = [context mergeResultsOfContext:chunk->_context];
+		
+		if (chunk->_status == SMJEvaluationStatusError)
+		{
+			if (error)
+				*error = chunk->_error;
+			
+			return SMJEvaluationStatusError;
+		}
+		else if (chunk->_status == SMJEvaluationStatusAborted || status == SMJEvaluationContextStatusAborted)
+			return SMJEvaluationStatusAborted;
+	}
+	
+	return SMJEvaluationStatusDone;
+}
+
+- (SMJEvaluationStatus)visitArray:(SMJPathToken *)pt currentPath:(const SMJPathSegment *)currentPath parent:(SMJPathRef *)parent jsonObject:(NSArray *)jsonObject context:(SMJEvaluationContextImpl *)context predicate:(id <SMJScanPredicate>)predicate error:(NSError **)error
+{
 	if ([predicate matchesJsonObject:jsonObject])
 	{
 		if (pt.leaf)
 		{
-			SMJEvaluationStatus result = [pt evaluateWithCurrentPath:currentPath parentPathRef:parent jsonObject:jsonObject evaluationContext:context error:error];
+			SMJEvaluationStatus result = SMJPathTokenEvaluate(pt, currentPath, parent, jsonObject, context, error);
 			
 			if (result == SMJEvaluationStatusError)
 				return SMJEvaluationStatusError;
@@ -126,8 +316,8 @@ NS_ASSUME_NONNULL_BEGIN
 
 			for (id evalObject in jsonObject)
 			{
-				NSString *evalPath = [NSString stringWithFormat:@"%@[%lu]", currentPath, (unsigned long)idx];
-				SMJEvaluationStatus result = [next evaluateWithCurrentPath:evalPath parentPathRef:parent jsonObject:evalObject evaluationContext:context error:error];
+				SMJPathSegment		evalPath = SMJPathSegmentMakeIndex(currentPath, (NSInteger)idx);
+				SMJEvaluationStatus	result = SMJPathTokenEvaluate(next, &evalPath, parent, evalObject, context, error);
 				
 				if (result == SMJEvaluationStatusError)
 					return SMJEvaluationStatusError;
@@ -139,46 +329,14 @@ NS_ASSUME_NONNULL_BEGIN
 		}
 	}
 	
-	// Recurse.
-	NSUInteger idx = 0;
-
-	for (id evalObject in jsonObject)
-	{
-		NSString *evalPath = [NSString stringWithFormat:@"%@[%lu]", currentPath, (unsigned long)idx];
-		SMJEvaluationStatus result = [self walk:pt currentPath:evalPath parent:[SMJPathRef pathRefWithObject:jsonObject item:evalObject]  jsonObject:evalObject context:context predicate:predicate error:error];
-		
-		if (result == SMJEvaluationStatusError)
-			return SMJEvaluationStatusError;
-		else if (result == SMJEvaluationStatusAborted)
-			return SMJEvaluationStatusAborted;
-		
-		idx++;
-	}
-	
 	return SMJEvaluationStatusDone;
 }
 
-- (SMJEvaluationStatus)walkObject:(SMJPathToken *)pt currentPath:(NSString *)currentPath parent:(SMJPathRef *)parent jsonObject:(NSDictionary *)jsonObject context:(SMJEvaluationContextImpl *)context predicate:(id <SMJScanPredicate>)predicate error:(NSError **)error
+- (SMJEvaluationStatus)visitObject:(SMJPathToken *)pt currentPath:(const SMJPathSegment *)currentPath parent:(SMJPathRef *)parent jsonObject:(NSDictionary *)jsonObject context:(SMJEvaluationContextImpl *)context predicate:(id <SMJScanPredicate>)predicate error:(NSError **)error
 {
-	// Evaluate.
 	if ([predicate matchesJsonObject:jsonObject])
 	{
-		SMJEvaluationStatus result = [pt evaluateWithCurrentPath:currentPath parentPathRef:parent jsonObject:jsonObject evaluationContext:context error:error];
-		
-		if (result == SMJEvaluationStatusError)
-			return SMJEvaluationStatusError;
-		else if (result == SMJEvaluationStatusAborted)
-			return SMJEvaluationStatusAborted;
-	}
-	
-	// Recurse.
-	for (NSString *property in jsonObject)
-	{
-		id propertyObject = jsonObject[property];
-		
-		NSString *evalPath = [NSString stringWithFormat:@"%@['%@']", currentPath, property];
-		
-		SMJEvaluationStatus result = [self walk:pt currentPath:evalPath parent:[SMJPathRef pathRefWithObject:jsonObject property:property] jsonObject:propertyObject context:context predicate:predicate error:error];
+		SMJEvaluationStatus result = SMJPathTokenEvaluate(pt, currentPath, parent, jsonObject, context, error);
 		
 		if (result == SMJEvaluationStatusError)
 			return SMJEvaluationStatusError;
@@ -207,6 +365,16 @@ NS_ASSUME_NONNULL_BEGIN
 
 
 
+/*
+** Parallel
+*/
+#pragma mark - Parallel
+
+@implementation SMJScanChunk
+@end
+
+
+
 /*
 ** Predicates
 */
@@ -258,18 +426,18 @@ NS_ASSUME_NONNULL_BEGIN
 		return YES;
 	}
 	
-	if (_propertyPathToken.leaf && [_ctx.configuration containsOption:SMJOptionDefaultPathLeafToNull])
+	if (_propertyPathToken.leaf && [_ctx containsOption:SMJOptionDefaultPathLeafToNull])
 	{
 		// In case of SMJOptionDefaultPathLeafToNull missing properties is not a problem.
 		return YES;
 	}
 	
-	NSArray <NSString *> *keys = [(NSDictionary *)jsonObject allKeys];
-	NSArray <NSString *> *properties = _propertyPathToken.properties;
+	NSDictionary			*dictionary = jsonObject;
+	NSArray <NSString *>	*properties = _propertyPathToken.properties;
 	
 	for (NSString *property in properties)
 	{
-		if ([keys containsObject:property] == NO)
+		if (dictionary[property] == nil)
 			return NO;
 	}
 	
@@ -42,6 +42,20 @@ NS_ASSUME_NONNULL_BEGIN
 
 + (nullable NSNumber *)numberWithString:(NSString *)string;
 
+// Number of a NUL terminated JSON number, already validated against the JSON grammar. The conversion doesn't depend on the current locale.
++ (NSNumber *)numberWithJSONNumberCString:(const char *)string integer:(BOOL)integer;
+
+// Hash of a JSON tree, consistent with -isEqual: (so 1 and 1.0 hash the same, and dictionaries hash whatever their keys order).
+// Unlike -[NSArray hash] and -[NSDictionary hash], which only hash the count, the whole tree is taken into account.
++ (NSUInteger)structuralHashForJSONObject:(id)object;
+
+// JSON Pointers (RFC 6901). Components are NSString keys and NSNumber indexes, reference tokens are unescaped strings.
++ (NSString *)jsonPointerWithComponents:(NSArray *)components;
++ (nullable NSArray <NSString *> *)referenceTokensOfJSONPointer:(NSString *)jsonPointer; // nil if the pointer is invalid.
+
+// Copy of a JSON tree using mutable containers all the way down. Scalars are shared.
++ (id)mutableCopyOfJSONObject:(id)object;
+
 @end
 
 
@@ -20,6 +20,10 @@
 /* Adapted from https://github.com/json-path/JsonPath/blob/master/json-path/src/main/java/com/jayway/jsonpath/internal/Utils.java */
 
 
+#include <errno.h>
+#include <locale.h>
+#include <stdlib.h>
+
 #import "SMJUtils.h"
 
 
@@ -32,6 +36,7 @@ NS_ASSUME_NONNULL_BEGIN
 #pragma mark - Prototypes
 
 static NSString * hexadecimal(uint16_t value);
+static NSUInteger mixHash(NSUInteger hash);
 
 
 /*
@@ -326,6 +331,163 @@ static NSString * hexadecimal(uint16_t value);
 	return nil;
 }
 
++ (NSNumber *)numberWithJSONNumberCString:(const char *)string integer:(BOOL)integer
+{
+	// Digits only: strtoll doesn't depend on the locale.
+	if (integer)
+	{
+		errno = 0;
+		
+		long long value = strtoll(string, NULL, 10);
+		
+		if (errno != ERANGE)
+			return [NSNumber numberWithLongLong:value];
+	}
+	
+	// The decimal separator of strtod depends on the locale of the thread: switch it to "C" during the conversion.
+	static locale_t			cLocale;
+	static dispatch_once_t	onceToken;
+	
+	dispatch_once(&onceToken, ^{
+		cLocale = newlocale(LC_NUMERIC_MASK, "C", (locale_t)0);
+	});
+	
+	if (!cLocale)
+		return [NSNumber numberWithDouble:strtod(string, NULL)];
+	
+	locale_t	previousLocale = uselocale(cLocale);
+	double		value = strtod(string, NULL);
+	
+	uselocale(previousLocale);
+	
+	return [NSNumber numberWithDouble:value];
+}
+
++ (NSUInteger)structuralHashForJSONObject:(id)object
+{
+	if ([object isKindOfClass:[NSArray class]])
+	{
+		// Ordered: each item is mixed with the hash of the previous ones.
+		NSUInteger hash = mixHash(((NSArray *)object).count + 1);
+		
+		for (id item in (NSArray *)object)
+			hash = mixHash(hash ^ [self structuralHashForJSONObject:item]);
+		
+		return hash;
+	}
+	else if ([object isKindOfClass:[NSDictionary class]])
+	{
+		// Unordered: entries are summed.
+		__block NSUInteger hash = mixHash(((NSDictionary *)object).count + 2);
+		
+		[(NSDictionary *)object enumerateKeysAndObjectsUsingBlock:^(id _Nonnull key, id _Nonnull value, BOOL * _Nonnull stop) {
+			hash += mixHash([key hash] ^ mixHash([self structuralHashForJSONObject:value]));
+		}];
+		
+		return hash;
+	}
+	
+	// Strings, numbers and null already hash their value.
+	return [object hash];
+}
+
++ (NSString *)jsonPointerWithComponents:(NSArray *)components
+{
+	NSMutableString *result = [[NSMutableString alloc] init];
+	
+	for (id component in components)
+	{
+		NSString *token = ([component isKindOfClass:[NSNumber class]] ? [component stringValue] : component);
+		
+		[result appendString:@"/"];
+		
+		if ([token rangeOfCharacterFromSet:[NSCharacterSet characterSetWithCharactersInString:@"~/"]].location == NSNotFound)
+			[result appendString:token];
+		else
+			[result appendString:[[token stringByReplacingOccurrencesOfString:@"~" withString:@"~0"] stringByReplacingOccurrencesOfString:@"/" withString:@"~1"]];
+	}
+	
+	return result;
+}
+
++ (nullable NSArray <NSString *> *)referenceTokensOfJSONPointer:(NSString *)jsonPointer
+{
+	if (jsonPointer.length == 0)
+		return @[];
+	
+	if ([jsonPointer hasPrefix:@"/"] == NO)
+		return nil;
+	
+	NSArray <NSString *>	*rawTokens = [[jsonPointer substringFromIndex:1] componentsSeparatedByString:@"/"];
+	NSMutableArray			*tokens = [[NSMutableArray alloc] initWithCapacity:rawTokens.count];
+	
+	for (NSString *rawToken in rawTokens)
+	{
+		NSRange tildeRange = [rawToken rangeOfString:@"~"];
+		
+		if (tildeRange.location == NSNotFound)
+		{
+			[tokens addObject:rawToken];
+			continue;
+		}
+		
+		// '~' has to be followed by '0' or '1'.
+		NSMutableString	*token = [[NSMutableString alloc] initWithCapacity:rawToken.length];
+		NSUInteger		length = rawToken.length;
+		
+		for (NSUInteger i = 0; i < length; i++)
+		{
+			unichar ch = [rawToken characterAtIndex:i];
+			
+			if (ch != '~')
+			{
+				[token appendFormat:@"%C", ch];
+				continue;
+			}
+			
+			unichar next = (i + 1 < length ? [rawToken characterAtIndex:i + 1] : 0);
+			
+			if (next == '0')
+				[token appendString:@"~"];
+			else if (next == '1')
+				[token appendString:@"/"];
+			else
+				return nil;
+			
+			i++;
+		}
+		
+		[tokens addObject:token];
+	}
+	
+	return tokens;
+}
+
++ (id)mutableCopyOfJSONObject:(id)object
+{
+	if ([object isKindOfClass:[NSDictionary class]])
+	{
+		NSMutableDictionary *result = [[NSMutableDictionary alloc] initWithCapacity:((NSDictionary *)object).count];
+		
+		[(NSDictionary *)object enumerateKeysAndObjectsUsingBlock:^(id _Nonnull key, id _Nonnull value, BOOL * _Nonnull stop) {
+			result[key] = [self mutableCopyOfJSONObject:value];
+		}];
+		
+		return result;
+	}
+	else if ([object isKindOfClass:[NSArray class]])
+	{
+		NSMutableArray *result = [[NSMutableArray alloc] initWithCapacity:((NSArray *)object).count];
+		
+		for (id item in (NSArray *)object)
+			[result addObject:[self mutableCopyOfJSONObject:item]];
+		
+		return result;
+	}
+	
+	return object;
+}
+
 @end
 
 
@@ -335,6 +497,18 @@ static NSString * hexadecimal(uint16_t value);
 */
 #pragma mark - C Tools
 
+static NSUInteger mixHash(NSUInteger hash)
+{
+	// Finalizer of splitmix64.
+	uint64_t value = (uint64_t)hash;
+	
+	value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+	value = value ^ (value >> 31);
+	
+	return (NSUInteger)value;
+}
+
 static NSString * hexadecimal(uint16_t value)
 {
 	const char	hexTable[] = "0123456789ABCDEF";
@@ -28,6 +28,7 @@
 #import "SMJPredicate.h"
 
 #import "SMJPath.h"
+#import "SMJCompiledPattern.h"
 
 
 NS_ASSUME_NONNULL_BEGIN
@@ -65,6 +66,7 @@ NS_ASSUME_NONNULL_BEGIN
 + (SMJBooleanNode *)booleanNodeWithString:(NSString *)string;
 + (SMJPathNode *)pathNodeWithPath:(id <SMJPath>)path;
 + (nullable SMJPathNode *)pathNodeWithPathString:(NSString *)pathString existsCheck:(BOOL)existsCheck shouldExists:(BOOL)shouldExists error:(NSError **)error;
++ (nullable SMJValueNode *)valueNodeWithJsonObject:(id)jsonObject error:(NSError **)error;
 
 @end
 
@@ -84,6 +86,7 @@ NS_ASSUME_NONNULL_BEGIN
 @property (readonly, getter=isExistsCheck) BOOL existsCheck;
 
 - (nullable SMJValueNode *)evaluate:(id <SMJPredicateContext>)context error:(NSError **)error;
+- (nullable id)evaluateJsonObject:(id <SMJPredicateContext>)context error:(NSError **)error; // The value evaluate: wraps in a node. Not for exists checks.
 
 - (id <SMJPath>)underlayingObjectWithError:(NSError **)error;
 
@@ -105,6 +108,13 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (nullable id)underlayingObjectWithError:(NSError **)error;
 
+// The items of a literal JSON array, hashed once when the node is compiled, so membership tests don't scan the array.
+// nil if the JSON isn't an array, or for nodes built on evaluated values.
+@property (nullable, readonly) NSSet *arrayItems;
+
+// Structural hash of the JSON tree, computed when the node is compiled for literals, on first use for evaluated values.
+@property (readonly) NSUInteger structuralHash;
+
 @end
 
 
@@ -113,6 +123,7 @@ NS_ASSUME_NONNULL_BEGIN
 - (instancetype)init NS_UNAVAILABLE;
 
 - (nullable NSRegularExpression *)underlayingObjectWithError:(NSError **)error;
+- (nullable SMJCompiledPattern *)compiledPatternWithError:(NSError **)error;
 
 @end
 
@@ -24,9 +24,9 @@
 #import "SMJValueNode.h"
 
 #import "SMJUtils.h"
-#import "SMJPatternFlags.h"
 
 #import "SMJPathCompiler.h"
+#import "SMJCompiledPath.h"
 #import "SMJPredicateContextImpl.h"
 
 
@@ -170,6 +170,36 @@ NS_ASSUME_NONNULL_BEGIN
 	return [[SMJPathNode alloc] initWithPath:path];
 }
 
++ (nullable SMJValueNode *)valueNodeWithJsonObject:(id)object error:(NSError **)error
+{
+	if ([object isKindOfClass:[NSNumber class]])
+	{
+		NSNumber *number = object;
+		
+		if (strcmp([number objCType], @encode(BOOL)) == 0)
+			return [[SMJBooleanNode alloc] initWithBoolean:[number boolValue]];
+		else
+			return [[SMJNumberNode alloc] initWithNumber:number];
+	}
+	else if ([object isKindOfClass:[NSString class]])
+	{
+		return [[SMJStringNode alloc] initWithString:object];
+	}
+	else if ([object isKindOfClass:[NSNull class]])
+	{
+		return [[SMJNullNode alloc] initInternal];
+	}
+	else if ([object isKindOfClass:[NSArray class]] || [object isKindOfClass:[NSDictionary class]])
+	{
+		return [[SMJJsonNode alloc] initWithJsonObject:object];
+	}
+	else
+	{
+		SMSetError(error, 1, @"Could not convert %@ to a ValueNode", [object class]);
+		return nil;
+	}
+}
+
 @end
 
 
@@ -196,7 +226,7 @@ NS_ASSUME_NONNULL_BEGIN
 	
 	if (self)
 	{
-		_path = [SMJPathCompiler compilePathString:pathString error:error];
+		_path = [SMJPathCompiler compileSharedPathString:pathString error:error];
 		
 		if (!_path)
 			return nil;
@@ -261,7 +291,15 @@ NS_ASSUME_NONNULL_BEGIN
 {
 	if (self.existsCheck)
 	{
-		SMJConfiguration *configuration = [context.configuration copy];
+		// Compiled paths have a dedicated probe, which doesn't need the configuration to be copied.
+		if ([(NSObject *)_path isKindOfClass:[SMJCompiledPath class]])
+		{
+			BOOL exists = [(SMJCompiledPath *)_path probeJsonObject:context.jsonObject rootJsonObject:context.rootJsonObject configuration:context.configuration];
+			
+			return (exists ? [SMJValueNodes valueNodeTRUE] : [SMJValueNodes valueNodeFALSE]);
+		}
+		
+		SMJConfiguration *configuration = [context.configuration mutableCopy];
 		
 		[configuration addOption:SMJOptionRequireProperties];
 		
@@ -279,57 +317,35 @@ NS_ASSUME_NONNULL_BEGIN
 	}
 	else
 	{
-		id object = nil;
-		
-		if ([context isKindOfClass:[SMJPredicateContextImpl class]])
-		{
-			//This will use cache for root ($) queries
-			SMJPredicateContextImpl *ctxi = (SMJPredicateContextImpl *)context;
-			
-			object = [ctxi evaluatePath:_path error:error];
-		}
-		else
-		{
-			id doc = _path.rootPath ? context.rootJsonObject : context.jsonObject;
-			id <SMJEvaluationContext> evaluationContext = [_path evaluateJsonObject:doc rootJsonObject:context.rootJsonObject configuration:context.configuration error:error];
-			
-			object = [evaluationContext jsonObjectWithError: error];
-		}
+		id object = [self evaluateJsonObject:context error:error];
 		
 		if (!object)
 			return nil;
 		
-		if ([object isKindOfClass:[NSNumber class]])
-		{
-			NSNumber *number = object;
-			
-			if (strcmp([number objCType], @encode(BOOL)) == 0)
-				return [[SMJBooleanNode alloc] initWithBoolean:[number boolValue]];
-			else
-				return [[SMJNumberNode alloc] initWithNumber:number];
-		}
-		else if ([object isKindOfClass:[NSString class]])
-		{
-			return [[SMJStringNode alloc] initWithString:object];
-		}
-		else if ([object isKindOfClass:[NSNull class]])
-		{
-			return [[SMJNullNode alloc] initInternal];
-		}
-		else if ([object isKindOfClass:[NSArray class]] || [object isKindOfClass:[NSDictionary class]])
-		{
-			return [[SMJJsonNode alloc] initWithJsonObject:object];
-		}
-		else
-		{
-			SMSetError(error, 1, @"Could not convert %@ to a ValueNode", [object class]);
-			return nil;
-		}
+		return [SMJValueNodes valueNodeWithJsonObject:object error:error];
 	}
 	
 	return nil;
 }
 
+- (nullable id)evaluateJsonObject:(id <SMJPredicateContext>)context error:(NSError **)error
+{
+	if ([context isKindOfClass:[SMJPredicateContextImpl class]])
+	{
+		//This will use cache for root ($) queries
+		SMJPredicateContextImpl *ctxi = (SMJPredicateContextImpl *)context;
+		
+		return [ctxi evaluatePath:_path error:error];
+	}
+	else
+	{
+		id doc = _path.rootPath ? context.rootJsonObject : context.jsonObject;
+		id <SMJEvaluationContext> evaluationContext = [_path evaluateJsonObject:doc rootJsonObject:context.rootJsonObject configuration:context.configuration error:error];
+		
+		return [evaluationContext jsonObjectWithError: error];
+	}
+}
+
 - (NSString *)stringValue
 {
 	if (_existsCheck && !_shouldExists)
@@ -401,9 +417,11 @@ NS_ASSUME_NONNULL_BEGIN
 {
 	NSString *_jsonString;
 	
-	BOOL	_done;
 	id		_json;
 	NSError	*_error;
+	
+	NSUInteger	_structuralHash;
+	BOOL		_hasStructuralHash;
 }
 
 - (instancetype)initWithString:(NSString *)string
@@ -412,7 +430,30 @@ NS_ASSUME_NONNULL_BEGIN
 	
 	if (self)
 	{
+		NSError *lerror = nil;
+		
 		_jsonString = [string copy];
+		
+		// Parse now: literal nodes are part of compiled paths, which are shared, and so have to stay untouched once built.
+		_json = [NSJSONSerialization JSONObjectWithData:[_jsonString dataUsingEncoding:NSUTF8StringEncoding] options:NSJSONReadingAllowFragments error:&lerror];
+		_error = lerror;
+		
+		if (_json && [_json isKindOfClass:[NSDictionary class]] == NO && [_json isKindOfClass:[NSArray class]] == NO)
+		{
+			_json = nil;
+			_error = [NSError errorWithDomain:@"SMJValueNodesErrorNode" code:1 userInfo:@{ NSLocalizedDescriptionKey : @"Invalid JSON type" }];
+		}
+		
+		// Hash literal arrays now: IN, ANYOF, etc. probe them for each filtered item.
+		if ([_json isKindOfClass:[NSArray class]])
+			_arrayItems = [[NSSet alloc] initWithArray:_json];
+		
+		// Same for the structural hash: literal nodes are shared, and have to stay untouched once built.
+		if (_json)
+		{
+			_structuralHash = [SMJUtils structuralHashForJSONObject:_json];
+			_hasStructuralHash = YES;
+		}
 	}
 	
 	return self;
@@ -425,7 +466,6 @@ NS_ASSUME_NONNULL_BEGIN
 	if (self)
 	{
 		_json = jsonObject;
-		_done = YES;
 	}
 	
 	return self;
@@ -455,27 +495,66 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (nullable id)underlayingObjectWithError:(NSError **)error
 {
-	if (!_done)
-	{
-		NSError *lerror = nil;
-		
-		_json = [NSJSONSerialization JSONObjectWithData:[_jsonString dataUsingEncoding:NSUTF8StringEncoding] options:NSJSONReadingAllowFragments error:&lerror];
-		_error = lerror;
-		_done = YES;
-				
-		if (_json && [_json isKindOfClass:[NSDictionary class]] == NO && [_json isKindOfClass:[NSArray class]] == NO)
-		{
-			_json = nil;
-			_error = [NSError errorWithDomain:@"SMJValueNodesErrorNode" code:1 userInfo:@{ NSLocalizedDescriptionKey : @"Invalid JSON type" }];
-		}
-	}
-	
 	if (error)
 		*error = _error;
 		
 	return _json;
 }
 
+- (NSUInteger)structuralHash
+{
+	// Evaluated nodes are built for one evaluation, so they can be lazily updated.
+	if (!_hasStructuralHash)
+	{
+		_structuralHash = (_json ? [SMJUtils structuralHashForJSONObject:_json] : 0);
+		_hasStructuralHash = YES;
+	}
+	
+	return _structuralHash;
+}
+
+- (SMJEqualityResult)isEqual:(SMJValueNode *)node withError:(NSError **)error
+{
+	if ([node isKindOfClass:[SMJJsonNode class]] == NO)
+		return [super isEqual:node withError:error];
+	
+	SMJJsonNode	*jsonNode = (SMJJsonNode *)node;
+	id			json1 = [self underlayingObjectWithError:error];
+	id			json2 = [jsonNode underlayingObjectWithError:error];
+	
+	if (!json1 || !json2)
+		return SMJEqualityError;
+	
+	// Same sub-tree.
+	if (json1 == json2)
+		return SMJEqualitySame;
+	
+	// Hashes already known: different hashes mean different trees, without walking them.
+	if (_hasStructuralHash && jsonNode->_hasStructuralHash && _structuralHash != jsonNode->_structuralHash)
+		return SMJEqualityDiffer;
+	
+	return ([json1 isEqual:json2] ? SMJEqualitySame : SMJEqualityDiffer);
+}
+
+- (SMJComparisonResult)compare:(SMJValueNode *)node withError:(NSError **)error
+{
+	// JSON trees are not ordered: comparing them is an equality test.
+	if ([node isKindOfClass:[SMJJsonNode class]] == NO)
+		return [super compare:node withError:error];
+	
+	switch ([self isEqual:node withError:error])
+	{
+		case SMJEqualitySame:
+			return SMJComparisonSame;
+			
+		case SMJEqualityDiffer:
+			return SMJComparisonDiffer;
+			
+		case SMJEqualityError:
+			return SMJComparisonError;
+	}
+}
+
 @end
 
 
@@ -487,8 +566,7 @@ NS_ASSUME_NONNULL_BEGIN
 	NSString *_pattern;
 	NSString *_flags;
 	
-	BOOL				_done;
-	NSRegularExpression	*_compiledPattern;
+	SMJCompiledPattern	*_compiledPattern;
 	NSError				*_error;
 }
 
@@ -518,6 +596,12 @@ NS_ASSUME_NONNULL_BEGIN
 		NSInteger flagsIndex = end + 1;
 		
 		_flags = string.length > flagsIndex ? [string substringFromIndex:flagsIndex] : @"";
+		
+		// Compile pattern now, so the node doesn't change once the path is compiled. Identical patterns share the same compiled pattern.
+		NSError *lerror = nil;
+		
+		_compiledPattern = [SMJCompiledPattern compiledPatternWithPattern:_pattern flags:_flags error:&lerror];
+		_error = lerror;
 	}
 	
 	return self;
@@ -535,15 +619,14 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (nullable NSRegularExpression *)underlayingObjectWithError:(NSError **)error
 {
-	if (!_done)
-	{
-		NSError *lerror = nil;
-		
-		_compiledPattern = [NSRegularExpression regularExpressionWithPattern:_pattern options:[SMJPatternFlags parseFlags:_flags] error:&lerror];
-		_error = lerror;
-		_done = YES;
-	}
+	if (error)
+		*error = _error;
+	
+	return _compiledPattern.regularExpression;
+}
 
+- (nullable SMJCompiledPattern *)compiledPatternWithError:(NSError **)error
+{
 	if (error)
 		*error = _error;
 	
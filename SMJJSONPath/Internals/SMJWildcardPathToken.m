@@ -36,7 +36,7 @@
 */
 #pragma mark - SMJWildcardPathToken - SMJPathToken
 
-- (SMJEvaluationStatus)evaluateWithCurrentPath:(NSString *)currentPath parentPathRef:(SMJPathRef *)parent jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error
+- (SMJEvaluationStatus)evaluateWithCurrentPath:(const SMJPathSegment *)currentPath parentPathRef:(SMJPathRef *)parent jsonObject:(id)jsonObject evaluationContext:(SMJEvaluationContextImpl *)context error:(NSError **)error
 {
 	if ([jsonObject isKindOfClass:[NSDictionary class]])
 	{
@@ -45,7 +45,7 @@
 		
 		for (NSString *propery in keys)
 		{
-			SMJEvaluationStatus result = [self handleObjectPropertyWithCurrentPathString:currentPath jsonObject:jsonObject evaluationContext:context properties:@[ propery ] error:error];
+			SMJEvaluationStatus result = [self handleObjectPropertyWithCurrentPath:currentPath jsonObject:jsonObject evaluationContext:context properties:@[ propery ] error:error];
 			
 			if (result == SMJEvaluationStatusError)
 				return SMJEvaluationStatusError;
@@ -59,11 +59,11 @@
 		
 		for (NSInteger idx = 0; idx < array.count; idx++)
 		{
-			SMJEvaluationStatus result = [self handleArrayIndex:idx currentPathString:currentPath jsonObject:jsonObject evaluationContext:context error:error];
+			SMJEvaluationStatus result = [self handleArrayIndex:idx currentPath:currentPath jsonObject:jsonObject evaluationContext:context error:error];
 			
 			if (result == SMJEvaluationStatusError)
 			{
-				if ([context.configuration containsOption:SMJOptionRequireProperties])
+				if ([context containsOption:SMJOptionRequireProperties])
 					return SMJEvaluationStatusError;
 			}
 			else if (result == SMJEvaluationStatusAborted)
@@ -29,18 +29,46 @@
 NS_ASSUME_NONNULL_BEGIN
 
 
+/*
+** Types
+*/
+#pragma mark - Types
+
+typedef NSUInteger SMJOptionMask;
+
+NS_INLINE SMJOptionMask SMJOptionMaskMake(SMJOption option)
+{
+	return ((SMJOptionMask)1 << option);
+}
+
+NS_INLINE BOOL SMJOptionMaskContains(SMJOptionMask mask, SMJOption option)
+{
+	return ((mask & SMJOptionMaskMake(option)) != 0);
+}
+
+
+
 /*
 ** SMJConfiguration
 */
 #pragma mark - SMJConfiguration
 
-@interface SMJConfiguration : NSObject <NSCopying>
+@interface SMJConfiguration : NSObject <NSCopying, NSMutableCopying>
 
 // -- Instance --
 + (instancetype)defaultConfiguration;
 
 + (instancetype)configurationWithOption:(SMJOption)option;
 
++ (SMJConfiguration *)sharedDefaultConfiguration; // Frozen default configuration, used when no configuration is given.
+
+// Freeze.
+// > A frozen configuration can't be modified anymore (mutators raise NSInternalInconsistencyException), and can be shared between threads without being copied: -copy returns the receiver itself. Use -mutableCopy to get a modifiable configuration.
+- (void)freeze;
+- (SMJConfiguration *)frozenCopy; // Returns the receiver if it's already frozen.
+
+@property (readonly, getter=isFrozen) BOOL frozen;
+
 // Listeners.
 - (void)addListener:(id <SMJEvaluationListener>)listener;
 - (void)removeListener:(id <SMJEvaluationListener>)listener;
@@ -50,6 +78,21 @@ NS_ASSUME_NONNULL_BEGIN
 // Options.
 - (BOOL)containsOption:(SMJOption)option;
 - (void)addOption:(SMJOption)option;
+- (void)removeOption:(SMJOption)option;
+
+@property (readonly) SMJOptionMask optionMask;
+
+// Parallelism.
+// > Deep scans split arrays and objects with at least parallelScanThreshold children between several workers.
+// > Filters evaluate their predicates on arrays with at least parallelFilterThreshold items with several workers, then select the matching items in order.
+// > Results and paths keep the document order. Listeners are called in document order too, but only once the parallel part of the scan is done.
+@property (nonatomic) NSUInteger parallelScanThreshold; // 0 (default) disable parallel scans.
+@property (nonatomic) NSUInteger parallelFilterThreshold; // 0 (default) disable parallel filters.
+@property (nonatomic) NSUInteger parallelConcurrency; // Maximum number of workers. 0 (default) use the number of active processors.
+
+// Evaluation settings.
+// > Options and tunables are read once, when an evaluation starts: modifying a configuration doesn't affect the evaluations already running.
+// > A new option only needs a new SMJOption value (one bit of SMJOptionMask). A new tunable needs a property here, copied by -mutableCopyWithZone:, refused once frozen, and snapshotted by the evaluation context.
 
 @end
 
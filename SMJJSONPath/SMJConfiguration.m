@@ -26,6 +26,16 @@
 NS_ASSUME_NONNULL_BEGIN
 
 
+/*
+** Macros
+*/
+#pragma mark - Macros
+
+// Raised in release builds too: frozen configurations are shared (see -copyWithZone:), so a silent mutation would leak into every user.
+#define SMCheckNotFrozen() do { if (_frozen) [NSException raise:NSInternalInconsistencyException format:@"can't modify a frozen configuration"]; } while (0)
+
+
+
 /*
 ** SMJConfiguration
 */
@@ -33,8 +43,14 @@ NS_ASSUME_NONNULL_BEGIN
 
 @implementation SMJConfiguration
 {
-	NSMutableSet *_options;
+	SMJOptionMask _optionMask;
 	NSMutableArray <id <SMJEvaluationListener>> *_listeners;
+	
+	BOOL _frozen;
+	
+	NSUInteger _parallelScanThreshold;
+	NSUInteger _parallelFilterThreshold;
+	NSUInteger _parallelConcurrency;
 }
 
 
@@ -57,13 +73,25 @@ NS_ASSUME_NONNULL_BEGIN
 	return configuration;
 }
 
++ (SMJConfiguration *)sharedDefaultConfiguration
+{
+	static dispatch_once_t		onceToken;
+	static SMJConfiguration	*shared;
+	
+	dispatch_once(&onceToken, ^{
+		shared = [[SMJConfiguration alloc] init];
+		[shared freeze];
+	});
+	
+	return shared;
+}
+
 - (instancetype)init
 {
 	self = [super init];
 	
 	if (self)
 	{
-		_options = [[NSMutableSet alloc] init];
 		_listeners = [[NSMutableArray alloc] init];
 	}
 	
@@ -77,15 +105,60 @@ NS_ASSUME_NONNULL_BEGIN
 #pragma mark - SMJConfiguration - NSCopying
 
 - (id)copyWithZone:(nullable NSZone *)zone
+{
+	// A frozen configuration is immutable: share it.
+	if (_frozen)
+		return self;
+	
+	return [self mutableCopyWithZone:zone];
+}
+
+
+/*
+** SMJConfiguration - NSMutableCopying
+*/
+#pragma mark - SMJConfiguration - NSMutableCopying
+
+- (id)mutableCopyWithZone:(nullable NSZone *)zone
 {
 	SMJConfiguration *copy = [[SMJConfiguration allocWithZone:zone] init];
 	
-	copy->_options = [_options mutableCopyWithZone:zone];
+	copy->_optionMask = _optionMask;
 	copy->_listeners = [_listeners mutableCopyWithZone:zone];
+	copy->_parallelScanThreshold = _parallelScanThreshold;
+	copy->_parallelFilterThreshold = _parallelFilterThreshold;
+	copy->_parallelConcurrency = _parallelConcurrency;
+	
+	return copy;
+}
+
+
+/*
+** SMJConfiguration - Freeze
+*/
+#pragma mark - SMJConfiguration - Freeze
+
+- (void)freeze
+{
+	_frozen = YES;
+}
+
+- (SMJConfiguration *)frozenCopy
+{
+	if (_frozen)
+		return self;
+	
+	SMJConfiguration *copy = [self mutableCopy];
+	
+	[copy freeze];
 	
 	return copy;
 }
 
+- (BOOL)isFrozen
+{
+	return _frozen;
+}
 
 
 /*
@@ -95,11 +168,15 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (void)addListener:(id <SMJEvaluationListener>)listener
 {
+	SMCheckNotFrozen();
+	
 	[_listeners addObject:listener];
 }
 
 - (void)removeListener:(id <SMJEvaluationListener>)listener
 {
+	SMCheckNotFrozen();
+	
 	[_listeners removeObject:listener];
 }
 
@@ -110,6 +187,8 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (void)setEvaluationListeners:(NSArray<id<SMJEvaluationListener>> *)evaluationListeners
 {
+	SMCheckNotFrozen();
+	
 	_listeners = [evaluationListeners mutableCopy];
 }
 
@@ -121,12 +200,68 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (BOOL)containsOption:(SMJOption)option
 {
-	return [_options containsObject:@(option)];
+	return SMJOptionMaskContains(_optionMask, option);
 }
 
 - (void)addOption:(SMJOption)option
 {
-	[_options addObject:@(option)];
+	SMCheckNotFrozen();
+	
+	_optionMask |= SMJOptionMaskMake(option);
+}
+
+- (void)removeOption:(SMJOption)option
+{
+	SMCheckNotFrozen();
+	
+	_optionMask &= ~SMJOptionMaskMake(option);
+}
+
+- (SMJOptionMask)optionMask
+{
+	return _optionMask;
+}
+
+
+/*
+** SMJConfiguration - Parallelism
+*/
+#pragma mark - SMJConfiguration - Parallelism
+
+- (NSUInteger)parallelScanThreshold
+{
+	return _parallelScanThreshold;
+}
+
+- (void)setParallelScanThreshold:(NSUInteger)parallelScanThreshold
+{
+	SMCheckNotFrozen();
+	
+	_parallelScanThreshold = parallelScanThreshold;
+}
+
+- (NSUInteger)parallelFilterThreshold
+{
+	return _parallelFilterThreshold;
+}
+
+- (void)setParallelFilterThreshold:(NSUInteger)parallelFilterThreshold
+{
+	SMCheckNotFrozen();
+	
+	_parallelFilterThreshold = parallelFilterThreshold;
+}
+
+- (NSUInteger)parallelConcurrency
+{
+	return _parallelConcurrency;
+}
+
+- (void)setParallelConcurrency:(NSUInteger)parallelConcurrency
+{
+	SMCheckNotFrozen();
+	
+	_parallelConcurrency = parallelConcurrency;
 }
 
 @end
@@ -0,0 +1,104 @@
+/*
+ * SMJEvaluationProfile.h
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** SMJTokenProfile
+*/
+#pragma mark - SMJTokenProfile
+
+// Statistics of one token of the evaluated path.
+
+@interface SMJTokenProfile : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@property (readonly) NSUInteger index; // Position in the path, 0 being the root token.
+@property (readonly) NSString *pathFragment;
+@property (readonly) NSString *kind; // "root", "property", "scan", "predicate", ...
+
+@property (readonly) NSUInteger visitCount; // Nodes evaluated by this token (nodes walked, for a deep scan).
+@property (readonly) NSUInteger outputCount; // Nodes handed to the next token, or results produced by the last token.
+
+@property (readonly) NSUInteger predicateApplyCount; // Filter tokens only.
+@property (readonly) NSUInteger predicateMatchCount;
+
+@property (readonly) NSTimeInterval totalTime; // Including the time spent in the following tokens.
+@property (readonly) NSTimeInterval selfTime;
+
+@end
+
+
+
+/*
+** SMJExpressionProfile
+*/
+#pragma mark - SMJExpressionProfile
+
+// Statistics of one sub-expression of a filter (a comparison, or an existence check).
+
+@interface SMJExpressionProfile : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@property (readonly) NSString *expression;
+
+@property (readonly) NSUInteger applyCount;
+@property (readonly) NSUInteger matchCount;
+
+@property (readonly) NSTimeInterval totalTime;
+
+@end
+
+
+
+/*
+** SMJEvaluationProfile
+*/
+#pragma mark - SMJEvaluationProfile
+
+// Report of a profiled evaluation, see -[SMJJSONPath resultForJSONObject:configuration:profile:error:].
+// > Times are measured by each thread: when parallel evaluation is enabled, the time of a token is the sum of the time spent by each worker.
+
+@interface SMJEvaluationProfile : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@property (readonly) NSString *plan; // The compiled path, and its tokens.
+
+@property (readonly) NSArray <SMJTokenProfile *> *tokens; // In path order.
+@property (readonly) NSArray <SMJExpressionProfile *> *expressions; // In first evaluation order.
+
+@property (readonly) NSUInteger cacheHitCount; // Root paths ($) referenced by filters, found in evaluation cache.
+@property (readonly) NSUInteger cacheMissCount;
+
+@property (readonly) NSUInteger resultCount;
+@property (readonly) NSTimeInterval totalTime;
+
+- (NSString *)stringValue; // Textual report.
+
+@end
+
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,490 @@
+/*
+ * SMJEvaluationProfile.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <pthread.h>
+
+#import "SMJEvaluationProfile.h"
+#import "SMJEvaluationProfileInternal.h"
+
+#import "SMJCompiledPath.h"
+#import "SMJPathToken.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** Macros
+*/
+#pragma mark - Macros
+
+#define SMNanosecondsToTimeInterval(Nanoseconds) ((NSTimeInterval)(Nanoseconds) / (NSTimeInterval)NSEC_PER_SEC)
+
+
+
+/*
+** Interfaces
+*/
+#pragma mark - Interfaces
+
+@interface SMJTokenProfile ()
+{
+@public
+	NSUInteger	_index;
+	NSString	*_pathFragment;
+	NSString	*_kind;
+	
+	NSUInteger	_inputCount;
+	NSUInteger	_visitCount;
+	NSUInteger	_outputCount;
+	NSUInteger	_predicateApplyCount;
+	NSUInteger	_predicateMatchCount;
+	
+	uint64_t	_totalTime;
+	uint64_t	_selfTime;
+}
+@end
+
+@interface SMJExpressionProfile ()
+{
+@public
+	NSString	*_expression;
+	
+	NSUInteger	_applyCount;
+	NSUInteger	_matchCount;
+	
+	uint64_t	_totalTime;
+}
+@end
+
+
+
+/*
+** SMJTokenProfile
+*/
+#pragma mark - SMJTokenProfile
+
+@implementation SMJTokenProfile
+
+- (instancetype)initWithToken:(SMJPathToken *)token index:(NSUInteger)index
+{
+	self = [super init];
+	
+	if (self)
+	{
+		// SMJPropertyPathToken -> property, SMJArrayIndexToken -> arrayindex, ...
+		NSString *kind = NSStringFromClass([token class]);
+		
+		if ([kind hasPrefix:@"SMJ"])
+			kind = [kind substringFromIndex:3];
+		
+		if ([kind hasSuffix:@"PathToken"])
+			kind = [kind substringToIndex:kind.length - 9];
+		else if ([kind hasSuffix:@"Token"])
+			kind = [kind substringToIndex:kind.length - 5];
+		
+		_index = index;
+		_pathFragment = token.pathFragment;
+		_kind = [kind lowercaseString];
+	}
+	
+	return self;
+}
+
+- (NSUInteger)index
+{
+	return _index;
+}
+
+- (NSString *)pathFragment
+{
+	return _pathFragment;
+}
+
+- (NSString *)kind
+{
+	return _kind;
+}
+
+- (NSUInteger)visitCount
+{
+	return _visitCount;
+}
+
+- (NSUInteger)outputCount
+{
+	return _outputCount;
+}
+
+- (NSUInteger)predicateApplyCount
+{
+	return _predicateApplyCount;
+}
+
+- (NSUInteger)predicateMatchCount
+{
+	return _predicateMatchCount;
+}
+
+- (NSTimeInterval)totalTime
+{
+	return SMNanosecondsToTimeInterval(_totalTime);
+}
+
+- (NSTimeInterval)selfTime
+{
+	return SMNanosecondsToTimeInterval(_selfTime);
+}
+
+@end
+
+
+
+/*
+** SMJExpressionProfile
+*/
+#pragma mark - SMJExpressionProfile
+
+@implementation SMJExpressionProfile
+
+- (instancetype)initWithExpression:(NSString *)expression
+{
+	self = [super init];
+	
+	if (self)
+	{
+		_expression = expression;
+	}
+	
+	return self;
+}
+
+- (NSString *)expression
+{
+	return _expression;
+}
+
+- (NSUInteger)applyCount
+{
+	return _applyCount;
+}
+
+- (NSUInteger)matchCount
+{
+	return _matchCount;
+}
+
+- (NSTimeInterval)totalTime
+{
+	return SMNanosecondsToTimeInterval(_totalTime);
+}
+
+@end
+
+
+
+/*
+** SMJEvaluationProfile
+*/
+#pragma mark - SMJEvaluationProfile
+
+@implementation SMJEvaluationProfile
+{
+	pthread_mutex_t _lock;
+	
+	NSString							*_plan;
+	NSArray <SMJTokenProfile *>			*_tokens;
+	NSMutableArray <SMJExpressionProfile *>	*_expressions;
+	
+	NSMapTable <SMJPathToken *, SMJTokenProfile *>	*_tokensMap;
+	NSMapTable <id, SMJExpressionProfile *>			*_expressionsMap;
+	
+	NSUInteger	_cacheHitCount;
+	NSUInteger	_cacheMissCount;
+	NSUInteger	_resultCount;
+	uint64_t	_totalTime;
+}
+
+
+/*
+** SMJEvaluationProfile - Instance
+*/
+#pragma mark - SMJEvaluationProfile - Instance
+
+- (instancetype)initWithPath:(SMJCompiledPath *)path
+{
+	self = [super init];
+	
+	if (self)
+	{
+		pthread_mutex_init(&_lock, NULL);
+		
+		_expressions = [[NSMutableArray alloc] init];
+		
+		_tokensMap = [NSMapTable mapTableWithKeyOptions:(NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality) valueOptions:NSPointerFunctionsStrongMemory];
+		_expressionsMap = [NSMapTable mapTableWithKeyOptions:(NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality) valueOptions:NSPointerFunctionsStrongMemory];
+		
+		// Tokens & plan.
+		NSMutableArray <SMJTokenProfile *>	*tokens = [[NSMutableArray alloc] init];
+		NSMutableString						*plan = [[NSMutableString alloc] initWithString:[path stringValue]];
+		NSUInteger							index = 0;
+		
+		for (SMJPathToken *token = path.root; token; token = token.next)
+		{
+			SMJTokenProfile *tokenProfile = [[SMJTokenProfile alloc] initWithToken:token index:index++];
+			
+			[tokens addObject:tokenProfile];
+			[_tokensMap setObject:tokenProfile forKey:token];
+			
+			[plan appendFormat:@"\n  %lu. %@ %@", (unsigned long)tokenProfile.index, tokenProfile.kind, tokenProfile.pathFragment];
+		}
+		
+		_tokens = tokens;
+		_plan = plan;
+	}
+	
+	return self;
+}
+
+- (void)dealloc
+{
+	pthread_mutex_destroy(&_lock);
+}
+
+
+/*
+** SMJEvaluationProfile - Record
+*/
+#pragma mark - SMJEvaluationProfile - Record
+
+- (void)recordEvaluationOfToken:(SMJPathToken *)token duration:(uint64_t)duration
+{
+	pthread_mutex_lock(&_lock);
+	{
+		SMJTokenProfile *tokenProfile = [_tokensMap objectForKey:token];
+		
+		if (tokenProfile)
+		{
+			tokenProfile->_inputCount++;
+			tokenProfile->_totalTime += duration;
+		}
+	}
+	pthread_mutex_unlock(&_lock);
+}
+
+- (void)recordScanOfToken:(SMJPathToken *)token
+{
+	pthread_mutex_lock(&_lock);
+	{
+		SMJTokenProfile *tokenProfile = [_tokensMap objectForKey:token];
+		
+		if (tokenProfile)
+			tokenProfile->_visitCount++;
+	}
+	pthread_mutex_unlock(&_lock);
+}
+
+- (void)recordApplyOfToken:(SMJPathToken *)token match:(BOOL)match
+{
+	pthread_mutex_lock(&_lock);
+	{
+		SMJTokenProfile *tokenProfile = [_tokensMap objectForKey:token];
+		
+		if (tokenProfile)
+		{
+			tokenProfile->_predicateApplyCount++;
+			
+			if (match)
+				tokenProfile->_predicateMatchCount++;
+		}
+	}
+	pthread_mutex_unlock(&_lock);
+}
+
+- (void)recordApplyOfExpression:(id <SMJPredicate>)expression match:(BOOL)match duration:(uint64_t)duration
+{
+	pthread_mutex_lock(&_lock);
+	{
+		SMJExpressionProfile *expressionProfile = [_expressionsMap objectForKey:expression];
+		
+		if (!expressionProfile)
+		{
+			expressionProfile = [[SMJExpressionProfile alloc] initWithExpression:[expression stringValue]];
+			
+			[_expressionsMap setObject:expressionProfile forKey:expression];
+			[_expressions addObject:expressionProfile];
+		}
+		
+		expressionProfile->_applyCount++;
+		expressionProfile->_totalTime += duration;
+		
+		if (match)
+			expressionProfile->_matchCount++;
+	}
+	pthread_mutex_unlock(&_lock);
+}
+
+- (void)recordCacheHit:(BOOL)hit
+{
+	pthread_mutex_lock(&_lock);
+	{
+		if (hit)
+			_cacheHitCount++;
+		else
+			_cacheMissCount++;
+	}
+	pthread_mutex_unlock(&_lock);
+}
+
+
+/*
+** SMJEvaluationProfile - Finish
+*/
+#pragma mark - SMJEvaluationProfile - Finish
+
+- (void)finishWithResultCount:(NSUInteger)resultCount duration:(uint64_t)duration
+{
+	pthread_mutex_lock(&_lock);
+	{
+		NSUInteger count = _tokens.count;
+		
+		_resultCount = resultCount;
+		_totalTime = duration;
+		
+		for (NSUInteger i = 0; i < count; i++)
+		{
+			SMJTokenProfile *tokenProfile = _tokens[i];
+			SMJTokenProfile *nextProfile = (i + 1 < count ? _tokens[i + 1] : nil);
+			
+			// Deep scans count the nodes they walk. Others visit the nodes they are given.
+			if (tokenProfile->_visitCount == 0)
+				tokenProfile->_visitCount = tokenProfile->_inputCount;
+			
+			// A token outputs what the next token is given, the last one outputs results.
+			// Time of a token includes the time of the next one: it's what the next token is given.
+			if (nextProfile)
+			{
+				tokenProfile->_outputCount = nextProfile->_inputCount;
+				tokenProfile->_selfTime = (tokenProfile->_totalTime > nextProfile->_totalTime ? tokenProfile->_totalTime - nextProfile->_totalTime : 0);
+			}
+			else
+			{
+				tokenProfile->_outputCount = resultCount;
+				tokenProfile->_selfTime = tokenProfile->_totalTime;
+			}
+		}
+	}
+	pthread_mutex_unlock(&_lock);
+}
+
+
+/*
+** SMJEvaluationProfile - Properties
+*/
+#pragma mark - SMJEvaluationProfile - Properties
+
+- (NSString *)plan
+{
+	return _plan;
+}
+
+- (NSArray <SMJTokenProfile *> *)tokens
+{
+	return _tokens;
+}
+
+- (NSArray <SMJExpressionProfile *> *)expressions
+{
+	NSArray *result;
+	
+	pthread_mutex_lock(&_lock);
+	result = [_expressions copy];
+	pthread_mutex_unlock(&_lock);
+	
+	return result;
+}
+
+- (NSUInteger)cacheHitCount
+{
+	return _cacheHitCount;
+}
+
+- (NSUInteger)cacheMissCount
+{
+	return _cacheMissCount;
+}
+
+- (NSUInteger)resultCount
+{
+	return _resultCount;
+}
+
+- (NSTimeInterval)totalTime
+{
+	return SMNanosecondsToTimeInterval(_totalTime);
+}
+
+
+/*
+** SMJEvaluationProfile - Report
+*/
+#pragma mark - SMJEvaluationProfile - Report
+
+- (NSString *)stringValue
+{
+	NSMutableString *result = [[NSMutableString alloc] init];
+	
+	// Summary.
+	[result appendFormat:@"Plan: %@\n", _plan];
+	[result appendFormat:@"Total: %.3f ms, %lu results, cache %lu hits / %lu misses\n", self.totalTime * 1000.0, (unsigned long)_resultCount, (unsigned long)_cacheHitCount, (unsigned long)_cacheMissCount];
+	
+	// Tokens.
+	[result appendFormat:@"\n%-4s %-12s %-20s %10s %10s %10s %10s %12s %12s\n", "#", "token", "fragment", "visits", "outputs", "applied", "matched", "total (ms)", "self (ms)"];
+	
+	for (SMJTokenProfile *token in _tokens)
+	{
+		[result appendFormat:@"%-4lu %-12s %-20s %10lu %10lu %10lu %10lu %12.3f %12.3f\n",
+			(unsigned long)token.index, token.kind.UTF8String, token.pathFragment.UTF8String,
+			(unsigned long)token.visitCount, (unsigned long)token.outputCount, (unsigned long)token.predicateApplyCount, (unsigned long)token.predicateMatchCount,
+			token.totalTime * 1000.0, token.selfTime * 1000.0];
+	}
+	
+	// Expressions.
+	NSArray <SMJExpressionProfile *> *expressions = self.expressions;
+	
+	if (expressions.count > 0)
+	{
+		[result appendFormat:@"\n%-40s %10s %10s %12s\n", "expression", "applied", "matched", "total (ms)"];
+		
+		for (SMJExpressionProfile *expression in expressions)
+			[result appendFormat:@"%-40s %10lu %10lu %12.3f\n", expression.expression.UTF8String, (unsigned long)expression.applyCount, (unsigned long)expression.matchCount, expression.totalTime * 1000.0];
+	}
+	
+	return result;
+}
+
+- (NSString *)description
+{
+	return [self stringValue];
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,59 @@
+/*
+ * SMJJSONPatch.h
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+#import <SMJJSONPath/SMJConfiguration.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** SMJJSONPatch
+*/
+#pragma mark - SMJJSONPatch
+
+// A JSON Patch (RFC 6902): a list of add, remove, replace, move, copy and test operations, addressing values with JSON Pointers (RFC 6901).
+// Patches describing an update can be obtained from SMJJSONPathTransaction.
+// Operations can target the whole document (empty pointer), except remove: such patches are rejected when they are created.
+
+@interface SMJJSONPatch : NSObject
+
+// Instance.
+- (nullable instancetype)initWithOperations:(NSArray <NSDictionary <NSString *, id> *> *)operations error:(NSError **)error NS_DESIGNATED_INITIALIZER;
+- (nullable instancetype)initWithJSONData:(NSData *)data error:(NSError **)error;
+- (instancetype)init NS_UNAVAILABLE;
+
+@property (readonly) NSArray <NSDictionary <NSString *, id> *> *operations;
+
+// Serialize.
+- (nullable NSData *)JSONDataWithError:(NSError **)error;
+
+// Apply patch. Operations are applied in order, and atomically: if an operation fails (including a failed test), the document is left untouched.
+// > The json object need to use mutable containers where values are modified. It's modified in place: the whole document can only be replaced by a container of the same kind.
+- (BOOL)applyToMutableJSONObject:(id)jsonObject configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error;
+
+// > The json object can use immutable containers, and is not modified. Return the root of an updated copy, sharing everything but the containers on the way to the updated values.
+- (nullable id)updatedJSONObject:(id)jsonObject configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error;
+
+@end
+
+
+NS_ASSUME_NONNULL_END
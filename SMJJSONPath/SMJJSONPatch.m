@@ -0,0 +1,519 @@
+/*
+ * SMJJSONPatch.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import "SMJJSONPatch.h"
+
+#import "SMJPathRef.h"
+#import "SMJUtils.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** Macros
+*/
+#pragma mark - Macros
+
+#define SMSetError(Error, Code, Message, ...) \
+	do { \
+		if ((Error) && *(Error) == nil) {\
+			NSString *___message = [NSString stringWithFormat:(Message), ## __VA_ARGS__];\
+			*(Error) = [NSError errorWithDomain:@"SMJJSONPatchErrorDomain" code:(Code) userInfo:@{ NSLocalizedDescriptionKey : ___message }]; \
+		} \
+	} while (0) \
+
+
+
+/*
+** Types
+*/
+#pragma mark - Types
+
+typedef enum SMJPatchOperationKind
+{
+	SMJPatchOperationKindAdd,
+	SMJPatchOperationKindRemove,
+	SMJPatchOperationKindReplace,
+	SMJPatchOperationKindMove,
+	SMJPatchOperationKindCopy,
+	SMJPatchOperationKindTest
+} SMJPatchOperationKind;
+
+
+
+/*
+** Prototypes
+*/
+#pragma mark - Prototypes
+
+static BOOL SMJArrayIndexWithReferenceToken(NSString *token, NSUInteger *index);
+
+
+
+/*
+** SMJPatchOperation
+*/
+#pragma mark - SMJPatchOperation
+
+@interface SMJPatchOperation : NSObject
+{
+@public
+	SMJPatchOperationKind			_kind;
+	
+	NSArray <NSString *>			*_path;
+	NSArray <NSString *> * _Nullable	_from;
+	id _Nullable					_value;
+}
+@end
+
+@implementation SMJPatchOperation
+@end
+
+
+
+/*
+** SMJJSONPatch
+*/
+#pragma mark - SMJJSONPatch
+
+@implementation SMJJSONPatch
+{
+	NSArray <SMJPatchOperation *> *_patchOperations;
+}
+
+
+/*
+** SMJJSONPatch - Instance
+*/
+#pragma mark - SMJJSONPatch - Instance
+
+- (nullable instancetype)initWithOperations:(NSArray <NSDictionary <NSString *, id> *> *)operations error:(NSError **)error
+{
+	self = [super init];
+	
+	if (self)
+	{
+		static NSDictionary <NSString *, NSNumber *>	*kinds;
+		static dispatch_once_t						onceToken;
+		
+		dispatch_once(&onceToken, ^{
+			kinds = @{
+				@"add" : @(SMJPatchOperationKindAdd),
+				@"remove" : @(SMJPatchOperationKindRemove),
+				@"replace" : @(SMJPatchOperationKindReplace),
+				@"move" : @(SMJPatchOperationKindMove),
+				@"copy" : @(SMJPatchOperationKindCopy),
+				@"test" : @(SMJPatchOperationKindTest)
+			};
+		});
+		
+		NSMutableArray <SMJPatchOperation *> *patchOperations = [[NSMutableArray alloc] initWithCapacity:operations.count];
+		
+		for (NSDictionary *operation in operations)
+		{
+			NSUInteger index = patchOperations.count;
+			
+			if ([operation isKindOfClass:[NSDictionary class]] == NO)
+			{
+				SMSetError(error, 1, @"Operation %lu is not an object.", (unsigned long)index);
+				return nil;
+			}
+			
+			// Kind.
+			id		op = operation[@"op"];
+			NSNumber	*kind = ([op isKindOfClass:[NSString class]] ? kinds[op] : nil);
+			
+			if (!kind)
+			{
+				SMSetError(error, 1, @"Operation %lu has an invalid 'op' member.", (unsigned long)index);
+				return nil;
+			}
+			
+			SMJPatchOperation *patchOperation = [[SMJPatchOperation alloc] init];
+			
+			patchOperation->_kind = (SMJPatchOperationKind)kind.intValue;
+			
+			// Path.
+			id		path = operation[@"path"];
+			NSArray	*pathTokens = ([path isKindOfClass:[NSString class]] ? [SMJUtils referenceTokensOfJSONPointer:path] : nil);
+			
+			if (!pathTokens)
+			{
+				SMSetError(error, 1, @"Operation %lu has an invalid 'path' member.", (unsigned long)index);
+				return nil;
+			}
+			
+			if (patchOperation->_kind == SMJPatchOperationKindRemove && pathTokens.count == 0)
+			{
+				SMSetError(error, 1, @"Operation %lu removes the whole document, which is not supported.", (unsigned long)index);
+				return nil;
+			}
+			
+			patchOperation->_path = pathTokens;
+			
+			// From.
+			if (patchOperation->_kind == SMJPatchOperationKindMove || patchOperation->_kind == SMJPatchOperationKindCopy)
+			{
+				id		from = operation[@"from"];
+				NSArray	*fromTokens = ([from isKindOfClass:[NSString class]] ? [SMJUtils referenceTokensOfJSONPointer:from] : nil);
+				
+				if (!fromTokens)
+				{
+					SMSetError(error, 1, @"Operation %lu has an invalid 'from' member.", (unsigned long)index);
+					return nil;
+				}
+				
+				patchOperation->_from = fromTokens;
+			}
+			
+			// Value.
+			if (patchOperation->_kind == SMJPatchOperationKindAdd || patchOperation->_kind == SMJPatchOperationKindReplace || patchOperation->_kind == SMJPatchOperationKindTest)
+			{
+				id value = operation[@"value"];
+				
+				if (!value)
+				{
+					SMSetError(error, 1, @"Operation %lu has no 'value' member.", (unsigned long)index);
+					return nil;
+				}
+				
+				patchOperation->_value = value;
+			}
+			
+			[patchOperations addObject:patchOperation];
+		}
+		
+		_operations = [operations copy];
+		_patchOperations = patchOperations;
+	}
+	
+	return self;
+}
+
+- (nullable instancetype)initWithJSONData:(NSData *)data error:(NSError **)error
+{
+	NSArray *operations = [NSJSONSerialization JSONObjectWithData:data options:0 error:error];
+	
+	if (!operations)
+		return nil;
+	
+	if ([operations isKindOfClass:[NSArray class]] == NO)
+	{
+		SMSetError(error, 1, @"A patch should be an array of operations.");
+		return nil;
+	}
+	
+	return [self initWithOperations:operations error:error];
+}
+
+
+/*
+** SMJJSONPatch - Serialize
+*/
+#pragma mark - SMJJSONPatch - Serialize
+
+- (nullable NSData *)JSONDataWithError:(NSError **)error
+{
+	return [NSJSONSerialization dataWithJSONObject:_operations options:0 error:error];
+}
+
+
+/*
+** SMJJSONPatch - Apply
+*/
+#pragma mark - SMJJSONPatch - Apply
+
+- (BOOL)applyToMutableJSONObject:(id)jsonObject configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error
+{
+	SMJCopyOnWriteDocument *document = [self documentByApplyingToJSONObject:jsonObject configuration:configuration error:error];
+	
+	if (!document)
+		return NO;
+	
+	// Operations were applied to copies: write them back into the original containers.
+	return [document commitWithError:error];
+}
+
+- (nullable id)updatedJSONObject:(id)jsonObject configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error
+{
+	return [self documentByApplyingToJSONObject:jsonObject configuration:configuration error:error].rootJsonObject;
+}
+
+
+/*
+** SMJJSONPatch - Helpers
+*/
+#pragma mark - SMJJSONPatch - Helpers
+
+- (nullable SMJCopyOnWriteDocument *)documentByApplyingToJSONObject:(id)jsonObject configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error
+{
+	if (!configuration)
+		configuration = [SMJConfiguration sharedDefaultConfiguration];
+	
+	// Each operation sees the result of the previous ones. Work on a copy of the containers on the way to the updated values, so a failure leaves the document untouched.
+	SMJCopyOnWriteDocument *document = [[SMJCopyOnWriteDocument alloc] initWithRootJsonObject:jsonObject];
+	
+	for (SMJPatchOperation *operation in _patchOperations)
+	{
+		NSArray <NSString *>	*path = operation->_path;
+		NSArray <NSString *>	*from = operation->_from;
+		SMJPathRef				*pathRef;
+		id						value;
+		
+		switch (operation->_kind)
+		{
+			case SMJPatchOperationKindAdd:
+			{
+				// Values are inserted as mutable copies, so following operations can update them in place.
+				if ([self insertObject:[SMJUtils mutableCopyOfJSONObject:(id)operation->_value] atReferenceTokens:path document:document configuration:configuration error:error] == NO)
+					return nil;
+				
+				break;
+			}
+			
+			case SMJPatchOperationKindRemove:
+			{
+				pathRef = [self pathRefAtReferenceTokens:path document:document insert:NO error:error];
+				
+				if (!pathRef || [pathRef deleteWithConfiguration:configuration error:error] == NO)
+					return nil;
+				
+				break;
+			}
+			
+			case SMJPatchOperationKindReplace:
+			{
+				if (path.count == 0)
+				{
+					[document replaceRootJsonObject:[SMJUtils mutableCopyOfJSONObject:(id)operation->_value]];
+					break;
+				}
+				
+				pathRef = [self pathRefAtReferenceTokens:path document:document insert:NO error:error];
+				
+				if (!pathRef || [pathRef setObject:[SMJUtils mutableCopyOfJSONObject:(id)operation->_value] configuration:configuration error:error] == NO)
+					return nil;
+				
+				break;
+			}
+			
+			case SMJPatchOperationKindMove:
+			{
+				value = [self valueAtReferenceTokens:(NSArray *)from count:from.count rootJsonObject:document.rootJsonObject components:nil error:error];
+				
+				if (!value)
+					return nil;
+				
+				if ([path isEqualToArray:(NSArray *)from])
+					break;
+				
+				if (path.count > from.count && [[path subarrayWithRange:NSMakeRange(0, from.count)] isEqualToArray:(NSArray *)from])
+				{
+					SMSetError(error, 2, @"Can't move a value into one of its children.");
+					return nil;
+				}
+				
+				pathRef = [self pathRefAtReferenceTokens:(NSArray *)from document:document insert:NO error:error];
+				
+				if (!pathRef || [pathRef deleteWithConfiguration:configuration error:error] == NO)
+					return nil;
+				
+				// A value moved to the root becomes the root container: it needs to be mutable.
+				if (path.count == 0)
+					value = [SMJUtils mutableCopyOfJSONObject:value];
+				
+				if ([self insertObject:value atReferenceTokens:path document:document configuration:configuration error:error] == NO)
+					return nil;
+				
+				break;
+			}
+			
+			case SMJPatchOperationKindCopy:
+			{
+				value = [self valueAtReferenceTokens:(NSArray *)from count:from.count rootJsonObject:document.rootJsonObject components:nil error:error];
+				
+				if (!value)
+					return nil;
+				
+				if ([self insertObject:[SMJUtils mutableCopyOfJSONObject:value] atReferenceTokens:path document:document configuration:configuration error:error] == NO)
+					return nil;
+				
+				break;
+			}
+			
+			case SMJPatchOperationKindTest:
+			{
+				value = [self valueAtReferenceTokens:path count:path.count rootJsonObject:document.rootJsonObject components:nil error:error];
+				
+				if (!value)
+					return nil;
+				
+				if ([value isEqual:operation->_value] == NO)
+				{
+					SMSetError(error, 3, @"Test failed for value at %@.", [SMJUtils jsonPointerWithComponents:path]);
+					return nil;
+				}
+				
+				break;
+			}
+		}
+	}
+	
+	return document;
+}
+
+- (nullable id)valueAtReferenceTokens:(NSArray <NSString *> *)tokens count:(NSUInteger)count rootJsonObject:(id)rootJsonObject components:(nullable NSMutableArray *)components error:(NSError **)error
+{
+	id value = rootJsonObject;
+	
+	for (NSUInteger i = 0; i < count; i++)
+	{
+		NSString	*token = tokens[i];
+		id			child = nil;
+		
+		if ([value isKindOfClass:[NSDictionary class]])
+		{
+			child = [(NSDictionary *)value objectForKey:token];
+			
+			[components addObject:token];
+		}
+		else if ([value isKindOfClass:[NSArray class]])
+		{
+			NSUInteger index = 0;
+			
+			if (SMJArrayIndexWithReferenceToken(token, &index) && index < [(NSArray *)value count])
+				child = [(NSArray *)value objectAtIndex:index];
+			
+			[components addObject:@(index)];
+		}
+		
+		if (!child)
+		{
+			SMSetError(error, 2, @"No value at %@.", [SMJUtils jsonPointerWithComponents:[tokens subarrayWithRange:NSMakeRange(0, i + 1)]]);
+			return nil;
+		}
+		
+		value = child;
+	}
+	
+	return value;
+}
+
+- (BOOL)insertObject:(id)object atReferenceTokens:(NSArray <NSString *> *)tokens document:(SMJCopyOnWriteDocument *)document configuration:(SMJConfiguration *)configuration error:(NSError **)error
+{
+	// Inserting at the root replaces the whole document.
+	if (tokens.count == 0)
+	{
+		[document replaceRootJsonObject:object];
+		return YES;
+	}
+	
+	SMJPathRef *pathRef = [self pathRefAtReferenceTokens:tokens document:document insert:YES error:error];
+	
+	if (!pathRef)
+		return NO;
+	
+	return [pathRef insertObject:object configuration:configuration error:error];
+}
+
+- (nullable SMJPathRef *)pathRefAtReferenceTokens:(NSArray <NSString *> *)tokens document:(SMJCopyOnWriteDocument *)document insert:(BOOL)insert error:(NSError **)error
+{
+	// The root has no container (callers replace it through the document).
+	if (tokens.count == 0)
+	{
+		SMSetError(error, 4, @"Operations on the whole document are not supported.");
+		return nil;
+	}
+	
+	// Resolve the container.
+	NSMutableArray	*components = [[NSMutableArray alloc] initWithCapacity:tokens.count - 1];
+	id				container = [self valueAtReferenceTokens:tokens count:tokens.count - 1 rootJsonObject:document.rootJsonObject components:components error:error];
+	
+	if (!container)
+		return nil;
+	
+	// Reference the value in the container.
+	NSString	*token = tokens.lastObject;
+	SMJPathRef	*pathRef = nil;
+	
+	if ([container isKindOfClass:[NSDictionary class]])
+	{
+		if (insert || [(NSDictionary *)container objectForKey:token])
+			pathRef = [SMJPathRef pathRefWithObject:container property:token];
+	}
+	else if ([container isKindOfClass:[NSArray class]])
+	{
+		NSUInteger count = [(NSArray *)container count];
+		NSUInteger index = count;
+		
+		if ((insert && [token isEqualToString:@"-"]) || (SMJArrayIndexWithReferenceToken(token, &index) && (index < count || (insert && index == count))))
+			pathRef = [SMJPathRef pathRefWithObject:container index:index];
+	}
+	
+	if (!pathRef)
+	{
+		SMSetError(error, 2, @"No value at %@.", [SMJUtils jsonPointerWithComponents:tokens]);
+		return nil;
+	}
+	
+	// Make it point into the copy.
+	pathRef.location = components;
+	
+	if ([document preparePathRef:pathRef copyTarget:NO error:error] == NO)
+		return nil;
+	
+	return pathRef;
+}
+
+@end
+
+
+
+/*
+** C Tools
+*/
+#pragma mark - C Tools
+
+static BOOL SMJArrayIndexWithReferenceToken(NSString *token, NSUInteger *index)
+{
+	// Decimal digits, without leading zero.
+	NSUInteger length = token.length;
+	NSUInteger result = 0;
+	
+	if (length == 0 || length > 18 || (length > 1 && [token characterAtIndex:0] == '0'))
+		return NO;
+	
+	for (NSUInteger i = 0; i < length; i++)
+	{
+		unichar ch = [token characterAtIndex:i];
+		
+		if (ch < '0' || ch > '9')
+			return NO;
+		
+		result = result * 10 + (ch - '0');
+	}
+	
+	*index = result;
+	
+	return YES;
+}
+
+
+NS_ASSUME_NONNULL_END
@@ -24,7 +24,12 @@
 
 #import <SMJJSONPath/SMJConfiguration.h>
 #import <SMJJSONPath/SMJEvaluationListener.h>
+#import <SMJJSONPath/SMJEvaluationProfile.h>
+#import <SMJJSONPath/SMJJSONPatch.h>
+#import <SMJJSONPath/SMJJSONPathBatch.h>
+#import <SMJJSONPath/SMJJSONPathTransaction.h>
 #import <SMJJSONPath/SMJOption.h>
+#import <SMJJSONPath/SMJPathFunctionFactory.h>
 
 
 NS_ASSUME_NONNULL_BEGIN
@@ -63,11 +68,30 @@ typedef _Nonnull id (^SMJJSONPathMapper)(id object, SMJConfiguration *configurat
 - (nullable instancetype)initWithJSONPathString:(NSString *)jsonPathString error:(NSError **)error NS_DESIGNATED_INITIALIZER;
 - (instancetype)init NS_UNAVAILABLE;
 
+@property (readonly) NSString *jsonPathString; // Trimmed path string.
+
+// Compiled paths cache. Instances created with the same path string share the same compiled path.
+@property (class) NSUInteger cacheCapacity; // Default is 400. 0 disable the cache.
+@property (class, readonly) NSUInteger cacheHitCount;
+@property (class, readonly) NSUInteger cacheMissCount;
+
++ (void)purgeCache;
+
 // Apply path to JSON.
+// > Files and streams are parsed while evaluated: only the parts of the document the path can select are materialized.
 - (nullable id)resultForJSONData:(NSData *)data configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error;
 - (nullable id)resultForJSONFile:(NSURL *)url configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error;
+- (nullable id)resultForJSONStream:(NSInputStream *)inputStream configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error; // UTF-8 only. The stream is opened if needed, but not closed.
 - (nullable id)resultForJSONObject:(id)jsonObject configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error;
 
+// Apply path to JSON, and stop the evaluation as soon as enough results are found.
+- (nullable id)resultForJSONObject:(id)jsonObject limit:(NSUInteger)limit configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error; // 0 for no limit.
+- (nullable id)firstResultForJSONObject:(id)jsonObject configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error; // Fail if there is no result.
+
+// Apply path to JSON, and report how the evaluation went: statistics by token and by filter expression, and the path plan.
+// > The profile is returned even if the evaluation fails. Profiling has a cost: use it to investigate slow paths only.
+- (nullable id)resultForJSONObject:(id)jsonObject configuration:(nullable SMJConfiguration *)configuration profile:(SMJEvaluationProfile * _Nullable * _Nullable)profile error:(NSError **)error;
+
 // Update JSON at path result. The json object need to use mutable containers.
 - (nullable id)updateMutableJSONObject:(id)jsonObject setObject:(id)object configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error;
 - (nullable id)updateMutableJSONObject:(id)jsonObject mapObjects:(SMJJSONPathMapper)mapper configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error;
@@ -76,6 +100,15 @@ typedef _Nonnull id (^SMJJSONPathMapper)(id object, SMJConfiguration *configurat
 - (nullable id)updateMutableJSONObject:(id)jsonObject putObject:(id)object key:(NSString *)key configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error;
 - (nullable id)updateMutableJSONObject:(id)jsonObject renameKey:(NSString *)oldKey toKey:(NSString *)newKey configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error;
 
+// Update a copy of JSON at path result, and return the root of this copy. The json object can use immutable containers, and is not modified.
+// > Only the containers on the way to the updated values are copied (as mutable containers): everything else is shared with the json object.
+- (nullable id)updatedJSONObject:(id)jsonObject setObject:(id)object configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error;
+- (nullable id)updatedJSONObject:(id)jsonObject mapObjects:(SMJJSONPathMapper)mapper configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error;
+- (nullable id)updatedJSONObject:(id)jsonObject deleteWithConfiguration:(nullable SMJConfiguration *)configuration error:(NSError **)error;
+- (nullable id)updatedJSONObject:(id)jsonObject addObject:(id)object configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error;
+- (nullable id)updatedJSONObject:(id)jsonObject putObject:(id)object key:(NSString *)key configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error;
+- (nullable id)updatedJSONObject:(id)jsonObject renameKey:(NSString *)oldKey toKey:(NSString *)newKey configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error;
+
 @end
 
 
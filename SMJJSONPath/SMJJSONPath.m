@@ -21,8 +21,14 @@
 
 
 #import "SMJJSONPath.h"
+#import "SMJJSONPathInternal.h"
 
 #import "SMJPathCompiler.h"
+#import "SMJPathCache.h"
+#import "SMJCompiledPath.h"
+#import "SMJJSONStreamReader.h"
+#import "SMJJSONParser.h"
+#import "SMJEvaluationProfileInternal.h"
 
 
 NS_ASSUME_NONNULL_BEGIN
@@ -48,7 +54,10 @@ NS_ASSUME_NONNULL_BEGIN
 
 @implementation SMJJSONPath
 {
-	id <SMJPath> _path;
+	id <SMJPath>	_path;
+	NSString		*_jsonPathString;
+	
+	BOOL _rootReferenced;
 }
 
 
@@ -72,20 +81,74 @@ NS_ASSUME_NONNULL_BEGIN
 			return nil;
 		}
 		
-		// Compile path.
-		id <SMJPath> path = [SMJPathCompiler compilePathString:pathString error:error];
+		// Compile path, or reuse an already compiled one.
+		SMJPathCache	*cache = [SMJPathCache sharedCache];
+		id <SMJPath>	path = [cache pathForKey:pathString];
 		
 		if (!path)
-			return nil;
+		{
+			path = [SMJPathCompiler compilePathString:pathString error:error];
+			
+			if (!path)
+				return nil;
+			
+			[cache setPath:path forKey:pathString];
+		}
 		
 		// Store path.
 		_path = path;
+		_jsonPathString = pathString;
+		
+		// Check if filters or functions reference the root document.
+		_rootReferenced = ([pathString rangeOfString:@"$" options:NSLiteralSearch range:NSMakeRange(1, pathString.length - 1)].location != NSNotFound);
 	}
 	
 	return self;
 }
 
 
+/*
+** SMJJSONPath - Properties
+*/
+#pragma mark - SMJJSONPath - Properties
+
+- (NSString *)jsonPathString
+{
+	return _jsonPathString;
+}
+
+
+/*
+** SMJJSONPath - Cache
+*/
+#pragma mark - SMJJSONPath - Cache
+
++ (NSUInteger)cacheCapacity
+{
+	return [SMJPathCache sharedCache].capacity;
+}
+
++ (void)setCacheCapacity:(NSUInteger)cacheCapacity
+{
+	[SMJPathCache sharedCache].capacity = cacheCapacity;
+}
+
++ (NSUInteger)cacheHitCount
+{
+	return [SMJPathCache sharedCache].hitCount;
+}
+
++ (NSUInteger)cacheMissCount
+{
+	return [SMJPathCache sharedCache].missCount;
+}
+
++ (void)purgeCache
+{
+	[[SMJPathCache sharedCache] purge];
+}
+
+
 /*
 ** SMJJSONPath - Query
 */
@@ -93,7 +156,27 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (nullable id)resultForJSONData:(NSData *)data configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error
 {
-	id rootJsonObject = [NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingAllowFragments error:error];
+	id rootJsonObject = nil;
+	
+	if ([configuration containsOption:SMJOptionBuiltInJSONParser])
+	{
+		SMJJSONParser	*parser = [[SMJJSONParser alloc] initWithData:data];
+		NSError			*parserError = nil;
+		
+		rootJsonObject = [parser readJSONObjectWithError:&parserError];
+		
+		// Built-in parser only handle UTF-8: fallback on NSJSONSerialization for other encodings.
+		if (!rootJsonObject && parser.unsupportedEncoding == NO)
+		{
+			if (error)
+				*error = parserError;
+			
+			return nil;
+		}
+	}
+	
+	if (!rootJsonObject)
+		rootJsonObject = [NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingAllowFragments error:error];
 	
 	if (!rootJsonObject)
 		return nil;
@@ -103,9 +186,50 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (nullable id)resultForJSONFile:(NSURL *)url configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error
 {
-	NSInputStream *inputStream = [NSInputStream inputStreamWithURL:url];
+	NSInputStream	*inputStream = [NSInputStream inputStreamWithURL:url];
+	BOOL			unsupportedEncoding = NO;
+	NSError			*streamError = nil;
+	id				result;
 	
-	[inputStream open];
+	result = [self resultForJSONStream:inputStream configuration:configuration unsupportedEncoding:&unsupportedEncoding error:&streamError];
+	
+	[inputStream close];
+	
+	if (result)
+		return result;
+	
+	// Stream reader only handle UTF-8: fallback on full parsing for other encodings.
+	if (unsupportedEncoding)
+	{
+		inputStream = [NSInputStream inputStreamWithURL:url];
+		
+		[inputStream open];
+		
+		id rootJsonObject = [NSJSONSerialization JSONObjectWithStream:inputStream options:NSJSONReadingAllowFragments error:error];
+		
+		[inputStream close];
+		
+		if (!rootJsonObject)
+			return nil;
+		
+		return [self resultForJSONObject:rootJsonObject configuration:configuration error:error];
+	}
+	
+	if (error)
+		*error = streamError;
+	
+	return nil;
+}
+
+- (nullable id)resultForJSONStream:(NSInputStream *)inputStream configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error
+{
+	return [self resultForJSONStream:inputStream configuration:configuration unsupportedEncoding:NULL error:error];
+}
+
+- (nullable id)resultForJSONStream:(NSInputStream *)inputStream configuration:(nullable SMJConfiguration *)configuration unsupportedEncoding:(nullable BOOL *)unsupportedEncoding error:(NSError **)error
+{
+	if ([inputStream streamStatus] == NSStreamStatusNotOpen)
+		[inputStream open];
 	
 	if ([inputStream streamStatus] == NSStreamStatusError)
 	{
@@ -115,64 +239,131 @@ NS_ASSUME_NONNULL_BEGIN
 		return nil;
 	}
 	
-	id rootJsonObject = [NSJSONSerialization JSONObjectWithStream:inputStream options:NSJSONReadingAllowFragments error:error];
+	// Read the document, projected on the path: the path is then evaluated as usual, on the parts it can select.
+	// > Filters and functions referencing the root document ('$') can look anywhere: read the whole document.
+	SMJJSONStreamReader	*reader = [[SMJJSONStreamReader alloc] initWithInputStream:inputStream];
+	SMJPathToken		*projection = (_rootReferenced ? nil : ((SMJCompiledPath *)_path).root.next);
+	id					rootJsonObject = [reader readJSONObjectProjectedOnPathToken:projection error:error];
 	
 	if (!rootJsonObject)
+	{
+		if (unsupportedEncoding)
+			*unsupportedEncoding = reader.unsupportedEncoding;
+		
 		return nil;
-
+	}
+	
 	return [self resultForJSONObject:rootJsonObject configuration:configuration error:error];
 }
 
 - (nullable id)resultForJSONObject:(id)jsonObject configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error
+{
+	return [self resultForJSONObject:jsonObject limit:0 configuration:configuration error:error];
+}
+
+- (nullable id)resultForJSONObject:(id)jsonObject limit:(NSUInteger)limit configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error
 {
 	if (!configuration)
-		configuration = [SMJConfiguration defaultConfiguration];
+		configuration = [SMJConfiguration sharedDefaultConfiguration];
+	
+	if ([self checkConfiguration:configuration error:error] == NO)
+		return nil;
 	
-	BOOL optAsPathList = [configuration containsOption:SMJOptionAsPathList];
-	BOOL optAlwaysReturnList = [configuration containsOption:SMJOptionAlwaysReturnList];
+	id <SMJEvaluationContext> evaluationContex = [_path evaluateJsonObject:jsonObject rootJsonObject:jsonObject configuration:configuration forUpdate:NO resultLimit:limit error:error];
 	
-	if ([_path isFunctionPath])
+	if (!evaluationContex)
+		return nil;
+	
+	return [self resultForEvaluationContext:evaluationContex configuration:configuration error:error];
+}
+
+- (nullable id)firstResultForJSONObject:(id)jsonObject configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error
+{
+	if (!configuration)
+		configuration = [SMJConfiguration sharedDefaultConfiguration];
+	
+	id result = [self resultForJSONObject:jsonObject limit:1 configuration:configuration error:error];
+	
+	if (!result)
+		return nil;
+	
+	// Function and definite paths return their single result as-is.
+	BOOL isList = ([configuration containsOption:SMJOptionAsPathList] || [configuration containsOption:SMJOptionAlwaysReturnList] || _path.definite == NO);
+	
+	if (_path.functionPath || isList == NO)
+		return result;
+	
+	// Others return a list.
+	NSArray *results = result;
+	
+	if (results.count == 0)
 	{
-		if (optAsPathList || optAlwaysReturnList)
-		{
-			SMSetError(error, 1, @"Options SMJOptionAsPathList and SMJOptionAlwaysReturnList are not allowed when using path functions");
-			return nil;
-		}
-		
-		id <SMJEvaluationContext> evaluationContex = [_path evaluateJsonObject:jsonObject rootJsonObject:jsonObject configuration:configuration error:error];
-		
-		if (!evaluationContex)
-			return nil;
-		
-		return [evaluationContex jsonObjectWithError:error];
-		
+		SMSetError(error, 1, @"No results for path");
+		return nil;
 	}
-	else if (optAsPathList)
-	{
-		id <SMJEvaluationContext> evaluationContex = [_path evaluateJsonObject:jsonObject rootJsonObject:jsonObject configuration:configuration error:error];
+	
+	return results.firstObject;
+}
 
-		if (!evaluationContex)
-			return nil;
-		
-		return evaluationContex.pathList;
-	}
-	else
-	{
-		id <SMJEvaluationContext> evaluationContex = [_path evaluateJsonObject:jsonObject rootJsonObject:jsonObject configuration:configuration error:error];
+- (nullable id)resultForJSONObject:(id)jsonObject configuration:(nullable SMJConfiguration *)configuration profile:(SMJEvaluationProfile * _Nullable * _Nullable)profile error:(NSError **)error
+{
+	if (!configuration)
+		configuration = [SMJConfiguration sharedDefaultConfiguration];
+	
+	if ([self checkConfiguration:configuration error:error] == NO)
+		return nil;
+	
+	SMJCompiledPath				*path = (SMJCompiledPath *)_path;
+	SMJEvaluationProfile		*evaluationProfile = [[SMJEvaluationProfile alloc] initWithPath:path];
+	id <SMJEvaluationContext>	evaluationContext = [path evaluateJsonObject:jsonObject rootJsonObject:jsonObject configuration:configuration forUpdate:NO resultLimit:0 profile:evaluationProfile error:error];
+	
+	if (profile)
+		*profile = evaluationProfile;
+	
+	if (!evaluationContext)
+		return nil;
+	
+	return [self resultForEvaluationContext:evaluationContext configuration:configuration error:error];
+}
 
-		if (!evaluationContex)
-			return nil;
-		
-		id value = [evaluationContex jsonObjectWithError:error];
-		
-		if (!value)
-			return nil;
-		
-		if (optAlwaysReturnList && _path.definite)
-			return @[ value ];
-		else
-			return value;
+
+/*
+** SMJJSONPath - Internal
+*/
+#pragma mark - SMJJSONPath - Internal
+
+- (id <SMJPath>)path
+{
+	return _path;
+}
+
+- (BOOL)checkConfiguration:(SMJConfiguration *)configuration error:(NSError **)error
+{
+	if ([_path isFunctionPath] && ([configuration containsOption:SMJOptionAsPathList] || [configuration containsOption:SMJOptionAlwaysReturnList]))
+	{
+		SMSetError(error, 1, @"Options SMJOptionAsPathList and SMJOptionAlwaysReturnList are not allowed when using path functions");
+		return NO;
 	}
+	
+	return YES;
+}
+
+- (nullable id)resultForEvaluationContext:(id <SMJEvaluationContext>)evaluationContext configuration:(SMJConfiguration *)configuration error:(NSError **)error
+{
+	if ([_path isFunctionPath])
+		return [evaluationContext jsonObjectWithError:error];
+	else if ([configuration containsOption:SMJOptionAsPathList])
+		return evaluationContext.pathList;
+	
+	id value = [evaluationContext jsonObjectWithError:error];
+	
+	if (!value)
+		return nil;
+	
+	if ([configuration containsOption:SMJOptionAlwaysReturnList] && _path.definite)
+		return @[ value ];
+	else
+		return value;
 }
 
 
@@ -184,7 +375,7 @@ NS_ASSUME_NONNULL_BEGIN
 - (nullable id)updateMutableJSONObject:(id)jsonObject setObject:(id)object configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error
 {
 	if (!configuration)
-		configuration = [SMJConfiguration defaultConfiguration];
+		configuration = [SMJConfiguration sharedDefaultConfiguration];
 	
 	id <SMJEvaluationContext> evaluationContext = [_path evaluateJsonObject:jsonObject rootJsonObject:jsonObject configuration:configuration forUpdate:YES error:error];
 	
@@ -205,7 +396,7 @@ NS_ASSUME_NONNULL_BEGIN
 - (nullable id)updateMutableJSONObject:(id)jsonObject mapObjects:(SMJJSONPathMapper)mapper configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error
 {
 	if (!configuration)
-		configuration = [SMJConfiguration defaultConfiguration];
+		configuration = [SMJConfiguration sharedDefaultConfiguration];
 	
 	id <SMJEvaluationContext> evaluationContext = [_path evaluateJsonObject:jsonObject rootJsonObject:jsonObject configuration:configuration forUpdate:YES error:error];
 
@@ -226,20 +417,15 @@ NS_ASSUME_NONNULL_BEGIN
 - (nullable id)updateMutableJSONObject:(id)jsonObject deleteWithConfiguration:(nullable SMJConfiguration *)configuration error:(NSError **)error
 {
 	if (!configuration)
-		configuration = [SMJConfiguration defaultConfiguration];
+		configuration = [SMJConfiguration sharedDefaultConfiguration];
 	
 	id <SMJEvaluationContext> evaluationContext = [_path evaluateJsonObject:jsonObject rootJsonObject:jsonObject configuration:configuration forUpdate:YES error:error];
 	
 	if (!evaluationContext)
 		return nil;
 	
-	NSArray <SMJPathRef *> *updateOperations = evaluationContext.updateOperations;
-	
-	for (SMJPathRef *pathRef in updateOperations)
-	{
-		if ([pathRef deleteWithConfiguration:configuration error:error] == NO)
-			return nil;
-	}
+	if ([SMJPathRef deletePathRefs:evaluationContext.updateOperations configuration:configuration error:error] == NO)
+		return nil;
 	
 	return [self resultForJSONObject:jsonObject evaluationContext:evaluationContext configuration:configuration];
 }
@@ -247,7 +433,7 @@ NS_ASSUME_NONNULL_BEGIN
 - (nullable id)updateMutableJSONObject:(id)jsonObject addObject:(id)object configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error
 {
 	if (!configuration)
-		configuration = [SMJConfiguration defaultConfiguration];
+		configuration = [SMJConfiguration sharedDefaultConfiguration];
 	
 	id <SMJEvaluationContext> evaluationContext = [_path evaluateJsonObject:jsonObject rootJsonObject:jsonObject configuration:configuration forUpdate:YES error:error];
 	
@@ -268,7 +454,7 @@ NS_ASSUME_NONNULL_BEGIN
 - (nullable id)updateMutableJSONObject:(id)jsonObject putObject:(id)object key:(NSString *)key configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error
 {
 	if (!configuration)
-		configuration = [SMJConfiguration defaultConfiguration];
+		configuration = [SMJConfiguration sharedDefaultConfiguration];
 	
 	id <SMJEvaluationContext> evaluationContext = [_path evaluateJsonObject:jsonObject rootJsonObject:jsonObject configuration:configuration forUpdate:YES error:error];
 	
@@ -289,7 +475,7 @@ NS_ASSUME_NONNULL_BEGIN
 - (nullable id)updateMutableJSONObject:(id)jsonObject renameKey:(NSString *)oldKey toKey:(NSString *)newKey configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error
 {
 	if (!configuration)
-		configuration = [SMJConfiguration defaultConfiguration];
+		configuration = [SMJConfiguration sharedDefaultConfiguration];
 	
 	id <SMJEvaluationContext> evaluationContext = [_path evaluateJsonObject:jsonObject rootJsonObject:jsonObject configuration:configuration forUpdate:YES error:error];
 	
@@ -308,6 +494,110 @@ NS_ASSUME_NONNULL_BEGIN
 }
 
 
+/*
+** SMJJSONPath - Copy on write update
+*/
+#pragma mark - SMJJSONPath - Copy on write update
+
+- (nullable id)updatedJSONObject:(id)jsonObject setObject:(id)object configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error
+{
+	return [self updatedJSONObject:jsonObject configuration:configuration copyTargets:NO operations:^BOOL(NSArray <SMJPathRef *> *pathRefs, SMJConfiguration *conf, NSError **lerror) {
+		for (SMJPathRef *pathRef in pathRefs)
+		{
+			if ([pathRef setObject:object configuration:conf error:lerror] == NO)
+				return NO;
+		}
+		
+		return YES;
+	} error:error];
+}
+
+- (nullable id)updatedJSONObject:(id)jsonObject mapObjects:(SMJJSONPathMapper)mapper configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error
+{
+	return [self updatedJSONObject:jsonObject configuration:configuration copyTargets:NO operations:^BOOL(NSArray <SMJPathRef *> *pathRefs, SMJConfiguration *conf, NSError **lerror) {
+		for (SMJPathRef *pathRef in pathRefs)
+		{
+			if ([pathRef convertWithMapper:mapper configuration:conf error:lerror] == NO)
+				return NO;
+		}
+		
+		return YES;
+	} error:error];
+}
+
+- (nullable id)updatedJSONObject:(id)jsonObject deleteWithConfiguration:(nullable SMJConfiguration *)configuration error:(NSError **)error
+{
+	return [self updatedJSONObject:jsonObject configuration:configuration copyTargets:NO operations:^BOOL(NSArray <SMJPathRef *> *pathRefs, SMJConfiguration *conf, NSError **lerror) {
+		return [SMJPathRef deletePathRefs:pathRefs configuration:conf error:lerror];
+	} error:error];
+}
+
+- (nullable id)updatedJSONObject:(id)jsonObject addObject:(id)object configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error
+{
+	return [self updatedJSONObject:jsonObject configuration:configuration copyTargets:YES operations:^BOOL(NSArray <SMJPathRef *> *pathRefs, SMJConfiguration *conf, NSError **lerror) {
+		for (SMJPathRef *pathRef in pathRefs)
+		{
+			if ([pathRef addObject:object configuration:conf error:lerror] == NO)
+				return NO;
+		}
+		
+		return YES;
+	} error:error];
+}
+
+- (nullable id)updatedJSONObject:(id)jsonObject putObject:(id)object key:(NSString *)key configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error
+{
+	return [self updatedJSONObject:jsonObject configuration:configuration copyTargets:YES operations:^BOOL(NSArray <SMJPathRef *> *pathRefs, SMJConfiguration *conf, NSError **lerror) {
+		for (SMJPathRef *pathRef in pathRefs)
+		{
+			if ([pathRef putObject:object forKey:key configuration:conf error:lerror] == NO)
+				return NO;
+		}
+		
+		return YES;
+	} error:error];
+}
+
+- (nullable id)updatedJSONObject:(id)jsonObject renameKey:(NSString *)oldKey toKey:(NSString *)newKey configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error
+{
+	return [self updatedJSONObject:jsonObject configuration:configuration copyTargets:YES operations:^BOOL(NSArray <SMJPathRef *> *pathRefs, SMJConfiguration *conf, NSError **lerror) {
+		for (SMJPathRef *pathRef in pathRefs)
+		{
+			if ([pathRef renameKey:oldKey toKey:newKey configuration:conf error:lerror] == NO)
+				return NO;
+		}
+		
+		return YES;
+	} error:error];
+}
+
+- (nullable id)updatedJSONObject:(id)jsonObject configuration:(nullable SMJConfiguration *)configuration copyTargets:(BOOL)copyTargets operations:(BOOL (^)(NSArray <SMJPathRef *> *pathRefs, SMJConfiguration *configuration, NSError **error))operations error:(NSError **)error
+{
+	if (!configuration)
+		configuration = [SMJConfiguration sharedDefaultConfiguration];
+	
+	id <SMJEvaluationContext> evaluationContext = [(SMJCompiledPath *)_path evaluateJsonObjectForCopyOnWrite:jsonObject configuration:configuration error:error];
+	
+	if (!evaluationContext)
+		return nil;
+	
+	// Copy the containers on the way to the updated values, then update the copy.
+	NSArray <SMJPathRef *>	*updateOperations = evaluationContext.updateOperations;
+	SMJCopyOnWriteDocument	*document = [[SMJCopyOnWriteDocument alloc] initWithRootJsonObject:jsonObject];
+	
+	for (SMJPathRef *pathRef in updateOperations)
+	{
+		if ([document preparePathRef:pathRef copyTarget:copyTargets error:error] == NO)
+			return nil;
+	}
+	
+	if (operations(updateOperations, configuration, error) == NO)
+		return nil;
+	
+	return document.rootJsonObject;
+}
+
+
 /*
 ** SMJJSONPath - Helpers
 */
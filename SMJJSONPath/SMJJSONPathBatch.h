@@ -0,0 +1,60 @@
+/*
+ * SMJJSONPathBatch.h
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+#import <SMJJSONPath/SMJConfiguration.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** Forward
+*/
+#pragma mark - Forward
+
+@class SMJJSONPath;
+
+
+
+/*
+** SMJJSONPathBatch
+*/
+#pragma mark - SMJJSONPathBatch
+
+// Evaluate several paths with a single walk of the document. The common prefixes of the paths are evaluated once.
+
+@interface SMJJSONPathBatch : NSObject
+
+// Instance.
+- (instancetype)initWithJSONPaths:(NSArray <SMJJSONPath *> *)jsonPaths NS_DESIGNATED_INITIALIZER; // Paths with the same path string are evaluated once.
+- (nullable instancetype)initWithJSONPathStrings:(NSArray <NSString *> *)jsonPathStrings error:(NSError **)error;
+- (instancetype)init NS_UNAVAILABLE;
+
+@property (readonly) NSArray <SMJJSONPath *> *jsonPaths;
+
+// Apply paths to JSON.
+// > Results and errors are keyed by path string. Each path gives the same result than -[SMJJSONPath resultForJSONObject:configuration:error:].
+- (NSDictionary <NSString *, id> *)resultsForJSONObject:(id)jsonObject configuration:(nullable SMJConfiguration *)configuration errors:(NSDictionary <NSString *, NSError *> * _Nullable * _Nullable)errors;
+
+@end
+
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,156 @@
+/*
+ * SMJJSONPathBatch.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import "SMJJSONPathBatch.h"
+
+#import "SMJJSONPath.h"
+#import "SMJJSONPathInternal.h"
+
+#import "SMJPathTrie.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** SMJJSONPathBatch
+*/
+#pragma mark - SMJJSONPathBatch
+
+@implementation SMJJSONPathBatch
+{
+	NSArray <SMJJSONPath *> *_jsonPaths;
+	
+	SMJPathTrie *_trie;
+}
+
+
+/*
+** SMJJSONPathBatch - Instance
+*/
+#pragma mark - SMJJSONPathBatch - Instance
+
+- (instancetype)initWithJSONPaths:(NSArray <SMJJSONPath *> *)jsonPaths
+{
+	self = [super init];
+	
+	if (self)
+	{
+		NSMutableArray <SMJJSONPath *>		*uniquePaths = [[NSMutableArray alloc] initWithCapacity:jsonPaths.count];
+		NSMutableArray <SMJCompiledPath *>	*compiledPaths = [[NSMutableArray alloc] initWithCapacity:jsonPaths.count];
+		NSMutableSet <NSString *>			*pathStrings = [[NSMutableSet alloc] init];
+		
+		for (SMJJSONPath *jsonPath in jsonPaths)
+		{
+			if ([pathStrings containsObject:jsonPath.jsonPathString])
+				continue;
+			
+			[pathStrings addObject:jsonPath.jsonPathString];
+			[uniquePaths addObject:jsonPath];
+			[compiledPaths addObject:(SMJCompiledPath *)jsonPath.path];
+		}
+		
+		_jsonPaths = uniquePaths;
+		_trie = [[SMJPathTrie alloc] initWithPaths:compiledPaths];
+	}
+	
+	return self;
+}
+
+- (nullable instancetype)initWithJSONPathStrings:(NSArray <NSString *> *)jsonPathStrings error:(NSError **)error
+{
+	NSMutableArray <SMJJSONPath *> *jsonPaths = [[NSMutableArray alloc] initWithCapacity:jsonPathStrings.count];
+	
+	for (NSString *jsonPathString in jsonPathStrings)
+	{
+		SMJJSONPath *jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:jsonPathString error:error];
+		
+		if (!jsonPath)
+			return nil;
+		
+		[jsonPaths addObject:jsonPath];
+	}
+	
+	return [self initWithJSONPaths:jsonPaths];
+}
+
+
+/*
+** SMJJSONPathBatch - Properties
+*/
+#pragma mark - SMJJSONPathBatch - Properties
+
+- (NSArray <SMJJSONPath *> *)jsonPaths
+{
+	return _jsonPaths;
+}
+
+
+/*
+** SMJJSONPathBatch - Result
+*/
+#pragma mark - SMJJSONPathBatch - Result
+
+- (NSDictionary <NSString *, id> *)resultsForJSONObject:(id)jsonObject configuration:(nullable SMJConfiguration *)configuration errors:(NSDictionary <NSString *, NSError *> * _Nullable * _Nullable)errors
+{
+	if (!configuration)
+		configuration = [SMJConfiguration sharedDefaultConfiguration];
+	
+	NSMutableDictionary <NSString *, id>		*results = [[NSMutableDictionary alloc] initWithCapacity:_jsonPaths.count];
+	NSMutableDictionary <NSString *, NSError *>	*pathErrors = [[NSMutableDictionary alloc] init];
+	
+	// Evaluate all paths at once.
+	NSArray *evaluations = [_trie evaluateJsonObject:jsonObject configuration:configuration];
+	
+	// Render each path result.
+	[_jsonPaths enumerateObjectsUsingBlock:^(SMJJSONPath * _Nonnull jsonPath, NSUInteger idx, BOOL * _Nonnull stop) {
+		NSString	*pathString = jsonPath.jsonPathString;
+		id			evaluation = evaluations[idx];
+		NSError		*error = nil;
+		
+		if ([evaluation isKindOfClass:[NSError class]])
+		{
+			pathErrors[pathString] = evaluation;
+			return;
+		}
+		
+		if ([jsonPath checkConfiguration:configuration error:&error] == NO)
+		{
+			pathErrors[pathString] = error;
+			return;
+		}
+		
+		id result = [jsonPath resultForEvaluationContext:evaluation configuration:configuration error:&error];
+		
+		if (result)
+			results[pathString] = result;
+		else if (error)
+			pathErrors[pathString] = error;
+	}];
+	
+	if (errors)
+		*errors = pathErrors;
+	
+	return results;
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
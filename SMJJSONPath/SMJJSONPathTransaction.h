@@ -0,0 +1,76 @@
+/*
+ * SMJJSONPathTransaction.h
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+#import <SMJJSONPath/SMJConfiguration.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** Forward
+*/
+#pragma mark - Forward
+
+@class SMJJSONPath;
+@class SMJJSONPatch;
+
+
+
+/*
+** SMJJSONPathTransaction
+*/
+#pragma mark - SMJJSONPathTransaction
+
+// Apply several updates to a document at once. All paths are evaluated with a single walk of the document, before any modification,
+// then the operations are applied in a deterministic order: sets, maps, adds, puts and renames in the order they were added, then
+// deletes (array items are removed in one pass by array, which amounts to removing them in descending index order).
+// Updates are atomic: if an operation fails, the document is left untouched.
+
+@interface SMJJSONPathTransaction : NSObject
+
+// Operations.
+- (void)setObject:(id)object atJSONPath:(SMJJSONPath *)jsonPath;
+- (void)mapObjects:(_Nonnull id (^)(id object, SMJConfiguration *configuration))mapper atJSONPath:(SMJJSONPath *)jsonPath;
+- (void)deleteAtJSONPath:(SMJJSONPath *)jsonPath;
+- (void)addObject:(id)object atJSONPath:(SMJJSONPath *)jsonPath;
+- (void)putObject:(id)object key:(NSString *)key atJSONPath:(SMJJSONPath *)jsonPath;
+- (void)renameKey:(NSString *)oldKey toKey:(NSString *)newKey atJSONPath:(SMJJSONPath *)jsonPath;
+
+@property (readonly) NSUInteger operationCount;
+
+// Apply operations.
+// > The json object need to use mutable containers where values are modified. It's modified in place, and nothing is evaluated again after the update.
+- (BOOL)applyToMutableJSONObject:(id)jsonObject configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error;
+
+// > The json object can use immutable containers, and is not modified. Return the root of an updated copy, sharing everything but the containers on the way to the updated values.
+- (nullable id)updatedJSONObject:(id)jsonObject configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error;
+
+// Apply operations, and describe the changes as a JSON Patch (RFC 6902), which can be applied to a copy of the json object to replicate them.
+// > Sets and maps give replace operations (add for new properties), adds and puts give add operations, renames give move operations, deletes give remove operations (deepest values and highest indexes first).
+// > Paths are evaluated before the update, and pointers then follow the renames applied before each operation, so the patch can be applied in order.
+- (BOOL)applyToMutableJSONObject:(id)jsonObject configuration:(nullable SMJConfiguration *)configuration patch:(SMJJSONPatch * _Nullable * _Nullable)patch error:(NSError **)error;
+- (nullable id)updatedJSONObject:(id)jsonObject configuration:(nullable SMJConfiguration *)configuration patch:(SMJJSONPatch * _Nullable * _Nullable)patch error:(NSError **)error;
+
+@end
+
+
+NS_ASSUME_NONNULL_END
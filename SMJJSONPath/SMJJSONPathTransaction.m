@@ -0,0 +1,464 @@
+/*
+ * SMJJSONPathTransaction.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import "SMJJSONPathTransaction.h"
+
+#import "SMJJSONPath.h"
+#import "SMJJSONPathInternal.h"
+#import "SMJJSONPatch.h"
+
+#import "SMJPathTrie.h"
+#import "SMJPathRef.h"
+#import "SMJEvaluationContextImpl.h"
+#import "SMJUtils.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** Types
+*/
+#pragma mark - Types
+
+typedef enum SMJTransactionOperationKind
+{
+	SMJTransactionOperationKindSet,
+	SMJTransactionOperationKindMap,
+	SMJTransactionOperationKindDelete,
+	SMJTransactionOperationKindAdd,
+	SMJTransactionOperationKindPut,
+	SMJTransactionOperationKindRename
+} SMJTransactionOperationKind;
+
+
+
+/*
+** SMJTransactionOperation
+*/
+#pragma mark - SMJTransactionOperation
+
+@interface SMJTransactionOperation : NSObject
+{
+@public
+	SMJTransactionOperationKind	_kind;
+	NSUInteger					_pathIndex;
+	
+	id _Nullable				_object;
+	NSString * _Nullable		_key;
+	NSString * _Nullable		_newKey;
+	SMJPathRefMapper _Nullable	_mapper;
+}
+@end
+
+@implementation SMJTransactionOperation
+@end
+
+
+
+/*
+** SMJJSONPathTransaction
+*/
+#pragma mark - SMJJSONPathTransaction
+
+@implementation SMJJSONPathTransaction
+{
+	NSMutableArray <SMJTransactionOperation *>	*_operations;
+	NSMutableArray <SMJCompiledPath *>			*_paths;
+	NSMutableDictionary <NSString *, NSNumber *>	*_pathIndexes;
+	
+	SMJPathTrie *_trie;
+}
+
+
+/*
+** SMJJSONPathTransaction - Instance
+*/
+#pragma mark - SMJJSONPathTransaction - Instance
+
+- (instancetype)init
+{
+	self = [super init];
+	
+	if (self)
+	{
+		_operations = [[NSMutableArray alloc] init];
+		_paths = [[NSMutableArray alloc] init];
+		_pathIndexes = [[NSMutableDictionary alloc] init];
+	}
+	
+	return self;
+}
+
+
+/*
+** SMJJSONPathTransaction - Operations
+*/
+#pragma mark - SMJJSONPathTransaction - Operations
+
+- (void)setObject:(id)object atJSONPath:(SMJJSONPath *)jsonPath
+{
+	SMJTransactionOperation *operation = [self addOperationWithKind:SMJTransactionOperationKindSet jsonPath:jsonPath];
+	
+	operation->_object = object;
+}
+
+- (void)mapObjects:(_Nonnull id (^)(id object, SMJConfiguration *configuration))mapper atJSONPath:(SMJJSONPath *)jsonPath
+{
+	SMJTransactionOperation *operation = [self addOperationWithKind:SMJTransactionOperationKindMap jsonPath:jsonPath];
+	
+	operation->_mapper = mapper;
+}
+
+- (void)deleteAtJSONPath:(SMJJSONPath *)jsonPath
+{
+	[self addOperationWithKind:SMJTransactionOperationKindDelete jsonPath:jsonPath];
+}
+
+- (void)addObject:(id)object atJSONPath:(SMJJSONPath *)jsonPath
+{
+	SMJTransactionOperation *operation = [self addOperationWithKind:SMJTransactionOperationKindAdd jsonPath:jsonPath];
+	
+	operation->_object = object;
+}
+
+- (void)putObject:(id)object key:(NSString *)key atJSONPath:(SMJJSONPath *)jsonPath
+{
+	SMJTransactionOperation *operation = [self addOperationWithKind:SMJTransactionOperationKindPut jsonPath:jsonPath];
+	
+	operation->_object = object;
+	operation->_key = key;
+}
+
+- (void)renameKey:(NSString *)oldKey toKey:(NSString *)newKey atJSONPath:(SMJJSONPath *)jsonPath
+{
+	SMJTransactionOperation *operation = [self addOperationWithKind:SMJTransactionOperationKindRename jsonPath:jsonPath];
+	
+	operation->_key = oldKey;
+	operation->_newKey = newKey;
+}
+
+- (NSUInteger)operationCount
+{
+	return _operations.count;
+}
+
+
+/*
+** SMJJSONPathTransaction - Apply
+*/
+#pragma mark - SMJJSONPathTransaction - Apply
+
+- (BOOL)applyToMutableJSONObject:(id)jsonObject configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error
+{
+	return [self applyToMutableJSONObject:jsonObject configuration:configuration patch:NULL error:error];
+}
+
+- (nullable id)updatedJSONObject:(id)jsonObject configuration:(nullable SMJConfiguration *)configuration error:(NSError **)error
+{
+	return [self updatedJSONObject:jsonObject configuration:configuration patch:NULL error:error];
+}
+
+- (BOOL)applyToMutableJSONObject:(id)jsonObject configuration:(nullable SMJConfiguration *)configuration patch:(SMJJSONPatch * _Nullable * _Nullable)patch error:(NSError **)error
+{
+	NSMutableArray			*patchOperations = (patch ? [[NSMutableArray alloc] init] : nil);
+	SMJCopyOnWriteDocument	*document = [self documentByApplyingToJSONObject:jsonObject configuration:configuration patchOperations:patchOperations error:error];
+	
+	if (!document)
+		return NO;
+	
+	// Operations were applied to copies: write them back into the original containers.
+	if ([document commitWithError:error] == NO)
+		return NO;
+	
+	if (patch)
+		*patch = [[SMJJSONPatch alloc] initWithOperations:(NSArray *)patchOperations error:nil];
+	
+	return YES;
+}
+
+- (nullable id)updatedJSONObject:(id)jsonObject configuration:(nullable SMJConfiguration *)configuration patch:(SMJJSONPatch * _Nullable * _Nullable)patch error:(NSError **)error
+{
+	NSMutableArray			*patchOperations = (patch ? [[NSMutableArray alloc] init] : nil);
+	SMJCopyOnWriteDocument	*document = [self documentByApplyingToJSONObject:jsonObject configuration:configuration patchOperations:patchOperations error:error];
+	
+	if (!document)
+		return nil;
+	
+	if (patch)
+		*patch = [[SMJJSONPatch alloc] initWithOperations:(NSArray *)patchOperations error:nil];
+	
+	return document.rootJsonObject;
+}
+
+
+/*
+** SMJJSONPathTransaction - Helpers
+*/
+#pragma mark - SMJJSONPathTransaction - Helpers
+
+- (SMJTransactionOperation *)addOperationWithKind:(SMJTransactionOperationKind)kind jsonPath:(SMJJSONPath *)jsonPath
+{
+	SMJTransactionOperation	*operation = [[SMJTransactionOperation alloc] init];
+	NSNumber				*pathIndex = _pathIndexes[jsonPath.jsonPathString];
+	
+	// Paths with the same path string are evaluated once.
+	if (!pathIndex)
+	{
+		pathIndex = @(_paths.count);
+		
+		_pathIndexes[jsonPath.jsonPathString] = pathIndex;
+		[_paths addObject:(SMJCompiledPath *)jsonPath.path];
+		
+		_trie = nil;
+	}
+	
+	operation->_kind = kind;
+	operation->_pathIndex = pathIndex.unsignedIntegerValue;
+	
+	[_operations addObject:operation];
+	
+	return operation;
+}
+
+- (nullable SMJCopyOnWriteDocument *)documentByApplyingToJSONObject:(id)jsonObject configuration:(nullable SMJConfiguration *)configuration patchOperations:(nullable NSMutableArray *)patchOperations error:(NSError **)error
+{
+	if (!configuration)
+		configuration = [SMJConfiguration sharedDefaultConfiguration];
+	
+	if (!_trie)
+		_trie = [[SMJPathTrie alloc] initWithPaths:_paths];
+	
+	// Evaluate all paths with a single walk, before any modification.
+	NSArray *evaluations = [_trie evaluateJsonObjectForUpdate:jsonObject configuration:configuration];
+	
+	for (id evaluation in evaluations)
+	{
+		if ([evaluation isKindOfClass:[NSError class]])
+		{
+			if (error)
+				*error = evaluation;
+			
+			return nil;
+		}
+	}
+	
+	// Work on a copy of the containers on the way to the updated values, so a failure leaves the document untouched.
+	SMJCopyOnWriteDocument	*document = [[SMJCopyOnWriteDocument alloc] initWithRootJsonObject:jsonObject];
+	NSMutableArray			*pathRefsByPath = [[NSMutableArray alloc] initWithCapacity:evaluations.count];
+	
+	for (SMJEvaluationContextImpl *evaluation in evaluations)
+		[pathRefsByPath addObject:evaluation.updateOperations];
+	
+	for (SMJTransactionOperation *operation in _operations)
+	{
+		SMJTransactionOperationKind kind = operation->_kind;
+		BOOL						copyTarget = (kind == SMJTransactionOperationKindAdd || kind == SMJTransactionOperationKindPut || kind == SMJTransactionOperationKindRename);
+		
+		for (SMJPathRef *pathRef in pathRefsByPath[operation->_pathIndex])
+		{
+			if ([document preparePathRef:pathRef copyTarget:copyTarget error:error] == NO)
+				return nil;
+		}
+	}
+	
+	// Apply in order, deletes last.
+	NSMutableArray <SMJPathRef *>	*deletePathRefs = [[NSMutableArray alloc] init];
+	NSMutableArray <NSDictionary *>	*patchMoves = (patchOperations ? [[NSMutableArray alloc] init] : nil);
+	
+	for (SMJTransactionOperation *operation in _operations)
+	{
+		NSArray <SMJPathRef *> *pathRefs = pathRefsByPath[operation->_pathIndex];
+		
+		if (operation->_kind == SMJTransactionOperationKindDelete)
+		{
+			[deletePathRefs addObjectsFromArray:pathRefs];
+			continue;
+		}
+		
+		for (SMJPathRef *pathRef in pathRefs)
+		{
+			BOOL			succeed = NO;
+			NSMutableSet	*existingPointers = nil;
+			
+			// Values replaced by sets and maps are reported as replaced, others as added.
+			if (patchOperations && (operation->_kind == SMJTransactionOperationKindSet || operation->_kind == SMJTransactionOperationKindMap))
+			{
+				existingPointers = [[NSMutableSet alloc] init];
+				
+				[pathRef enumerateReferencedValuesUsingBlock:^(NSString *jsonPointer, id _Nullable value) {
+					if (value)
+						[existingPointers addObject:jsonPointer];
+				}];
+			}
+			
+			switch (operation->_kind)
+			{
+				case SMJTransactionOperationKindSet:
+					succeed = [pathRef setObject:(id)operation->_object configuration:configuration error:error];
+					break;
+				
+				case SMJTransactionOperationKindMap:
+					succeed = [pathRef convertWithMapper:(SMJPathRefMapper)operation->_mapper configuration:configuration error:error];
+					break;
+				
+				case SMJTransactionOperationKindAdd:
+					succeed = [pathRef addObject:(id)operation->_object configuration:configuration error:error];
+					break;
+				
+				case SMJTransactionOperationKindPut:
+					succeed = [pathRef putObject:(id)operation->_object forKey:(NSString *)operation->_key configuration:configuration error:error];
+					break;
+				
+				case SMJTransactionOperationKindRename:
+					succeed = [pathRef renameKey:(NSString *)operation->_key toKey:(NSString *)operation->_newKey configuration:configuration error:error];
+					break;
+				
+				case SMJTransactionOperationKindDelete:
+					break;
+			}
+			
+			if (!succeed)
+				return nil;
+			
+			if (patchOperations)
+				[self recordOperation:operation pathRef:pathRef existingPointers:existingPointers moves:(NSMutableArray *)patchMoves patchOperations:(NSMutableArray *)patchOperations];
+		}
+	}
+	
+	if (patchOperations)
+		[self recordDeletePathRefs:deletePathRefs moves:(NSArray *)patchMoves patchOperations:(NSMutableArray *)patchOperations];
+	
+	if ([SMJPathRef deletePathRefs:deletePathRefs configuration:configuration error:error] == NO)
+		return nil;
+	
+	return document;
+}
+
+
+/*
+** SMJJSONPathTransaction - Patch
+*/
+#pragma mark - SMJJSONPathTransaction - Patch
+
+- (void)recordOperation:(SMJTransactionOperation *)operation pathRef:(SMJPathRef *)pathRef existingPointers:(nullable NSSet *)existingPointers moves:(NSMutableArray <NSDictionary *> *)moves patchOperations:(NSMutableArray *)patchOperations
+{
+	[pathRef enumerateReferencedValuesUsingBlock:^(NSString *jsonPointer, id _Nullable value) {
+		
+		// Pointers are evaluated before the update: follow the renames already recorded, so the operation applies to the patched document.
+		NSString *pointer = [SMJJSONPathTransaction jsonPointer:jsonPointer followingMoves:moves];
+		
+		switch (operation->_kind)
+		{
+			case SMJTransactionOperationKindSet:
+			case SMJTransactionOperationKindMap:
+			{
+				if (!value)
+					break;
+				
+				[patchOperations addObject:@{ @"op" : ([existingPointers containsObject:jsonPointer] ? @"replace" : @"add"), @"path" : pointer, @"value" : value }];
+				break;
+			}
+				
+			case SMJTransactionOperationKindAdd:
+			{
+				[patchOperations addObject:@{ @"op" : @"add", @"path" : [pointer stringByAppendingString:@"/-"], @"value" : (id)operation->_object }];
+				break;
+			}
+				
+			case SMJTransactionOperationKindPut:
+			{
+				NSString *path = [pointer stringByAppendingString:[SMJUtils jsonPointerWithComponents:@[ (id)operation->_key ]]];
+				
+				[patchOperations addObject:@{ @"op" : @"add", @"path" : path, @"value" : (id)operation->_object }];
+				break;
+			}
+				
+			case SMJTransactionOperationKindRename:
+			{
+				NSString		*from = [pointer stringByAppendingString:[SMJUtils jsonPointerWithComponents:@[ (id)operation->_key ]]];
+				NSString		*path = [pointer stringByAppendingString:[SMJUtils jsonPointerWithComponents:@[ (id)operation->_newKey ]]];
+				NSDictionary	*move = @{ @"op" : @"move", @"from" : from, @"path" : path };
+				
+				[patchOperations addObject:move];
+				[moves addObject:move];
+				break;
+			}
+				
+			case SMJTransactionOperationKindDelete:
+				break;
+		}
+	}];
+}
+
+- (void)recordDeletePathRefs:(NSArray <SMJPathRef *> *)pathRefs moves:(NSArray <NSDictionary *> *)moves patchOperations:(NSMutableArray *)patchOperations
+{
+	NSMutableOrderedSet <NSString *> *pointers = [[NSMutableOrderedSet alloc] init];
+	
+	for (SMJPathRef *pathRef in pathRefs)
+	{
+		[pathRef enumerateReferencedValuesUsingBlock:^(NSString *jsonPointer, id _Nullable value) {
+			if (value)
+				[pointers addObject:[SMJJSONPathTransaction jsonPointer:jsonPointer followingMoves:moves]];
+		}];
+	}
+	
+	// Removing a value only moves its next siblings: remove deepest values first, and highest indexes first in each array.
+	NSArray <NSString *> *sortedPointers = [pointers.array sortedArrayWithOptions:NSSortStable usingComparator:^NSComparisonResult(NSString *pointer1, NSString *pointer2) {
+		NSArray <NSString *> *tokens1 = [pointer1 componentsSeparatedByString:@"/"];
+		NSArray <NSString *> *tokens2 = [pointer2 componentsSeparatedByString:@"/"];
+		
+		// Deepest first.
+		if (tokens1.count != tokens2.count)
+			return (tokens1.count > tokens2.count ? NSOrderedAscending : NSOrderedDescending);
+		
+		// Grouped by container.
+		NSString			*parent1 = [pointer1 substringToIndex:pointer1.length - tokens1.lastObject.length];
+		NSString			*parent2 = [pointer2 substringToIndex:pointer2.length - tokens2.lastObject.length];
+		NSComparisonResult	parentResult = [parent1 compare:parent2];
+		
+		if (parentResult != NSOrderedSame)
+			return parentResult;
+		
+		// Highest index first (keys order doesn't matter).
+		return [tokens2.lastObject compare:tokens1.lastObject options:NSNumericSearch];
+	}];
+	
+	for (NSString *pointer in sortedPointers)
+		[patchOperations addObject:@{ @"op" : @"remove", @"path" : pointer }];
+}
+
++ (NSString *)jsonPointer:(NSString *)jsonPointer followingMoves:(NSArray <NSDictionary *> *)moves
+{
+	// Replay the moves in order: each one relocates the values under its "from" pointer.
+	for (NSDictionary *move in moves)
+	{
+		NSString *from = move[@"from"];
+		
+		if ([jsonPointer isEqualToString:from] || ([jsonPointer hasPrefix:from] && [jsonPointer characterAtIndex:from.length] == '/'))
+			jsonPointer = [move[@"path"] stringByAppendingString:[jsonPointer substringFromIndex:from.length]];
+	}
+	
+	return jsonPointer;
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
@@ -86,5 +86,14 @@ typedef enum SMJOption {
 	 * If SMJOptionRequireProperties option is present PathNotFoundException is thrown.
 	 * If SMJOptionRequireProperties option is not present ["b-val"] is returned.
 	 */
-	SMJOptionRequireProperties
+	SMJOptionRequireProperties,
+	
+	/**
+	 * Parse the data given to resultForJSONData: with the built-in parser instead of NSJSONSerialization.
+	 *
+	 * The built-in parser first indexes the structural characters of the document with SIMD instructions when
+	 * available, then builds the same values than NSJSONSerialization from this index.
+	 * Documents which are not UTF-8 encoded are parsed with NSJSONSerialization.
+	 */
+	SMJOptionBuiltInJSONParser
 } SMJOption;
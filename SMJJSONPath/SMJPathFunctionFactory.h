@@ -23,7 +23,7 @@
 #import <Foundation/Foundation.h>
 #import <dispatch/dispatch.h>
 
-#import "SMJPathFunction.h"
+#import <SMJJSONPath/SMJPathFunction.h>
 
 
 NS_ASSUME_NONNULL_BEGIN
@@ -38,6 +38,12 @@ NS_ASSUME_NONNULL_BEGIN
 
 // -- Instance --
 + (nullable id <SMJPathFunction>)pathFunctionForName:(NSString *)name error:(NSError **)error;
++ (nullable Class)pathFunctionClassForName:(NSString *)name error:(NSError **)error;
+
+// -- Registration --
+// > Registered functions are resolved when paths are compiled, like built-in functions. The class has to conform to SMJPathFunction.
+// > A name can be registered only once, and built-in names can't be replaced.
++ (BOOL)registerPathFunctionClass:(Class)functionClass forName:(NSString *)name error:(NSError **)error;
 
 @end
 
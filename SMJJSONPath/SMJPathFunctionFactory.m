@@ -20,9 +20,15 @@
 /* Adapted from https://github.com/json-path/JsonPath/blob/master/json-path/src/main/java/com/jayway/jsonpath/internal/function/PathFunctionFactory.java */
 
 
+#include <pthread.h>
+
 #import "SMJPathFunctionFactory.h"
 
+#import "SMJPathRef.h"
+#import "SMJEvaluationContext.h"
+
 #import "SMJUtils.h"
+#import "SMJNumericAggregation.h"
 
 
 NS_ASSUME_NONNULL_BEGIN
@@ -51,21 +57,20 @@ NS_ASSUME_NONNULL_BEGIN
 @interface SMJAbstractAggregation : NSObject <SMJPathFunction>
 
 /**
- * Defines the next value in the array to the mathmatical function
- *
- * @param value
- *      The numerical value to process next
+ * Tell if the function needs the variance of the values. Count, sum, min and max are always computed.
  */
-
-- (void)handleNumber:(NSNumber *)value; // To be overwritten
+@property (class, readonly) BOOL needsVariance; // Can be overwritten
 
 /**
- * Obtains the value generated via the series of next value calls
+ * Obtains the value generated from the aggregates of the values
+ *
+ * @param aggregates
+ *      The aggregates computed in one pass on the unboxed values
  *
  * @return
  *      A numerical answer based on the input value provided
  */
-@property (readonly) NSNumber *result; // To be overwritten
+- (NSNumber *)resultWithAggregates:(const SMJNumericAggregates *)aggregates; // To be overwritten
 
 @end
 
@@ -103,20 +108,19 @@ NS_ASSUME_NONNULL_BEGIN
 
 
 /*
-** SMJPathFunctionFactory
+** Globals
 */
-#pragma mark - SMJPathFunctionFactory
+#pragma mark - Globals
 
-@implementation SMJPathFunctionFactory
+static pthread_mutex_t							gFunctionsLock = PTHREAD_MUTEX_INITIALIZER;
+static NSMutableDictionary <NSString *, Class>	*gFunctions;
 
-+ (nullable id <SMJPathFunction>)pathFunctionForName:(NSString *)name error:(NSError **)error
+NS_INLINE void SMJPathFunctionFactoryLoadFunctions(void)
 {
-	// Functions list.
 	static dispatch_once_t onceToken;
-	static NSDictionary <NSString *, Class> *functions;
 	
 	dispatch_once(&onceToken, ^{
-		functions = @{
+		gFunctions = [@{
 		  // Math Functions
 		  @"avg" 	: SMJAverageFunction.class,
 		  @"stddev"	: SMJStandardDeviationFunction.class,
@@ -131,11 +135,46 @@ NS_ASSUME_NONNULL_BEGIN
 		  @"length" : SMJLengthFunction.class,
 		  @"size" 	: SMJLengthFunction.class,
 		  @"append" : SMJAppendFunction.class
-	  };
+	  } mutableCopy];
 	});
+}
+
+
+
+/*
+** SMJPathFunctionFactory
+*/
+#pragma mark - SMJPathFunctionFactory
+
+@implementation SMJPathFunctionFactory
+
+
+/*
+** SMJPathFunctionFactory - Instance
+*/
+#pragma mark - SMJPathFunctionFactory - Instance
+
++ (nullable id <SMJPathFunction>)pathFunctionForName:(NSString *)name error:(NSError **)error
+{
+	Class class = [self pathFunctionClassForName:name error:error];
+	
+	if (!class)
+		return nil;
+	
+	// Return instance.
+	return [class new];
+}
+
++ (nullable Class)pathFunctionClassForName:(NSString *)name error:(NSError **)error
+{
+	SMJPathFunctionFactoryLoadFunctions();
 	
 	// Search request functions.
-	Class class = functions[name];
+	Class class;
+	
+	pthread_mutex_lock(&gFunctionsLock);
+	class = gFunctions[name];
+	pthread_mutex_unlock(&gFunctionsLock);
 	
 	if (!class)
 	{
@@ -143,8 +182,48 @@ NS_ASSUME_NONNULL_BEGIN
 		return nil;
 	}
 	
-	// Return instance.
-	return [class new];
+	return class;
+}
+
+
+/*
+** SMJPathFunctionFactory - Registration
+*/
+#pragma mark - SMJPathFunctionFactory - Registration
+
++ (BOOL)registerPathFunctionClass:(Class)functionClass forName:(NSString *)name error:(NSError **)error
+{
+	if ([functionClass conformsToProtocol:@protocol(SMJPathFunction)] == NO)
+	{
+		SMSetError(error, 3, @"Class %@ doesn't conform to SMJPathFunction.", NSStringFromClass(functionClass));
+		return NO;
+	}
+	
+	if (name.length == 0)
+	{
+		SMSetError(error, 4, @"Function name can't be empty.");
+		return NO;
+	}
+	
+	SMJPathFunctionFactoryLoadFunctions();
+	
+	// Register.
+	BOOL registered = NO;
+	
+	pthread_mutex_lock(&gFunctionsLock);
+	
+	if (gFunctions[name] == nil)
+	{
+		gFunctions[name] = functionClass;
+		registered = YES;
+	}
+	
+	pthread_mutex_unlock(&gFunctionsLock);
+	
+	if (!registered)
+		SMSetError(error, 5, @"Function with name: %@ already exists.", name);
+	
+	return registered;
 }
 
 @end
@@ -158,12 +237,17 @@ NS_ASSUME_NONNULL_BEGIN
 
 @implementation SMJAbstractAggregation
 
-- (void)handleNumber:(NSNumber *)value
++ (BOOL)isShareable
 {
-	NSAssert(NO, @"need to be overwritten");
+	return YES;
+}
+
++ (BOOL)needsVariance
+{
+	return NO;
 }
 
-- (NSNumber *)result
+- (NSNumber *)resultWithAggregates:(const SMJNumericAggregates *)aggregates
 {
 	NSAssert(NO, @"need to be overwritten");
 	return (NSNumber *)nil;
@@ -171,43 +255,48 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (nullable id)invokeWithCurrentPathString:(NSString *)currentPath parentPath:(SMJPathRef *)parent jsonObject:(id)jsonObject evaluationContext:(id <SMJEvaluationContext>)ctx parameters:(nullable NSArray <SMJParameter *> *)parameters error:(NSError **)error
 {
-	// Helper.
-	__block NSUInteger count = 0;
+	// Unbox the numbers in a contiguous buffer, so they can be aggregated by a tight loop.
+	SMJNumericBuffer buffer;
 	
-	void (^handleEntry)(id) = ^(id entry) {
-		
-		if ([entry isKindOfClass:[NSNumber class]] == NO)
-			return;
-		
-		[self handleNumber:entry];
-		count++;
-	};
+	SMJNumericBufferInit(&buffer);
 	
 	// Enumerate object.
-	if ([jsonObject isKindOfClass:[NSArray class]])
+	if ([jsonObject isKindOfClass:[NSArray class]] && SMJNumericBufferAppendNumbers(&buffer, jsonObject) == NO)
 	{
-		NSArray *array = jsonObject;
-		
-		[array enumerateObjectsUsingBlock:^(id  _Nonnull obj, NSUInteger idx, BOOL * _Nonnull stop) {
-			handleEntry(obj);
-		}];
+		SMJNumericBufferFree(&buffer);
+		SMSetError(error, 6, @"Aggregation function can't allocate memory for %lu values", (unsigned long)[jsonObject count]);
+		return nil;
 	}
-
+	
 	// Enumerate parameters.
-	NSArray *list = [SMJParameter listWithParameters:parameters itemsClass:[NSNumber class] error:error];
+	NSArray *list = [SMJParameter listWithParameters:parameters evaluationContext:ctx itemsClass:[NSNumber class] error:error];
 	
 	if (!list)
+	{
+		SMJNumericBufferFree(&buffer);
 		return nil;
+	}
 	
-	for (NSNumber *number in list)
-		handleEntry(number);
-
-	if (count != 0)
-		return self.result;
+	if (SMJNumericBufferAppendNumbers(&buffer, list) == NO)
+	{
+		SMJNumericBufferFree(&buffer);
+		SMSetError(error, 6, @"Aggregation function can't allocate memory for %lu values", (unsigned long)list.count);
+		return nil;
+	}
 	
-	// Fall back.
-	SMSetError(error, 2, @"Aggregation function attempted to calculate value using empty array");
-	return nil;
+	// Aggregate.
+	if (buffer.count == 0)
+	{
+		SMJNumericBufferFree(&buffer);
+		SMSetError(error, 2, @"Aggregation function attempted to calculate value using empty array");
+		return nil;
+	}
+	
+	SMJNumericAggregates aggregates = SMJNumericAggregate(buffer.values, buffer.count, [[self class] needsVariance]);
+	
+	SMJNumericBufferFree(&buffer);
+	
+	return [self resultWithAggregates:&aggregates];
 }
 
 @end
@@ -222,22 +311,12 @@ NS_ASSUME_NONNULL_BEGIN
 #pragma mark SMJAverageFunction
 
 @implementation SMJAverageFunction
-{
-	double _summation;
-	double _count;
-}
-
-- (void)handleNumber:(NSNumber *)value
-{
-	_count++;
-	_summation += value.doubleValue;
-}
 
-- (NSNumber *)result
+- (NSNumber *)resultWithAggregates:(const SMJNumericAggregates *)aggregates
 {
-	if (_count != 0.0)
-		return @(_summation / _count);
-
+	if (aggregates->count != 0)
+		return @(aggregates->sum / (double)aggregates->count);
+	
 	return @(0.0);
 }
 
@@ -247,22 +326,15 @@ NS_ASSUME_NONNULL_BEGIN
 #pragma mark SMJStandardDeviationFunction
 
 @implementation SMJStandardDeviationFunction
-{
-	double _sumSq;
-	double _sum;
-	double _count;
-}
 
-- (void)handleNumber:(NSNumber *)value
++ (BOOL)needsVariance
 {
-	_sum += value.doubleValue;
-	_sumSq += value.doubleValue * value.doubleValue;
-	_count++;
+	return YES;
 }
 
-- (NSNumber *)result
+- (NSNumber *)resultWithAggregates:(const SMJNumericAggregates *)aggregates
 {
-	 return @(sqrt((_sumSq / _count) - (_sum * _sum / _count / _count)));
+	return @(sqrt(aggregates->variance));
 }
 
 @end
@@ -271,18 +343,10 @@ NS_ASSUME_NONNULL_BEGIN
 #pragma mark SMJSumFunction
 
 @implementation SMJSumFunction
-{
-	double _summation;
-}
 
-- (void)handleNumber:(NSNumber *)value
+- (NSNumber *)resultWithAggregates:(const SMJNumericAggregates *)aggregates
 {
-	_summation += value.doubleValue;
-}
-
-- (NSNumber *)result
-{
-	return @(_summation);
+	return @(aggregates->sum);
 }
 
 @end
@@ -291,28 +355,10 @@ NS_ASSUME_NONNULL_BEGIN
 #pragma mark SMJMinFunction
 
 @implementation SMJMinFunction
-{
-	BOOL	_set;
-	double	_min;
-}
 
-- (void)handleNumber:(NSNumber *)value
+- (NSNumber *)resultWithAggregates:(const SMJNumericAggregates *)aggregates
 {
-	if (!_set)
-	{
-		_min = value.doubleValue;
-		_set = YES;
-	}
-	else
-	{
-		if (value.doubleValue < _min)
-			_min = value.doubleValue;
-	}
-}
-
-- (NSNumber *)result
-{
-	return @(_min);
+	return @(aggregates->min);
 }
 
 @end
@@ -321,28 +367,10 @@ NS_ASSUME_NONNULL_BEGIN
 #pragma mark SMJMaxFunction
 
 @implementation SMJMaxFunction
-{
-	BOOL	_set;
-	double	_max;
-}
 
-- (void)handleNumber:(NSNumber *)value
+- (NSNumber *)resultWithAggregates:(const SMJNumericAggregates *)aggregates
 {
-	if (!_set)
-	{
-		_max = value.doubleValue;
-		_set = YES;
-	}
-	else
-	{
-		if (value.doubleValue > _max)
-			_max = value.doubleValue;
-	}
-}
-
-- (NSNumber *)result
-{
-	return @(_max);
+	return @(aggregates->max);
 }
 
 @end
@@ -352,6 +380,11 @@ NS_ASSUME_NONNULL_BEGIN
 
 @implementation SMJConcatenateFunction
 
++ (BOOL)isShareable
+{
+	return YES;
+}
+
 - (nullable id)invokeWithCurrentPathString:(NSString *)currentPath parentPath:(SMJPathRef *)parent jsonObject:(id)jsonObject evaluationContext:(id <SMJEvaluationContext>)ctx parameters:(nullable NSArray <SMJParameter *> *)parameters error:(NSError **)error
 {
 	NSMutableString *result = [NSMutableString string];
@@ -376,7 +409,7 @@ NS_ASSUME_NONNULL_BEGIN
 	}
 	
 	// Enumerate parameters.
-	NSArray *list = [SMJParameter listWithParameters:parameters itemsClass:[NSString class] error:error];
+	NSArray *list = [SMJParameter listWithParameters:parameters evaluationContext:ctx itemsClass:[NSString class] error:error];
 	
 	if (!list)
 		return nil;
@@ -394,6 +427,11 @@ NS_ASSUME_NONNULL_BEGIN
 
 @implementation SMJLengthFunction
 
++ (BOOL)isShareable
+{
+	return YES;
+}
+
 - (nullable id)invokeWithCurrentPathString:(NSString *)currentPath parentPath:(SMJPathRef *)parent jsonObject:(id)jsonObject evaluationContext:(id <SMJEvaluationContext>)ctx parameters:(nullable NSArray <SMJParameter *> *)parameters error:(NSError **)error
 {	
 	if ([jsonObject isKindOfClass:[NSArray class]])
@@ -415,6 +453,11 @@ NS_ASSUME_NONNULL_BEGIN
 
 @implementation SMJAppendFunction
 
++ (BOOL)isShareable
+{
+	return YES;
+}
+
 - (nullable id)invokeWithCurrentPathString:(NSString *)currentPath parentPath:(SMJPathRef *)parent jsonObject:(id)jsonObject evaluationContext:(id <SMJEvaluationContext>)ctx parameters:(nullable NSArray <SMJParameter *> *)parameters error:(NSError **)error
 {
 	if ([jsonObject isKindOfClass:[NSArray class]] == NO)
@@ -424,7 +467,7 @@ NS_ASSUME_NONNULL_BEGIN
 	
 	for (SMJParameter *parameter in parameters)
 	{
-		id value = [parameter valueWithError:error];
+		id value = [parameter valueWithEvaluationContext:ctx error:error];
 
 		if (!value)
 			return nil;
@@ -0,0 +1,160 @@
+/*
+ * SMJBulkUpdateTest.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <XCTest/XCTest.h>
+
+#import "SMJCommonTest.h"
+
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** Defines
+*/
+#pragma mark - Defines
+
+#define SMJBulkItemCount 500000
+
+
+
+/*
+** SMJBulkUpdateTest
+*/
+#pragma mark - SMJBulkUpdateTest
+
+@interface SMJBulkUpdateTest : SMJCommonTest
+@end
+
+@implementation SMJBulkUpdateTest
+
+
+/*
+** SMJBulkUpdateTest - Tests
+*/
+#pragma mark - SMJBulkUpdateTest - Tests
+
+- (void)test_identical_items_are_addressed_by_index
+{
+	// Shared NSNull and tagged numbers are the same object at several indexes.
+	NSMutableArray	*array = [@[ @1, [NSNull null], @1, [NSNull null], @1 ] mutableCopy];
+	SMJJSONPath		*jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$[2:]" error:nil];
+	
+	XCTAssertNotNil([jsonPath updateMutableJSONObject:array setObject:@"x" configuration:nil error:nil]);
+	XCTAssertEqualObjects(array, (@[ @1, [NSNull null], @"x", @"x", @"x" ]));
+	
+	array = [@[ @1, [NSNull null], @1, [NSNull null], @1 ] mutableCopy];
+	jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$[3,4]" error:nil];
+	
+	XCTAssertNotNil([jsonPath updateMutableJSONObject:array deleteWithConfiguration:nil error:nil]);
+	XCTAssertEqualObjects(array, (@[ @1, [NSNull null], @1 ]));
+	
+	array = [@[ @1, @1, @1 ] mutableCopy];
+	jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$[-1]" error:nil];
+	
+	XCTAssertNotNil([jsonPath updateMutableJSONObject:array mapObjects:^id (id object, SMJConfiguration *configuration) { return @2; } configuration:nil error:nil]);
+	XCTAssertEqualObjects(array, (@[ @1, @1, @2 ]));
+}
+
+- (void)test_grouped_deletions
+{
+	NSMutableArray *items = [NSMutableArray array];
+	
+	for (NSUInteger i = 0; i < 20; i++)
+		[items addObject:[@{ @"id" : @(i), @"expired" : @(i % 3 == 0), @"tags" : [@[ @"a", @"b", @"a" ] mutableCopy] } mutableCopy]];
+	
+	NSMutableDictionary *json = [@{ @"items" : items } mutableCopy];
+	
+	// Several items of one array.
+	SMJJSONPath *jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.items[?(@.expired == true)]" error:nil];
+	
+	XCTAssertNotNil([jsonPath updateMutableJSONObject:json deleteWithConfiguration:nil error:nil]);
+	
+	[self checkResultForJSONObject:json jsonPathString:@"$.items[*].id" expectedResult:@[ @1, @2, @4, @5, @7, @8, @10, @11, @13, @14, @16, @17, @19 ]];
+	
+	// Several items of several arrays.
+	jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.items[*].tags[?(@ == 'a')]" error:nil];
+	
+	XCTAssertNotNil([jsonPath updateMutableJSONObject:json deleteWithConfiguration:nil error:nil]);
+	
+	[self checkResultForJSONObject:json jsonPathString:@"$.items[*].tags[*]" expectedResult:@[ @"b", @"b", @"b", @"b", @"b", @"b", @"b", @"b", @"b", @"b", @"b", @"b", @"b" ]];
+	
+	// The same index reached twice is removed once.
+	NSMutableArray *array = [@[ @0, @1, @2 ] mutableCopy];
+	
+	jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$[0,0,-3]" error:nil];
+	
+	XCTAssertNotNil([jsonPath updateMutableJSONObject:array deleteWithConfiguration:nil error:nil]);
+	XCTAssertEqualObjects(array, (@[ @1, @2 ]));
+}
+
+- (void)test_bulk_delete_performance
+{
+	SMJJSONPath *jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.items[?(@.expired)]" error:nil];
+	
+	[self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:NO forBlock:^{
+		NSMutableDictionary *json = [self bulkJSONObject];
+		
+		[self startMeasuring];
+		XCTAssertNotNil([jsonPath updateMutableJSONObject:json deleteWithConfiguration:nil error:nil]);
+		[self stopMeasuring];
+		
+		XCTAssertEqual([json[@"items"] count], SMJBulkItemCount / 2);
+	}];
+}
+
+- (void)test_bulk_set_performance
+{
+	SMJJSONPath *jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.items[?(@.expired)]" error:nil];
+	
+	[self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:NO forBlock:^{
+		NSMutableDictionary *json = [self bulkJSONObject];
+		
+		[self startMeasuring];
+		XCTAssertNotNil([jsonPath updateMutableJSONObject:json setObject:[NSNull null] configuration:nil error:nil]);
+		[self stopMeasuring];
+		
+		XCTAssertEqualObjects([json[@"items"] objectAtIndex:0], [NSNull null]);
+	}];
+}
+
+
+/*
+** SMJBulkUpdateTest - Helpers
+*/
+#pragma mark - SMJBulkUpdateTest - Helpers
+
+- (NSMutableDictionary *)bulkJSONObject
+{
+	NSMutableArray	*items = [[NSMutableArray alloc] initWithCapacity:SMJBulkItemCount];
+	NSDictionary	*expired = @{ @"expired" : @YES };
+	NSDictionary	*valid = @{ @"expired" : @NO };
+	
+	// Shared items: only indexes tell them apart.
+	for (NSUInteger i = 0; i < SMJBulkItemCount; i++)
+		[items addObject:(i % 2 == 0 ? expired : valid)];
+	
+	return [@{ @"items" : items } mutableCopy];
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
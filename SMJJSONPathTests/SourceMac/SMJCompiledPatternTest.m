@@ -0,0 +1,146 @@
+/*
+ * SMJCompiledPatternTest.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <XCTest/XCTest.h>
+
+#import "SMJCommonTest.h"
+
+#import "SMJCompiledPattern.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** SMJCompiledPatternTest
+*/
+#pragma mark - SMJCompiledPatternTest
+
+@interface SMJCompiledPatternTest : SMJCommonTest
+@end
+
+@implementation SMJCompiledPatternTest
+
+
+/*
+** SMJCompiledPatternTest - Tests
+*/
+#pragma mark - SMJCompiledPatternTest - Tests
+
+- (void)test_shared_patterns
+{
+	SMJCompiledPattern *pattern1 = [SMJCompiledPattern compiledPatternWithPattern:@"a+b" flags:@"" error:nil];
+	SMJCompiledPattern *pattern2 = [SMJCompiledPattern compiledPatternWithPattern:@"a+b" flags:@"" error:nil];
+	SMJCompiledPattern *pattern3 = [SMJCompiledPattern compiledPatternWithPattern:@"a+b" flags:@"i" error:nil];
+	
+	XCTAssertNotNil(pattern1);
+	XCTAssertEqual(pattern1, pattern2);
+	XCTAssertNotEqual(pattern1, pattern3);
+	
+	NSError *error = nil;
+	
+	XCTAssertNil([SMJCompiledPattern compiledPatternWithPattern:@"a(b" flags:@"" error:&error]);
+	XCTAssertNotNil(error);
+}
+
+- (void)test_required_literals
+{
+	[self checkPattern:@"abc" flags:@"" literal:@"abc" prefix:NO];
+	[self checkPattern:@"^abc.*" flags:@"" literal:@"abc" prefix:YES];
+	[self checkPattern:@"^abc" flags:@"m" literal:@"abc" prefix:NO];
+	[self checkPattern:@"^a?bcd" flags:@"" literal:@"bcd" prefix:NO];
+	[self checkPattern:@"ab+cd" flags:@"" literal:@"ab" prefix:NO];
+	[self checkPattern:@"x[0-9]+\\.json$" flags:@"" literal:@".json" prefix:NO];
+	[self checkPattern:@"(foo|bar)-baz" flags:@"" literal:@"-baz" prefix:NO];
+	[self checkPattern:@"\\d{3}-\\d{4}" flags:@"" literal:@"-" prefix:NO];
+	[self checkPattern:@"caf\\u00e9" flags:@"" literal:nil prefix:NO];
+	[self checkPattern:@"foo|bar" flags:@"" literal:nil prefix:NO];
+	[self checkPattern:@"abc" flags:@"i" literal:nil prefix:NO];
+	[self checkPattern:@"(?i)abc" flags:@"" literal:nil prefix:NO];
+	[self checkPattern:@"\\Qa.b\\E" flags:@"" literal:nil prefix:NO];
+	[self checkPattern:@".*" flags:@"" literal:nil prefix:NO];
+}
+
+- (void)test_prefilter_matches_regex
+{
+	NSArray *patterns = @[ @"abc", @"^abc", @"^ab?c", @"b+c$", @"(x|y)yz", @"[a-c]+\\.z", @"a\\.b", @"^é+t", @"😀b", @"^a{2}b", @"ab*c", @"\\bfoo\\b" ];
+	NSArray *strings = @[ @"", @"abc", @"xabc", @"ac", @"abbc", @"xyz", @"yyz", @"ab.z", @"a.b", @"aXb", @"éét", @"tét", @"😀b", @"x😀b", @"aab", @"ab", @"a foo b", @"foobar",
+						  [@"abc" stringByPaddingToLength:200 withString:@"-abc" startingAtIndex:0], @"éabc", @"AbC" ];
+	
+	for (NSString *patternString in patterns)
+	{
+		NSRegularExpression	*regex = [NSRegularExpression regularExpressionWithPattern:patternString options:0 error:nil];
+		SMJCompiledPattern	*pattern = [SMJCompiledPattern compiledPatternWithPattern:patternString flags:@"" error:nil];
+		
+		XCTAssertNotNil(pattern);
+		
+		for (NSString *string in strings)
+		{
+			NSMutableString	*mutableString = [string mutableCopy]; // Different storage than the constant strings.
+			BOOL			expected = ([regex numberOfMatchesInString:string options:0 range:NSMakeRange(0, string.length)] > 0);
+			
+			XCTAssertEqual([pattern matchesString:string], expected, @"pattern: %@, string: %@", patternString, string);
+			XCTAssertEqual([pattern matchesString:mutableString], expected, @"pattern: %@, string: %@", patternString, string);
+		}
+	}
+}
+
+- (void)test_filter_results
+{
+	NSDictionary *json = @{ @"files" : @[ @{ @"name" : @"a.json" }, @{ @"name" : @"b.JSON" }, @{ @"name" : @"json.txt" }, @{ @"name" : @3 } ] };
+	
+	[self checkResultForJSONObject:json jsonPathString:@"$.files[?(@.name =~ /.*\\.json$/)].name" expectedResult:@[ @"a.json" ]];
+	[self checkResultForJSONObject:json jsonPathString:@"$.files[?(@.name =~ /.*\\.json$/i)].name" expectedResult:@[ @"a.json", @"b.JSON" ]];
+	[self checkResultForJSONObject:json jsonPathString:@"$.files[?(@.name =~ /^json/)].name" expectedResult:@[ @"json.txt" ]];
+}
+
+- (void)test_regex_filter_performance
+{
+	NSMutableArray *logs = [NSMutableArray array];
+	
+	for (NSUInteger i = 0; i < 100000; i++)
+		[logs addObject:@{ @"message" : [NSString stringWithFormat:@"%@ request %lu served in %lu ms", (i % 100 == 0 ? @"ERROR" : @"INFO"), (unsigned long)i, (unsigned long)(i % 997)] }];
+	
+	NSDictionary	*json = @{ @"logs" : logs };
+	SMJJSONPath		*jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.logs[?(@.message =~ /^ERROR request [0-9]+/)].message" error:nil];
+	
+	[self measureBlock:^{
+		[jsonPath resultForJSONObject:json configuration:nil error:nil];
+	}];
+}
+
+
+/*
+** SMJCompiledPatternTest - Helpers
+*/
+#pragma mark - SMJCompiledPatternTest - Helpers
+
+- (void)checkPattern:(NSString *)patternString flags:(NSString *)flags literal:(nullable NSString *)literal prefix:(BOOL)prefix
+{
+	SMJCompiledPattern *pattern = [SMJCompiledPattern compiledPatternWithPattern:patternString flags:flags error:nil];
+	
+	XCTAssertNotNil(pattern, @"pattern: %@", patternString);
+	XCTAssertEqualObjects(pattern.requiredLiteral, literal, @"pattern: %@", patternString);
+	XCTAssertEqual(pattern.requiredLiteralIsPrefix, prefix, @"pattern: %@", patternString);
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
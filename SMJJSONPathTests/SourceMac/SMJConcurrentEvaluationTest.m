@@ -0,0 +1,174 @@
+/*
+ * SMJConcurrentEvaluationTest.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <XCTest/XCTest.h>
+
+#import "SMJCommonTest.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** Defines
+*/
+#pragma mark - Defines
+
+#define SMJQueueCount		8
+#define SMJDocumentCount	64
+#define SMJIterationCount	20
+
+
+
+/*
+** SMJConcurrentEvaluationTest
+*/
+#pragma mark - SMJConcurrentEvaluationTest
+
+@interface SMJConcurrentEvaluationTest : SMJCommonTest
+{
+	NSArray <NSDictionary *> *_documents;
+}
+
+@end
+
+@implementation SMJConcurrentEvaluationTest
+
+- (void)setUp
+{
+	[super setUp];
+	
+	// Each document gives different results for the same paths.
+	NSMutableArray *documents = [NSMutableArray array];
+	
+	for (NSUInteger i = 0; i < SMJDocumentCount; i++)
+	{
+		NSMutableArray *items = [NSMutableArray array];
+		
+		for (NSUInteger k = 0; k < 20; k++)
+			[items addObject:@{ @"price" : @(k), @"owner" : [NSString stringWithFormat:@"user-%lu", (unsigned long)i] }];
+		
+		[documents addObject:@{
+			@"values" : @[ @(i), @(i + 1), @(i + 2) ],
+			@"extra" : @(i * 10),
+			@"limit" : @(i % 20),
+			@"items" : items,
+		}];
+	}
+	
+	_documents = documents;
+}
+
+
+/*
+** SMJConcurrentEvaluationTest - Tests
+*/
+#pragma mark - SMJConcurrentEvaluationTest - Tests
+
+- (void)test_function_parameters_concurrent
+{
+	// Path parameters are evaluated against the root of each document: the value of one evaluation must not leak in another one.
+	[self checkConcurrentEvaluationOfPath:@"$.values.sum($.extra)" validator:^BOOL(NSUInteger documentIndex, id result) {
+		return [result isKindOfClass:[NSNumber class]] && [result doubleValue] == (double)(documentIndex * 13 + 3);
+	}];
+}
+
+- (void)test_root_filter_concurrent
+{
+	[self checkConcurrentEvaluationOfPath:@"$.items[?(@.price < $.limit)].price" validator:^BOOL(NSUInteger documentIndex, id result) {
+		return [result isKindOfClass:[NSArray class]] && [result count] == documentIndex % 20;
+	}];
+}
+
+- (void)test_scan_concurrent
+{
+	[self checkConcurrentEvaluationOfPath:@"$..owner" validator:^BOOL(NSUInteger documentIndex, id result) {
+		NSString *owner = [NSString stringWithFormat:@"user-%lu", (unsigned long)documentIndex];
+		
+		return [result isKindOfClass:[NSArray class]] && [result count] == 20 && [[NSSet setWithArray:result] isEqualToSet:[NSSet setWithObject:owner]];
+	}];
+}
+
+- (void)test_mixed_paths_concurrent
+{
+	[self checkConcurrentEvaluationOfPath:@"$.items[?(@.price >= $.limit && @.owner)].price" validator:^BOOL(NSUInteger documentIndex, id result) {
+		return [result isKindOfClass:[NSArray class]] && [result count] == 20 - (documentIndex % 20);
+	}];
+}
+
+
+/*
+** SMJConcurrentEvaluationTest - Helpers
+*/
+#pragma mark - SMJConcurrentEvaluationTest - Helpers
+
+- (void)checkConcurrentEvaluationOfPath:(NSString *)jsonPathString validator:(BOOL (^)(NSUInteger documentIndex, id result))validator
+{
+	NSError			*error = nil;
+	SMJJSONPath		*jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:jsonPathString error:&error];
+	
+	XCTAssertNotNil(jsonPath, @"error: %@", error);
+	
+	if (!jsonPath)
+		return;
+	
+	// Hammer the same instance from several queues, each one walking the documents in a different order.
+	dispatch_group_t		group = dispatch_group_create();
+	NSMutableArray			*failures = [NSMutableArray array];
+	NSArray					*documents = _documents;
+	
+	for (NSUInteger queueIndex = 0; queueIndex < SMJQueueCount; queueIndex++)
+	{
+		NSString			*label = [NSString stringWithFormat:@"com.smjjsonpath.test.concurrent-%lu", (unsigned long)queueIndex];
+		dispatch_queue_t	queue = dispatch_queue_create(label.UTF8String, DISPATCH_QUEUE_SERIAL);
+		
+		dispatch_group_async(group, queue, ^{
+			for (NSUInteger iteration = 0; iteration < SMJIterationCount; iteration++)
+			{
+				for (NSUInteger i = 0; i < SMJDocumentCount; i++)
+				{
+					NSUInteger	documentIndex = (i * (queueIndex + 1) + iteration) % SMJDocumentCount;
+					NSError		*lerror = nil;
+					id			result = [jsonPath resultForJSONObject:documents[documentIndex] configuration:nil error:&lerror];
+					
+					if (validator(documentIndex, result) == NO)
+					{
+						@synchronized (failures) {
+							[failures addObject:[NSString stringWithFormat:@"document %lu: %@ (error: %@)", (unsigned long)documentIndex, result, lerror]];
+						}
+					}
+				}
+			}
+		});
+	}
+	
+	dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+	
+	XCTAssertEqual(failures.count, 0, @"%@", [failures subarrayWithRange:NSMakeRange(0, MIN(failures.count, 10))]);
+	
+	// Sequential results still match.
+	[documents enumerateObjectsUsingBlock:^(NSDictionary * _Nonnull document, NSUInteger idx, BOOL * _Nonnull stop) {
+		XCTAssertTrue(validator(idx, [jsonPath resultForJSONObject:document configuration:nil error:nil]));
+	}];
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
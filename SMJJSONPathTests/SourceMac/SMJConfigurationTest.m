@@ -0,0 +1,190 @@
+/*
+ * SMJConfigurationTest.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <XCTest/XCTest.h>
+
+#import "SMJCommonTest.h"
+
+#import "SMJEvaluationContextImpl.h"
+#import "SMJPathCompiler.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** SMJConfigurationTest
+*/
+#pragma mark - SMJConfigurationTest
+
+@interface SMJConfigurationTest : SMJCommonTest
+{
+	NSArray *_documents;
+}
+
+@end
+
+@implementation SMJConfigurationTest
+
+- (void)setUp
+{
+	[super setUp];
+	
+	NSMutableArray *documents = [NSMutableArray array];
+	
+	for (NSUInteger i = 0; i < 10000; i++)
+		[documents addObject:@{ @"store" : @{ @"book" : @[ @{ @"title" : @"a", @"price" : @(i) }, @{ @"title" : @"b" } ] } }];
+	
+	_documents = documents;
+}
+
+
+/*
+** SMJConfigurationTest - Tests
+*/
+#pragma mark - SMJConfigurationTest - Tests
+
+- (void)test_options
+{
+	SMJConfiguration *configuration = [SMJConfiguration defaultConfiguration];
+	
+	XCTAssertEqual(configuration.optionMask, 0);
+	XCTAssertFalse([configuration containsOption:SMJOptionDefaultPathLeafToNull]);
+	
+	[configuration addOption:SMJOptionDefaultPathLeafToNull];
+	[configuration addOption:SMJOptionRequireProperties];
+	
+	XCTAssertTrue([configuration containsOption:SMJOptionDefaultPathLeafToNull]);
+	XCTAssertTrue([configuration containsOption:SMJOptionRequireProperties]);
+	XCTAssertFalse([configuration containsOption:SMJOptionAsPathList]);
+	XCTAssertEqual(configuration.optionMask, SMJOptionMaskMake(SMJOptionDefaultPathLeafToNull) | SMJOptionMaskMake(SMJOptionRequireProperties));
+	
+	[configuration removeOption:SMJOptionDefaultPathLeafToNull];
+	
+	XCTAssertFalse([configuration containsOption:SMJOptionDefaultPathLeafToNull]);
+	XCTAssertEqual(configuration.optionMask, SMJOptionMaskMake(SMJOptionRequireProperties));
+}
+
+- (void)test_copy_and_freeze
+{
+	SMJConfiguration *configuration = [SMJConfiguration configurationWithOption:SMJOptionAlwaysReturnList];
+	
+	configuration.parallelScanThreshold = 12;
+	
+	// Copies of mutable configurations are independent.
+	SMJConfiguration *copy = [configuration copy];
+	
+	XCTAssertNotEqual(copy, configuration);
+	XCTAssertFalse(copy.frozen);
+	
+	[copy addOption:SMJOptionAsPathList];
+	
+	XCTAssertFalse([configuration containsOption:SMJOptionAsPathList]);
+	
+	// Frozen configurations are shared.
+	SMJConfiguration *frozen = [configuration frozenCopy];
+	
+	XCTAssertTrue(frozen.frozen);
+	XCTAssertFalse(configuration.frozen);
+	XCTAssertEqual([frozen copy], frozen);
+	XCTAssertEqual([frozen frozenCopy], frozen);
+	XCTAssertEqual(frozen.optionMask, configuration.optionMask);
+	XCTAssertEqual(frozen.parallelScanThreshold, 12);
+	
+	XCTAssertThrows([frozen addOption:SMJOptionAsPathList]);
+	XCTAssertThrows(frozen.parallelConcurrency = 2);
+	
+	// Mutable copies of frozen configurations can be modified.
+	SMJConfiguration *mutableCopy = [frozen mutableCopy];
+	
+	XCTAssertFalse(mutableCopy.frozen);
+	
+	[mutableCopy addOption:SMJOptionAsPathList];
+	
+	XCTAssertTrue([mutableCopy containsOption:SMJOptionAsPathList]);
+	XCTAssertFalse([frozen containsOption:SMJOptionAsPathList]);
+	
+	// Shared default.
+	XCTAssertTrue([SMJConfiguration sharedDefaultConfiguration].frozen);
+	XCTAssertEqual([SMJConfiguration sharedDefaultConfiguration].optionMask, 0);
+	XCTAssertThrowsSpecificNamed([[[SMJConfiguration sharedDefaultConfiguration] copy] addOption:SMJOptionAsPathList], NSException, NSInternalInconsistencyException);
+	XCTAssertThrowsSpecificNamed([[[SMJConfiguration sharedDefaultConfiguration] copy] setParallelScanThreshold:1], NSException, NSInternalInconsistencyException);
+	XCTAssertEqual([SMJConfiguration sharedDefaultConfiguration].optionMask, 0);
+}
+
+- (void)test_context_snapshot
+{
+	SMJConfiguration			*configuration = [SMJConfiguration configurationWithOption:SMJOptionDefaultPathLeafToNull];
+	id <SMJPath>				path = [SMJPathCompiler compilePathString:@"$.a" error:nil];
+	SMJEvaluationContextImpl	*context = [[SMJEvaluationContextImpl alloc] initWithPath:path rootJsonObject:@{ } configuration:configuration forUpdate:NO];
+	
+	[configuration addOption:SMJOptionRequireProperties];
+	[configuration removeOption:SMJOptionDefaultPathLeafToNull];
+	
+	XCTAssertTrue([context containsOption:SMJOptionDefaultPathLeafToNull]);
+	XCTAssertFalse([context containsOption:SMJOptionRequireProperties]);
+	
+	SMJEvaluationContextImpl *worker = [[SMJEvaluationContextImpl alloc] initWithParentContext:context];
+	
+	XCTAssertEqual(worker.optionMask, context.optionMask);
+}
+
+- (void)test_shared_frozen_configuration
+{
+	SMJConfiguration *configuration = [SMJConfiguration configurationWithOption:SMJOptionDefaultPathLeafToNull];
+	
+	[configuration addOption:SMJOptionAlwaysReturnList];
+	[configuration freeze];
+	
+	SMJJSONPath *jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.store.book[*].price" error:nil];
+	NSArray *documents = _documents;
+	NSMutableArray *failures = [NSMutableArray array];
+	
+	dispatch_apply(documents.count, DISPATCH_APPLY_AUTO, ^(size_t idx) {
+		NSArray *result = [jsonPath resultForJSONObject:documents[idx] configuration:configuration error:nil];
+		
+		if ([result isEqual:@[ @(idx), [NSNull null] ]] == NO)
+		{
+			@synchronized (failures) {
+				[failures addObject:@(idx)];
+			}
+		}
+	});
+	
+	XCTAssertEqual(failures.count, 0);
+}
+
+- (void)test_options_performance
+{
+	SMJConfiguration *configuration = [SMJConfiguration configurationWithOption:SMJOptionDefaultPathLeafToNull];
+	
+	[configuration freeze];
+	
+	SMJJSONPath *jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.store.book[*]['title', 'isbn']" error:nil];
+	
+	[self measureBlock:^{
+		for (NSDictionary *document in self->_documents)
+			[jsonPath resultForJSONObject:document configuration:configuration error:nil];
+	}];
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,167 @@
+/*
+ * SMJCopyOnWriteUpdateTest.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <XCTest/XCTest.h>
+
+#import "SMJCommonTest.h"
+
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** SMJCopyOnWriteUpdateTest
+*/
+#pragma mark - SMJCopyOnWriteUpdateTest
+
+@interface SMJCopyOnWriteUpdateTest : SMJCommonTest
+{
+	NSDictionary *_document;
+}
+
+@end
+
+@implementation SMJCopyOnWriteUpdateTest
+
+- (void)setUp
+{
+	[super setUp];
+	
+	NSString *jsonString = @"{ \"store\" : { \"book\" : [ { \"title\" : \"a\", \"price\" : 8, \"tags\" : [ \"x\" ] }, { \"title\" : \"b\", \"price\" : 12, \"tags\" : [ ] }, { \"title\" : \"c\", \"price\" : 20, \"tags\" : [ \"y\", \"z\" ] } ], \"bicycle\" : { \"color\" : \"red\" } }, \"expensive\" : 10 }";
+	
+	// Immutable containers.
+	_document = [NSJSONSerialization JSONObjectWithData:[jsonString dataUsingEncoding:NSUTF8StringEncoding] options:0 error:nil];
+}
+
+
+/*
+** SMJCopyOnWriteUpdateTest - Tests
+*/
+#pragma mark - SMJCopyOnWriteUpdateTest - Tests
+
+- (void)test_set_shares_untouched_values
+{
+	NSDictionary	*original = [self deepCopy:_document];
+	SMJJSONPath		*jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.store.book[1].price" error:nil];
+	NSDictionary	*updated = [jsonPath updatedJSONObject:_document setObject:@15 configuration:nil error:nil];
+	
+	XCTAssertNotNil(updated);
+	XCTAssertEqualObjects(_document, original);
+	
+	[self checkResultForJSONObject:updated jsonPathString:@"$.store.book[*].price" expectedResult:@[ @8, @15, @20 ]];
+	
+	// Only the containers on the way to the price are copied.
+	XCTAssertNotEqual(updated, _document);
+	XCTAssertNotEqual(updated[@"store"], _document[@"store"]);
+	XCTAssertNotEqual(updated[@"store"][@"book"], _document[@"store"][@"book"]);
+	XCTAssertNotEqual(updated[@"store"][@"book"][1], _document[@"store"][@"book"][1]);
+	XCTAssertEqual(updated[@"store"][@"book"][0], _document[@"store"][@"book"][0]);
+	XCTAssertEqual(updated[@"store"][@"book"][2], _document[@"store"][@"book"][2]);
+	XCTAssertEqual(updated[@"store"][@"book"][1][@"tags"], _document[@"store"][@"book"][1][@"tags"]);
+	XCTAssertEqual(updated[@"store"][@"bicycle"], _document[@"store"][@"bicycle"]);
+}
+
+- (void)test_operations
+{
+	NSDictionary	*original = [self deepCopy:_document];
+	SMJJSONPath		*jsonPath;
+	id				updated;
+	
+	// Map.
+	jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.store.book[?(@.price > $.expensive)].price" error:nil];
+	updated = [jsonPath updatedJSONObject:_document mapObjects:^id (id object, SMJConfiguration *configuration) { return @([object integerValue] * 2); } configuration:nil error:nil];
+	
+	[self checkResultForJSONObject:updated jsonPathString:@"$.store.book[*].price" expectedResult:@[ @8, @24, @40 ]];
+	
+	// Delete.
+	jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.store.book[?(@.price > $.expensive)]" error:nil];
+	updated = [jsonPath updatedJSONObject:_document deleteWithConfiguration:nil error:nil];
+	
+	[self checkResultForJSONObject:updated jsonPathString:@"$.store.book[*].title" expectedResult:@[ @"a" ]];
+	
+	// Add.
+	jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.store.book[-1].tags" error:nil];
+	updated = [jsonPath updatedJSONObject:_document addObject:@"new" configuration:nil error:nil];
+	
+	[self checkResultForJSONObject:updated jsonPathString:@"$.store.book[2].tags" expectedResult:@[ @"y", @"z", @"new" ]];
+	
+	// Put.
+	jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.store.bicycle" error:nil];
+	updated = [jsonPath updatedJSONObject:_document putObject:@"big" key:@"size" configuration:nil error:nil];
+	
+	[self checkResultForJSONObject:updated jsonPathString:@"$.store.bicycle" expectedResult:@{ @"color" : @"red", @"size" : @"big" }];
+	
+	// Rename, on the root.
+	jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$" error:nil];
+	updated = [jsonPath updatedJSONObject:_document renameKey:@"expensive" toKey:@"limit" configuration:nil error:nil];
+	
+	[self checkResultForJSONObject:updated jsonPathString:@"$.limit" expectedResult:@10];
+	
+	// Deep scan.
+	jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$..tags[0]" error:nil];
+	updated = [jsonPath updatedJSONObject:_document setObject:@"first" configuration:nil error:nil];
+	
+	[self checkResultForJSONObject:updated jsonPathString:@"$..tags" expectedResult:@[ @[ @"first" ], @[ ], @[ @"first", @"z" ] ]];
+	
+	// The original never changes.
+	XCTAssertEqualObjects(_document, original);
+}
+
+- (void)test_function_paths_are_refused
+{
+	SMJJSONPath *jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.store.book.length()" error:nil];
+	NSError		*error = nil;
+	
+	XCTAssertNil([jsonPath updatedJSONObject:_document setObject:@1 configuration:nil error:&error]);
+	XCTAssertNotNil(error);
+}
+
+- (void)test_single_set_performance
+{
+	NSMutableArray *items = [NSMutableArray array];
+	
+	for (NSUInteger i = 0; i < 500000; i++)
+		[items addObject:@{ @"id" : @(i), @"name" : [NSString stringWithFormat:@"item %lu", (unsigned long)i], @"values" : @[ @1, @2, @3 ] }];
+	
+	NSDictionary	*document = @{ @"items" : [items copy], @"meta" : @{ @"version" : @1 } };
+	SMJJSONPath		*jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.meta.version" error:nil];
+	
+	[self measureBlock:^{
+		XCTAssertNotNil([jsonPath updatedJSONObject:document setObject:@2 configuration:nil error:nil]);
+	}];
+}
+
+
+/*
+** SMJCopyOnWriteUpdateTest - Helpers
+*/
+#pragma mark - SMJCopyOnWriteUpdateTest - Helpers
+
+- (id)deepCopy:(id)jsonObject
+{
+	NSData *data = [NSJSONSerialization dataWithJSONObject:jsonObject options:0 error:nil];
+	
+	return [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,178 @@
+/*
+ * SMJEvaluationProfileTest.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <XCTest/XCTest.h>
+
+#import "SMJCommonTest.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** SMJEvaluationProfileTest
+*/
+#pragma mark - SMJEvaluationProfileTest
+
+@interface SMJEvaluationProfileTest : SMJCommonTest
+{
+	NSDictionary *_document;
+}
+
+@end
+
+@implementation SMJEvaluationProfileTest
+
+- (void)setUp
+{
+	[super setUp];
+	
+	_document = @{
+		@"expensive" : @10,
+		@"store" : @{
+			@"book" : @[
+				@{ @"category" : @"reference", @"author" : @"Nigel Rees", @"title" : @"Sayings of the Century", @"price" : @8.95 },
+				@{ @"category" : @"fiction", @"author" : @"Evelyn Waugh", @"title" : @"Sword of Honour", @"price" : @12.99 },
+				@{ @"category" : @"fiction", @"author" : @"Herman Melville", @"title" : @"Moby Dick", @"price" : @8.99 },
+				@{ @"category" : @"fiction", @"author" : @"J. R. R. Tolkien", @"title" : @"The Lord of the Rings", @"price" : @22.99 },
+			],
+			@"bicycle" : @{ @"color" : @"red", @"price" : @19.95 },
+		},
+	};
+}
+
+
+/*
+** SMJEvaluationProfileTest - Tests
+*/
+#pragma mark - SMJEvaluationProfileTest - Tests
+
+- (void)test_profile_tokens
+{
+	SMJJSONPath				*jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.store.book[?(@.price < 10)].title" error:nil];
+	SMJEvaluationProfile	*profile = nil;
+	id						result = [jsonPath resultForJSONObject:_document configuration:nil profile:&profile error:nil];
+	
+	XCTAssertEqualObjects(result, (@[ @"Sayings of the Century", @"Moby Dick" ]));
+	XCTAssertNotNil(profile);
+	
+	NSArray <SMJTokenProfile *> *tokens = profile.tokens;
+	
+	XCTAssertEqual(tokens.count, 5);
+	XCTAssertEqualObjects([tokens valueForKey:@"kind"], (@[ @"root", @"property", @"property", @"predicate", @"property" ]));
+	XCTAssertEqualObjects([tokens valueForKey:@"visitCount"], (@[ @1, @1, @1, @1, @2 ]));
+	XCTAssertEqualObjects([tokens valueForKey:@"outputCount"], (@[ @1, @1, @1, @2, @2 ]));
+	
+	XCTAssertEqual(tokens[3].predicateApplyCount, 4);
+	XCTAssertEqual(tokens[3].predicateMatchCount, 2);
+	
+	for (SMJTokenProfile *token in tokens)
+		XCTAssertLessThanOrEqual(token.selfTime, token.totalTime);
+	
+	XCTAssertEqual(profile.resultCount, 2);
+	XCTAssertGreaterThan(profile.totalTime, 0);
+	XCTAssertGreaterThanOrEqual(profile.totalTime, tokens[0].totalTime);
+}
+
+- (void)test_profile_expressions
+{
+	SMJJSONPath				*jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.store.book[?(@.price < $.expensive && @.category == 'fiction')].author" error:nil];
+	SMJEvaluationProfile	*profile = nil;
+	id						result = [jsonPath resultForJSONObject:_document configuration:nil profile:&profile error:nil];
+	
+	XCTAssertEqualObjects(result, (@[ @"Herman Melville" ]));
+	
+	NSArray <SMJExpressionProfile *> *expressions = profile.expressions;
+	
+	// The second comparison is only applied when the first one matched.
+	XCTAssertEqual(expressions.count, 2);
+	XCTAssertEqual(expressions[0].applyCount, 4);
+	XCTAssertEqual(expressions[0].matchCount, 2);
+	XCTAssertEqual(expressions[1].applyCount, 2);
+	XCTAssertEqual(expressions[1].matchCount, 1);
+	
+	// $.expensive is evaluated once, then found in cache.
+	XCTAssertEqual(profile.cacheMissCount, 1);
+	XCTAssertEqual(profile.cacheHitCount, 3);
+}
+
+- (void)test_profile_scan
+{
+	SMJJSONPath				*jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$..price" error:nil];
+	SMJEvaluationProfile	*profile = nil;
+	NSArray					*result = [jsonPath resultForJSONObject:_document configuration:nil profile:&profile error:nil];
+	
+	XCTAssertEqual(result.count, 5);
+	XCTAssertEqual(profile.resultCount, 5);
+	
+	SMJTokenProfile *scan = profile.tokens[1];
+	
+	XCTAssertEqualObjects(scan.kind, @"scan");
+	XCTAssertGreaterThan(scan.visitCount, scan.outputCount);
+}
+
+- (void)test_profile_parallel_filter
+{
+	NSMutableArray *items = [NSMutableArray array];
+	
+	for (NSUInteger i = 0; i < 10000; i++)
+		[items addObject:@{ @"value" : @(i) }];
+	
+	SMJConfiguration *configuration = [SMJConfiguration defaultConfiguration];
+	
+	configuration.parallelFilterThreshold = 100;
+	
+	SMJJSONPath				*jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$[?(@.value < 2500 || @.value > 7500)].value" error:nil];
+	SMJEvaluationProfile	*profile = nil;
+	NSArray					*result = [jsonPath resultForJSONObject:items configuration:configuration profile:&profile error:nil];
+	
+	XCTAssertEqualObjects(result, [jsonPath resultForJSONObject:items configuration:nil error:nil]);
+	XCTAssertEqual(profile.tokens[1].predicateApplyCount, 10000);
+	XCTAssertEqual(profile.tokens[1].predicateMatchCount, result.count);
+	XCTAssertEqual(profile.resultCount, result.count);
+}
+
+- (void)test_profile_report
+{
+	SMJJSONPath				*jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.store.book[?(@.price < 10)].title" error:nil];
+	SMJEvaluationProfile	*profile = nil;
+	
+	[jsonPath resultForJSONObject:_document configuration:nil profile:&profile error:nil];
+	
+	XCTAssertTrue([profile.plan hasPrefix:@"$['store']['book'][?]['title']"]);
+	XCTAssertTrue([profile.stringValue containsString:profile.plan]);
+	XCTAssertTrue([profile.stringValue containsString:@"@['price'] < 10"]);
+}
+
+- (void)test_profile_on_error
+{
+	SMJJSONPath				*jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.store.missing" error:nil];
+	SMJEvaluationProfile	*profile = nil;
+	NSError					*error = nil;
+	
+	XCTAssertNil([jsonPath resultForJSONObject:_document configuration:nil profile:&profile error:&error]);
+	XCTAssertNotNil(error);
+	XCTAssertNotNil(profile);
+	XCTAssertEqual(profile.resultCount, 0);
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,158 @@
+/*
+ * SMJExistsProbeTest.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <XCTest/XCTest.h>
+
+#import "SMJCommonTest.h"
+
+#import "SMJCompiledPath.h"
+#import "SMJPathCompiler.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** SMJExistsProbeTest
+*/
+#pragma mark - SMJExistsProbeTest
+
+@interface SMJExistsProbeTest : SMJCommonTest
+{
+	NSDictionary *_library;
+}
+
+@end
+
+@implementation SMJExistsProbeTest
+
+- (void)setUp
+{
+	[super setUp];
+	
+	NSMutableArray *books = [NSMutableArray array];
+	
+	for (NSUInteger i = 0; i < 100000; i++)
+	{
+		NSMutableDictionary *book = [NSMutableDictionary dictionary];
+		
+		book[@"title"] = [NSString stringWithFormat:@"Book %lu", (unsigned long)i];
+		
+		if (i % 4 == 0)
+			book[@"isbn"] = [NSString stringWithFormat:@"0-%05lu", (unsigned long)i];
+		
+		if (i % 5 == 0)
+			book[@"meta"] = @{ @"tags" : @[ @"a", @"b" ] };
+		
+		[books addObject:book];
+	}
+	
+	_library = @{ @"books" : books };
+}
+
+
+/*
+** SMJExistsProbeTest - Tests
+*/
+#pragma mark - SMJExistsProbeTest - Tests
+
+- (void)test_probe_matches_evaluation
+{
+	NSArray *paths = @[ @"@", @"@.a", @"@.a.b", @"@['a']['b']", @"@.a[0]", @"@.a[-1]", @"@.a[5]", @"@.a[0].b", @"@.n", @"@.a[*]", @"@.a[0,1]", @"@..b", @"@.a.length()" ];
+	NSArray *objects = @[
+		@{ },
+		@{ @"a" : @1 },
+		@{ @"a" : [NSNull null], @"n" : [NSNull null] },
+		@{ @"a" : @{ @"b" : @2 } },
+		@{ @"a" : @{ @"c" : @2 } },
+		@{ @"a" : @[ ] },
+		@{ @"a" : @[ @{ @"b" : @3 }, @4 ] },
+		@{ @"a" : @"string" },
+		@[ @1, @2 ],
+	];
+	
+	SMJConfiguration *configuration = [SMJConfiguration defaultConfiguration];
+	SMJConfiguration *leafToNull = [SMJConfiguration configurationWithOption:SMJOptionDefaultPathLeafToNull];
+	
+	for (NSString *pathString in paths)
+	{
+		SMJCompiledPath *path = (SMJCompiledPath *)[SMJPathCompiler compilePathString:pathString error:nil];
+		
+		XCTAssertNotNil(path, @"%@", pathString);
+		
+		for (id object in objects)
+		{
+			for (SMJConfiguration *conf in @[ configuration, leafToNull ])
+			{
+				XCTAssertEqual([path probeJsonObject:object rootJsonObject:object configuration:conf], [self evaluatePath:path jsonObject:object configuration:conf], @"%@ - %@", pathString, object);
+			}
+		}
+	}
+}
+
+- (void)test_exists_filter_results
+{
+	NSDictionary *json = @{ @"items" : @[ @{ @"id" : @0, @"isbn" : @"x" }, @{ @"id" : @1 }, @{ @"id" : @2, @"isbn" : [NSNull null] }, @{ @"id" : @3, @"meta" : @{ @"tags" : @[ @"t" ] } } ] };
+	
+	[self checkResultForJSONObject:json jsonPathString:@"$.items[?(@.isbn)].id" expectedResult:@[ @0, @2 ]];
+	[self checkResultForJSONObject:json jsonPathString:@"$.items[?(!@.isbn)].id" expectedResult:@[ @1, @3 ]];
+	[self checkResultForJSONObject:json jsonPathString:@"$.items[?(@.meta.tags[0])].id" expectedResult:@[ @3 ]];
+	[self checkResultForJSONObject:json jsonPathString:@"$.items[?(@.meta.tags[*])].id" expectedResult:@[ @3 ]];
+}
+
+- (void)test_exists_filter_performance
+{
+	SMJJSONPath *jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.books[?(@.isbn)].title" error:nil];
+	
+	[self measureBlock:^{
+		[jsonPath resultForJSONObject:self->_library configuration:nil error:nil];
+	}];
+}
+
+- (void)test_nested_exists_filter_performance
+{
+	SMJJSONPath *jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.books[?(@.meta.tags[1] && !@.isbn)].title" error:nil];
+	
+	[self measureBlock:^{
+		[jsonPath resultForJSONObject:self->_library configuration:nil error:nil];
+	}];
+}
+
+
+/*
+** SMJExistsProbeTest - Helpers
+*/
+#pragma mark - SMJExistsProbeTest - Helpers
+
+- (BOOL)evaluatePath:(SMJCompiledPath *)path jsonObject:(id)jsonObject configuration:(SMJConfiguration *)configuration
+{
+	// What exists checks did before probes.
+	SMJConfiguration *probeConfiguration = [configuration mutableCopy];
+	
+	[probeConfiguration addOption:SMJOptionRequireProperties];
+	
+	id <SMJEvaluationContext> evaluationContext = [path evaluateJsonObject:jsonObject rootJsonObject:jsonObject configuration:probeConfiguration error:nil];
+	
+	return (evaluationContext && [evaluationContext jsonObjectWithError:nil] != nil);
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
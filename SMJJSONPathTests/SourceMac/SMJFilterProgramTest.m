@@ -0,0 +1,318 @@
+/*
+ * SMJFilterProgramTest.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <XCTest/XCTest.h>
+
+#import "SMJCommonTest.h"
+
+#import "SMJFilterProgram.h"
+#import "SMJLogicalExpressionNode.h"
+#import "SMJRelationalExpressionNode.h"
+#import "SMJPredicateContextImpl.h"
+#import "SMJEvaluationCache.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** SMJCountingExpressionNode
+*/
+#pragma mark - SMJCountingExpressionNode
+
+@interface SMJCountingExpressionNode : SMJExpressionNode
+{
+	SMJPredicateApply _result;
+}
+
+@property (readonly) NSUInteger applyCount;
+
+@end
+
+@implementation SMJCountingExpressionNode
+
++ (instancetype)nodeWithResult:(SMJPredicateApply)result
+{
+	SMJCountingExpressionNode *node = [[SMJCountingExpressionNode alloc] init];
+	
+	node->_result = result;
+	
+	return node;
+}
+
+- (SMJPredicateApply)applyWithContext:(id <SMJPredicateContext>)context error:(NSError **)error
+{
+	_applyCount++;
+	return _result;
+}
+
+- (NSString *)stringValue
+{
+	return @"counting";
+}
+
+@end
+
+
+
+/*
+** SMJFilterProgramTest
+*/
+#pragma mark - SMJFilterProgramTest
+
+@interface SMJFilterProgramTest : SMJCommonTest
+{
+	NSArray *_orders;
+}
+
+@end
+
+@implementation SMJFilterProgramTest
+
+- (void)setUp
+{
+	[super setUp];
+	
+	NSMutableArray *orders = [NSMutableArray array];
+	
+	for (NSUInteger i = 0; i < 100000; i++)
+	{
+		[orders addObject:@{
+			@"id" : @(i),
+			@"total" : @((i * 7919) % 500),
+			@"status" : (i % 3 == 0 ? @"open" : @"closed"),
+			@"vip" : @(i % 11 == 0 ? YES : NO),
+		}];
+	}
+	
+	_orders = orders;
+}
+
+
+/*
+** SMJFilterProgramTest - Tests
+*/
+#pragma mark - SMJFilterProgramTest - Tests
+
+- (void)test_program_matches_expression_tree
+{
+	SMJExpressionNode *totalGT = [self relationWithLeft:@"@.total" operator:@">" right:@"100"];
+	SMJExpressionNode *totalLTE = [self relationWithLeft:@"@.total" operator:@"<=" right:@"400"];
+	SMJExpressionNode *open = [self relationWithLeft:@"@.status" operator:@"==" right:@"'open'"];
+	SMJExpressionNode *vip = [self relationWithLeft:@"@.vip" operator:@"==" right:@"true"];
+	SMJExpressionNode *exists = [self relationWithLeft:@"@.status" operator:@"EXISTS" right:@"true"];
+	
+	NSArray <SMJExpressionNode *> *trees = @[
+		[SMJLogicalExpressionNode logicalAndWithExpressionNodes:@[ totalGT, totalLTE, open ]],
+		[SMJLogicalExpressionNode logicalOrWithExpressionNodes:@[ open, vip, totalGT ]],
+		[SMJLogicalExpressionNode logicalNotWithExpressionNode:[SMJLogicalExpressionNode logicalAndWithLeftExpressionNode:open rightExpressionNode:vip]],
+		[SMJLogicalExpressionNode logicalOrWithLeftExpressionNode:[SMJLogicalExpressionNode logicalAndWithLeftExpressionNode:totalGT rightExpressionNode:open]
+											  rightExpressionNode:[SMJLogicalExpressionNode logicalNotWithExpressionNode:[SMJLogicalExpressionNode logicalOrWithLeftExpressionNode:vip rightExpressionNode:totalLTE]]],
+		[SMJLogicalExpressionNode logicalAndWithLeftExpressionNode:exists rightExpressionNode:vip],
+	];
+	
+	SMJConfiguration	*configuration = [SMJConfiguration defaultConfiguration];
+	SMJEvaluationCache	*cache = [[SMJEvaluationCache alloc] init];
+	NSArray				*orders = [_orders subarrayWithRange:NSMakeRange(0, 2000)];
+	
+	for (SMJExpressionNode *tree in trees)
+	{
+		SMJFilterProgram *program = [[SMJFilterProgram alloc] initWithPredicate:tree];
+		
+		for (id order in orders)
+		{
+			SMJPredicateContextImpl *context = [[SMJPredicateContextImpl alloc] initWithJsonObject:order rootJsonObject:orders configuration:configuration pathCache:cache];
+			
+			SMJPredicateApply expected = [tree applyWithContext:context error:nil];
+			SMJPredicateApply result = [program applyWithContext:context error:nil];
+			
+			XCTAssertEqual(result, expected, @"%@ - %@", [tree stringValue], order);
+		}
+		
+		XCTAssertEqualObjects([program stringValue], [tree stringValue]);
+	}
+}
+
+- (void)test_program_layout
+{
+	SMJExpressionNode *a = [self relationWithLeft:@"@.a" operator:@"==" right:@"1"];
+	SMJExpressionNode *b = [self relationWithLeft:@"@.b" operator:@"==" right:@"2"];
+	SMJExpressionNode *c = [self relationWithLeft:@"@.c" operator:@"==" right:@"3"];
+	
+	// a, jump, b, jump, c.
+	XCTAssertEqual([[SMJFilterProgram alloc] initWithPredicate:[SMJLogicalExpressionNode logicalOrWithExpressionNodes:@[ a, b, c ]]].instructionCount, 5);
+	
+	// a, jump, b, not.
+	XCTAssertEqual([[SMJFilterProgram alloc] initWithPredicate:[SMJLogicalExpressionNode logicalNotWithExpressionNode:[SMJLogicalExpressionNode logicalAndWithLeftExpressionNode:a rightExpressionNode:b]]].instructionCount, 4);
+}
+
+- (void)test_program_short_circuit
+{
+	SMJConfiguration			*configuration = [SMJConfiguration defaultConfiguration];
+	SMJPredicateContextImpl		*context = [[SMJPredicateContextImpl alloc] initWithJsonObject:@{ } rootJsonObject:@{ } configuration:configuration pathCache:[[SMJEvaluationCache alloc] init]];
+	
+	// OR stops on the first true.
+	SMJCountingExpressionNode	*orFirst = [SMJCountingExpressionNode nodeWithResult:SMJPredicateApplyTrue];
+	SMJCountingExpressionNode	*orSecond = [SMJCountingExpressionNode nodeWithResult:SMJPredicateApplyFalse];
+	SMJFilterProgram			*orProgram = [[SMJFilterProgram alloc] initWithPredicate:[SMJLogicalExpressionNode logicalOrWithLeftExpressionNode:orFirst rightExpressionNode:orSecond]];
+	
+	XCTAssertEqual([orProgram applyWithContext:context error:nil], SMJPredicateApplyTrue);
+	XCTAssertEqual(orFirst.applyCount, 1);
+	XCTAssertEqual(orSecond.applyCount, 0);
+	
+	// AND stops on the first false.
+	SMJCountingExpressionNode	*andFirst = [SMJCountingExpressionNode nodeWithResult:SMJPredicateApplyFalse];
+	SMJCountingExpressionNode	*andSecond = [SMJCountingExpressionNode nodeWithResult:SMJPredicateApplyTrue];
+	SMJFilterProgram			*andProgram = [[SMJFilterProgram alloc] initWithPredicate:[SMJLogicalExpressionNode logicalAndWithLeftExpressionNode:andFirst rightExpressionNode:andSecond]];
+	
+	XCTAssertEqual([andProgram applyWithContext:context error:nil], SMJPredicateApplyFalse);
+	XCTAssertEqual(andFirst.applyCount, 1);
+	XCTAssertEqual(andSecond.applyCount, 0);
+	
+	// Errors stop the program.
+	SMJCountingExpressionNode	*errorFirst = [SMJCountingExpressionNode nodeWithResult:SMJPredicateApplyError];
+	SMJCountingExpressionNode	*errorSecond = [SMJCountingExpressionNode nodeWithResult:SMJPredicateApplyTrue];
+	SMJFilterProgram			*errorProgram = [[SMJFilterProgram alloc] initWithPredicate:[SMJLogicalExpressionNode logicalOrWithLeftExpressionNode:errorFirst rightExpressionNode:errorSecond]];
+	
+	XCTAssertEqual([errorProgram applyWithContext:context error:nil], SMJPredicateApplyError);
+	XCTAssertEqual(errorSecond.applyCount, 0);
+}
+
+- (void)test_compiled_filter_results
+{
+	NSDictionary *shop = @{ @"orders" : [_orders subarrayWithRange:NSMakeRange(0, 30)] };
+	
+	[self checkResultForJSONObject:shop jsonPathString:@"$.orders[?(@.total > 100 && @.status == 'open' || @.vip == true)].id" expectedResult:@[ @0, @3, @9, @11, @15, @21, @22, @27 ]];
+	[self checkResultForJSONObject:shop jsonPathString:@"$.orders[?(!(@.status == 'closed') && @.total <= 100)].id" expectedResult:@[ @0, @6, @12, @18, @24 ]];
+}
+
+- (void)test_scalar_comparisons_match_generic_comparisons
+{
+	NSArray *values = @[ @5, @5.0, @5.5, @-3, @0, @YES, @NO, @(ULLONG_MAX), @9007199254740993LL, @9007199254740992.0, @"5", @"abc", @"Abd", @"", [NSNull null], @[ @1 ], @{ } ];
+	NSArray *literals = @[ @"5", @"5.5", @"-3", @"0", @"1", @"9007199254740993", @"9007199254740992.0", @"'abc'", @"'5'", @"true", @"false" ];
+	NSArray *operators = @[ @"==", @"!=", @"<", @"<=", @">", @">=" ];
+	
+	SMJConfiguration	*configuration = [SMJConfiguration defaultConfiguration];
+	SMJEvaluationCache	*cache = [[SMJEvaluationCache alloc] init];
+	
+	for (NSString *literal in literals)
+	{
+		for (NSString *operator in operators)
+		{
+			SMJRelationalOperator	*op = [SMJRelationalOperator relationalOperatorFromString:operator error:nil];
+			SMJValueNode			*path = [SMJValueNodes pathNodeWithPathString:@"@.v" existsCheck:NO shouldExists:NO error:nil];
+			
+			NSArray <SMJExpressionNode *> *trees = @[
+				[SMJRelationalExpressionNode relationExpressionNodeWithLeftValue:path operator:op rightValue:[self literalNodeWithString:literal]],
+				[SMJRelationalExpressionNode relationExpressionNodeWithLeftValue:[self literalNodeWithString:literal] operator:op rightValue:path],
+			];
+			
+			for (SMJExpressionNode *tree in trees)
+			{
+				SMJFilterProgram *program = [[SMJFilterProgram alloc] initWithPredicate:tree];
+				
+				for (id value in values)
+				{
+					NSDictionary			*item = @{ @"v" : value };
+					SMJPredicateContextImpl	*context = [[SMJPredicateContextImpl alloc] initWithJsonObject:item rootJsonObject:item configuration:configuration pathCache:cache];
+					
+					SMJPredicateApply expected = [tree applyWithContext:context error:nil];
+					SMJPredicateApply result = [program applyWithContext:context error:nil];
+					
+					XCTAssertEqual(result, expected, @"%@ - %@", [tree stringValue], value);
+				}
+			}
+		}
+	}
+}
+
+- (void)test_root_invariant_comparisons
+{
+	// Identical paths are compiled once, so their values are cached by identity.
+	SMJPathNode *limit1 = [SMJValueNodes pathNodeWithPathString:@"$.limit" existsCheck:NO shouldExists:NO error:nil];
+	SMJPathNode *limit2 = [SMJValueNodes pathNodeWithPathString:@"$.limit" existsCheck:NO shouldExists:NO error:nil];
+	
+	XCTAssertEqual([limit1 underlayingObjectWithError:nil], [limit2 underlayingObjectWithError:nil]);
+	
+	// The same compiled path, on documents with different roots.
+	SMJJSONPath *jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.orders[?($.enabled == true && @.total > $.limit)].id" error:nil];
+	NSArray		*orders = [_orders subarrayWithRange:NSMakeRange(0, 30)];
+	
+	XCTAssertEqualObjects([jsonPath resultForJSONObject:@{ @"enabled" : @YES, @"limit" : @450, @"orders" : orders } configuration:nil error:nil], (@[ @19, @25 ]));
+	XCTAssertEqualObjects([jsonPath resultForJSONObject:@{ @"enabled" : @NO, @"limit" : @450, @"orders" : orders } configuration:nil error:nil], @[ ]);
+	
+	// The root-invariant comparison is evaluated for the first item only: $.enabled is never looked up again.
+	SMJEvaluationProfile *profile = nil;
+	
+	[[[SMJJSONPath alloc] initWithJSONPathString:@"$.orders[?($.enabled == true)].id" error:nil] resultForJSONObject:@{ @"enabled" : @YES, @"orders" : orders } configuration:nil profile:&profile error:nil];
+	
+	XCTAssertEqual(profile.cacheMissCount, 1);
+	XCTAssertEqual(profile.cacheHitCount, 0);
+	XCTAssertEqual(profile.expressions[0].applyCount, orders.count);
+}
+
+- (void)test_root_invariant_performance
+{
+	SMJJSONPath		*jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.orders[?($.enabled == true && $.limit > 100 && @.total > $.limit)].id" error:nil];
+	NSDictionary	*shop = @{ @"enabled" : @YES, @"limit" : @250, @"orders" : _orders };
+	
+	[self measureBlock:^{
+		[jsonPath resultForJSONObject:shop configuration:nil error:nil];
+	}];
+}
+
+- (void)test_compiled_filter_performance
+{
+	SMJJSONPath		*jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$[?(@.total > 100 && @.status == 'open' || !(@.vip == true))].id" error:nil];
+	NSArray			*orders = _orders;
+	
+	[self measureBlock:^{
+		[jsonPath resultForJSONObject:orders configuration:nil error:nil];
+	}];
+}
+
+
+/*
+** SMJFilterProgramTest - Helpers
+*/
+#pragma mark - SMJFilterProgramTest - Helpers
+
+- (SMJExpressionNode *)relationWithLeft:(NSString *)left operator:(NSString *)operator right:(NSString *)right
+{
+	SMJValueNode			*leftNode = [SMJValueNodes pathNodeWithPathString:left existsCheck:NO shouldExists:NO error:nil];
+	SMJValueNode			*rightNode = [self literalNodeWithString:right];
+	SMJRelationalOperator	*op = [SMJRelationalOperator relationalOperatorFromString:operator error:nil];
+	
+	return [SMJRelationalExpressionNode relationExpressionNodeWithLeftValue:leftNode operator:op rightValue:rightNode];
+}
+
+- (SMJValueNode *)literalNodeWithString:(NSString *)literal
+{
+	if ([literal hasPrefix:@"'"])
+		return [SMJValueNodes stringNodeWithString:[literal substringWithRange:NSMakeRange(1, literal.length - 2)] escape:NO];
+	else if ([literal isEqualToString:@"true"] || [literal isEqualToString:@"false"])
+		return [SMJValueNodes booleanNodeWithString:literal];
+	else
+		return [SMJValueNodes numberNodeWithString:literal];
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
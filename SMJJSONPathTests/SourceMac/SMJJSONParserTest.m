@@ -0,0 +1,303 @@
+/*
+ * SMJJSONParserTest.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <XCTest/XCTest.h>
+
+#import "SMJCommonTest.h"
+
+#import "SMJJSONParser.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** SMJJSONParserTest
+*/
+#pragma mark - SMJJSONParserTest
+
+@interface SMJJSONParserTest : SMJCommonTest
+{
+	NSArray<NSData *>	*_documentsData;
+	NSData				*_eventsData;
+	NSArray<NSNumber *>	*_kernels;
+}
+
+@end
+
+@implementation SMJJSONParserTest
+
+- (void)setUp
+{
+	[super setUp];
+	
+	NSBundle *bundle = [NSBundle bundleForClass:self.class];
+	
+	_documentsData = @[
+		[NSData dataWithContentsOfFile:[bundle pathForResource:@"issue_191" ofType:@"json"]],
+		[NSData dataWithContentsOfFile:[bundle pathForResource:@"issue_24" ofType:@"json"]],
+	];
+	
+	// Build a log export like document.
+	NSMutableArray *events = [NSMutableArray array];
+	
+	for (NSUInteger i = 0; i < 20000; i++)
+	{
+		[events addObject:@{
+			@"id" : @(i),
+			@"level" : (i % 10 == 0 ? @"error" : @"info"),
+			@"message" : [NSString stringWithFormat:@"event \"%lu\" \\ \u00e9\u6f22 %@", (unsigned long)i, [@"" stringByPaddingToLength:(i % 100) withString:@"x" startingAtIndex:0]],
+			@"payload" : @{ @"values" : @[ @1, @2.5, @-3e10, @YES, [NSNull null] ], @"nested" : @{ @"deep" : @[ @{ @"key" : @"value" } ] } },
+		}];
+	}
+	
+	_eventsData = [NSJSONSerialization dataWithJSONObject:@{ @"count" : @(events.count), @"events" : events } options:NSJSONWritingPrettyPrinted error:nil];
+	
+	// Available kernels.
+	NSMutableArray *kernels = [NSMutableArray array];
+	
+	for (NSNumber *kernel in @[ @(SMJJSONParserKernelScalar), @(SMJJSONParserKernelSSE2), @(SMJJSONParserKernelAVX2), @(SMJJSONParserKernelNEON) ])
+	{
+		if ([SMJJSONParser isKernelAvailable:(SMJJSONParserKernel)kernel.intValue])
+			[kernels addObject:kernel];
+	}
+	
+	_kernels = kernels;
+}
+
+
+/*
+** SMJJSONParserTest - Tests
+*/
+#pragma mark - SMJJSONParserTest - Tests
+
+- (void)test_matches_foundation
+{
+	NSMutableArray *documentsData = [_documentsData mutableCopy];
+	
+	[documentsData addObject:_eventsData];
+	
+	for (NSData *data in documentsData)
+	{
+		id expected = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+		
+		XCTAssertNotNil(expected);
+		
+		for (NSNumber *kernel in _kernels)
+		{
+			NSError	*error = nil;
+			id		result = [self parseData:data kernel:(SMJJSONParserKernel)kernel.intValue error:&error];
+			
+			XCTAssertNil(error, @"unexpected error with kernel %@", kernel);
+			XCTAssertEqualObjects(result, expected, @"unexpected result with kernel %@", kernel);
+		}
+	}
+}
+
+- (void)test_scalars
+{
+	NSString *jsonString = @"{ \"s\" : \"a\\\"b\\\\c\\/d\\b\\f\\n\\r\\t\\u00e9\\u6f22\\ud83d\\ude00\", \"i\" : -42, \"long\" : 123456789012345678, \"big\" : 123456789012345678901234567890, \"d\" : 1.5e-3, \"z\" : -0, \"t\" : true, \"f\" : false, \"n\" : null, \"e\" : [], \"o\" : {} }";
+	NSData *data = [jsonString dataUsingEncoding:NSUTF8StringEncoding];
+	
+	id expected = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+	
+	// Start with a byte order mark.
+	NSMutableData *bomData = [NSMutableData dataWithBytes:"\xEF\xBB\xBF" length:3];
+	
+	[bomData appendData:data];
+	
+	for (NSNumber *kernel in _kernels)
+	{
+		id result = [self parseData:bomData kernel:(SMJJSONParserKernel)kernel.intValue error:nil];
+		
+		XCTAssertEqualObjects(result[@"s"], expected[@"s"]);
+		XCTAssertEqualObjects(result[@"i"], @-42);
+		XCTAssertEqualObjects(result[@"long"], @123456789012345678LL);
+		XCTAssertEqualWithAccuracy([result[@"big"] doubleValue], 1.2345678901234568e29, 1e15);
+		XCTAssertEqualWithAccuracy([result[@"d"] doubleValue], 0.0015, 1e-12);
+		XCTAssertEqualObjects(result[@"t"], @YES);
+		XCTAssertEqualObjects(result[@"f"], @NO);
+		XCTAssertEqualObjects(result[@"n"], [NSNull null]);
+		XCTAssertEqualObjects(result[@"e"], @[]);
+		XCTAssertEqualObjects(result[@"o"], @{});
+		
+		// Fragments.
+		XCTAssertEqualObjects([self parseData:[@" \"fragment\" " dataUsingEncoding:NSUTF8StringEncoding] kernel:(SMJJSONParserKernel)kernel.intValue error:nil], @"fragment");
+		XCTAssertEqualObjects([self parseData:[@"42" dataUsingEncoding:NSUTF8StringEncoding] kernel:(SMJJSONParserKernel)kernel.intValue error:nil], @42);
+		XCTAssertEqualObjects([self parseData:[@"null" dataUsingEncoding:NSUTF8StringEncoding] kernel:(SMJJSONParserKernel)kernel.intValue error:nil], [NSNull null]);
+	}
+}
+
+- (void)test_block_boundaries
+{
+	// Move escapes, quotes and scalars across the 64 bytes blocks of the structural index.
+	for (NSUInteger padding = 0; padding < 130; padding++)
+	{
+		NSString	*pad = [@"" stringByPaddingToLength:padding withString:@" " startingAtIndex:0];
+		NSString	*jsonString = [NSString stringWithFormat:@"[%@\"a\\\\\", \"b\\\\\\\"c\", \"\\\\\\\\\", %@ 12.5e3,%@true, {\"k\\\"\":\"%@\\\"\"}]", pad, pad, pad, pad];
+		NSData		*data = [jsonString dataUsingEncoding:NSUTF8StringEncoding];
+		id			expected = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+		
+		XCTAssertNotNil(expected);
+		
+		for (NSNumber *kernel in _kernels)
+			XCTAssertEqualObjects([self parseData:data kernel:(SMJJSONParserKernel)kernel.intValue error:nil], expected, @"unexpected result with padding %lu and kernel %@", (unsigned long)padding, kernel);
+	}
+}
+
+- (void)test_invalid_documents
+{
+	NSArray *jsonStrings = @[
+		@"",
+		@"   ",
+		@"{",
+		@"}",
+		@"{ \"a\" : 1, }",
+		@"{ \"a\" 1 }",
+		@"{ 1 : 1 }",
+		@"[1, 2",
+		@"[1 2]",
+		@"[01]",
+		@"[1.]",
+		@"[-]",
+		@"[1e]",
+		@"[tru]",
+		@"[truex]",
+		@"[nul",
+		@"[\"\\x\"]",
+		@"[\"\\u12\"]",
+		@"[\"\\ud83d\"]",
+		@"[\"\\ude00\"]",
+		@"[\"a\tb\"]",
+		@"[\"unterminated]",
+		@"{ \"a\" : 1 } garbage",
+		@"1 2",
+		[[@"" stringByPaddingToLength:1000 withString:@"[" startingAtIndex:0] stringByAppendingString:[@"" stringByPaddingToLength:1000 withString:@"]" startingAtIndex:0]],
+	];
+	
+	for (NSString *jsonString in jsonStrings)
+	{
+		NSData *data = [jsonString dataUsingEncoding:NSUTF8StringEncoding];
+		
+		for (NSNumber *kernel in _kernels)
+		{
+			NSError	*error = nil;
+			id		result = [self parseData:data kernel:(SMJJSONParserKernel)kernel.intValue error:&error];
+			
+			XCTAssertNil(result, @"unexpected result for %@ with kernel %@", jsonString, kernel);
+			XCTAssertNotNil(error, @"missing error for %@ with kernel %@", jsonString, kernel);
+		}
+	}
+	
+	// Invalid UTF-8.
+	const uint8_t	bytes[] = { '[', '"', 0xC3, 0x28, '"', ']' };
+	NSError			*error = nil;
+	
+	XCTAssertNil([self parseData:[NSData dataWithBytes:bytes length:sizeof(bytes)] kernel:SMJJSONParserKernelScalar error:&error]);
+	XCTAssertNotNil(error);
+}
+
+- (void)test_result_for_json_data
+{
+	SMJConfiguration *configuration = [SMJConfiguration configurationWithOption:SMJOptionBuiltInJSONParser];
+	
+	for (NSString *pathString in @[ @"$", @"$.completed_frameworks[*].name", @"$..timestamp", @"$.completed_frameworks[?(@.active == true)].id" ])
+	{
+		SMJJSONPath	*jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:pathString error:nil];
+		id			expected = [jsonPath resultForJSONData:_documentsData[0] configuration:nil error:nil];
+		
+		XCTAssertNotNil(expected);
+		XCTAssertEqualObjects([jsonPath resultForJSONData:_documentsData[0] configuration:configuration error:nil], expected, @"unexpected result for %@", pathString);
+	}
+	
+	// Other encodings fallback on NSJSONSerialization.
+	SMJJSONPath	*jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.key" error:nil];
+	NSData		*data = [@"{ \"key\" : \"value\" }" dataUsingEncoding:NSUTF16LittleEndianStringEncoding];
+	
+	XCTAssertEqualObjects([jsonPath resultForJSONData:data configuration:configuration error:nil], @"value");
+	
+	// Errors come from the built-in parser.
+	NSError *error = nil;
+	
+	XCTAssertNil([jsonPath resultForJSONData:[@"{ \"key\" : }" dataUsingEncoding:NSUTF8StringEncoding] configuration:configuration error:&error]);
+	XCTAssertEqualObjects(error.domain, @"SMJJSONParserErrorDomain");
+}
+
+- (void)test_foundation_performance
+{
+	NSData *data = _eventsData;
+	
+	[self measureBlock:^{
+		CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+		
+		for (NSUInteger i = 0; i < 5; i++)
+			[NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+		
+		[self logThroughputForLength:data.length * 5 duration:CFAbsoluteTimeGetCurrent() - start name:@"NSJSONSerialization"];
+	}];
+}
+
+- (void)test_parser_performance
+{
+	NSData *data = _eventsData;
+	
+	[self measureBlock:^{
+		CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+		
+		for (NSUInteger i = 0; i < 5; i++)
+			[[[SMJJSONParser alloc] initWithData:data] readJSONObjectWithError:nil];
+		
+		[self logThroughputForLength:data.length * 5 duration:CFAbsoluteTimeGetCurrent() - start name:@"SMJJSONParser"];
+	}];
+}
+
+- (void)test_parser_scalar_performance
+{
+	NSData *data = _eventsData;
+	
+	[self measureBlock:^{
+		CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+		
+		for (NSUInteger i = 0; i < 5; i++)
+			[[[SMJJSONParser alloc] initWithData:data kernel:SMJJSONParserKernelScalar] readJSONObjectWithError:nil];
+		
+		[self logThroughputForLength:data.length * 5 duration:CFAbsoluteTimeGetCurrent() - start name:@"SMJJSONParser (scalar)"];
+	}];
+}
+
+
+/*
+** SMJJSONParserTest - Helpers
+*/
+#pragma mark - SMJJSONParserTest - Helpers
+
+- (nullable id)parseData:(NSData *)data kernel:(SMJJSONParserKernel)kernel error:(NSError **)error
+{
+	return [[[SMJJSONParser alloc] initWithData:data kernel:kernel] readJSONObjectWithError:error];
+}
+
+- (void)logThroughputForLength:(NSUInteger)length duration:(CFAbsoluteTime)duration name:(NSString *)name
+{
+	NSLog(@"%@: %.1f MB/s", name, ((double)length / (1024.0 * 1024.0)) / duration);
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,222 @@
+/*
+ * SMJJSONPatchTest.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <XCTest/XCTest.h>
+
+#import "SMJCommonTest.h"
+
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** SMJJSONPatchTest
+*/
+#pragma mark - SMJJSONPatchTest
+
+@interface SMJJSONPatchTest : SMJCommonTest
+@end
+
+@implementation SMJJSONPatchTest
+
+
+/*
+** SMJJSONPatchTest - Apply
+*/
+#pragma mark - SMJJSONPatchTest - Apply
+
+- (void)test_apply_operations
+{
+	// Examples from RFC 6902, appendix A.
+	[self checkPatch:@"[ { \"op\": \"add\", \"path\": \"/baz\", \"value\": \"qux\" } ]" document:@"{ \"foo\": \"bar\" }" expected:@"{ \"baz\": \"qux\", \"foo\": \"bar\" }"];
+	[self checkPatch:@"[ { \"op\": \"add\", \"path\": \"/foo/1\", \"value\": \"qux\" } ]" document:@"{ \"foo\": [ \"bar\", \"baz\" ] }" expected:@"{ \"foo\": [ \"bar\", \"qux\", \"baz\" ] }"];
+	[self checkPatch:@"[ { \"op\": \"remove\", \"path\": \"/baz\" } ]" document:@"{ \"baz\": \"qux\", \"foo\": \"bar\" }" expected:@"{ \"foo\": \"bar\" }"];
+	[self checkPatch:@"[ { \"op\": \"remove\", \"path\": \"/foo/1\" } ]" document:@"{ \"foo\": [ \"bar\", \"qux\", \"baz\" ] }" expected:@"{ \"foo\": [ \"bar\", \"baz\" ] }"];
+	[self checkPatch:@"[ { \"op\": \"replace\", \"path\": \"/baz\", \"value\": \"boo\" } ]" document:@"{ \"baz\": \"qux\", \"foo\": \"bar\" }" expected:@"{ \"baz\": \"boo\", \"foo\": \"bar\" }"];
+	[self checkPatch:@"[ { \"op\": \"move\", \"from\": \"/foo/waldo\", \"path\": \"/qux/thud\" } ]" document:@"{ \"foo\": { \"bar\": \"baz\", \"waldo\": \"fred\" }, \"qux\": { \"corge\": \"grault\" } }" expected:@"{ \"foo\": { \"bar\": \"baz\" }, \"qux\": { \"corge\": \"grault\", \"thud\": \"fred\" } }"];
+	[self checkPatch:@"[ { \"op\": \"move\", \"from\": \"/foo/1\", \"path\": \"/foo/3\" } ]" document:@"{ \"foo\": [ \"all\", \"grass\", \"cows\", \"eat\" ] }" expected:@"{ \"foo\": [ \"all\", \"cows\", \"eat\", \"grass\" ] }"];
+	[self checkPatch:@"[ { \"op\": \"test\", \"path\": \"/baz\", \"value\": \"qux\" }, { \"op\": \"test\", \"path\": \"/foo/1\", \"value\": 2 } ]" document:@"{ \"baz\": \"qux\", \"foo\": [ \"a\", 2, \"c\" ] }" expected:@"{ \"baz\": \"qux\", \"foo\": [ \"a\", 2, \"c\" ] }"];
+	[self checkPatch:@"[ { \"op\": \"add\", \"path\": \"/child\", \"value\": { \"grandchild\": { } } } ]" document:@"{ \"foo\": \"bar\" }" expected:@"{ \"foo\": \"bar\", \"child\": { \"grandchild\": { } } }"];
+	[self checkPatch:@"[ { \"op\": \"add\", \"path\": \"/foo/-\", \"value\": [ \"abc\", \"def\" ] } ]" document:@"{ \"foo\": [ \"bar\" ] }" expected:@"{ \"foo\": [ \"bar\", [ \"abc\", \"def\" ] ] }"];
+	[self checkPatch:@"[ { \"op\": \"test\", \"path\": \"/~01\", \"value\": 10 }, { \"op\": \"copy\", \"from\": \"/a~1b\", \"path\": \"/c\" } ]" document:@"{ \"/\": 9, \"~1\": 10, \"a/b\": [ 1 ] }" expected:@"{ \"/\": 9, \"~1\": 10, \"a/b\": [ 1 ], \"c\": [ 1 ] }"];
+	
+	// Values added by the patch can be updated by following operations.
+	[self checkPatch:@"[ { \"op\": \"add\", \"path\": \"/a\", \"value\": { \"b\": [ ] } }, { \"op\": \"add\", \"path\": \"/a/b/0\", \"value\": 1 }, { \"op\": \"copy\", \"from\": \"/a\", \"path\": \"/c\" }, { \"op\": \"replace\", \"path\": \"/c/b/0\", \"value\": 2 } ]" document:@"{ }" expected:@"{ \"a\": { \"b\": [ 1 ] }, \"c\": { \"b\": [ 2 ] } }"];
+	
+	// Operations on the whole document.
+	[self checkPatch:@"[ { \"op\": \"replace\", \"path\": \"\", \"value\": { \"a\": 1 } }, { \"op\": \"add\", \"path\": \"/b\", \"value\": 2 } ]" document:@"{ \"foo\": \"bar\" }" expected:@"{ \"a\": 1, \"b\": 2 }"];
+	[self checkPatch:@"[ { \"op\": \"add\", \"path\": \"\", \"value\": { \"c\": [ ] } }, { \"op\": \"add\", \"path\": \"/c/-\", \"value\": 1 } ]" document:@"{ \"foo\": \"bar\" }" expected:@"{ \"c\": [ 1 ] }"];
+	[self checkPatch:@"[ { \"op\": \"move\", \"from\": \"/a\", \"path\": \"\" }, { \"op\": \"replace\", \"path\": \"/b\", \"value\": 3 } ]" document:@"{ \"a\": { \"b\": 1 }, \"c\": 2 }" expected:@"{ \"b\": 3 }"];
+	[self checkPatch:@"[ { \"op\": \"copy\", \"from\": \"/a\", \"path\": \"\" } ]" document:@"{ \"a\": { \"b\": 1 }, \"c\": 2 }" expected:@"{ \"b\": 1 }"];
+	
+	// The whole document can change its kind in a copy.
+	SMJJSONPatch	*patch = [[SMJJSONPatch alloc] initWithOperations:@[ @{ @"op" : @"replace", @"path" : @"", @"value" : @[ @1 ] }, @{ @"op" : @"add", @"path" : @"/-", @"value" : @2 } ] error:nil];
+	NSDictionary	*document = @{ @"a" : @1 };
+	
+	XCTAssertEqualObjects([patch updatedJSONObject:document configuration:nil error:nil], (@[ @1, @2 ]));
+	XCTAssertEqualObjects(document, @{ @"a" : @1 });
+}
+
+- (void)test_apply_errors
+{
+	// Failures leave the document untouched.
+	[self checkPatch:@"[ { \"op\": \"add\", \"path\": \"/a\", \"value\": 1 }, { \"op\": \"test\", \"path\": \"/baz\", \"value\": \"bar\" } ]" failingOnDocument:@"{ \"baz\": \"qux\" }"];
+	[self checkPatch:@"[ { \"op\": \"add\", \"path\": \"/baz/bat\", \"value\": \"qux\" } ]" failingOnDocument:@"{ \"foo\": \"bar\" }"];
+	[self checkPatch:@"[ { \"op\": \"remove\", \"path\": \"/a/1\" }, { \"op\": \"remove\", \"path\": \"/b\" } ]" failingOnDocument:@"{ \"a\": [ 1, 2 ] }"];
+	[self checkPatch:@"[ { \"op\": \"replace\", \"path\": \"/a/01\", \"value\": 0 } ]" failingOnDocument:@"{ \"a\": [ 1, 2 ] }"];
+	[self checkPatch:@"[ { \"op\": \"add\", \"path\": \"/a/3\", \"value\": 0 } ]" failingOnDocument:@"{ \"a\": [ 1, 2 ] }"];
+	[self checkPatch:@"[ { \"op\": \"move\", \"from\": \"/a\", \"path\": \"/a/b\" } ]" failingOnDocument:@"{ \"a\": { } }"];
+	[self checkPatch:@"[ { \"op\": \"replace\", \"path\": \"\", \"value\": [ 1 ] } ]" failingOnDocument:@"{ \"a\": 1 }"];
+	
+	// Invalid patches.
+	NSArray *invalidPatches = @[ @"{ }", @"[ { \"op\": \"jump\", \"path\": \"/a\" } ]", @"[ { \"op\": \"add\", \"path\": \"a\", \"value\": 1 } ]", @"[ { \"op\": \"add\", \"path\": \"/a\" } ]", @"[ { \"op\": \"copy\", \"path\": \"/a\" } ]", @"[ { \"op\": \"remove\", \"path\": \"/~2\" } ]", @"[ { \"op\": \"remove\", \"path\": \"\" } ]" ];
+	
+	for (NSString *invalidPatch in invalidPatches)
+	{
+		NSError *error = nil;
+		
+		XCTAssertNil([[SMJJSONPatch alloc] initWithJSONData:[invalidPatch dataUsingEncoding:NSUTF8StringEncoding] error:&error], @"%@", invalidPatch);
+		XCTAssertNotNil(error);
+	}
+}
+
+
+/*
+** SMJJSONPatchTest - Transaction
+*/
+#pragma mark - SMJJSONPatchTest - Transaction
+
+- (void)test_transaction_patch
+{
+	NSString				*jsonString = @"{ \"store\" : { \"book\" : [ { \"title\" : \"a\", \"price\" : 8, \"tags\" : [ \"x\" ] }, { \"title\" : \"b\", \"price\" : 12 }, { \"title\" : \"c\", \"price\" : 20 }, { \"title\" : \"d\", \"price\" : 30 } ], \"bicycle\" : { \"color\" : \"red\", \"a/b\" : 1 } }, \"expensive\" : 10 }";
+	NSMutableDictionary		*json = [self jsonObjectWithString:jsonString];
+	NSMutableDictionary		*replica = [self jsonObjectWithString:jsonString];
+	SMJJSONPathTransaction	*transaction = [[SMJJSONPathTransaction alloc] init];
+	SMJJSONPatch			*patch = nil;
+	NSError					*error = nil;
+	
+	[transaction setObject:@"blue" atJSONPath:[self jsonPath:@"$.store.bicycle.color"]];
+	[transaction mapObjects:^id (id object, SMJConfiguration *configuration) { return @([object integerValue] + 1); } atJSONPath:[self jsonPath:@"$.store.book[*].price"]];
+	[transaction addObject:@"y" atJSONPath:[self jsonPath:@"$.store.book[0].tags"]];
+	[transaction putObject:@YES key:@"sold" atJSONPath:[self jsonPath:@"$.store.book[1]"]];
+	[transaction renameKey:@"a/b" toKey:@"c~d" atJSONPath:[self jsonPath:@"$.store.bicycle"]];
+	[transaction deleteAtJSONPath:[self jsonPath:@"$.store.book[?(@.price > 15)]"]];
+	[transaction deleteAtJSONPath:[self jsonPath:@"$.store.book[0].tags[0]"]];
+	[transaction deleteAtJSONPath:[self jsonPath:@"$.expensive"]];
+	
+	XCTAssertTrue([transaction applyToMutableJSONObject:json configuration:nil patch:&patch error:&error], @"%@", error);
+	XCTAssertNotNil(patch);
+	
+	// Ship the patch, and apply it to the replica.
+	NSData *patchData = [patch JSONDataWithError:&error];
+	
+	XCTAssertNotNil(patchData, @"%@", error);
+	
+	SMJJSONPatch *receivedPatch = [[SMJJSONPatch alloc] initWithJSONData:(NSData *)patchData error:&error];
+	
+	XCTAssertNotNil(receivedPatch, @"%@", error);
+	XCTAssertTrue([receivedPatch applyToMutableJSONObject:replica configuration:nil error:&error], @"%@", error);
+	XCTAssertEqualObjects(replica, json);
+	
+	// Removes come last, deepest and highest indexes first.
+	NSArray *removePaths = [[patch.operations filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"op == 'remove'"]] valueForKey:@"path"];
+	
+	XCTAssertEqualObjects(removePaths, (@[ @"/store/book/0/tags/0", @"/store/book/3", @"/store/book/2", @"/expensive" ]));
+	
+	// The patch can be applied to an immutable copy too.
+	NSDictionary *immutable = [NSJSONSerialization JSONObjectWithData:[jsonString dataUsingEncoding:NSUTF8StringEncoding] options:0 error:nil];
+	
+	XCTAssertEqualObjects([receivedPatch updatedJSONObject:immutable configuration:nil error:nil], json);
+}
+
+- (void)test_transaction_patch_rename
+{
+	NSString				*jsonString = @"{ \"store\" : { \"book\" : [ { \"title\" : \"a\", \"price\" : 8 }, { \"title\" : \"b\", \"price\" : 20 } ] } }";
+	NSMutableDictionary		*json = [self jsonObjectWithString:jsonString];
+	NSMutableDictionary		*replica = [self jsonObjectWithString:jsonString];
+	SMJJSONPathTransaction	*transaction = [[SMJJSONPathTransaction alloc] init];
+	SMJJSONPatch			*patch = nil;
+	NSError					*error = nil;
+	
+	// Renames on the way to values updated before and after them.
+	[transaction setObject:@"z" atJSONPath:[self jsonPath:@"$.store.book[0].title"]];
+	[transaction renameKey:@"book" toKey:@"books" atJSONPath:[self jsonPath:@"$.store"]];
+	[transaction renameKey:@"store" toKey:@"shop" atJSONPath:[self jsonPath:@"$"]];
+	[transaction mapObjects:^id (id object, SMJConfiguration *configuration) { return @([object integerValue] + 1); } atJSONPath:[self jsonPath:@"$.store.book[*].price"]];
+	[transaction putObject:@YES key:@"sold" atJSONPath:[self jsonPath:@"$.store.book[0]"]];
+	[transaction deleteAtJSONPath:[self jsonPath:@"$.store.book[?(@.price > 15)]"]];
+	
+	XCTAssertTrue([transaction applyToMutableJSONObject:json configuration:nil patch:&patch error:&error], @"%@", error);
+	XCTAssertEqualObjects(json, [self jsonObjectWithString:@"{ \"shop\" : { \"books\" : [ { \"title\" : \"z\", \"price\" : 9, \"sold\" : true } ] } }"]);
+	
+	// Pointers follow the renames recorded before them.
+	XCTAssertEqualObjects([patch.operations valueForKey:@"path"], (@[ @"/store/book/0/title", @"/store/books", @"/shop", @"/shop/books/0/price", @"/shop/books/1/price", @"/shop/books/0/sold", @"/shop/books/1" ]));
+	
+	XCTAssertTrue([patch applyToMutableJSONObject:replica configuration:nil error:&error], @"%@", error);
+	XCTAssertEqualObjects(replica, json);
+}
+
+
+/*
+** SMJJSONPatchTest - Helpers
+*/
+#pragma mark - SMJJSONPatchTest - Helpers
+
+- (void)checkPatch:(NSString *)patchString document:(NSString *)documentString expected:(NSString *)expectedString
+{
+	NSError				*error = nil;
+	SMJJSONPatch		*patch = [[SMJJSONPatch alloc] initWithJSONData:[patchString dataUsingEncoding:NSUTF8StringEncoding] error:&error];
+	NSMutableDictionary	*document = [self jsonObjectWithString:documentString];
+	id					expected = [self jsonObjectWithString:expectedString];
+	
+	XCTAssertNotNil(patch, @"%@", error);
+	
+	XCTAssertTrue([patch applyToMutableJSONObject:document configuration:nil error:&error], @"%@ - %@", patchString, error);
+	XCTAssertEqualObjects(document, expected, @"%@", patchString);
+}
+
+- (void)checkPatch:(NSString *)patchString failingOnDocument:(NSString *)documentString
+{
+	NSError				*error = nil;
+	SMJJSONPatch		*patch = [[SMJJSONPatch alloc] initWithJSONData:[patchString dataUsingEncoding:NSUTF8StringEncoding] error:&error];
+	NSMutableDictionary	*document = [self jsonObjectWithString:documentString];
+	id					original = [self jsonObjectWithString:documentString];
+	
+	XCTAssertNotNil(patch, @"%@", error);
+	
+	XCTAssertFalse([patch applyToMutableJSONObject:document configuration:nil error:&error], @"%@", patchString);
+	XCTAssertNotNil(error);
+	XCTAssertEqualObjects(document, original, @"%@", patchString);
+}
+
+- (SMJJSONPath *)jsonPath:(NSString *)pathString
+{
+	return [[SMJJSONPath alloc] initWithJSONPathString:pathString error:nil];
+}
+
+- (id)jsonObjectWithString:(NSString *)jsonString
+{
+	return [NSJSONSerialization JSONObjectWithData:[jsonString dataUsingEncoding:NSUTF8StringEncoding] options:NSJSONReadingMutableContainers error:nil];
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,209 @@
+/*
+ * SMJJSONPathBatchTest.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <XCTest/XCTest.h>
+
+#import "SMJCommonTest.h"
+
+#import "SMJJSONPathBatch.h"
+#import "SMJPathTrie.h"
+#import "SMJPathCompiler.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** SMJJSONPathBatchTest
+*/
+#pragma mark - SMJJSONPathBatchTest
+
+@interface SMJJSONPathBatchTest : SMJCommonTest
+{
+	id _issue191;
+}
+
+@end
+
+@implementation SMJJSONPathBatchTest
+
+- (void)setUp
+{
+	[super setUp];
+	
+	NSString *path = [[NSBundle bundleForClass:self.class] pathForResource:@"issue_191" ofType:@"json"];
+	
+	_issue191 = [NSJSONSerialization JSONObjectWithData:[NSData dataWithContentsOfFile:path] options:0 error:nil];
+}
+
+
+/*
+** SMJJSONPathBatchTest - Tests
+*/
+#pragma mark - SMJJSONPathBatchTest - Tests
+
+- (void)test_batch_matches_individual_evaluation
+{
+	NSArray *pathStrings = @[
+		@"$",
+		@"$.build_date",
+		@"$.build_user",
+		@"$.flags.port",
+		@"$.flags",
+		@"$.completed_frameworks[*].name",
+		@"$.completed_frameworks[*].id",
+		@"$.completed_frameworks[*].completed_tasks[*].id",
+		@"$.completed_frameworks[*].missing",
+		@"$.completed_frameworks[0].name",
+		@"$.completed_frameworks[0].completed_tasks[*].executor_id",
+		@"$.completed_frameworks[0].completed_tasks[0].resources.cpus",
+		@"$.completed_frameworks[-1].name",
+		@"$.completed_frameworks[42].name",
+		@"$.completed_frameworks[1:4].id",
+		@"$.completed_frameworks[:2]['name', 'active']",
+		@"$.completed_frameworks[0, 2, 6].hostname",
+		@"$.completed_frameworks.name",
+		@"$.completed_frameworks[?(@.active == true)].name",
+		@"$.build_date.length()",
+		@"$..timestamp",
+		@"$..id",
+		@"$..resources.cpus",
+		@"$..completed_tasks[0].id",
+		@"$..timestamp.sum()",
+		@"$.sum($..timestamp)",
+		@"$.*",
+		@"$.*.port",
+		@"$.missing",
+		@"$.missing.key",
+		@"$.build_date.key",
+		@"$.build_date[0]",
+	];
+	
+	NSArray *configurations = @[
+		[SMJConfiguration defaultConfiguration],
+		[SMJConfiguration configurationWithOption:SMJOptionAsPathList],
+		[SMJConfiguration configurationWithOption:SMJOptionAlwaysReturnList],
+		[SMJConfiguration configurationWithOption:SMJOptionDefaultPathLeafToNull],
+		[SMJConfiguration configurationWithOption:SMJOptionRequireProperties],
+	];
+	
+	SMJJSONPathBatch *batch = [[SMJJSONPathBatch alloc] initWithJSONPathStrings:pathStrings error:nil];
+	
+	XCTAssertNotNil(batch);
+	XCTAssertEqual(batch.jsonPaths.count, pathStrings.count);
+	
+	for (SMJConfiguration *configuration in configurations)
+	{
+		NSDictionary <NSString *, NSError *> *errors = nil;
+		NSDictionary <NSString *, id> *results = [batch resultsForJSONObject:_issue191 configuration:configuration errors:&errors];
+		
+		XCTAssertNotNil(errors);
+		XCTAssertEqual(results.count + errors.count, pathStrings.count);
+		
+		for (SMJJSONPath *jsonPath in batch.jsonPaths)
+		{
+			NSError	*error = nil;
+			id		expected = [jsonPath resultForJSONObject:_issue191 configuration:configuration error:&error];
+			
+			if (expected)
+				XCTAssertEqualObjects(results[jsonPath.jsonPathString], expected, @"%@", jsonPath.jsonPathString);
+			else
+			{
+				XCTAssertNil(results[jsonPath.jsonPathString], @"%@", jsonPath.jsonPathString);
+				XCTAssertEqualObjects(errors[jsonPath.jsonPathString].localizedDescription, error.localizedDescription, @"%@", jsonPath.jsonPathString);
+			}
+		}
+	}
+}
+
+- (void)test_batch_share_prefixes
+{
+	NSArray *pathStrings = @[ @"$.a.b.c", @"$.a.b.d", @"$.a.b[0]", @"$.a.e", @"$.a.*", @"$..f", @"$..g", @"$.a[?(@.b)]" ];
+	NSMutableArray <SMJCompiledPath *> *paths = [NSMutableArray array];
+	
+	for (NSString *pathString in pathStrings)
+		[paths addObject:(SMJCompiledPath *)[SMJPathCompiler compilePathString:pathString error:nil]];
+	
+	SMJPathTrie *trie = [[SMJPathTrie alloc] initWithPaths:paths];
+	
+	// $ -> (a -> (b -> (c, d, [0]), e, *, [?()]), ..)
+	XCTAssertEqual(trie.nodeCount, 10);
+}
+
+- (void)test_batch_duplicates_and_errors
+{
+	SMJJSONPath			*jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.a" error:nil];
+	SMJJSONPathBatch	*batch = [[SMJJSONPathBatch alloc] initWithJSONPaths:@[ jsonPath, jsonPath, [[SMJJSONPath alloc] initWithJSONPathString:@"  $.a  " error:nil] ]];
+	
+	XCTAssertEqual(batch.jsonPaths.count, 1);
+	XCTAssertEqualObjects([batch resultsForJSONObject:@{ @"a" : @1 } configuration:nil errors:nil], @{ @"$.a" : @1 });
+	
+	// Invalid path string.
+	XCTAssertNil([[SMJJSONPathBatch alloc] initWithJSONPathStrings:@[ @"$.a", @"$.." ] error:nil]);
+	
+	// Function paths with list options.
+	NSDictionary *errors = nil;
+	
+	batch = [[SMJJSONPathBatch alloc] initWithJSONPathStrings:@[ @"$.a", @"$.a.length()" ] error:nil];
+	
+	XCTAssertEqualObjects([batch resultsForJSONObject:@{ @"a" : @[ @1, @2 ] } configuration:[SMJConfiguration configurationWithOption:SMJOptionAlwaysReturnList] errors:&errors], @{ @"$.a" : @[ @[ @1, @2 ] ] });
+	XCTAssertNotNil(errors[@"$.a.length()"]);
+}
+
+- (void)test_batch_performance
+{
+	NSMutableArray *pathStrings = [NSMutableArray array];
+	
+	for (NSString *property in @[ @"id", @"name", @"hostname", @"active", @"user", @"pid", @"registered_time", @"unregistered_time" ])
+	{
+		[pathStrings addObject:[NSString stringWithFormat:@"$.completed_frameworks[*].%@", property]];
+		[pathStrings addObject:[NSString stringWithFormat:@"$.completed_frameworks[*].completed_tasks[*].%@", property]];
+	}
+	
+	SMJJSONPathBatch *batch = [[SMJJSONPathBatch alloc] initWithJSONPathStrings:pathStrings error:nil];
+	
+	[self measureBlock:^{
+		for (NSUInteger i = 0; i < 20; i++)
+			[batch resultsForJSONObject:self->_issue191 configuration:nil errors:nil];
+	}];
+}
+
+- (void)test_individual_performance
+{
+	NSMutableArray *jsonPaths = [NSMutableArray array];
+	
+	for (NSString *property in @[ @"id", @"name", @"hostname", @"active", @"user", @"pid", @"registered_time", @"unregistered_time" ])
+	{
+		[jsonPaths addObject:[[SMJJSONPath alloc] initWithJSONPathString:[NSString stringWithFormat:@"$.completed_frameworks[*].%@", property] error:nil]];
+		[jsonPaths addObject:[[SMJJSONPath alloc] initWithJSONPathString:[NSString stringWithFormat:@"$.completed_frameworks[*].completed_tasks[*].%@", property] error:nil]];
+	}
+	
+	[self measureBlock:^{
+		for (NSUInteger i = 0; i < 20; i++)
+		{
+			for (SMJJSONPath *jsonPath in jsonPaths)
+				[jsonPath resultForJSONObject:self->_issue191 configuration:nil error:nil];
+		}
+	}];
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,169 @@
+/*
+ * SMJJSONPathTransactionTest.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <XCTest/XCTest.h>
+
+#import "SMJCommonTest.h"
+
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** SMJJSONPathTransactionTest
+*/
+#pragma mark - SMJJSONPathTransactionTest
+
+@interface SMJJSONPathTransactionTest : SMJCommonTest
+@end
+
+@implementation SMJJSONPathTransactionTest
+
+
+/*
+** SMJJSONPathTransactionTest - Tests
+*/
+#pragma mark - SMJJSONPathTransactionTest - Tests
+
+- (void)test_operations
+{
+	NSMutableDictionary		*json = [self mutableDocument];
+	NSMutableDictionary		*bicycle = json[@"store"][@"bicycle"];
+	SMJJSONPathTransaction	*transaction = [[SMJJSONPathTransaction alloc] init];
+	
+	[transaction setObject:@"blue" atJSONPath:[self jsonPath:@"$.store.bicycle.color"]];
+	[transaction mapObjects:^id (id object, SMJConfiguration *configuration) { return @([object integerValue] + 1); } atJSONPath:[self jsonPath:@"$.store.book[*].price"]];
+	[transaction addObject:@"new" atJSONPath:[self jsonPath:@"$.store.book[0].tags"]];
+	[transaction putObject:@YES key:@"sold" atJSONPath:[self jsonPath:@"$.store.book[1]"]];
+	[transaction renameKey:@"expensive" toKey:@"limit" atJSONPath:[self jsonPath:@"$"]];
+	[transaction deleteAtJSONPath:[self jsonPath:@"$.store.book[?(@.price > 15)]"]];
+	
+	XCTAssertEqual(transaction.operationCount, 6);
+	
+	NSError *error = nil;
+	
+	XCTAssertTrue([transaction applyToMutableJSONObject:json configuration:nil error:&error], @"%@", error);
+	
+	[self checkResultForJSONObject:json jsonPathString:@"$.store.bicycle.color" expectedResult:@"blue"];
+	[self checkResultForJSONObject:json jsonPathString:@"$.store.book[*].price" expectedResult:@[ @9, @13 ]];
+	[self checkResultForJSONObject:json jsonPathString:@"$.store.book[0].tags" expectedResult:@[ @"x", @"new" ]];
+	[self checkResultForJSONObject:json jsonPathString:@"$.store.book[1].sold" expectedResult:@YES];
+	[self checkResultForJSONObject:json jsonPathString:@"$.limit" expectedResult:@10];
+	
+	// Containers are updated in place.
+	XCTAssertEqual(json[@"store"][@"bicycle"], bicycle);
+}
+
+- (void)test_deterministic_order
+{
+	// Deletes are applied after other operations, on the items selected before any modification.
+	NSMutableArray			*json = [@[ @0, @1, @2, @3, @4 ] mutableCopy];
+	SMJJSONPathTransaction	*transaction = [[SMJJSONPathTransaction alloc] init];
+	
+	[transaction deleteAtJSONPath:[self jsonPath:@"$[1]"]];
+	[transaction deleteAtJSONPath:[self jsonPath:@"$[3]"]];
+	[transaction setObject:@"x" atJSONPath:[self jsonPath:@"$[3]"]];
+	[transaction setObject:@"y" atJSONPath:[self jsonPath:@"$[4]"]];
+	
+	XCTAssertTrue([transaction applyToMutableJSONObject:json configuration:nil error:nil]);
+	XCTAssertEqualObjects(json, (@[ @0, @2, @"y" ]));
+}
+
+- (void)test_rollback
+{
+	NSMutableDictionary		*json = [self mutableDocument];
+	NSDictionary			*original = [self deepCopy:json];
+	SMJJSONPathTransaction	*transaction = [[SMJJSONPathTransaction alloc] init];
+	NSError					*error = nil;
+	
+	[transaction setObject:@"blue" atJSONPath:[self jsonPath:@"$.store.bicycle.color"]];
+	[transaction deleteAtJSONPath:[self jsonPath:@"$.store.book[0]"]];
+	[transaction addObject:@"fail" atJSONPath:[self jsonPath:@"$.store.bicycle"]]; // Not an array.
+	
+	XCTAssertFalse([transaction applyToMutableJSONObject:json configuration:nil error:&error]);
+	XCTAssertNotNil(error);
+	XCTAssertEqualObjects(json, original);
+	
+	// Immutable containers are refused only where values change.
+	NSDictionary *immutable = [self deepCopy:json];
+	
+	transaction = [[SMJJSONPathTransaction alloc] init];
+	[transaction setObject:@"blue" atJSONPath:[self jsonPath:@"$.store.bicycle.color"]];
+	
+	XCTAssertFalse([transaction applyToMutableJSONObject:immutable configuration:nil error:nil]);
+	XCTAssertEqualObjects(immutable, original);
+	
+	// ... but can be updated in a copy.
+	id updated = [transaction updatedJSONObject:immutable configuration:nil error:nil];
+	
+	[self checkResultForJSONObject:updated jsonPathString:@"$.store.bicycle.color" expectedResult:@"blue"];
+	XCTAssertEqual(updated[@"store"][@"book"], immutable[@"store"][@"book"]);
+}
+
+- (void)test_transaction_performance
+{
+	NSMutableArray *items = [NSMutableArray array];
+	
+	for (NSUInteger i = 0; i < 20000; i++)
+		[items addObject:[@{ @"id" : @(i), @"name" : [NSString stringWithFormat:@"item %lu", (unsigned long)i] } mutableCopy]];
+	
+	NSMutableDictionary		*json = [@{ @"items" : items, @"meta" : [NSMutableDictionary dictionary] } mutableCopy];
+	SMJJSONPathTransaction	*transaction = [[SMJJSONPathTransaction alloc] init];
+	
+	for (NSUInteger i = 0; i < 20; i++)
+	{
+		[transaction setObject:@(i) atJSONPath:[self jsonPath:[NSString stringWithFormat:@"$.items[%lu].name", (unsigned long)(i * 1000)]]];
+		[transaction putObject:@(i) key:[NSString stringWithFormat:@"key%lu", (unsigned long)i] atJSONPath:[self jsonPath:@"$.meta"]];
+	}
+	
+	[self measureBlock:^{
+		XCTAssertTrue([transaction applyToMutableJSONObject:json configuration:nil error:nil]);
+	}];
+}
+
+
+/*
+** SMJJSONPathTransactionTest - Helpers
+*/
+#pragma mark - SMJJSONPathTransactionTest - Helpers
+
+- (SMJJSONPath *)jsonPath:(NSString *)pathString
+{
+	return [[SMJJSONPath alloc] initWithJSONPathString:pathString error:nil];
+}
+
+- (NSMutableDictionary *)mutableDocument
+{
+	NSString *jsonString = @"{ \"store\" : { \"book\" : [ { \"title\" : \"a\", \"price\" : 8, \"tags\" : [ \"x\" ] }, { \"title\" : \"b\", \"price\" : 12 }, { \"title\" : \"c\", \"price\" : 20 } ], \"bicycle\" : { \"color\" : \"red\" } }, \"expensive\" : 10 }";
+	
+	return [NSJSONSerialization JSONObjectWithData:[jsonString dataUsingEncoding:NSUTF8StringEncoding] options:NSJSONReadingMutableContainers error:nil];
+}
+
+- (id)deepCopy:(id)jsonObject
+{
+	NSData *data = [NSJSONSerialization dataWithJSONObject:jsonObject options:0 error:nil];
+	
+	return [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,252 @@
+/*
+ * SMJJSONStreamTest.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <XCTest/XCTest.h>
+
+#import "SMJCommonTest.h"
+
+#import "SMJJSONStreamReader.h"
+#import "SMJPathCompiler.h"
+#import "SMJCompiledPath.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** SMJJSONStreamTest
+*/
+#pragma mark - SMJJSONStreamTest
+
+@interface SMJJSONStreamTest : SMJCommonTest
+{
+	NSData *_issue191Data;
+	NSData *_eventsData;
+}
+
+@end
+
+@implementation SMJJSONStreamTest
+
+- (void)setUp
+{
+	[super setUp];
+	
+	NSString *path = [[NSBundle bundleForClass:self.class] pathForResource:@"issue_191" ofType:@"json"];
+	
+	_issue191Data = [NSData dataWithContentsOfFile:path];
+	
+	// Build a log export like document.
+	NSMutableArray *events = [NSMutableArray array];
+	
+	for (NSUInteger i = 0; i < 5000; i++)
+	{
+		[events addObject:@{
+			@"id" : @(i),
+			@"level" : (i % 10 == 0 ? @"error" : @"info"),
+			@"message" : [NSString stringWithFormat:@"event \"%lu\" \\ \u00e9\u6f22 %@", (unsigned long)i, [@"" stringByPaddingToLength:200 withString:@"x" startingAtIndex:0]],
+			@"payload" : @{ @"values" : @[ @1, @2.5, @-3e10, @YES, [NSNull null] ], @"nested" : @{ @"deep" : @[ @{ @"key" : @"value" } ] } },
+		}];
+	}
+	
+	_eventsData = [NSJSONSerialization dataWithJSONObject:@{ @"count" : @(events.count), @"events" : events } options:NSJSONWritingPrettyPrinted error:nil];
+}
+
+
+/*
+** SMJJSONStreamTest - Tests
+*/
+#pragma mark - SMJJSONStreamTest - Tests
+
+- (void)test_stream_matches_in_memory_evaluation
+{
+	NSArray *pathStrings = @[
+		@"$",
+		@"$.build_date",
+		@"$.completed_frameworks[*].name",
+		@"$.completed_frameworks[0].completed_tasks[*].executor_id",
+		@"$.completed_frameworks[1:4].id",
+		@"$.completed_frameworks[:2]['name', 'active']",
+		@"$.completed_frameworks[-1].name",
+		@"$.completed_frameworks[0, 2, 6].hostname",
+		@"$.completed_frameworks[42].hostname",
+		@"$.completed_frameworks.name",
+		@"$.build_date.length()",
+		@"$..timestamp",
+		@"$..timestamp.sum()",
+		@"$.sum($..timestamp)",
+		@"$.completed_frameworks[?(@.active == true)].name",
+		@"$.completed_frameworks[?(@.name == $.completed_frameworks[0].name)].id",
+		@"$.missing",
+		@"$.missing.key",
+	];
+	
+	for (NSString *pathString in pathStrings)
+	{
+		[self checkStreamForData:_issue191Data jsonPathString:pathString configuration:nil];
+		[self checkStreamForData:_issue191Data jsonPathString:pathString configuration:[SMJConfiguration configurationWithOption:SMJOptionAsPathList]];
+		[self checkStreamForData:_issue191Data jsonPathString:pathString configuration:[SMJConfiguration configurationWithOption:SMJOptionDefaultPathLeafToNull]];
+	}
+	
+	[self checkStreamForData:_eventsData jsonPathString:@"$.events[*].id" configuration:nil];
+	[self checkStreamForData:_eventsData jsonPathString:@"$.events[*].message" configuration:nil];
+	[self checkStreamForData:_eventsData jsonPathString:@"$.events[10:20].payload.values" configuration:nil];
+	[self checkStreamForData:_eventsData jsonPathString:@"$.events[?(@.level == 'error')].id" configuration:nil];
+}
+
+- (void)test_stream_materialize_selected_parts_only
+{
+	NSDictionary *document = [self projectedDocumentForData:_eventsData jsonPathString:@"$.events[*].id"];
+	
+	XCTAssertEqualObjects(document.allKeys, @[ @"events" ]);
+	XCTAssertEqual([document[@"events"] count], 5000);
+	XCTAssertEqualObjects([document[@"events"] lastObject], @{ @"id" : @4999 });
+	
+	// Items before the selected index are placeholders, items after are dropped.
+	document = [self projectedDocumentForData:_eventsData jsonPathString:@"$.events[2].payload.nested"];
+	
+	XCTAssertEqualObjects(document[@"events"], (@[ [NSNull null], [NSNull null], @{ @"payload" : @{ @"nested" : @{ @"deep" : @[ @{ @"key" : @"value" } ] } } } ]));
+	
+	// Negative indexes need all the items.
+	document = [self projectedDocumentForData:_eventsData jsonPathString:@"$.events[-1].id"];
+	
+	XCTAssertEqual([document[@"events"] count], 5000);
+}
+
+- (void)test_stream_scalars
+{
+	NSString *jsonString = @"{ \"s\" : \"a\\\"b\\\\c\\/d\\b\\f\\n\\r\\t\\u00e9\\u6f22\\ud83d\\ude00\", \"i\" : -42, \"big\" : 123456789012345678901234567890, \"d\" : 1.5e-3, \"z\" : -0, \"t\" : true, \"f\" : false, \"n\" : null, \"e\" : [], \"o\" : {} }";
+	NSData *data = [jsonString dataUsingEncoding:NSUTF8StringEncoding];
+	
+	id expected = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+	id result = [[[SMJJSONStreamReader alloc] initWithInputStream:[self openedStreamWithData:data]] readJSONObjectWithError:nil];
+	
+	XCTAssertEqualObjects(result[@"s"], expected[@"s"]);
+	XCTAssertEqualObjects(result[@"i"], @-42);
+	XCTAssertEqualWithAccuracy([result[@"big"] doubleValue], 1.2345678901234568e29, 1e15);
+	XCTAssertEqualWithAccuracy([result[@"d"] doubleValue], 0.0015, 1e-12);
+	XCTAssertEqualObjects(result[@"t"], @YES);
+	XCTAssertEqualObjects(result[@"f"], @NO);
+	XCTAssertEqualObjects(result[@"n"], [NSNull null]);
+	XCTAssertEqualObjects(result[@"e"], @[]);
+	XCTAssertEqualObjects(result[@"o"], @{});
+	
+	// Fragments.
+	XCTAssertEqualObjects([[[SMJJSONPath alloc] initWithJSONPathString:@"$" error:nil] resultForJSONStream:[self openedStreamWithData:[@" \"fragment\" " dataUsingEncoding:NSUTF8StringEncoding]] configuration:nil error:nil], @"fragment");
+}
+
+- (void)test_stream_invalid_documents
+{
+	NSArray *jsonStrings = @[
+		@"",
+		@"{",
+		@"{ \"a\" : 1, }",
+		@"{ \"a\" 1 }",
+		@"[1, 2",
+		@"[01]",
+		@"[1.]",
+		@"[tru]",
+		@"[\"\\x\"]",
+		@"[\"\\ud83d\"]",
+		@"[\"unterminated]",
+		@"{ \"a\" : 1 } garbage",
+		[[@"" stringByPaddingToLength:1000 withString:@"[" startingAtIndex:0] stringByAppendingString:[@"" stringByPaddingToLength:1000 withString:@"]" startingAtIndex:0]],
+	];
+	
+	for (NSString *jsonString in jsonStrings)
+	{
+		for (NSString *pathString in @[ @"$", @"$.a", @"$[0]" ])
+		{
+			SMJJSONPath	*jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:pathString error:nil];
+			NSError		*error = nil;
+			id			result = [jsonPath resultForJSONStream:[self openedStreamWithData:[jsonString dataUsingEncoding:NSUTF8StringEncoding]] configuration:nil error:&error];
+			
+			XCTAssertNil(result, @"unexpected result for %@ with %@", jsonString, pathString);
+			XCTAssertNotNil(error, @"missing error for %@ with %@", jsonString, pathString);
+		}
+	}
+}
+
+- (void)test_file_with_other_encoding
+{
+	NSURL	*url = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString]];
+	NSData	*data = [@"{ \"key\" : \"value\" }" dataUsingEncoding:NSUTF16LittleEndianStringEncoding];
+	
+	XCTAssertTrue([data writeToURL:url atomically:NO]);
+	
+	SMJJSONPath *jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.key" error:nil];
+	
+	XCTAssertEqualObjects([jsonPath resultForJSONFile:url configuration:nil error:nil], @"value");
+	
+	[[NSFileManager defaultManager] removeItemAtURL:url error:nil];
+}
+
+- (void)test_stream_performance
+{
+	SMJJSONPath *jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.events[*].id" error:nil];
+	
+	[self measureBlock:^{
+		for (NSUInteger i = 0; i < 5; i++)
+			[jsonPath resultForJSONStream:[NSInputStream inputStreamWithData:self->_eventsData] configuration:nil error:nil];
+	}];
+}
+
+
+/*
+** SMJJSONStreamTest - Helpers
+*/
+#pragma mark - SMJJSONStreamTest - Helpers
+
+- (void)checkStreamForData:(NSData *)data jsonPathString:(NSString *)jsonPathString configuration:(nullable SMJConfiguration *)configuration
+{
+	SMJJSONPath *jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:jsonPathString error:nil];
+	
+	XCTAssertNotNil(jsonPath);
+	
+	NSError	*expectedError = nil;
+	id		expectedResult = [jsonPath resultForJSONData:data configuration:configuration error:&expectedError];
+	
+	NSError	*error = nil;
+	id		result = [jsonPath resultForJSONStream:[NSInputStream inputStreamWithData:data] configuration:configuration error:&error];
+	
+	XCTAssertEqualObjects(result, expectedResult, @"stream result mismatch for %@", jsonPathString);
+	XCTAssertEqual(error == nil, expectedError == nil, @"stream error mismatch for %@", jsonPathString);
+}
+
+- (nullable id)projectedDocumentForData:(NSData *)data jsonPathString:(NSString *)jsonPathString
+{
+	SMJCompiledPath		*path = (SMJCompiledPath *)[SMJPathCompiler compilePathString:jsonPathString error:nil];
+	SMJJSONStreamReader	*reader = [[SMJJSONStreamReader alloc] initWithInputStream:[self openedStreamWithData:data]];
+	
+	return [reader readJSONObjectProjectedOnPathToken:path.root.next error:nil];
+}
+
+- (NSInputStream *)openedStreamWithData:(NSData *)data
+{
+	NSInputStream *inputStream = [NSInputStream inputStreamWithData:data];
+	
+	[inputStream open];
+	
+	return inputStream;
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
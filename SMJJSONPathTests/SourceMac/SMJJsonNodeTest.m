@@ -0,0 +1,109 @@
+/*
+ * SMJJsonNodeTest.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <XCTest/XCTest.h>
+
+#import "SMJCommonTest.h"
+
+#import "SMJValueNodes.h"
+#import "SMJUtils.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** SMJJsonNodeTest
+*/
+#pragma mark - SMJJsonNodeTest
+
+@interface SMJJsonNodeTest : SMJCommonTest
+@end
+
+@implementation SMJJsonNodeTest
+
+
+/*
+** SMJJsonNodeTest - Tests
+*/
+#pragma mark - SMJJsonNodeTest - Tests
+
+- (void)test_structural_hash
+{
+	NSUInteger hash1 = [SMJUtils structuralHashForJSONObject:@{ @"a" : @[ @1, @"x" ], @"b" : [NSNull null] }];
+	NSUInteger hash2 = [SMJUtils structuralHashForJSONObject:@{ @"b" : [NSNull null], @"a" : @[ @1.0, @"x" ] }];
+	
+	XCTAssertEqual(hash1, hash2);
+	
+	// Same counts, different content.
+	XCTAssertNotEqual([SMJUtils structuralHashForJSONObject:@[ @1, @2 ]], [SMJUtils structuralHashForJSONObject:@[ @2, @1 ]]);
+	XCTAssertNotEqual([SMJUtils structuralHashForJSONObject:@{ @"a" : @1 }], [SMJUtils structuralHashForJSONObject:@{ @"a" : @2 }]);
+	XCTAssertNotEqual([SMJUtils structuralHashForJSONObject:@[ @[ @1 ] ]], [SMJUtils structuralHashForJSONObject:@[ @[ @2 ] ]]);
+	
+	// Literal and evaluated nodes agree.
+	SMJJsonNode *literalNode = [SMJValueNodes jsonNodeWithString:@"{ \"b\" : null, \"a\" : [1, \"x\"] }"];
+	SMJJsonNode *evaluatedNode = (SMJJsonNode *)[SMJValueNodes valueNodeWithJsonObject:@{ @"a" : @[ @1, @"x" ], @"b" : [NSNull null] } error:nil];
+	
+	XCTAssertEqual(literalNode.structuralHash, hash1);
+	XCTAssertEqual(evaluatedNode.structuralHash, hash1);
+}
+
+- (void)test_structural_equality
+{
+	SMJJsonNode *node1 = [SMJValueNodes jsonNodeWithString:@"[1, {\"a\" : [true, \"b\"]}]"];
+	SMJJsonNode *node2 = [SMJValueNodes jsonNodeWithString:@"[1.0, {\"a\" : [true, \"b\"]}]"];
+	SMJJsonNode *node3 = [SMJValueNodes jsonNodeWithString:@"[1, {\"a\" : [true, \"c\"]}]"];
+	SMJJsonNode *invalidNode = [SMJValueNodes jsonNodeWithString:@"[1,"];
+	
+	XCTAssertEqual([node1 isEqual:node2 withError:nil], SMJEqualitySame);
+	XCTAssertEqual([node1 isEqual:node3 withError:nil], SMJEqualityDiffer);
+	XCTAssertEqual([node1 compare:node2 withError:nil], SMJComparisonSame);
+	XCTAssertEqual([node1 compare:node3 withError:nil], SMJComparisonDiffer);
+	XCTAssertEqual([node1 isEqual:invalidNode withError:nil], SMJEqualityError);
+	XCTAssertEqual([node1 isEqual:[SMJValueNodes stringNodeWithString:@"[1]" escape:NO] withError:nil], SMJEqualityDiffer);
+}
+
+- (void)test_json_equality_filters
+{
+	NSDictionary *json = @{ @"items" : @[ @{ @"id" : @1, @"tags" : @[ @"a", @"b" ] }, @{ @"id" : @2, @"tags" : @[ @"b", @"a" ] }, @{ @"id" : @3, @"tags" : @{ @"a" : @1 } } ] };
+	
+	[self checkResultForJSONObject:json jsonPathString:@"$.items[?(@.tags == [\"a\", \"b\"])].id" expectedResult:@[ @1 ]];
+	[self checkResultForJSONObject:json jsonPathString:@"$.items[?(@.tags != [\"a\", \"b\"])].id" expectedResult:@[ @2, @3 ]];
+	[self checkResultForJSONObject:json jsonPathString:@"$.items[?(@.tags === {\"a\" : 1})].id" expectedResult:@[ @3 ]];
+}
+
+- (void)test_json_equality_performance
+{
+	NSMutableArray *items = [NSMutableArray array];
+	
+	for (NSUInteger i = 0; i < 50000; i++)
+		[items addObject:@{ @"point" : @{ @"x" : @(i % 100), @"y" : @(i % 7), @"labels" : @[ @"p", @(i % 3) ] } }];
+	
+	NSDictionary	*json = @{ @"items" : items };
+	SMJJSONPath		*jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.items[?(@.point == {\"x\" : 42, \"y\" : 0, \"labels\" : [\"p\", 0]})]" error:nil];
+	
+	[self measureBlock:^{
+		[jsonPath resultForJSONObject:json configuration:nil error:nil];
+	}];
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,140 @@
+/*
+ * SMJMembershipOperatorTest.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <XCTest/XCTest.h>
+
+#import "SMJCommonTest.h"
+
+#import "SMJValueNodes.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** SMJMembershipOperatorTest
+*/
+#pragma mark - SMJMembershipOperatorTest
+
+@interface SMJMembershipOperatorTest : SMJCommonTest
+{
+	NSDictionary	*_catalog;
+	NSString		*_skuList;
+}
+
+@end
+
+@implementation SMJMembershipOperatorTest
+
+- (void)setUp
+{
+	[super setUp];
+	
+	// 20000 items, each one with a sku and two tags.
+	NSMutableArray *items = [NSMutableArray array];
+	
+	for (NSUInteger i = 0; i < 20000; i++)
+	{
+		NSUInteger tag = i % 10;
+		
+		[items addObject:@{
+			@"sku" : [NSString stringWithFormat:@"sku-%lu", (unsigned long)i],
+			@"tags" : @[ [NSString stringWithFormat:@"t%lu", (unsigned long)tag], [NSString stringWithFormat:@"t%lu", (unsigned long)tag + 1] ],
+		}];
+	}
+	
+	_catalog = @{ @"items" : items, @"allowed" : @[ @"t0", @"t1", @"t2", @"t3" ] };
+	
+	// 5000 literals: the even skus of the first half.
+	NSMutableArray *skus = [NSMutableArray array];
+	
+	for (NSUInteger i = 0; i < 10000; i += 2)
+		[skus addObject:[NSString stringWithFormat:@"\"sku-%lu\"", (unsigned long)i]];
+	
+	_skuList = [NSString stringWithFormat:@"[%@]", [skus componentsJoinedByString:@", "]];
+}
+
+
+/*
+** SMJMembershipOperatorTest - Tests
+*/
+#pragma mark - SMJMembershipOperatorTest - Tests
+
+- (void)test_literal_array_items
+{
+	SMJJsonNode *node = [SMJValueNodes jsonNodeWithString:@"[1, \"a\", null, [2], 1.0]"];
+	
+	XCTAssertEqual(node.arrayItems.count, 4);
+	XCTAssertTrue([node.arrayItems containsObject:@1]);
+	XCTAssertTrue([node.arrayItems containsObject:@"a"]);
+	XCTAssertTrue([node.arrayItems containsObject:[NSNull null]]);
+	XCTAssertTrue([node.arrayItems containsObject:@[ @2 ]]);
+	
+	XCTAssertNil([SMJValueNodes jsonNodeWithString:@"{ \"a\" : 1 }"].arrayItems);
+}
+
+- (void)test_membership_results
+{
+	[self checkResultForJSONObject:_catalog jsonPathString:[NSString stringWithFormat:@"$.items[?(@.sku IN %@)].sku", _skuList] expectedCount:5000];
+	[self checkResultForJSONObject:_catalog jsonPathString:[NSString stringWithFormat:@"$.items[?(@.sku NIN %@)].sku", _skuList] expectedCount:15000];
+	
+	[self checkResultForJSONObject:_catalog jsonPathString:@"$.items[?(@.tags SUBSETOF [\"t0\", \"t1\", \"t2\", \"t3\"])]" expectedCount:6000];
+	[self checkResultForJSONObject:_catalog jsonPathString:@"$.items[?(@.tags SUBSETOF $.allowed)]" expectedCount:6000];
+	[self checkResultForJSONObject:_catalog jsonPathString:@"$.items[?(@.tags ANYOF [\"t0\"])]" expectedCount:2000];
+	[self checkResultForJSONObject:_catalog jsonPathString:@"$.items[?(@.tags NONEOF [\"t0\"])]" expectedCount:18000];
+	[self checkResultForJSONObject:_catalog jsonPathString:@"$.items[?(@.tags ALL [\"t1\", \"t2\"])]" expectedCount:2000];
+	[self checkResultForJSONObject:_catalog jsonPathString:@"$.items[?(@.tags CONTAINS \"t3\")]" expectedCount:4000];
+}
+
+- (void)test_membership_number_equality
+{
+	NSDictionary *json = @{ @"values" : @[ @{ @"v" : @1 }, @{ @"v" : @2.0 }, @{ @"v" : @3.5 }, @{ @"v" : @"1" } ] };
+	
+	// Numbers are equal whatever their representation, but never equal to strings.
+	[self checkResultForJSONObject:json jsonPathString:@"$.values[?(@.v IN [1.0, 2, 10, 11, 12, 13, 14, 15, 16, 17])].v" expectedResult:@[ @1, @2.0 ]];
+}
+
+- (void)test_in_large_literal_list_performance
+{
+	SMJJSONPath *jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:[NSString stringWithFormat:@"$.items[?(@.sku IN %@)].sku", _skuList] error:nil];
+	
+	[self measureBlock:^{
+		[jsonPath resultForJSONObject:self->_catalog configuration:nil error:nil];
+	}];
+}
+
+- (void)test_subsetof_evaluated_array_performance
+{
+	NSMutableArray *allowed = [NSMutableArray array];
+	
+	for (NSUInteger i = 0; i < 1000; i++)
+		[allowed addObject:[NSString stringWithFormat:@"t%lu", (unsigned long)i]];
+	
+	NSDictionary	*catalog = @{ @"items" : _catalog[@"items"], @"allowed" : allowed };
+	SMJJSONPath		*jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.items[?(@.tags SUBSETOF $.allowed)]" error:nil];
+	
+	[self measureBlock:^{
+		[jsonPath resultForJSONObject:catalog configuration:nil error:nil];
+	}];
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,175 @@
+/*
+ * SMJNumericAggregationTest.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <XCTest/XCTest.h>
+
+#import "SMJCommonTest.h"
+
+#import "SMJNumericAggregation.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** SMJNumericAggregationTest
+*/
+#pragma mark - SMJNumericAggregationTest
+
+@interface SMJNumericAggregationTest : SMJCommonTest
+{
+	NSDictionary *_metrics;
+}
+
+@end
+
+@implementation SMJNumericAggregationTest
+
+- (void)setUp
+{
+	[super setUp];
+	
+	NSMutableArray *samples = [NSMutableArray array];
+	
+	srand48(42);
+	
+	for (NSUInteger i = 0; i < 200000; i++)
+		[samples addObject:@{ @"value" : @(drand48() * 1000.0) }];
+	
+	_metrics = @{ @"metrics" : samples };
+}
+
+
+/*
+** SMJNumericAggregationTest - Tests
+*/
+#pragma mark - SMJNumericAggregationTest - Tests
+
+- (void)test_kernel_matches_reference
+{
+	srand48(7);
+	
+	for (NSUInteger count = 1; count < 300; count += 7)
+	{
+		double *values = malloc(count * sizeof(double));
+		
+		long double	sum = 0.0;
+		double		min = INFINITY, max = -INFINITY;
+		
+		for (NSUInteger i = 0; i < count; i++)
+		{
+			values[i] = (drand48() - 0.5) * 2000.0;
+			
+			sum += values[i];
+			min = MIN(min, values[i]);
+			max = MAX(max, values[i]);
+		}
+		
+		long double mean = sum / count;
+		long double squares = 0.0;
+		
+		for (NSUInteger i = 0; i < count; i++)
+			squares += (values[i] - mean) * (values[i] - mean);
+		
+		SMJNumericAggregates aggregates = SMJNumericAggregate(values, count, YES);
+		
+		XCTAssertEqual(aggregates.count, count);
+		XCTAssertEqualWithAccuracy(aggregates.sum, (double)sum, 1e-9 * count * 1000.0);
+		XCTAssertEqual(aggregates.min, min);
+		XCTAssertEqual(aggregates.max, max);
+		XCTAssertEqualWithAccuracy(aggregates.variance, (double)(squares / count), 1e-6);
+		
+		free(values);
+	}
+}
+
+- (void)test_buffer_skips_non_numbers
+{
+	SMJNumericBuffer buffer;
+	
+	SMJNumericBufferInit(&buffer);
+	
+	for (NSUInteger i = 0; i < 100; i++)
+		SMJNumericBufferAppendNumbers(&buffer, @[ @1, @"2", [NSNull null], @3.5, @{ } ]);
+	
+	XCTAssertEqual(buffer.count, 200);
+	XCTAssertEqual(buffer.values[198], 1.0);
+	XCTAssertEqual(buffer.values[199], 3.5);
+	
+	SMJNumericBufferFree(&buffer);
+}
+
+- (void)test_stable_standard_deviation
+{
+	// Large values with a small spread: the sum of squares formula lose all the significant digits here.
+	NSDictionary *json = @{ @"values" : @[ @1000000004.0, @1000000007.0, @1000000013.0, @1000000016.0 ] };
+	
+	NSNumber *stddev = [self checkResultForJSONObject:json jsonPathString:@"$.values.stddev()" expectedError:NO];
+	NSNumber *avg = [self checkResultForJSONObject:json jsonPathString:@"$.values.avg()" expectedError:NO];
+	
+	XCTAssertEqualWithAccuracy(stddev.doubleValue, sqrt(22.5), 1e-9);
+	XCTAssertEqualWithAccuracy(avg.doubleValue, 1000000010.0, 1e-9);
+}
+
+- (void)test_aggregation_results
+{
+	NSDictionary *json = @{ @"values" : @[ @3, @"skip", @-2, @8.5, [NSNull null], @1 ] };
+	
+	[self checkResultForJSONObject:json jsonPathString:@"$.values.sum()" expectedResult:@10.5];
+	[self checkResultForJSONObject:json jsonPathString:@"$.values.min()" expectedResult:@-2.0];
+	[self checkResultForJSONObject:json jsonPathString:@"$.values.max()" expectedResult:@8.5];
+	[self checkResultForJSONObject:json jsonPathString:@"$.values.avg()" expectedResult:@2.625];
+	[self checkResultForJSONObject:json jsonPathString:@"$.values.max(20, $.values[0])" expectedResult:@20.0];
+}
+
+- (void)test_aggregation_performance
+{
+	SMJJSONPath *jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.metrics[*].value.avg()" error:nil];
+	
+	[self measureBlock:^{
+		[jsonPath resultForJSONObject:self->_metrics configuration:nil error:nil];
+	}];
+}
+
+- (void)test_boxed_aggregation_reference_performance
+{
+	// Reference: the path selection, then the previous one-message-per-value aggregation.
+	SMJJSONPath *jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.metrics[*].value" error:nil];
+	
+	[self measureBlock:^{
+		NSArray			*values = [jsonPath resultForJSONObject:self->_metrics configuration:nil error:nil];
+		__block double	summation = 0.0;
+		__block double	count = 0.0;
+		
+		[values enumerateObjectsUsingBlock:^(id _Nonnull obj, NSUInteger idx, BOOL * _Nonnull stop) {
+			if ([obj isKindOfClass:[NSNumber class]] == NO)
+				return;
+			
+			summation += [obj doubleValue];
+			count++;
+		}];
+		
+		XCTAssertGreaterThan(summation / count, 0.0);
+	}];
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
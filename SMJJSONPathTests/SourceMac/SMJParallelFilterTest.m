@@ -0,0 +1,232 @@
+/*
+ * SMJParallelFilterTest.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <XCTest/XCTest.h>
+
+#import "SMJCommonTest.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** Globals
+*/
+#pragma mark - Globals
+
+static NSUInteger gFilterLookupCount = 0;
+
+
+
+/*
+** SMJFilterCountingDictionary
+*/
+#pragma mark - SMJFilterCountingDictionary
+
+// Dictionary counting the lookups done by the evaluation, from any thread.
+@interface SMJFilterCountingDictionary : NSDictionary
+@end
+
+@implementation SMJFilterCountingDictionary
+{
+	NSDictionary *_storage;
+}
+
+- (instancetype)initWithObjects:(const id _Nonnull [_Nullable])objects forKeys:(const id <NSCopying> _Nonnull [_Nullable])keys count:(NSUInteger)count
+{
+	self = [super init];
+	
+	if (self)
+		_storage = [[NSDictionary alloc] initWithObjects:objects forKeys:keys count:count];
+	
+	return self;
+}
+
+- (NSUInteger)count
+{
+	return _storage.count;
+}
+
+- (nullable id)objectForKey:(id)key
+{
+	__atomic_add_fetch(&gFilterLookupCount, 1, __ATOMIC_RELAXED);
+	return [_storage objectForKey:key];
+}
+
+- (NSEnumerator *)keyEnumerator
+{
+	return [_storage keyEnumerator];
+}
+
+@end
+
+
+
+/*
+** SMJParallelFilterTest
+*/
+#pragma mark - SMJParallelFilterTest
+
+@interface SMJParallelFilterTest : SMJCommonTest
+{
+	NSDictionary *_shop;
+}
+
+@end
+
+@implementation SMJParallelFilterTest
+
+- (void)setUp
+{
+	[super setUp];
+	
+	NSMutableArray *orders = [NSMutableArray array];
+	
+	for (NSUInteger i = 0; i < 100000; i++)
+	{
+		[orders addObject:@{
+			@"id" : @(i),
+			@"total" : @((i * 7919) % 500),
+			@"status" : (i % 3 == 0 ? @"open" : @"closed"),
+			@"customer" : @{ @"name" : [NSString stringWithFormat:@"customer-%lu", (unsigned long)(i % 1000)], @"vip" : @(i % 11 == 0) },
+		}];
+	}
+	
+	_shop = @{ @"threshold" : @250, @"vip" : @"customer-42", @"orders" : orders };
+}
+
+
+/*
+** SMJParallelFilterTest - Tests
+*/
+#pragma mark - SMJParallelFilterTest - Tests
+
+- (void)test_parallel_filter_matches_sequential_filter
+{
+	NSArray *pathStrings = @[
+		@"$.orders[?(@.total > 100 && @.status == 'open')].id",
+		@"$.orders[?(@.total > $.threshold)]",
+		@"$.orders[?(@.customer.name == $.vip || @.customer.vip == true)].total",
+		@"$.orders[?(@.status =~ /op.*/)].customer.name",
+		@"$.orders[?(@.missing)]",
+		@"$.orders[?(@.total > 100)].total.sum()",
+	];
+	
+	for (NSString *pathString in pathStrings)
+	{
+		SMJJSONPath *jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:pathString error:nil];
+		
+		for (NSNumber *option in @[ @(-1), @(SMJOptionAsPathList) ])
+		{
+			SMJConfiguration *sequential = (option.intValue < 0 ? [SMJConfiguration defaultConfiguration] : [SMJConfiguration configurationWithOption:(SMJOption)option.intValue]);
+			SMJConfiguration *parallel = [self parallelConfigurationWithConfiguration:sequential concurrency:0];
+			
+			id expected = [jsonPath resultForJSONObject:_shop configuration:sequential error:nil];
+			id result = [jsonPath resultForJSONObject:_shop configuration:parallel error:nil];
+			
+			XCTAssertEqualObjects(result, expected, @"%@", pathString);
+		}
+	}
+}
+
+- (void)test_parallel_filter_limit_and_update
+{
+	SMJJSONPath			*jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.orders[?(@.total > 490)]" error:nil];
+	SMJConfiguration	*parallel = [self parallelConfigurationWithConfiguration:[SMJConfiguration defaultConfiguration] concurrency:0];
+	
+	// Limit.
+	id expected = [jsonPath resultForJSONObject:_shop limit:10 configuration:nil error:nil];
+	id result = [jsonPath resultForJSONObject:_shop limit:10 configuration:parallel error:nil];
+	
+	XCTAssertEqual([result count], 10);
+	XCTAssertEqualObjects(result, expected);
+	
+	// Update.
+	NSData	*data = [NSJSONSerialization dataWithJSONObject:_shop options:0 error:nil];
+	id		mutableShop = [NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:nil];
+	
+	XCTAssertNotNil([jsonPath updateMutableJSONObject:mutableShop deleteWithConfiguration:parallel error:nil]);
+	
+	[self checkResultForJSONObject:mutableShop jsonPathString:@"$.orders[?(@.total > 490)]" expectedCount:0];
+	[self checkResultForJSONObject:mutableShop jsonPathString:@"$.orders[?(@.total <= 490)]" expectedCount:[[_shop[@"orders"] valueForKey:@"total"] filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"SELF <= 490"]].count];
+}
+
+- (void)test_parallel_filter_first_match
+{
+	NSMutableArray *items = [NSMutableArray array];
+	
+	for (NSUInteger i = 0; i < 10000; i++)
+		[items addObject:[[SMJFilterCountingDictionary alloc] initWithObjectsAndKeys:@(i), @"id", nil]];
+	
+	SMJJSONPath			*jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.items[?(@.id == 10)].id" error:nil];
+	SMJConfiguration	*parallel = [self parallelConfigurationWithConfiguration:[SMJConfiguration defaultConfiguration] concurrency:0];
+	
+	gFilterLookupCount = 0;
+	
+	// Limited evaluations don't filter the items ahead of the matches.
+	XCTAssertEqualObjects([jsonPath firstResultForJSONObject:@{ @"items" : items } configuration:parallel error:nil], @10);
+	XCTAssertLessThan(gFilterLookupCount, 100);
+}
+
+
+/*
+** SMJParallelFilterTest - Performance
+*/
+#pragma mark - SMJParallelFilterTest - Performance
+
+- (void)test_filter_performance_sequential
+{
+	[self measureFilterWithConfiguration:[SMJConfiguration defaultConfiguration]];
+}
+
+- (void)test_filter_performance_parallel
+{
+	[self measureFilterWithConfiguration:[self parallelConfigurationWithConfiguration:[SMJConfiguration defaultConfiguration] concurrency:0]];
+}
+
+
+/*
+** SMJParallelFilterTest - Helpers
+*/
+#pragma mark - SMJParallelFilterTest - Helpers
+
+- (SMJConfiguration *)parallelConfigurationWithConfiguration:(SMJConfiguration *)configuration concurrency:(NSUInteger)concurrency
+{
+	SMJConfiguration *result = [configuration mutableCopy];
+	
+	result.parallelFilterThreshold = 1000;
+	result.parallelConcurrency = concurrency;
+	
+	return result;
+}
+
+- (void)measureFilterWithConfiguration:(SMJConfiguration *)configuration
+{
+	SMJJSONPath *jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.orders[?(@.total > 100 && @.status == 'open')].id" error:nil];
+	
+	[self measureBlock:^{
+		for (NSUInteger i = 0; i < 5; i++)
+			[jsonPath resultForJSONObject:self->_shop configuration:configuration error:nil];
+	}];
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
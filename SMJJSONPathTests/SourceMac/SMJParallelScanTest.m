@@ -0,0 +1,268 @@
+/*
+ * SMJParallelScanTest.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <XCTest/XCTest.h>
+
+#import "SMJCommonTest.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** SMJPathRecorder
+*/
+#pragma mark - SMJPathRecorder
+
+@interface SMJPathRecorder : NSObject <SMJEvaluationListener>
+@property (readonly) NSMutableArray <NSString *> *paths;
+@property NSUInteger abortAfter; // 0 for never.
+@end
+
+@implementation SMJPathRecorder
+
+- (instancetype)init
+{
+	self = [super init];
+	
+	if (self)
+		_paths = [NSMutableArray array];
+	
+	return self;
+}
+
+- (SMJEvaluationContinuation)resultFound:(id <SMJFoundResult>)found
+{
+	[_paths addObject:found.path];
+	
+	if (_abortAfter > 0 && _paths.count >= _abortAfter)
+		return SMJEvaluationContinuationAbort;
+	
+	return SMJEvaluationContinuationContinue;
+}
+
+@end
+
+
+
+/*
+** SMJParallelScanTest
+*/
+#pragma mark - SMJParallelScanTest
+
+@interface SMJParallelScanTest : SMJCommonTest
+{
+	NSDictionary *_store;
+}
+
+@end
+
+@implementation SMJParallelScanTest
+
+- (void)setUp
+{
+	[super setUp];
+	
+	// Build a big store.
+	NSMutableArray		*books = [NSMutableArray array];
+	NSMutableDictionary	*shelves = [NSMutableDictionary dictionary];
+	
+	for (NSUInteger i = 0; i < 20000; i++)
+	{
+		[books addObject:@{
+			@"title" : [NSString stringWithFormat:@"title-%lu", (unsigned long)i],
+			@"price" : @(i % 50),
+			@"tags" : @[ @"a", @"b", @{ @"price" : @(i) } ],
+			@"details" : @{ @"pages" : @(i % 300), @"isbn" : @{ @"group" : @(i % 7) } },
+		}];
+	}
+	
+	for (NSUInteger i = 0; i < 2000; i++)
+		shelves[[NSString stringWithFormat:@"shelf-%lu", (unsigned long)i]] = @{ @"price" : @(i), @"books" : @[ @{ @"price" : @(i * 2) } ] };
+	
+	_store = @{ @"store" : @{ @"books" : books, @"shelves" : shelves } };
+}
+
+
+/*
+** SMJParallelScanTest - Tests
+*/
+#pragma mark - SMJParallelScanTest - Tests
+
+- (void)test_parallel_scan_matches_sequential_scan
+{
+	NSArray *pathStrings = @[
+		@"$..price",
+		@"$..isbn.group",
+		@"$..tags[2]",
+		@"$..tags[*]",
+		@"$..books[?(@.price > 45)].title",
+		@"$..[?(@.pages == 12)]",
+		@"$..missing",
+		@"$..price.sum()",
+	];
+	
+	for (NSString *pathString in pathStrings)
+	{
+		SMJJSONPath *jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:pathString error:nil];
+		
+		for (NSNumber *option in @[ @(-1), @(SMJOptionAsPathList) ])
+		{
+			SMJConfiguration *sequential = (option.intValue < 0 ? [SMJConfiguration defaultConfiguration] : [SMJConfiguration configurationWithOption:(SMJOption)option.intValue]);
+			SMJConfiguration *parallel = [self parallelConfigurationWithConfiguration:sequential concurrency:0];
+			
+			id expected = [jsonPath resultForJSONObject:_store configuration:sequential error:nil];
+			id result = [jsonPath resultForJSONObject:_store configuration:parallel error:nil];
+			
+			XCTAssertEqualObjects(result, expected, @"%@", pathString);
+		}
+	}
+}
+
+- (void)test_parallel_scan_listeners_order
+{
+	SMJJSONPath *jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$..price" error:nil];
+	
+	// Full.
+	SMJPathRecorder		*sequentialRecorder = [[SMJPathRecorder alloc] init];
+	SMJPathRecorder		*parallelRecorder = [[SMJPathRecorder alloc] init];
+	SMJConfiguration	*sequential = [SMJConfiguration defaultConfiguration];
+	SMJConfiguration	*parallel = [self parallelConfigurationWithConfiguration:sequential concurrency:0];
+	
+	[sequential addListener:sequentialRecorder];
+	[parallel addListener:parallelRecorder];
+	
+	XCTAssertNotNil([jsonPath resultForJSONObject:_store configuration:sequential error:nil]);
+	XCTAssertNotNil([jsonPath resultForJSONObject:_store configuration:parallel error:nil]);
+	
+	XCTAssertGreaterThan(sequentialRecorder.paths.count, 40000);
+	XCTAssertEqualObjects(parallelRecorder.paths, sequentialRecorder.paths);
+	
+	// Abort.
+	sequentialRecorder = [[SMJPathRecorder alloc] init];
+	parallelRecorder = [[SMJPathRecorder alloc] init];
+	
+	sequentialRecorder.abortAfter = 1234;
+	parallelRecorder.abortAfter = 1234;
+	
+	sequential.evaluationListeners = @[ sequentialRecorder ];
+	parallel.evaluationListeners = @[ parallelRecorder ];
+	
+	id expected = [jsonPath resultForJSONObject:_store configuration:sequential error:nil];
+	id result = [jsonPath resultForJSONObject:_store configuration:parallel error:nil];
+	
+	XCTAssertEqual([result count], 1234);
+	XCTAssertEqualObjects(result, expected);
+	XCTAssertEqualObjects(parallelRecorder.paths, sequentialRecorder.paths);
+}
+
+- (void)test_parallel_scan_limit
+{
+	SMJJSONPath			*jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$..details.pages" error:nil];
+	SMJConfiguration	*parallel = [self parallelConfigurationWithConfiguration:[SMJConfiguration defaultConfiguration] concurrency:0];
+	
+	id expected = [jsonPath resultForJSONObject:_store limit:100 configuration:nil error:nil];
+	id result = [jsonPath resultForJSONObject:_store limit:100 configuration:parallel error:nil];
+	
+	XCTAssertEqual([result count], 100);
+	XCTAssertEqualObjects(result, expected);
+}
+
+- (void)test_parallel_scan_update
+{
+	id					mutableStore = [self mutableCopyOfJSONObject:_store];
+	SMJJSONPath			*jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$..isbn" error:nil];
+	SMJConfiguration	*parallel = [self parallelConfigurationWithConfiguration:[SMJConfiguration defaultConfiguration] concurrency:0];
+	
+	XCTAssertNotNil([jsonPath updateMutableJSONObject:mutableStore deleteWithConfiguration:parallel error:nil]);
+	
+	[self checkResultForJSONObject:mutableStore jsonPathString:@"$..isbn" expectedCount:0];
+	[self checkResultForJSONObject:mutableStore jsonPathString:@"$..pages" expectedCount:20000];
+}
+
+
+/*
+** SMJParallelScanTest - Performance
+*/
+#pragma mark - SMJParallelScanTest - Performance
+
+// > Compare the results of the tests below to see how the scan scales with the number of workers.
+
+- (void)test_scan_performance_sequential
+{
+	[self measureScanWithConfiguration:[SMJConfiguration defaultConfiguration]];
+}
+
+- (void)test_scan_performance_1_worker
+{
+	[self measureScanWithConfiguration:[self parallelConfigurationWithConfiguration:[SMJConfiguration defaultConfiguration] concurrency:1]];
+}
+
+- (void)test_scan_performance_2_workers
+{
+	[self measureScanWithConfiguration:[self parallelConfigurationWithConfiguration:[SMJConfiguration defaultConfiguration] concurrency:2]];
+}
+
+- (void)test_scan_performance_4_workers
+{
+	[self measureScanWithConfiguration:[self parallelConfigurationWithConfiguration:[SMJConfiguration defaultConfiguration] concurrency:4]];
+}
+
+- (void)test_scan_performance_all_workers
+{
+	[self measureScanWithConfiguration:[self parallelConfigurationWithConfiguration:[SMJConfiguration defaultConfiguration] concurrency:0]];
+}
+
+
+/*
+** SMJParallelScanTest - Helpers
+*/
+#pragma mark - SMJParallelScanTest - Helpers
+
+- (SMJConfiguration *)parallelConfigurationWithConfiguration:(SMJConfiguration *)configuration concurrency:(NSUInteger)concurrency
+{
+	SMJConfiguration *result = [configuration mutableCopy];
+	
+	result.parallelScanThreshold = 64;
+	result.parallelConcurrency = concurrency;
+	
+	return result;
+}
+
+- (void)measureScanWithConfiguration:(SMJConfiguration *)configuration
+{
+	SMJJSONPath *jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$..books[?(@.price > 10)].details.isbn.group" error:nil];
+	
+	[self measureBlock:^{
+		for (NSUInteger i = 0; i < 5; i++)
+			[jsonPath resultForJSONObject:self->_store configuration:configuration error:nil];
+	}];
+}
+
+- (id)mutableCopyOfJSONObject:(id)jsonObject
+{
+	NSData *data = [NSJSONSerialization dataWithJSONObject:jsonObject options:0 error:nil];
+	
+	return [NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:nil];
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,141 @@
+/*
+ * SMJPathCacheTest.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <XCTest/XCTest.h>
+
+#import "SMJCommonTest.h"
+
+#import "SMJPathCache.h"
+#import "SMJPathCompiler.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** SMJPathCacheTest
+*/
+#pragma mark - SMJPathCacheTest
+
+@interface SMJPathCacheTest : SMJCommonTest
+@end
+
+@implementation SMJPathCacheTest
+
+- (void)test_cache_hit_and_miss
+{
+	SMJPathCache	*cache = [[SMJPathCache alloc] initWithCapacity:10];
+	id <SMJPath>	path = [SMJPathCompiler compilePathString:@"$.a.b" error:nil];
+	
+	XCTAssertNil([cache pathForKey:@"$.a.b"]);
+	XCTAssertEqual(cache.missCount, 1);
+	
+	[cache setPath:path forKey:@"$.a.b"];
+	
+	XCTAssertEqual([cache pathForKey:@"$.a.b"], path);
+	XCTAssertEqual(cache.hitCount, 1);
+	XCTAssertEqual(cache.count, 1);
+	
+	[cache purge];
+	
+	XCTAssertEqual(cache.count, 0);
+	XCTAssertNil([cache pathForKey:@"$.a.b"]);
+	XCTAssertEqual(cache.missCount, 2);
+}
+
+- (void)test_cache_evict_least_recently_used
+{
+	SMJPathCache *cache = [[SMJPathCache alloc] initWithCapacity:2];
+	
+	[cache setPath:[SMJPathCompiler compilePathString:@"$.a" error:nil] forKey:@"$.a"];
+	[cache setPath:[SMJPathCompiler compilePathString:@"$.b" error:nil] forKey:@"$.b"];
+	
+	// Touch $.a, so $.b become the least recently used.
+	XCTAssertNotNil([cache pathForKey:@"$.a"]);
+	
+	[cache setPath:[SMJPathCompiler compilePathString:@"$.c" error:nil] forKey:@"$.c"];
+	
+	XCTAssertEqual(cache.count, 2);
+	XCTAssertNotNil([cache pathForKey:@"$.a"]);
+	XCTAssertNil([cache pathForKey:@"$.b"]);
+	XCTAssertNotNil([cache pathForKey:@"$.c"]);
+	
+	// Reduce capacity.
+	cache.capacity = 1;
+	
+	XCTAssertEqual(cache.count, 1);
+	XCTAssertNotNil([cache pathForKey:@"$.c"]);
+	
+	// Disable.
+	cache.capacity = 0;
+	
+	[cache setPath:[SMJPathCompiler compilePathString:@"$.d" error:nil] forKey:@"$.d"];
+	
+	XCTAssertEqual(cache.count, 0);
+}
+
+- (void)test_shared_cache
+{
+	[SMJJSONPath purgeCache];
+	
+	NSUInteger hitCount = SMJJSONPath.cacheHitCount;
+	NSUInteger missCount = SMJJSONPath.cacheMissCount;
+	
+	XCTAssertNotNil([[SMJJSONPath alloc] initWithJSONPathString:@"$.store.book[?(@.price < 10)].title" error:nil]);
+	XCTAssertNotNil([[SMJJSONPath alloc] initWithJSONPathString:@"$.store.book[?(@.price < 10)].title" error:nil]);
+	XCTAssertNotNil([[SMJJSONPath alloc] initWithJSONPathString:@"  $.store.book[?(@.price < 10)].title  " error:nil]);
+	
+	XCTAssertEqual(SMJJSONPath.cacheMissCount - missCount, 1);
+	XCTAssertEqual(SMJJSONPath.cacheHitCount - hitCount, 2);
+	
+	// Invalid paths are not cached.
+	XCTAssertNil([[SMJJSONPath alloc] initWithJSONPathString:@"$.." error:nil]);
+	XCTAssertNil([[SMJJSONPath alloc] initWithJSONPathString:@"$.." error:nil]);
+	
+	XCTAssertEqual(SMJJSONPath.cacheMissCount - missCount, 3);
+}
+
+- (void)test_cached_function_path_with_distinct_documents
+{
+	// The compiled path is shared: parameters must be bound to each evaluation, not to the first one.
+	[self checkResultForJSONObject:@{ @"key" : @"first" } jsonPathString:@"concat(\"/\", $.key)" expectedResult:@"/first"];
+	[self checkResultForJSONObject:@{ @"key" : @"second" } jsonPathString:@"concat(\"/\", $.key)" expectedResult:@"/second"];
+	
+	[self checkResultForJSONObject:@{ @"items" : @[ @1, @2, @3 ] } jsonPathString:@"$..items.sum()" expectedResult:@6.0];
+	[self checkResultForJSONObject:@{ @"items" : @[ @10, @20 ] } jsonPathString:@"$..items.sum()" expectedResult:@30.0];
+}
+
+- (void)test_concurrent_access
+{
+	NSArray *pathStrings = @[ @"$.a", @"$.b", @"$.c[*]", @"$..d", @"$[?(@.e == 1)]" ];
+	
+	dispatch_apply(1000, dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0), ^(size_t iteration) {
+		SMJJSONPath *jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:pathStrings[iteration % pathStrings.count] error:nil];
+		
+		XCTAssertNotNil(jsonPath);
+		
+		if (iteration % 100 == 0)
+			[SMJJSONPath purgeCache];
+	});
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,196 @@
+/*
+ * SMJPathFunctionRegistrationTest.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <XCTest/XCTest.h>
+
+#import "SMJCommonTest.h"
+
+#import "SMJPathFunctionFactory.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** SMJProductTestFunction
+*/
+#pragma mark - SMJProductTestFunction
+
+@interface SMJProductTestFunction : NSObject <SMJPathFunction>
+@end
+
+@implementation SMJProductTestFunction
+
++ (BOOL)isShareable
+{
+	return YES;
+}
+
+- (nullable id)invokeWithCurrentPathString:(NSString *)currentPath parentPath:(SMJPathRef *)parentPath jsonObject:(id)jsonObject evaluationContext:(id <SMJEvaluationContext>)context parameters:(nullable NSArray <SMJParameter *> *)parameters error:(NSError **)error
+{
+	if ([jsonObject isKindOfClass:[NSArray class]] == NO)
+		return nil;
+	
+	double product = 1.0;
+	
+	for (id item in (NSArray *)jsonObject)
+	{
+		if ([item isKindOfClass:[NSNumber class]])
+			product *= [item doubleValue];
+	}
+	
+	NSArray *list = [SMJParameter listWithParameters:parameters evaluationContext:context itemsClass:[NSNumber class] error:error];
+	
+	if (!list)
+		return nil;
+	
+	for (NSNumber *number in list)
+		product *= number.doubleValue;
+	
+	return @(product);
+}
+
+@end
+
+
+
+/*
+** SMJPathTestFunction
+*/
+#pragma mark - SMJPathTestFunction
+
+// Keep the current path it's invoked with.
+static NSString *gCurrentPath = nil;
+
+@interface SMJPathTestFunction : NSObject <SMJPathFunction>
+@end
+
+@implementation SMJPathTestFunction
+
+- (nullable id)invokeWithCurrentPathString:(NSString *)currentPath parentPath:(SMJPathRef *)parentPath jsonObject:(id)jsonObject evaluationContext:(id <SMJEvaluationContext>)context parameters:(nullable NSArray <SMJParameter *> *)parameters error:(NSError **)error
+{
+	gCurrentPath = currentPath;
+	
+	return jsonObject;
+}
+
+@end
+
+
+
+/*
+** SMJPathFunctionRegistrationTest
+*/
+#pragma mark - SMJPathFunctionRegistrationTest
+
+@interface SMJPathFunctionRegistrationTest : SMJCommonTest
+@end
+
+@implementation SMJPathFunctionRegistrationTest
+
++ (void)setUp
+{
+	[super setUp];
+	
+	[SMJPathFunctionFactory registerPathFunctionClass:[SMJProductTestFunction class] forName:@"product" error:nil];
+	[SMJPathFunctionFactory registerPathFunctionClass:[SMJPathTestFunction class] forName:@"currentPath" error:nil];
+}
+
+
+/*
+** SMJPathFunctionRegistrationTest - Tests
+*/
+#pragma mark - SMJPathFunctionRegistrationTest - Tests
+
+- (void)test_registered_function
+{
+	NSDictionary *json = @{ @"numbers" : @[ @1, @2, @3, @4 ], @"factor" : @10 };
+	
+	[self checkResultForJSONObject:json jsonPathString:@"$.numbers.product()" expectedResult:@24.0];
+	[self checkResultForJSONObject:json jsonPathString:@"$.numbers.product(2, $.factor)" expectedResult:@480.0];
+	[self checkResultForJSONObject:json jsonPathString:@"$.numbers.append(5).product()" expectedResult:@120.0];
+}
+
+- (void)test_current_path
+{
+	NSDictionary	*json = @{ @"numbers" : @[ @1, @2 ] };
+	SMJJSONPath		*jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.numbers.currentPath()" error:nil];
+	
+	// Rendered only if the evaluation reports paths.
+	XCTAssertNotNil([jsonPath resultForJSONObject:json configuration:nil error:nil]);
+	XCTAssertEqualObjects(gCurrentPath, @"");
+	
+	XCTAssertNotNil([jsonPath resultForJSONObject:json configuration:[SMJConfiguration configurationWithOption:SMJOptionAsPathList] error:nil]);
+	XCTAssertEqualObjects(gCurrentPath, @"$['numbers']");
+}
+
+- (void)test_registration_errors
+{
+	NSError *error = nil;
+	
+	// Built-in names can't be replaced.
+	XCTAssertFalse([SMJPathFunctionFactory registerPathFunctionClass:[SMJProductTestFunction class] forName:@"sum" error:&error]);
+	XCTAssertNotNil(error);
+	
+	// Names can be registered only once.
+	error = nil;
+	
+	XCTAssertFalse([SMJPathFunctionFactory registerPathFunctionClass:[SMJProductTestFunction class] forName:@"product" error:&error]);
+	XCTAssertNotNil(error);
+	
+	// Classes have to be path functions.
+	error = nil;
+	
+	XCTAssertFalse([SMJPathFunctionFactory registerPathFunctionClass:[NSObject class] forName:@"object" error:&error]);
+	XCTAssertNotNil(error);
+	
+	// Unknown function still fail on evaluation.
+	[self checkResultForJSONObject:@{ @"numbers" : @[ @1 ] } jsonPathString:@"$.numbers.unknown()" expectedError:YES];
+}
+
+- (void)test_resolved_classes
+{
+	XCTAssertEqualObjects([SMJPathFunctionFactory pathFunctionClassForName:@"product" error:nil], [SMJProductTestFunction class]);
+	XCTAssertNotNil([SMJPathFunctionFactory pathFunctionClassForName:@"length" error:nil]);
+	XCTAssertNil([SMJPathFunctionFactory pathFunctionClassForName:@"unknown" error:nil]);
+}
+
+- (void)test_function_performance
+{
+	NSMutableArray *documents = [NSMutableArray array];
+	
+	for (NSUInteger i = 0; i < 10000; i++)
+		[documents addObject:@{ @"items" : @[ @(i), @(i + 1), @(i + 2) ] }];
+	
+	SMJJSONPath *lengthPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.items.length()" error:nil];
+	SMJJSONPath *sumPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.items.sum()" error:nil];
+	
+	[self measureBlock:^{
+		for (NSDictionary *document in documents)
+		{
+			[lengthPath resultForJSONObject:document configuration:nil error:nil];
+			[sumPath resultForJSONObject:document configuration:nil error:nil];
+		}
+	}];
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
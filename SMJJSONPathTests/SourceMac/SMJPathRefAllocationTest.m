@@ -0,0 +1,184 @@
+/*
+ * SMJPathRefAllocationTest.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <XCTest/XCTest.h>
+#import <objc/runtime.h>
+
+#import "SMJCommonTest.h"
+
+#import "SMJPathRef.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** Globals
+*/
+#pragma mark - Globals
+
+static NSUInteger gPathRefCount = 0;
+
+
+
+/*
+** SMJPathRefAllocationTest
+*/
+#pragma mark - SMJPathRefAllocationTest
+
+@interface SMJPathRefAllocationTest : SMJCommonTest
+{
+	NSDictionary *_library;
+	
+	NSMutableArray <NSValue *> *_originalImplementations;
+}
+
+@end
+
+@implementation SMJPathRefAllocationTest
+
+- (void)setUp
+{
+	[super setUp];
+	
+	// Build a document with a lot of nodes, but few authors.
+	NSMutableArray *shelves = [NSMutableArray array];
+	
+	for (NSUInteger shelfIndex = 0; shelfIndex < 200; shelfIndex++)
+	{
+		NSMutableArray *books = [NSMutableArray array];
+		
+		for (NSUInteger bookIndex = 0; bookIndex < 50; bookIndex++)
+		{
+			NSMutableDictionary *book = [@{
+				@"title" : [NSString stringWithFormat:@"title-%lu-%lu", (unsigned long)shelfIndex, (unsigned long)bookIndex],
+				@"price" : @(bookIndex),
+				@"tags" : @[ @"a", @"b", @"c", @"d" ],
+				@"isbn" : @{ @"prefix" : @978, @"group" : @2, @"publisher" : @(shelfIndex) },
+			} mutableCopy];
+			
+			if (bookIndex == 0)
+				book[@"author"] = [NSString stringWithFormat:@"author-%lu", (unsigned long)shelfIndex];
+			
+			[books addObject:book];
+		}
+		
+		[shelves addObject:@{ @"books" : books }];
+	}
+	
+	_library = @{ @"shelves" : shelves };
+	
+	// Count path refs creation.
+	gPathRefCount = 0;
+	_originalImplementations = [NSMutableArray array];
+	
+	[self countCallsOfSelector:@selector(pathRefWithObject:property:)];
+	[self countCallsOfSelector:@selector(pathRefWithObject:properties:)];
+	[self countCallsOfSelector:@selector(pathRefWithObject:index:)];
+}
+
+- (void)tearDown
+{
+	NSArray *selectors = @[ NSStringFromSelector(@selector(pathRefWithObject:property:)), NSStringFromSelector(@selector(pathRefWithObject:properties:)), NSStringFromSelector(@selector(pathRefWithObject:index:)) ];
+	
+	[selectors enumerateObjectsUsingBlock:^(NSString * _Nonnull selector, NSUInteger idx, BOOL * _Nonnull stop) {
+		Method method = class_getClassMethod([SMJPathRef class], NSSelectorFromString(selector));
+		
+		method_setImplementation(method, (IMP)[self->_originalImplementations[idx] pointerValue]);
+	}];
+	
+	[super tearDown];
+}
+
+
+/*
+** SMJPathRefAllocationTest - Tests
+*/
+#pragma mark - SMJPathRefAllocationTest - Tests
+
+- (void)test_read_only_scan_allocate_no_path_ref
+{
+	NSArray *result = [self checkResultForJSONObject:_library jsonPathString:@"$..author" expectedCount:200];
+	
+	XCTAssertEqual(result.count, 200);
+	XCTAssertEqual(gPathRefCount, 0);
+}
+
+- (void)test_read_only_tokens_allocate_no_path_ref
+{
+	[self checkResultForJSONObject:_library jsonPathString:@"$.shelves[*].books[0:10].title" expectedCount:2000];
+	[self checkResultForJSONObject:_library jsonPathString:@"$.shelves[1,2,-1].books[?(@.price > 45)].isbn.*" expectedCount:36];
+	[self checkResultForJSONObject:_library jsonPathString:@"$..books[?(@.author)]['title', 'price']" expectedCount:200];
+	
+	XCTAssertEqual(gPathRefCount, 0);
+}
+
+- (void)test_update_scan_still_allocate_path_refs
+{
+	SMJJSONPath	*jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$..author" error:nil];
+	id			mutableLibrary = [self jsonObjectFromString:[self stringFromJSONObject:_library] options:NSJSONReadingMutableContainers];
+	
+	XCTAssertNotNil([jsonPath updateMutableJSONObject:mutableLibrary setObject:@"anonymous" configuration:nil error:nil]);
+	XCTAssertGreaterThan(gPathRefCount, 0);
+	
+	[self checkResultForJSONObject:mutableLibrary jsonPathString:@"$.shelves[7].books[0].author" expectedResult:@"anonymous"];
+}
+
+- (void)test_read_only_scan_performance
+{
+	SMJJSONPath *jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$..author" error:nil];
+	
+	[self measureBlock:^{
+		for (NSUInteger i = 0; i < 10; i++)
+			[jsonPath resultForJSONObject:self->_library configuration:nil error:nil];
+	}];
+}
+
+
+/*
+** SMJPathRefAllocationTest - Helpers
+*/
+#pragma mark - SMJPathRefAllocationTest - Helpers
+
+- (void)countCallsOfSelector:(SEL)selector
+{
+	Method	method = class_getClassMethod([SMJPathRef class], selector);
+	IMP		original = method_getImplementation(method);
+	
+	[_originalImplementations addObject:[NSValue valueWithPointer:(const void *)original]];
+	
+	IMP counting = imp_implementationWithBlock(^ id (id receiver, id object, id other) {
+		gPathRefCount++;
+		return ((id (*)(id, SEL, id, id))original)(receiver, selector, object, other);
+	});
+	
+	method_setImplementation(method, counting);
+}
+
+- (NSString *)stringFromJSONObject:(id)jsonObject
+{
+	NSData *data = [NSJSONSerialization dataWithJSONObject:jsonObject options:0 error:nil];
+	
+	return [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,91 @@
+/*
+ * SMJPublicPathFunctionTest.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <XCTest/XCTest.h>
+
+// Only the umbrella header: custom functions have to be written against the public API.
+#import <SMJJSONPath/SMJJSONPath.h>
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** SMJScaleTestFunction
+*/
+#pragma mark - SMJScaleTestFunction
+
+@interface SMJScaleTestFunction : NSObject <SMJPathFunction>
+@end
+
+@implementation SMJScaleTestFunction
+
++ (BOOL)isShareable
+{
+	return YES;
+}
+
+- (nullable id)invokeWithCurrentPathString:(NSString *)currentPath parentPath:(SMJPathRef *)parentPath jsonObject:(id)jsonObject evaluationContext:(id <SMJEvaluationContext>)context parameters:(nullable NSArray <SMJParameter *> *)parameters error:(NSError **)error
+{
+	if ([jsonObject isKindOfClass:[NSNumber class]] == NO || parameters.count != 1)
+		return nil;
+	
+	id factor = [parameters.firstObject valueWithEvaluationContext:context error:error];
+	
+	if ([factor isKindOfClass:[NSNumber class]] == NO)
+		return nil;
+	
+	return @([jsonObject doubleValue] * [factor doubleValue]);
+}
+
+@end
+
+
+
+/*
+** SMJPublicPathFunctionTest
+*/
+#pragma mark - SMJPublicPathFunctionTest
+
+@interface SMJPublicPathFunctionTest : XCTestCase
+@end
+
+@implementation SMJPublicPathFunctionTest
+
+- (void)test_register_with_public_headers
+{
+	NSError *error = nil;
+	
+	XCTAssertTrue([SMJPathFunctionFactory registerPathFunctionClass:[SMJScaleTestFunction class] forName:@"scale" error:&error]);
+	XCTAssertNil(error);
+	
+	NSDictionary	*json = @{ @"price" : @4, @"factor" : @2.5 };
+	SMJJSONPath		*jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.price.scale($.factor)" error:nil];
+	
+	XCTAssertEqualObjects([jsonPath resultForJSONObject:json configuration:nil error:nil], @10.0);
+	
+	jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.price.scale(3)" error:nil];
+	
+	XCTAssertEqualObjects([jsonPath resultForJSONObject:json configuration:nil error:nil], @12.0);
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,222 @@
+/*
+ * SMJResultLimitTest.m
+ *
+ * Copyright 2020 Avérous Julien-Pierre
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#import <XCTest/XCTest.h>
+
+#import "SMJCommonTest.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+
+/*
+** Globals
+*/
+#pragma mark - Globals
+
+static NSUInteger gLookupCount = 0;
+
+
+
+/*
+** SMJCountingDictionary
+*/
+#pragma mark - SMJCountingDictionary
+
+// Dictionary counting the lookups done by the evaluation.
+@interface SMJCountingDictionary : NSDictionary
+@end
+
+@implementation SMJCountingDictionary
+{
+	NSDictionary *_storage;
+}
+
+- (instancetype)initWithObjects:(const id _Nonnull [_Nullable])objects forKeys:(const id <NSCopying> _Nonnull [_Nullable])keys count:(NSUInteger)count
+{
+	self = [super init];
+	
+	if (self)
+		_storage = [[NSDictionary alloc] initWithObjects:objects forKeys:keys count:count];
+	
+	return self;
+}
+
+- (NSUInteger)count
+{
+	return _storage.count;
+}
+
+- (nullable id)objectForKey:(id)key
+{
+	gLookupCount++;
+	return [_storage objectForKey:key];
+}
+
+- (NSEnumerator *)keyEnumerator
+{
+	return [_storage keyEnumerator];
+}
+
+@end
+
+
+
+/*
+** SMJResultCounter
+*/
+#pragma mark - SMJResultCounter
+
+@interface SMJResultCounter : NSObject <SMJEvaluationListener>
+@property NSUInteger count;
+@end
+
+@implementation SMJResultCounter
+
+- (SMJEvaluationContinuation)resultFound:(id <SMJFoundResult>)found
+{
+	self.count++;
+	return SMJEvaluationContinuationContinue;
+}
+
+@end
+
+
+
+/*
+** SMJResultLimitTest
+*/
+#pragma mark - SMJResultLimitTest
+
+@interface SMJResultLimitTest : SMJCommonTest
+{
+	NSDictionary *_document;
+}
+
+@end
+
+@implementation SMJResultLimitTest
+
+- (void)setUp
+{
+	[super setUp];
+	
+	NSMutableArray *items = [NSMutableArray array];
+	
+	for (NSUInteger i = 0; i < 10000; i++)
+		[items addObject:[[SMJCountingDictionary alloc] initWithObjectsAndKeys:@(i), @"id", @(i % 100), @"group", nil]];
+	
+	_document = @{ @"items" : items };
+	
+	gLookupCount = 0;
+}
+
+
+/*
+** SMJResultLimitTest - Tests
+*/
+#pragma mark - SMJResultLimitTest - Tests
+
+- (void)test_limit_indefinite_paths
+{
+	for (NSString *pathString in @[ @"$..id", @"$.items[*].id", @"$.items[?(@.group == 7)].id" ])
+	{
+		SMJJSONPath	*jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:pathString error:nil];
+		NSArray		*all = [jsonPath resultForJSONObject:_document configuration:nil error:nil];
+		NSArray		*limited = [jsonPath resultForJSONObject:_document limit:3 configuration:nil error:nil];
+		
+		XCTAssertEqualObjects(limited, [all subarrayWithRange:NSMakeRange(0, 3)], @"invalid limited result for %@", pathString);
+		XCTAssertEqualObjects([jsonPath resultForJSONObject:_document limit:0 configuration:nil error:nil], all);
+	}
+	
+	// Path list.
+	SMJJSONPath *jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.items[?(@.group == 7)]" error:nil];
+	
+	XCTAssertEqualObjects([jsonPath resultForJSONObject:_document limit:2 configuration:[SMJConfiguration configurationWithOption:SMJOptionAsPathList] error:nil], (@[ @"$['items'][7]", @"$['items'][107]" ]));
+}
+
+- (void)test_limit_stop_traversal
+{
+	SMJJSONPath *jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.items[?(@.id == 10)].id" error:nil];
+	
+	XCTAssertEqualObjects([jsonPath firstResultForJSONObject:_document configuration:nil error:nil], @10);
+	XCTAssertLessThan(gLookupCount, 100);
+	
+	gLookupCount = 0;
+	
+	jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$..group" error:nil];
+	
+	XCTAssertEqualObjects([jsonPath firstResultForJSONObject:_document configuration:nil error:nil], @0);
+	XCTAssertLessThan(gLookupCount, 100);
+	
+	gLookupCount = 0;
+	
+	// Deep scan filters match dictionaries directly.
+	jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$..[?(@.id == 10)]" error:nil];
+	
+	XCTAssertEqualObjects([[jsonPath firstResultForJSONObject:_document configuration:nil error:nil] objectForKey:@"id"], @10);
+	XCTAssertLessThan(gLookupCount, 100);
+}
+
+- (void)test_first_result
+{
+	NSError *error = nil;
+	
+	// Definite path: result as-is.
+	XCTAssertEqualObjects([[[SMJJSONPath alloc] initWithJSONPathString:@"$.items[3].id" error:nil] firstResultForJSONObject:_document configuration:nil error:nil], @3);
+	XCTAssertEqual([[[[SMJJSONPath alloc] initWithJSONPathString:@"$.items" error:nil] firstResultForJSONObject:_document configuration:nil error:nil] count], 10000);
+	
+	// Function path.
+	XCTAssertEqualObjects([[[SMJJSONPath alloc] initWithJSONPathString:@"$.items.length()" error:nil] firstResultForJSONObject:_document configuration:nil error:nil], @10000);
+	
+	// Always return list.
+	XCTAssertEqualObjects([[[SMJJSONPath alloc] initWithJSONPathString:@"$.items[3].id" error:nil] firstResultForJSONObject:_document configuration:[SMJConfiguration configurationWithOption:SMJOptionAlwaysReturnList] error:nil], @3);
+	
+	// No result.
+	XCTAssertNil([[[SMJJSONPath alloc] initWithJSONPathString:@"$.items[?(@.id == -1)]" error:nil] firstResultForJSONObject:_document configuration:nil error:&error]);
+	XCTAssertNotNil(error);
+}
+
+- (void)test_limit_with_listener
+{
+	SMJConfiguration	*configuration = [SMJConfiguration defaultConfiguration];
+	SMJResultCounter	*counter = [[SMJResultCounter alloc] init];
+	
+	[configuration addListener:counter];
+	
+	NSArray *result = [[[SMJJSONPath alloc] initWithJSONPathString:@"$..id" error:nil] resultForJSONObject:_document limit:5 configuration:configuration error:nil];
+	
+	XCTAssertEqual(result.count, 5);
+	XCTAssertEqual(counter.count, 5);
+}
+
+- (void)test_first_result_performance
+{
+	SMJJSONPath *jsonPath = [[SMJJSONPath alloc] initWithJSONPathString:@"$.items[?(@.group == 1)]" error:nil];
+	
+	[self measureBlock:^{
+		for (NSUInteger i = 0; i < 1000; i++)
+			[jsonPath firstResultForJSONObject:self->_document configuration:nil error:nil];
+	}];
+}
+
+@end
+
+
+NS_ASSUME_NONNULL_END